@@ -26,7 +26,7 @@
  *          Pavel Boyko <boyko@iitp.ru>
  */
 #define NS_LOG_APPEND_CONTEXT                                   \
-  if (m_ipv4) { std::clog << "[node " << m_ipv4->GetObject<Node> ()->GetId () << "] "; } 
+  if (m_ipv4) { ns3LogStream << "[node " << m_ipv4->GetObject<Node> ()->GetId () << "] "; } 
 
 #include "aodv-routing-protocol.h"
 #include "ns3/log.h"
@@ -23,6 +23,7 @@
 #include "ns3/boolean.h"
 #include "ns3/simulator.h"
 #include "ns3/uinteger.h"
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("BridgeNetDevice");
 
@@ -30,6 +31,13 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (BridgeNetDevice);
 
+// The learning table starts with this number of entries, and doubles
+// when it is half full.
+static const uint32_t LEARN_TABLE_MIN_SIZE = 64;
+// The aging wheel has this number of slots, and the expiration time
+// spans half of them.
+static const uint32_t AGING_WHEEL_SIZE = 64;
+static const uint32_t AGING_TICKS_PER_EXPIRATION = AGING_WHEEL_SIZE / 2;
 
 TypeId
 BridgeNetDevice::GetTypeId (void)
@@ -58,7 +66,13 @@ BridgeNetDevice::GetTypeId (void)
 
 
 BridgeNetDevice::BridgeNetDevice ()
-  : m_node (0),
+  : m_nLearnedStates (0),
+    m_agingWheel (AGING_WHEEL_SIZE),
+    m_agingTick (0),
+    m_nLearnEvents (0),
+    m_nLookupMisses (0),
+    m_nFloodedFrames (0),
+    m_node (0),
     m_ifIndex (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -79,6 +93,12 @@ BridgeNetDevice::DoDispose ()
       *iter = 0;
     }
   m_ports.clear ();
+  m_learnState.clear ();
+  m_nLearnedStates = 0;
+  for (uint32_t i = 0; i < m_agingWheel.size (); i++)
+    {
+      m_agingWheel[i].clear ();
+    }
   m_channel = 0;
   m_node = 0;
   NetDevice::DoDispose ();
@@ -146,19 +166,7 @@ BridgeNetDevice::ForwardUnicast (Ptr<NetDevice> incomingPort, Ptr<const Packet>
   else
     {
       NS_LOG_LOGIC ("No learned state: send through all ports");
-      for (std::vector< Ptr<NetDevice> >::iterator iter = m_ports.begin ();
-           iter != m_ports.end (); iter++)
-        {
-          Ptr<NetDevice> port = *iter;
-          if (port != incomingPort)
-            {
-              NS_LOG_LOGIC ("LearningBridgeForward (" << src << " => " << dst << "): " 
-                                                      << incomingPort->GetInstanceTypeId ().GetName ()
-                                                      << " --> " << port->GetInstanceTypeId ().GetName ()
-                                                      << " (UID " << packet->GetUid () << ").");
-              port->SendFrom (packet->Copy (), src, dst, protocol);
-            }
-        }
+      Flood (incomingPort, packet->Copy (), src, dst, protocol);
     }
 }
 
@@ -171,20 +179,45 @@ BridgeNetDevice::ForwardBroadcast (Ptr<NetDevice> incomingPort, Ptr<const Packet
                                                        << ", packet=" << packet << ", protocol="<<protocol
                                                        << ", src=" << src << ", dst=" << dst << ")");
   Learn (src, incomingPort);
+  Flood (incomingPort, packet->Copy (), src, dst, protocol);
+}
 
-  for (std::vector< Ptr<NetDevice> >::iterator iter = m_ports.begin ();
-       iter != m_ports.end (); iter++)
+void
+BridgeNetDevice::Flood (Ptr<NetDevice> incomingPort, Ptr<Packet> packet,
+                        const Address &src, const Address &dst, uint16_t protocol)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_nFloodedFrames++;
+  // the last port gets the packet itself, the other ones a copy which
+  // shares its buffer until a header is added.
+  uint32_t last = m_ports.size ();
+  for (uint32_t i = 0; i < m_ports.size (); i++)
     {
-      Ptr<NetDevice> port = *iter;
+      if (m_ports[i] != incomingPort)
+        {
+          last = i;
+        }
+    }
+  for (uint32_t i = 0; i < last; i++)
+    {
+      Ptr<NetDevice> port = m_ports[i];
       if (port != incomingPort)
         {
-          NS_LOG_LOGIC ("LearningBridgeForward (" << src << " => " << dst << "): " 
-                                                  << incomingPort->GetInstanceTypeId ().GetName ()
-                                                  << " --> " << port->GetInstanceTypeId ().GetName ()
+          NS_LOG_LOGIC ("LearningBridgeForward (" << Mac48Address::ConvertFrom (src) << " => "
+                                                  << Mac48Address::ConvertFrom (dst) << "): --> "
+                                                  << port->GetInstanceTypeId ().GetName ()
                                                   << " (UID " << packet->GetUid () << ").");
           port->SendFrom (packet->Copy (), src, dst, protocol);
         }
     }
+  if (last < m_ports.size ())
+    {
+      NS_LOG_LOGIC ("LearningBridgeForward (" << Mac48Address::ConvertFrom (src) << " => "
+                                              << Mac48Address::ConvertFrom (dst) << "): --> "
+                                              << m_ports[last]->GetInstanceTypeId ().GetName ()
+                                              << " (UID " << packet->GetUid () << ").");
+      m_ports[last]->SendFrom (packet, src, dst, protocol);
+    }
 }
 
 void BridgeNetDevice::Learn (Mac48Address source, Ptr<NetDevice> port)
@@ -192,9 +225,31 @@ void BridgeNetDevice::Learn (Mac48Address source, Ptr<NetDevice> port)
   NS_LOG_FUNCTION_NOARGS ();
   if (m_enableLearning)
     {
-      LearnedState &state = m_learnState[source];
+      AdvanceAgingWheel ();
+      if (2 * (m_nLearnedStates + 1) > m_learnState.size ())
+        {
+          GrowLearnTable ();
+        }
+      Time now = Simulator::Now ();
+      uint64_t key = GetKey (source);
+      LearnedState &state = m_learnState[FindSlot (key)];
+      if (!state.used)
+        {
+          state.used = true;
+          state.key = key;
+          m_nLearnedStates++;
+          m_nLearnEvents++;
+          state.associatedPort = port;
+          state.expirationTime = now + m_expirationTime;
+          m_agingWheel[(GetAgingTick (state.expirationTime) + 1) % AGING_WHEEL_SIZE].push_back (key);
+          return;
+        }
+      if (state.associatedPort != port || state.expirationTime <= now)
+        {
+          m_nLearnEvents++;
+        }
       state.associatedPort = port;
-      state.expirationTime = Simulator::Now () + m_expirationTime;
+      state.expirationTime = now + m_expirationTime;
     }
 }
 
@@ -203,23 +258,134 @@ Ptr<NetDevice> BridgeNetDevice::GetLearnedState (Mac48Address source)
   NS_LOG_FUNCTION_NOARGS ();
   if (m_enableLearning)
     {
-      Time now = Simulator::Now ();
-      std::map<Mac48Address, LearnedState>::iterator iter =
-        m_learnState.find (source);
-      if (iter != m_learnState.end ())
+      AdvanceAgingWheel ();
+      if (m_nLearnedStates > 0)
         {
-          LearnedState &state = iter->second;
-          if (state.expirationTime > now)
+          const LearnedState &state = m_learnState[FindSlot (GetKey (source))];
+          if (state.used && state.expirationTime > Simulator::Now ())
             {
               return state.associatedPort;
             }
+        }
+    }
+  m_nLookupMisses++;
+  return NULL;
+}
+
+uint64_t
+BridgeNetDevice::GetKey (Mac48Address address)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  uint64_t key = 0;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return key;
+}
+
+uint32_t
+BridgeNetDevice::FindSlot (uint64_t key) const
+{
+  // the table is never full: the probe ends on the key or on an unused
+  // entry.
+  uint32_t mask = m_learnState.size () - 1;
+  uint32_t i = static_cast<uint32_t> ((key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+  while (m_learnState[i].used && m_learnState[i].key != key)
+    {
+      i = (i + 1) & mask;
+    }
+  return i;
+}
+
+void
+BridgeNetDevice::GrowLearnTable (void)
+{
+  NS_LOG_FUNCTION (this << m_learnState.size ());
+  LearnedState unused;
+  unused.key = 0;
+  unused.used = false;
+  std::vector<LearnedState> states (std::max<uint32_t> (LEARN_TABLE_MIN_SIZE, 2 * m_learnState.size ()),
+                                    unused);
+  states.swap (m_learnState);
+  for (std::vector<LearnedState>::const_iterator i = states.begin (); i != states.end (); ++i)
+    {
+      if (i->used)
+        {
+          m_learnState[FindSlot (i->key)] = *i;
+        }
+    }
+}
+
+void
+BridgeNetDevice::EraseLearnedState (uint32_t slot)
+{
+  // move back the entries which follow the erased one in its probe
+  // sequence, such that the probes of their key still find them.
+  uint32_t mask = m_learnState.size () - 1;
+  uint32_t hole = slot;
+  uint32_t i = slot;
+  while (true)
+    {
+      i = (i + 1) & mask;
+      if (!m_learnState[i].used)
+        {
+          break;
+        }
+      uint32_t home = static_cast<uint32_t> ((m_learnState[i].key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+      bool reachable = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+      if (!reachable)
+        {
+          m_learnState[hole] = m_learnState[i];
+          hole = i;
+        }
+    }
+  m_learnState[hole].used = false;
+  m_learnState[hole].associatedPort = 0;
+  m_nLearnedStates--;
+}
+
+int64_t
+BridgeNetDevice::GetAgingTick (Time time) const
+{
+  int64_t tick = m_expirationTime.GetTimeStep () / AGING_TICKS_PER_EXPIRATION;
+  return time.GetTimeStep () / std::max<int64_t> (tick, 1);
+}
+
+void
+BridgeNetDevice::AdvanceAgingWheel (void)
+{
+  Time now = Simulator::Now ();
+  int64_t current = GetAgingTick (now);
+  if (m_nLearnedStates == 0)
+    {
+      m_agingTick = current;
+      return;
+    }
+  // process each slot at most once.
+  int64_t tick = std::max<int64_t> (m_agingTick + 1, current - AGING_WHEEL_SIZE + 1);
+  for (; tick <= current; tick++)
+    {
+      std::vector<uint64_t> keys;
+      keys.swap (m_agingWheel[tick % AGING_WHEEL_SIZE]);
+      for (std::vector<uint64_t>::const_iterator i = keys.begin (); i != keys.end (); ++i)
+        {
+          uint32_t slot = FindSlot (*i);
+          NS_ASSERT (m_learnState[slot].used);
+          if (m_learnState[slot].expirationTime <= now)
+            {
+              NS_LOG_LOGIC ("Learned state of " << std::hex << *i << std::dec << " expired");
+              EraseLearnedState (slot);
+            }
           else
             {
-              m_learnState.erase (iter);
+              int64_t expiration = GetAgingTick (m_learnState[slot].expirationTime) + 1;
+              m_agingWheel[expiration % AGING_WHEEL_SIZE].push_back (*i);
             }
         }
     }
-  return NULL;
+  m_agingTick = current;
 }
 
 uint32_t
@@ -237,6 +403,30 @@ BridgeNetDevice::GetBridgePort (uint32_t n) const
   return m_ports[n];
 }
 
+uint32_t
+BridgeNetDevice::GetNLearnedAddresses (void) const
+{
+  return m_nLearnedStates;
+}
+
+uint64_t
+BridgeNetDevice::GetNLearnEvents (void) const
+{
+  return m_nLearnEvents;
+}
+
+uint64_t
+BridgeNetDevice::GetNLookupMisses (void) const
+{
+  return m_nLookupMisses;
+}
+
+uint64_t
+BridgeNetDevice::GetNFloodedFrames (void) const
+{
+  return m_nFloodedFrames;
+}
+
 void 
 BridgeNetDevice::AddBridgePort (Ptr<NetDevice> bridgePort)
 {
@@ -398,12 +588,7 @@ BridgeNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address
 
   // data was not unicast or no state has been learned for that mac
   // address => flood through all ports.
-  for (std::vector< Ptr<NetDevice> >::iterator iter = m_ports.begin ();
-       iter != m_ports.end (); iter++)
-    {
-      Ptr<NetDevice> port = *iter;
-      port->SendFrom (packet, src, dest, protocolNumber);
-    }
+  Flood (0, packet, src, dest, protocolNumber);
 
   return true;
 }
@@ -24,7 +24,7 @@
 #include "ns3/bridge-channel.h"
 #include <stdint.h>
 #include <string>
-#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -88,6 +88,26 @@ public:
 
   Ptr<NetDevice> GetBridgePort (uint32_t n) const;
 
+  /**
+   * \returns the number of MAC addresses in the learning table, which
+   * may include expired addresses not yet reclaimed.
+   */
+  uint32_t GetNLearnedAddresses (void) const;
+  /**
+   * \returns the number of times an address was learned on a new port
+   * or learned again after it expired.
+   */
+  uint64_t GetNLearnEvents (void) const;
+  /**
+   * \returns the number of unicast destinations which were not found in
+   * the learning table.
+   */
+  uint64_t GetNLookupMisses (void) const;
+  /**
+   * \returns the number of frames sent through all the ports.
+   */
+  uint64_t GetNFloodedFrames (void) const;
+
   // inherited from NetDevice base class.
   virtual void SetIfIndex (const uint32_t index);
   virtual uint32_t GetIfIndex (void) const;
@@ -130,6 +150,30 @@ private:
   BridgeNetDevice (const BridgeNetDevice &);
   BridgeNetDevice &operator = (const BridgeNetDevice &);
 
+  /**
+   * Send a frame through all the ports but the incoming one.  Every
+   * port but the last receives a (copy-on-write) copy of the packet.
+   */
+  void Flood (Ptr<NetDevice> incomingPort, Ptr<Packet> packet,
+              const Address &src, const Address &dst, uint16_t protocol);
+
+  /*
+   * The learning table is an open addressing hash table with linear
+   * probing, keyed by the 48 bits of the MAC addresses.  Lookups check
+   * the expiration time of the entries, and the expired entries are
+   * reclaimed by a timer wheel which is advanced by the received frames:
+   * each entry is filed in the slot of its expiration tick, and refreshing
+   * an entry only updates its expiration time.  When the slot of an entry
+   * is processed, the entry is removed if it expired, and filed again
+   * otherwise.
+   */
+  static uint64_t GetKey (Mac48Address address);
+  uint32_t FindSlot (uint64_t key) const;
+  void GrowLearnTable (void);
+  void EraseLearnedState (uint32_t slot);
+  int64_t GetAgingTick (Time time) const;
+  void AdvanceAgingWheel (void);
+
   NetDevice::ReceiveCallback m_rxCallback;
   NetDevice::PromiscReceiveCallback m_promiscRxCallback;
 
@@ -137,10 +181,18 @@ private:
   Time m_expirationTime; // time it takes for learned MAC state to expire
   struct LearnedState
   {
+    uint64_t key;
+    bool used;
     Ptr<NetDevice> associatedPort;
     Time expirationTime;
   };
-  std::map<Mac48Address, LearnedState> m_learnState;
+  std::vector<LearnedState> m_learnState; // size is a power of two
+  uint32_t m_nLearnedStates;
+  std::vector<std::vector<uint64_t> > m_agingWheel;
+  int64_t m_agingTick; // last tick processed
+  uint64_t m_nLearnEvents;
+  uint64_t m_nLookupMisses;
+  uint64_t m_nFloodedFrames;
   Ptr<Node> m_node;
   Ptr<BridgeChannel> m_channel;
   std::vector< Ptr<NetDevice> > m_ports;
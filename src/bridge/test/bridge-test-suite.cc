@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/bridge-net-device.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+class BridgeLearningTestCase : public TestCase
+{
+public:
+  BridgeLearningTestCase ();
+private:
+  virtual void DoRun (void);
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType packetType);
+  void Send (uint32_t from, Mac48Address to, Time delay = Seconds (0));
+
+  std::vector<Ptr<SimpleNetDevice> > m_hosts;
+  std::vector<uint32_t> m_received;
+};
+
+BridgeLearningTestCase::BridgeLearningTestCase ()
+  : TestCase ("Check the learning, the expiration and the flooding of a bridge")
+{
+}
+
+void
+BridgeLearningTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                                 const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  m_received[device->GetNode ()->GetId () - m_hosts[0]->GetNode ()->GetId ()]++;
+}
+
+void
+BridgeLearningTestCase::Send (uint32_t from, Mac48Address to, Time delay)
+{
+  for (uint32_t i = 0; i < m_received.size (); i++)
+    {
+      m_received[i] = 0;
+    }
+  Simulator::Schedule (delay, &SimpleNetDevice::Send, m_hosts[from], Create<Packet> (100), to, 0x800);
+  Simulator::Run ();
+}
+
+void
+BridgeLearningTestCase::DoRun (void)
+{
+  // a bridge with three ports, each one linked to a host.
+  Ptr<Node> bridgeNode = CreateObject<Node> ();
+  Ptr<BridgeNetDevice> bridge = CreateObject<BridgeNetDevice> ();
+  bridge->SetAttribute ("ExpirationTime", TimeValue (Seconds (10)));
+  bridgeNode->AddDevice (bridge);
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+      Ptr<Node> hostNode = CreateObject<Node> ();
+      Ptr<SimpleNetDevice> host = CreateObject<SimpleNetDevice> ();
+      addresses.push_back (Mac48Address::Allocate ());
+      host->SetAddress (addresses[i]);
+      host->SetChannel (channel);
+      hostNode->AddDevice (host);
+      hostNode->RegisterProtocolHandler (MakeCallback (&BridgeLearningTestCase::Receive, this),
+                                         0, host, true);
+      m_hosts.push_back (host);
+      m_received.push_back (0);
+
+      Ptr<SimpleNetDevice> port = CreateObject<SimpleNetDevice> ();
+      port->SetAddress (Mac48Address::Allocate ());
+      port->SetChannel (channel);
+      bridgeNode->AddDevice (port);
+      bridge->AddBridgePort (port);
+    }
+
+  // the destination is unknown: the frame is flooded.
+  Send (0, addresses[1]);
+  NS_TEST_EXPECT_MSG_EQ (m_received[1], 1, "Flooded frame received by its destination");
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], 1, "Flooded frame received by the other host");
+  NS_TEST_EXPECT_MSG_EQ (bridge->GetNFloodedFrames (), 1, "One frame was flooded");
+  NS_TEST_EXPECT_MSG_EQ (bridge->GetNLookupMisses (), 1, "One destination was not found");
+
+  // both hosts are now known.
+  Send (1, addresses[0]);
+  NS_TEST_EXPECT_MSG_EQ (m_received[0], 1, "Forwarded frame received by its destination");
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], 0, "Forwarded frame not received by the other host");
+  Send (0, addresses[1]);
+  NS_TEST_EXPECT_MSG_EQ (m_received[1], 1, "Forwarded frame received by its destination");
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], 0, "Forwarded frame not received by the other host");
+  NS_TEST_EXPECT_MSG_EQ (bridge->GetNFloodedFrames (), 1, "No other frame was flooded");
+  NS_TEST_EXPECT_MSG_EQ (bridge->GetNLearnEvents (), 2, "Two addresses were learned");
+  NS_TEST_EXPECT_MSG_EQ (bridge->GetNLearnedAddresses (), 2, "Two addresses are in the table");
+
+  // the address of host 1 expires, not the one of host 0, which keeps
+  // sending.
+  Send (0, addresses[2], Seconds (6));
+  Send (0, addresses[1], Seconds (6));
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], 1, "Frame to an expired address is flooded");
+  NS_TEST_EXPECT_MSG_EQ (bridge->GetNFloodedFrames (), 3, "Frames were flooded");
+  NS_TEST_EXPECT_MSG_EQ (bridge->GetNLearnedAddresses (), 1, "The expired address was removed");
+  Send (2, addresses[0]);
+  NS_TEST_EXPECT_MSG_EQ (m_received[0], 1, "Host 0 is still known");
+  NS_TEST_EXPECT_MSG_EQ (m_received[1], 0, "Host 0 is still known");
+  NS_TEST_EXPECT_MSG_EQ (bridge->GetNLearnEvents (), 3, "Host 2 was learned");
+
+  // many addresses move the entries of the table, and expire together.
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Simulator::Schedule (Seconds (0), &SimpleNetDevice::SendFrom, m_hosts[i % 3], Create<Packet> (100),
+                           Mac48Address::Allocate (), addresses[(i + 1) % 3], 0x800);
+    }
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (bridge->GetNLearnedAddresses (), 1002, "Addresses were learned");
+  Send (1, addresses[0]);
+  NS_TEST_EXPECT_MSG_EQ (m_received[0], 1, "Host 0 is still known");
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], 0, "Host 0 is still known");
+  NS_TEST_EXPECT_MSG_EQ (bridge->GetNLearnedAddresses (), 1003, "Host 1 was learned again");
+  Send (1, addresses[0], Seconds (11));
+  NS_TEST_EXPECT_MSG_EQ (bridge->GetNLearnedAddresses (), 1, "Only host 1 was learned again");
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], 1, "Frame to an expired address is flooded");
+
+  bridgeNode->Dispose ();
+  m_hosts.clear ();
+  Simulator::Destroy ();
+}
+
+class BridgeTestSuite : public TestSuite
+{
+public:
+  BridgeTestSuite ();
+};
+
+BridgeTestSuite::BridgeTestSuite ()
+  : TestSuite ("bridge", UNIT)
+{
+  AddTestCase (new BridgeLearningTestCase);
+}
+
+static BridgeTestSuite g_bridgeTestSuite;
+
+} // namespace ns3
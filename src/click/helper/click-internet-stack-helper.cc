@@ -33,6 +33,7 @@
 #include "ns3/string.h"
 #include "ns3/net-device.h"
 #include "ns3/callback.h"
+#include "ns3/trace-context.h"
 #include "ns3/node.h"
 #include "ns3/core-config.h"
 #include "ns3/arp-l3-protocol.h"
@@ -333,7 +334,7 @@ Ipv4L3ProtocolDropSinkWithoutContext (
 static void
 Ipv4L3ProtocolDropSinkWithContext (
   Ptr<OutputStreamWrapper> stream,
-  std::string context,
+  TraceContext context,
   Ipv4Header const &header,
   Ptr<const Packet> packet,
   Ipv4L3Protocol::DropReason reason,
@@ -485,7 +486,7 @@ ClickInternetStackHelper::EnableAsciiIpv4Internal (
       // functions that are always there waiting for just such a case.
       //
       oss << "/NodeList/" << node->GetId () << "/$ns3::ArpL3Protocol/Drop";
-      Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithContext, stream));
+      Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithTraceContext, stream));
 
       //
       // This has all kinds of parameters coming with, so we have to cook up our
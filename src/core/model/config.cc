@@ -27,6 +27,9 @@
 #include "log.h"
 
 #include <sstream>
+#include <algorithm>
+#include <limits>
+#include <map>
 
 NS_LOG_COMPONENT_DEFINE ("Config");
 
@@ -126,88 +129,134 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
     }
 }
 
-} // namespace Config
-
-class ArrayMatcher
+CompiledPath::CompiledPath (std::string path)
+  : m_path (path),
+    m_hasLeaf (false)
 {
-public:
-  ArrayMatcher (std::string element);
-  bool Matches (uint32_t i) const;
-private:
-  bool StringToUint32 (std::string str, uint32_t *value) const;
-  std::string m_element;
-};
-
-
-ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  NS_LOG_FUNCTION (path);
+  Compile (Canonicalize (path), &m_segments);
+  std::string::size_type slash = path.find_last_of ("/");
+  if (slash != std::string::npos)
+    {
+      m_hasLeaf = true;
+      Compile (Canonicalize (path.substr (0, slash)), &m_rootSegments);
+      m_leaf = path.substr (slash+1, path.size ()-(slash+1));
+    }
+}
+std::string
+CompiledPath::GetPath (void) const
 {
+  return m_path;
 }
-bool
-ArrayMatcher::Matches (uint32_t i) const
+std::string
+CompiledPath::Canonicalize (std::string path)
 {
-  if (m_element == "*")
+  // ensure that we start and end with a '/'
+  std::string::size_type tmp = path.find ("/");
+  if (tmp != 0)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      // no slash at start
+      path = "/" + path;
     }
-  std::string::size_type tmp;
-  tmp = m_element.find ("|");
-  if (tmp != std::string::npos)
+  tmp = path.find_last_of ("/");
+  if (tmp != (path.size () - 1))
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
+      // no slash at end
+      path = path + "/";
+    }
+  return path;
+}
+void
+CompiledPath::Compile (std::string path, std::vector<Segment> *segments)
+{
+  NS_ASSERT ((path.find ("/")) == 0);
+  std::string::size_type start = 1;
+  std::string::size_type next = path.find ("/", start);
+  while (next != std::string::npos)
+    {
+      Segment segment;
+      segment.name = path.substr (start, next-start);
+      segment.isGetObject = segment.name.find ("$") == 0;
+      segment.hasTypeId = false;
+      segment.tid = 0;
+      if (segment.isGetObject)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
+          TypeId tid;
+          segment.hasTypeId = TypeId::LookupByNameFailSafe (segment.name.substr (1), &tid);
+          segment.tid = tid.GetUid ();
         }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      CompileArray (segment.name, &segment);
+      segments->push_back (segment);
+      start = next + 1;
+      next = path.find ("/", start);
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
-      dash > leftBracket && dash < rightBracket)
-    {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
-      uint32_t min;
-      uint32_t max;
-      if (StringToUint32 (lowerBound, &min) && 
-          StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
+}
+void
+CompiledPath::CompileArray (std::string item, Segment *segment)
+{
+  // An array index is a list of '|'-separated alternatives, each
+  // of which is a '*', a range ('[min-max]') or a single number.
+  segment->matchesAll = false;
+  std::vector<std::pair<uint32_t, uint32_t> > ranges;
+  std::string::size_type start = 0;
+  while (true)
+    {
+      std::string::size_type bar = item.find ("|", start);
+      std::string element = item.substr (start, bar == std::string::npos ? std::string::npos : bar - start);
+      if (element == "*")
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
+          segment->matchesAll = true;
         }
       else
         {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          std::string::size_type leftBracket = element.find ("[");
+          std::string::size_type rightBracket = element.find ("]");
+          std::string::size_type dash = element.find ("-");
+          uint32_t min;
+          uint32_t max;
+          if (leftBracket == 0 && rightBracket == element.size () - 1 &&
+              dash > leftBracket && dash < rightBracket)
+            {
+              std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+              std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
+              if (StringToUint32 (lowerBound, &min) &&
+                  StringToUint32 (upperBound, &max) &&
+                  min <= max)
+                {
+                  ranges.push_back (std::make_pair (min, max));
+                }
+            }
+          else if (StringToUint32 (element, &min))
+            {
+              ranges.push_back (std::make_pair (min, min));
+            }
+        }
+      if (bar == std::string::npos)
+        {
+          break;
         }
+      start = bar + 1;
     }
-  uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  // merge overlapping and adjacent ranges such that the matched
+  // indexes can be enumerated in increasing order, each only once.
+  std::sort (ranges.begin (), ranges.end ());
+  segment->ranges.clear ();
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator i = ranges.begin (); i != ranges.end (); ++i)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-      return true;
+      if (!segment->ranges.empty () &&
+          (segment->ranges.back ().second == std::numeric_limits<uint32_t>::max () ||
+           i->first <= segment->ranges.back ().second + 1))
+        {
+          segment->ranges.back ().second = std::max (segment->ranges.back ().second, i->second);
+        }
+      else
+        {
+          segment->ranges.push_back (*i);
+        }
     }
-  NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-  return false;
 }
-
 bool
-ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
+CompiledPath::StringToUint32 (std::string str, uint32_t *value)
 {
   std::istringstream iss;
   iss.str (str);
@@ -215,55 +264,42 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+} // namespace Config
 
 class Resolver
 {
 public:
-  Resolver (std::string path);
+  typedef std::vector<Config::CompiledPath::Segment> Segments;
+
+  Resolver (const Segments &segments);
   virtual ~Resolver ();
 
   void Resolve (Ptr<Object> root);
 private:
-  void Canonicalize (void);
-  void DoResolve (std::string path, Ptr<Object> root);
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoResolve (uint32_t segment, Ptr<Object> root);
+  void DoArrayResolve (uint32_t segment, Ptr<Object> root, const struct TypeId::AttributeInformation &info);
+  void DoArrayResolveOne (uint32_t segment, uint32_t i, Ptr<Object> object);
+  void GetMatchingIndexes (const Config::CompiledPath::Segment &segment, uint32_t n,
+                           std::vector<uint32_t> *indexes) const;
   void DoResolveOne (Ptr<Object> object);
   std::string GetResolvedPath (void) const;
   virtual void DoOne (Ptr<Object> object, std::string path) = 0;
   std::vector<std::string> m_workStack;
-  std::string m_path;
+  const Segments &m_segments;
 };
 
-Resolver::Resolver (std::string path)
-  : m_path (path)
+Resolver::Resolver (const Segments &segments)
+  : m_segments (segments)
 {
-  Canonicalize ();
 }
 Resolver::~Resolver ()
 {
 }
-void
-Resolver::Canonicalize (void)
-{
-  // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
-    {
-      // no slash at start
-      m_path = "/" + m_path;
-    }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
-    {
-      // no slash at end
-      m_path = m_path + "/";
-    }
-}
 
 void 
 Resolver::Resolve (Ptr<Object> root)
 {
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -285,13 +321,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (uint32_t segment, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (segment << root);
 
-  if (next == std::string::npos)
+  if (segment == m_segments.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -307,8 +341,8 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const Config::CompiledPath::Segment &current = m_segments[segment];
+  const std::string &item = current.name;
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -319,11 +353,11 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
+      std::string::size_type offset = item.find ("Names");
       if (offset == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (segment + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -340,7 +374,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (segment + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -356,21 +390,27 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (current.isGetObject)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      NS_LOG_DEBUG ("GetObject="<<item.substr (1)<<" on path="<<GetResolvedPath ());
+      TypeId tid;
+      if (current.hasTypeId)
+        {
+          tid.SetUid (current.tid);
+        }
+      else
+        {
+          tid = TypeId::LookupByName (item.substr (1));
+        }
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject ("<<item.substr (1)<<") failed on path="<<GetResolvedPath ());
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (segment + 1, object);
       m_workStack.pop_back ();
     }
   else 
@@ -399,7 +439,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
               return;
             }
           m_workStack.push_back (item);
-          DoResolve (pathLeft, object);
+          DoResolve (segment + 1, object);
           m_workStack.pop_back ();
         }
       // attempt to cast to an object vector.
@@ -407,10 +447,8 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
       if (vectorChecker != 0)
         {
           NS_LOG_DEBUG ("GetAttribute(vector)="<<item<<" on path="<<GetResolvedPath ());
-          ObjectPtrContainerValue vector;
-          root->GetAttribute (item, vector);
           m_workStack.push_back (item);
-          DoArrayResolve (pathLeft, vector);
+          DoArrayResolve (segment + 1, root, info);
           m_workStack.pop_back ();
         }
       // this could be anything else and we don't know what to do with it.
@@ -419,42 +457,85 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector)
+Resolver::DoArrayResolve (uint32_t segment, Ptr<Object> root, const struct TypeId::AttributeInformation &info)
 {
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  if (segment == m_segments.size ())
+    {
+      NS_FATAL_ERROR ("vector path includes no index data on path=\""<<GetResolvedPath ()<<"\"");
+    }
+  const Config::CompiledPath::Segment &current = m_segments[segment];
+
+  // Enumerate the matching indexes in increasing order.
+  std::vector<uint32_t> indexes;
+  uint32_t n;
+  const ObjectPtrContainerAccessor *accessor = dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (info.accessor));
+  if (accessor != 0 && (info.flags & TypeId::ATTR_GET) &&
+      accessor->GetN (PeekPointer (root), &n))
+    {
+      // Fetch only the matching items straight from the container
+      // rather than copying all of them in an ObjectPtrContainerValue.
+      GetMatchingIndexes (current, n, &indexes);
+      for (std::vector<uint32_t>::const_iterator i = indexes.begin (); i != indexes.end (); ++i)
+        {
+          DoArrayResolveOne (segment, *i, accessor->GetItem (PeekPointer (root), *i));
+        }
+      return;
+    }
+  ObjectPtrContainerValue vector;
+  root->GetAttribute (m_segments[segment - 1].name, vector);
+  GetMatchingIndexes (current, vector.GetN (), &indexes);
+  for (std::vector<uint32_t>::const_iterator i = indexes.begin (); i != indexes.end (); ++i)
     {
-      NS_FATAL_ERROR ("vector path includes no index data on path=\""<<path<<"\"");
+      DoArrayResolveOne (segment, *i, vector.Get (*i));
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+}
 
-  ArrayMatcher matcher = ArrayMatcher (item);
-  for (uint32_t i = 0; i < vector.GetN (); i++)
+void
+Resolver::GetMatchingIndexes (const Config::CompiledPath::Segment &segment, uint32_t n,
+                              std::vector<uint32_t> *indexes) const
+{
+  if (segment.matchesAll)
     {
-      if (matcher.Matches (i))
+      for (uint32_t i = 0; i < n; i++)
         {
-          std::ostringstream oss;
-          oss << i;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, vector.Get (i));
-          m_workStack.pop_back ();
+          indexes->push_back (i);
         }
+      return;
     }
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator j = segment.ranges.begin ();
+       j != segment.ranges.end () && j->first < n; ++j)
+    {
+      uint32_t last = std::min (j->second, n - 1);
+      for (uint32_t i = j->first; i <= last; i++)
+        {
+          indexes->push_back (i);
+        }
+    }
+}
+
+void
+Resolver::DoArrayResolveOne (uint32_t segment, uint32_t i, Ptr<Object> object)
+{
+  NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_segments[segment].name);
+  std::ostringstream oss;
+  oss << i;
+  m_workStack.push_back (oss.str ());
+  DoResolve (segment + 1, object);
+  m_workStack.pop_back ();
 }
 
 
 class ConfigImpl 
 {
 public:
-  void Set (std::string path, const AttributeValue &value);
-  void ConnectWithoutContext (std::string path, const CallbackBase &cb);
-  void Connect (std::string path, const CallbackBase &cb);
-  void DisconnectWithoutContext (std::string path, const CallbackBase &cb);
-  void Disconnect (std::string path, const CallbackBase &cb);
-  Config::MatchContainer LookupMatches (std::string path);
+  void Set (const Config::CompiledPath &path, const AttributeValue &value);
+  void ConnectWithoutContext (const Config::CompiledPath &path, const CallbackBase &cb);
+  void Connect (const Config::CompiledPath &path, const CallbackBase &cb);
+  void DisconnectWithoutContext (const Config::CompiledPath &path, const CallbackBase &cb);
+  void Disconnect (const Config::CompiledPath &path, const CallbackBase &cb);
+  Config::MatchContainer LookupMatches (const Config::CompiledPath &path);
+  void ConnectWithoutContext (const std::vector<std::string> &paths, const CallbackBase &cb);
+  void Connect (const std::vector<std::string> &paths, const CallbackBase &cb);
 
   void RegisterRootNamespaceObject (Ptr<Object> obj);
   void UnregisterRootNamespaceObject (Ptr<Object> obj);
@@ -463,71 +544,107 @@ public:
   Ptr<Object> GetRootNamespaceObject (uint32_t i) const;
 
 private:
-  void ParsePath (std::string path, std::string *root, std::string *leaf) const;
+  Config::MatchContainer LookupRootMatches (const Config::CompiledPath &path);
+  Config::MatchContainer DoLookupMatches (const Resolver::Segments &segments, std::string path);
+  void ConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb, bool withContext);
   typedef std::vector<Ptr<Object> > Roots;
   Roots m_roots;
 };
 
-void 
-ConfigImpl::ParsePath (std::string path, std::string *root, std::string *leaf) const
+Config::MatchContainer
+ConfigImpl::LookupRootMatches (const Config::CompiledPath &path)
 {
-  std::string::size_type slash = path.find_last_of ("/");
-  NS_ASSERT (slash != std::string::npos);
-  *root = path.substr (0, slash);
-  *leaf = path.substr (slash+1, path.size ()-(slash+1));
-  NS_LOG_FUNCTION (path << *root << *leaf);
+  NS_ASSERT (path.m_hasLeaf);
+  NS_LOG_FUNCTION (path.m_path << path.m_leaf);
+  std::string::size_type slash = path.m_path.find_last_of ("/");
+  return DoLookupMatches (path.m_rootSegments, path.m_path.substr (0, slash));
 }
 
 void 
-ConfigImpl::Set (std::string path, const AttributeValue &value)
+ConfigImpl::Set (const Config::CompiledPath &path, const AttributeValue &value)
 {
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  Config::MatchContainer container = LookupMatches (root);
-  container.Set (leaf, value);
+  Config::MatchContainer container = LookupRootMatches (path);
+  container.Set (path.m_leaf, value);
 }
 void 
-ConfigImpl::ConnectWithoutContext (std::string path, const CallbackBase &cb)
+ConfigImpl::ConnectWithoutContext (const Config::CompiledPath &path, const CallbackBase &cb)
 {
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  Config::MatchContainer container = LookupMatches (root);
-  container.ConnectWithoutContext (leaf, cb);
+  Config::MatchContainer container = LookupRootMatches (path);
+  container.ConnectWithoutContext (path.m_leaf, cb);
 }
 void 
-ConfigImpl::DisconnectWithoutContext (std::string path, const CallbackBase &cb)
+ConfigImpl::DisconnectWithoutContext (const Config::CompiledPath &path, const CallbackBase &cb)
 {
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  Config::MatchContainer container = LookupMatches (root);
-  container.DisconnectWithoutContext (leaf, cb);
+  Config::MatchContainer container = LookupRootMatches (path);
+  container.DisconnectWithoutContext (path.m_leaf, cb);
 }
 void 
-ConfigImpl::Connect (std::string path, const CallbackBase &cb)
+ConfigImpl::Connect (const Config::CompiledPath &path, const CallbackBase &cb)
 {
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  Config::MatchContainer container = LookupMatches (root);
-  container.Connect (leaf, cb);
+  Config::MatchContainer container = LookupRootMatches (path);
+  container.Connect (path.m_leaf, cb);
 }
 void 
-ConfigImpl::Disconnect (std::string path, const CallbackBase &cb)
+ConfigImpl::Disconnect (const Config::CompiledPath &path, const CallbackBase &cb)
+{
+  Config::MatchContainer container = LookupRootMatches (path);
+  container.Disconnect (path.m_leaf, cb);
+}
+
+void
+ConfigImpl::ConnectAll (const std::vector<std::string> &paths, const CallbackBase &cb, bool withContext)
+{
+  // Paths which differ only by their trace source name share the
+  // same matches: look them up only once.
+  std::map<std::string, Config::MatchContainer> matches;
+  for (std::vector<std::string>::const_iterator i = paths.begin (); i != paths.end (); ++i)
+    {
+      std::string::size_type slash = i->find_last_of ("/");
+      NS_ASSERT (slash != std::string::npos);
+      std::string root = i->substr (0, slash);
+      std::string leaf = i->substr (slash+1, i->size ()-(slash+1));
+      std::map<std::string, Config::MatchContainer>::iterator found = matches.find (root);
+      if (found == matches.end ())
+        {
+          Config::CompiledPath compiled = Config::CompiledPath (root);
+          found = matches.insert (std::make_pair (root, LookupMatches (compiled))).first;
+        }
+      if (withContext)
+        {
+          found->second.Connect (leaf, cb);
+        }
+      else
+        {
+          found->second.ConnectWithoutContext (leaf, cb);
+        }
+    }
+}
+void
+ConfigImpl::ConnectWithoutContext (const std::vector<std::string> &paths, const CallbackBase &cb)
 {
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  Config::MatchContainer container = LookupMatches (root);
-  container.Disconnect (leaf, cb);
+  ConnectAll (paths, cb, false);
+}
+void
+ConfigImpl::Connect (const std::vector<std::string> &paths, const CallbackBase &cb)
+{
+  ConnectAll (paths, cb, true);
+}
+
+Config::MatchContainer 
+ConfigImpl::LookupMatches (const Config::CompiledPath &path)
+{
+  return DoLookupMatches (path.m_segments, path.m_path);
 }
 
 Config::MatchContainer 
-ConfigImpl::LookupMatches (std::string path)
+ConfigImpl::DoLookupMatches (const Resolver::Segments &segments, std::string path)
 {
   NS_LOG_FUNCTION (path);
   class LookupMatchesResolver : public Resolver 
   {
 public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
+    LookupMatchesResolver (const Resolver::Segments &segments)
+      : Resolver (segments)
     {}
     virtual void DoOne (Ptr<Object> object, std::string path) {
       m_objects.push_back (object);
@@ -535,7 +652,7 @@ public:
     }
     std::vector<Ptr<Object> > m_objects;
     std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  } resolver = LookupMatchesResolver (segments);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
@@ -603,6 +720,10 @@ void Reset (void)
 }
 
 void Set (std::string path, const AttributeValue &value)
+{
+  Singleton<ConfigImpl>::Get ()->Set (CompiledPath (path), value);
+}
+void Set (const CompiledPath &path, const AttributeValue &value)
 {
   Singleton<ConfigImpl>::Get ()->Set (path, value);
 }
@@ -653,24 +774,55 @@ bool SetGlobalFailSafe (std::string name, const AttributeValue &value)
   return GlobalValue::BindFailSafe (name, value);
 }
 void ConnectWithoutContext (std::string path, const CallbackBase &cb)
+{
+  Singleton<ConfigImpl>::Get ()->ConnectWithoutContext (CompiledPath (path), cb);
+}
+void ConnectWithoutContext (const CompiledPath &path, const CallbackBase &cb)
 {
   Singleton<ConfigImpl>::Get ()->ConnectWithoutContext (path, cb);
 }
+void ConnectWithoutContext (const std::vector<std::string> &paths, const CallbackBase &cb)
+{
+  Singleton<ConfigImpl>::Get ()->ConnectWithoutContext (paths, cb);
+}
 void DisconnectWithoutContext (std::string path, const CallbackBase &cb)
+{
+  Singleton<ConfigImpl>::Get ()->DisconnectWithoutContext (CompiledPath (path), cb);
+}
+void DisconnectWithoutContext (const CompiledPath &path, const CallbackBase &cb)
 {
   Singleton<ConfigImpl>::Get ()->DisconnectWithoutContext (path, cb);
 }
 void 
 Connect (std::string path, const CallbackBase &cb)
+{
+  Singleton<ConfigImpl>::Get ()->Connect (CompiledPath (path), cb);
+}
+void 
+Connect (const CompiledPath &path, const CallbackBase &cb)
 {
   Singleton<ConfigImpl>::Get ()->Connect (path, cb);
 }
 void 
+Connect (const std::vector<std::string> &paths, const CallbackBase &cb)
+{
+  Singleton<ConfigImpl>::Get ()->Connect (paths, cb);
+}
+void 
 Disconnect (std::string path, const CallbackBase &cb)
+{
+  Singleton<ConfigImpl>::Get ()->Disconnect (CompiledPath (path), cb);
+}
+void 
+Disconnect (const CompiledPath &path, const CallbackBase &cb)
 {
   Singleton<ConfigImpl>::Get ()->Disconnect (path, cb);
 }
 Config::MatchContainer LookupMatches (std::string path)
+{
+  return Singleton<ConfigImpl>::Get ()->LookupMatches (CompiledPath (path));
+}
+Config::MatchContainer LookupMatches (const CompiledPath &path)
 {
   return Singleton<ConfigImpl>::Get ()->LookupMatches (path);
 }
@@ -29,6 +29,8 @@ namespace ns3 {
 class AttributeValue;
 class Object;
 class CallbackBase;
+class Resolver;
+class ConfigImpl;
 
 /**
  * \brief Configuration of simulation parameters and tracing
@@ -222,6 +224,126 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+/**
+ * \brief a configuration path, parsed once to be matched many times.
+ *
+ * Config::Set, Config::Connect and the other functions of this namespace
+ * which take a path string parse it again for every call.  A
+ * CompiledPath splits the path in segments, parses the array indexes
+ * (e.g., "*", "3", "[2-5]" or "1|4") and looks up the TypeIds named
+ * by "$" segments once and for all, and can then be passed to the
+ * overloads of these functions which take a CompiledPath.
+ */
+class CompiledPath
+{
+public:
+  /**
+   * \param path a path, with the same syntax as the paths given to
+   *        Config::Set, Config::Connect or Config::LookupMatches.
+   */
+  explicit CompiledPath (std::string path);
+  /**
+   * \returns the path this object was created from.
+   */
+  std::string GetPath (void) const;
+
+private:
+  friend class ns3::Resolver;
+  friend class ns3::ConfigImpl;
+
+  struct Segment
+  {
+    std::string name;
+    /// true if name starts with '$'
+    bool isGetObject;
+    /// true if the TypeId named by a '$' segment exists
+    bool hasTypeId;
+    /// the uid of the TypeId named by a '$' segment
+    uint16_t tid;
+    /// true if the segment is "*" or contains a "*" alternative
+    bool matchesAll;
+    /// the sorted, disjoint [min, max] ranges of array indexes matched
+    std::vector<std::pair<uint32_t, uint32_t> > ranges;
+  };
+  static std::string Canonicalize (std::string path);
+  static void Compile (std::string path, std::vector<Segment> *segments);
+  static void CompileArray (std::string item, Segment *segment);
+  static bool StringToUint32 (std::string str, uint32_t *value);
+
+  std::string m_path;
+  /// the segments of the whole path, as used by Config::LookupMatches
+  std::vector<Segment> m_segments;
+  /// the segments of the path without its last element
+  std::vector<Segment> m_rootSegments;
+  /// the last element of the path: an attribute or trace source name
+  std::string m_leaf;
+  /// false if the path contains no '/' and thus cannot be split
+  bool m_hasLeaf;
+};
+
+/**
+ * \param path a compiled path to match attributes.
+ * \param value the value to set in all matching attributes.
+ *
+ * \sa Config::Set (std::string, const AttributeValue &)
+ */
+void Set (const CompiledPath &path, const AttributeValue &value);
+/**
+ * \param path a compiled path to match trace sources.
+ * \param cb the callback to connect to the matching trace sources.
+ *
+ * \sa Config::ConnectWithoutContext (std::string, const CallbackBase &)
+ */
+void ConnectWithoutContext (const CompiledPath &path, const CallbackBase &cb);
+/**
+ * \param path a compiled path to match trace sources.
+ * \param cb the callback to disconnect from the matching trace sources.
+ *
+ * \sa Config::DisconnectWithoutContext (std::string, const CallbackBase &)
+ */
+void DisconnectWithoutContext (const CompiledPath &path, const CallbackBase &cb);
+/**
+ * \param path a compiled path to match trace sources.
+ * \param cb the callback to connect to the matching trace sources.
+ *
+ * \sa Config::Connect (std::string, const CallbackBase &)
+ */
+void Connect (const CompiledPath &path, const CallbackBase &cb);
+/**
+ * \param path a compiled path to match trace sources.
+ * \param cb the callback to disconnect from the matching trace sources.
+ *
+ * \sa Config::Disconnect (std::string, const CallbackBase &)
+ */
+void Disconnect (const CompiledPath &path, const CallbackBase &cb);
+/**
+ * \param path a compiled path to perform a match against
+ * \returns a container which contains all the objects which match the input
+ *          path.
+ */
+MatchContainer LookupMatches (const CompiledPath &path);
+
+/**
+ * \param paths a set of paths to match trace sources.
+ * \param cb the callback to connect to the matching trace sources.
+ *
+ * This is equivalent to calling Config::ConnectWithoutContext on each
+ * path in turn, except that the objects matched by paths which differ
+ * only by their last element (the trace source name) are looked up
+ * only once.
+ */
+void ConnectWithoutContext (const std::vector<std::string> &paths, const CallbackBase &cb);
+/**
+ * \param paths a set of paths to match trace sources.
+ * \param cb the callback to connect to the matching trace sources.
+ *
+ * This is equivalent to calling Config::Connect on each
+ * path in turn, except that the objects matched by paths which differ
+ * only by their last element (the trace source name) are looked up
+ * only once.
+ */
+void Connect (const std::vector<std::string> &paths, const CallbackBase &cb);
+
 /**
  * \param obj a new root object
  *
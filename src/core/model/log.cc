@@ -20,12 +20,21 @@
 #include "log.h"
 
 #include <list>
+#include <map>
+#include <vector>
 #include <utility>
 #include <iostream>
+#include <sstream>
+#include <cstdio>
 #include <string.h>
 #include "assert.h"
 #include "ns3/core-config.h"
 #include "fatal-error.h"
+#include "fatal-impl.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 
 #ifdef HAVE_GETENV
 #include <string.h>
@@ -57,6 +66,344 @@ ComponentList *GetComponentList (void)
 }
 
 
+/**
+ * The binary log output: a sequence of records, each made of a one
+ * byte type followed by the fields below, all in host byte order.
+ */
+enum LogRecordType {
+  LOG_RECORD_COMPONENT = 1, // uint16_t id, uint16_t length, name
+  LOG_RECORD_MESSAGE = 2,   // uint16_t id, uint32_t level, uint32_t length, text
+  LOG_RECORD_DROPPED = 3    // uint16_t id, uint32_t count
+};
+static const char g_logBinaryMagic[8] = { 'N', 'S', '3', 'L', 'O', 'G', 0, 1 };
+
+/**
+ * Buffers binary log records in a ring of fixed-size blocks which are
+ * written to the output file by a background thread.  The simulation
+ * thread blocks only when all the blocks are waiting to be written.
+ *
+ * The thread is managed with pthreads directly rather than with
+ * SystemThread and friends because these log their own operations.
+ */
+class LogBinaryOutput
+{
+public:
+  LogBinaryOutput (FILE *file);
+  ~LogBinaryOutput ();
+  void WriteMessage (const LogComponent &component, enum LogLevel level, const std::string &message);
+  void WriteDropped (const LogComponent &component, uint32_t count);
+  void Flush (void);
+private:
+  class FlushBuffer : public std::streambuf
+  {
+public:
+    FlushBuffer (LogBinaryOutput *output) : m_output (output) {}
+    virtual int sync (void) { m_output->Flush (); return 0; }
+    LogBinaryOutput *m_output;
+  };
+  uint16_t GetComponentId (const LogComponent &component);
+  void Append (const void *data, uint32_t size);
+  template <typename T>
+  void AppendValue (T value)
+  {
+    Append (&value, sizeof (value));
+  }
+  void Submit (void);
+#ifdef HAVE_PTHREAD_H
+  static void *Run (void *output);
+  void DoRun (void);
+  pthread_t m_thread;
+  // serializes the threads which output messages
+  pthread_mutex_t m_writeMutex;
+  // protects the ring of blocks shared with the writer thread
+  pthread_mutex_t m_mutex;
+  pthread_cond_t m_notEmpty;
+  pthread_cond_t m_notFull;
+  uint32_t m_pending;
+  uint32_t m_next;
+  bool m_stop;
+#endif
+  FILE *m_file;
+  std::vector<std::string> m_blocks;
+  uint32_t m_current;
+  std::map<const LogComponent *, uint16_t> m_ids;
+  FlushBuffer m_flushBuffer;
+  std::ostream m_flushStream;
+
+  static const uint32_t BLOCK_SIZE = 1 << 16;
+  static const uint32_t N_BLOCKS = 16;
+};
+
+LogBinaryOutput::LogBinaryOutput (FILE *file)
+  : m_file (file),
+    m_blocks (N_BLOCKS),
+    m_current (0),
+    m_flushBuffer (this),
+    m_flushStream (&m_flushBuffer)
+{
+  for (uint32_t i = 0; i < N_BLOCKS; i++)
+    {
+      m_blocks[i].reserve (BLOCK_SIZE);
+    }
+  std::fwrite (g_logBinaryMagic, sizeof (g_logBinaryMagic), 1, m_file);
+#ifdef HAVE_PTHREAD_H
+  m_pending = 0;
+  m_next = 0;
+  m_stop = false;
+  pthread_mutex_init (&m_writeMutex, 0);
+  pthread_mutex_init (&m_mutex, 0);
+  pthread_cond_init (&m_notEmpty, 0);
+  pthread_cond_init (&m_notFull, 0);
+  if (pthread_create (&m_thread, 0, &LogBinaryOutput::Run, this) != 0)
+    {
+      NS_FATAL_ERROR ("Could not start the binary log writer thread");
+    }
+#endif
+  // make sure that the buffered messages are written if the program
+  // stops on a fatal error.
+  FatalImpl::RegisterStream (&m_flushStream);
+}
+
+LogBinaryOutput::~LogBinaryOutput ()
+{
+  FatalImpl::UnregisterStream (&m_flushStream);
+  Submit ();
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&m_mutex);
+  m_stop = true;
+  pthread_cond_signal (&m_notEmpty);
+  pthread_mutex_unlock (&m_mutex);
+  pthread_join (m_thread, 0);
+  pthread_cond_destroy (&m_notFull);
+  pthread_cond_destroy (&m_notEmpty);
+  pthread_mutex_destroy (&m_mutex);
+  pthread_mutex_destroy (&m_writeMutex);
+#endif
+  std::fclose (m_file);
+}
+
+uint16_t
+LogBinaryOutput::GetComponentId (const LogComponent &component)
+{
+  std::map<const LogComponent *, uint16_t>::const_iterator i = m_ids.find (&component);
+  if (i != m_ids.end ())
+    {
+      return i->second;
+    }
+  uint16_t id = m_ids.size ();
+  m_ids[&component] = id;
+  std::string name = component.Name ();
+  AppendValue<uint8_t> (LOG_RECORD_COMPONENT);
+  AppendValue<uint16_t> (id);
+  AppendValue<uint16_t> (name.size ());
+  Append (name.data (), name.size ());
+  return id;
+}
+
+void
+LogBinaryOutput::WriteMessage (const LogComponent &component, enum LogLevel level, const std::string &message)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&m_writeMutex);
+#endif
+  uint16_t id = GetComponentId (component);
+  AppendValue<uint8_t> (LOG_RECORD_MESSAGE);
+  AppendValue<uint16_t> (id);
+  AppendValue<uint32_t> (level);
+  AppendValue<uint32_t> (message.size ());
+  Append (message.data (), message.size ());
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock (&m_writeMutex);
+#endif
+}
+
+void
+LogBinaryOutput::WriteDropped (const LogComponent &component, uint32_t count)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&m_writeMutex);
+#endif
+  uint16_t id = GetComponentId (component);
+  AppendValue<uint8_t> (LOG_RECORD_DROPPED);
+  AppendValue<uint16_t> (id);
+  AppendValue<uint32_t> (count);
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock (&m_writeMutex);
+#endif
+}
+
+void
+LogBinaryOutput::Append (const void *data, uint32_t size)
+{
+  // records may span two blocks: the file is a plain byte stream.
+  m_blocks[m_current].append (static_cast<const char *> (data), size);
+  if (m_blocks[m_current].size () >= BLOCK_SIZE)
+    {
+      Submit ();
+    }
+}
+
+void
+LogBinaryOutput::Submit (void)
+{
+  if (m_blocks[m_current].empty ())
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&m_mutex);
+  while (m_pending == N_BLOCKS - 1)
+    {
+      pthread_cond_wait (&m_notFull, &m_mutex);
+    }
+  m_pending++;
+  m_current = (m_current + 1) % N_BLOCKS;
+  pthread_cond_signal (&m_notEmpty);
+  pthread_mutex_unlock (&m_mutex);
+#else
+  std::fwrite (m_blocks[m_current].data (), m_blocks[m_current].size (), 1, m_file);
+  m_blocks[m_current].clear ();
+#endif
+}
+
+void
+LogBinaryOutput::Flush (void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&m_writeMutex);
+  Submit ();
+  pthread_mutex_lock (&m_mutex);
+  while (m_pending != 0)
+    {
+      pthread_cond_wait (&m_notFull, &m_mutex);
+    }
+  pthread_mutex_unlock (&m_mutex);
+  pthread_mutex_unlock (&m_writeMutex);
+#else
+  Submit ();
+#endif
+  std::fflush (m_file);
+}
+
+#ifdef HAVE_PTHREAD_H
+void *
+LogBinaryOutput::Run (void *output)
+{
+  static_cast<LogBinaryOutput *> (output)->DoRun ();
+  return 0;
+}
+
+void
+LogBinaryOutput::DoRun (void)
+{
+  pthread_mutex_lock (&m_mutex);
+  while (true)
+    {
+      while (m_pending == 0 && !m_stop)
+        {
+          pthread_cond_wait (&m_notEmpty, &m_mutex);
+        }
+      if (m_pending == 0)
+        {
+          break;
+        }
+      // The simulation thread does not touch the pending blocks: write
+      // this one without holding the lock.
+      std::string &block = m_blocks[m_next];
+      pthread_mutex_unlock (&m_mutex);
+      std::fwrite (block.data (), block.size (), 1, m_file);
+      block.clear ();
+      pthread_mutex_lock (&m_mutex);
+      m_next = (m_next + 1) % N_BLOCKS;
+      m_pending--;
+      pthread_cond_broadcast (&m_notFull);
+    }
+  pthread_mutex_unlock (&m_mutex);
+}
+#endif
+
+bool g_logBinaryOutputEnabled = false;
+static LogBinaryOutput *g_logBinaryOutput = 0;
+static LogRateClock g_logRateClock = 0;
+// incremented each time the rate clock is set, such that the seconds of
+// different simulations are not mixed up.
+static uint32_t g_logRateClockId = 0;
+
+/**
+ * The streams to which a thread formats its binary log messages: a
+ * message output while the arguments of another message are evaluated
+ * gets the next stream.
+ */
+struct LogMessageStreams
+{
+  LogMessageStreams () : depth (0) {}
+  ~LogMessageStreams ()
+  {
+    for (uint32_t i = 0; i < streams.size (); i++)
+      {
+        delete streams[i];
+      }
+  }
+  std::vector<std::ostringstream *> streams;
+  uint32_t depth;
+};
+
+#ifdef HAVE_PTHREAD_H
+static pthread_key_t g_logMessageStreamsKey;
+static pthread_once_t g_logMessageStreamsOnce = PTHREAD_ONCE_INIT;
+
+static void
+DeleteLogMessageStreams (void *streams)
+{
+  delete static_cast<LogMessageStreams *> (streams);
+}
+
+static void
+CreateLogMessageStreamsKey (void)
+{
+  pthread_key_create (&g_logMessageStreamsKey, &DeleteLogMessageStreams);
+}
+#endif
+
+static LogMessageStreams *
+GetLogMessageStreams (void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_once (&g_logMessageStreamsOnce, &CreateLogMessageStreamsKey);
+  LogMessageStreams *streams = static_cast<LogMessageStreams *> (pthread_getspecific (g_logMessageStreamsKey));
+  if (streams == 0)
+    {
+      streams = new LogMessageStreams ();
+      pthread_setspecific (g_logMessageStreamsKey, streams);
+    }
+  return streams;
+#else
+  static LogMessageStreams streams;
+  return &streams;
+#endif
+}
+
+static class LogOutputCleanup
+{
+public:
+  ~LogOutputCleanup ()
+  {
+    LogSetTextOutput ();
+  }
+} g_logOutputCleanup;
+
+static void
+LogMessagesDropped (const LogComponent &component, uint32_t count)
+{
+  if (g_logBinaryOutput != 0)
+    {
+      g_logBinaryOutput->WriteDropped (component, count);
+    }
+  else
+    {
+      std::clog << component.Name () << ": " << count << " messages dropped" << std::endl;
+    }
+}
 
 PrintList::PrintList ()
 {
@@ -86,10 +433,25 @@ PrintList::PrintList ()
 
 
 LogComponent::LogComponent (char const * name)
-  : m_levels (0), m_name (name)
+  : m_levels (0), m_name (name),
+    m_rateLimit (0), m_rateCount (0), m_rateDropped (0), m_rateClock (0),
+    m_rateSecond (0)
 {
   EnvVarCheck (name);
 
+#ifdef HAVE_GETENV
+  static bool binaryChecked = false;
+  if (!binaryChecked)
+    {
+      binaryChecked = true;
+      char *envVar = getenv ("NS_LOG_BINARY");
+      if (envVar != 0 && strlen (envVar) != 0)
+        {
+          LogSetBinaryOutput (envVar);
+        }
+    }
+#endif
+
   ComponentList *components = GetComponentList ();
   for (ComponentListI i = components->begin ();
        i != components->end ();
@@ -256,6 +618,42 @@ LogComponent::Name (void) const
   return m_name;
 }
 
+void
+LogComponent::SetRateLimit (uint32_t maxMessagesPerSecond)
+{
+  m_rateLimit = maxMessagesPerSecond;
+  m_rateCount = 0;
+}
+
+bool
+LogComponent::DoIsRateLimited (void)
+{
+  int64_t second = 0;
+  if (g_logRateClock != 0)
+    {
+      second = (*g_logRateClock)();
+    }
+  if (m_rateClock != g_logRateClockId || second != m_rateSecond)
+    {
+      uint32_t dropped = m_rateDropped;
+      m_rateClock = g_logRateClockId;
+      m_rateSecond = second;
+      m_rateCount = 0;
+      m_rateDropped = 0;
+      if (dropped != 0)
+        {
+          LogMessagesDropped (*this, dropped);
+        }
+    }
+  if (m_rateCount >= m_rateLimit)
+    {
+      m_rateDropped++;
+      return true;
+    }
+  m_rateCount++;
+  return false;
+}
+
 
 void 
 LogComponentEnable (char const *name, enum LogLevel level)
@@ -321,6 +719,25 @@ LogComponentDisableAll (enum LogLevel level)
     }
 }
 
+void
+LogComponentSetRateLimit (char const *name, uint32_t maxMessagesPerSecond)
+{
+  ComponentList *components = GetComponentList ();
+  for (ComponentListI i = components->begin ();
+       i != components->end ();
+       i++)
+    {
+      if (i->first.compare (name) == 0)
+        {
+          i->second->SetRateLimit (maxMessagesPerSecond);
+          return;
+        }
+    }
+  LogComponentPrintList ();
+  NS_FATAL_ERROR ("Logging component \"" << name <<
+                  "\" not found. See above for a list of available log components");
+}
+
 void 
 LogComponentPrintList (void)
 {
@@ -493,6 +910,136 @@ LogNodePrinter LogGetNodePrinter (void)
   return g_logNodePrinter;
 }
 
+void
+LogSetRateClock (LogRateClock clock)
+{
+  g_logRateClock = clock;
+  g_logRateClockId++;
+}
+
+void
+LogSetBinaryOutput (std::string filename)
+{
+  LogSetTextOutput ();
+  FILE *file = std::fopen (filename.c_str (), "wb");
+  if (file == 0)
+    {
+      NS_FATAL_ERROR ("Could not open binary log file \"" << filename << "\"");
+    }
+  g_logBinaryOutput = new LogBinaryOutput (file);
+  g_logBinaryOutputEnabled = true;
+}
+
+void
+LogSetTextOutput (void)
+{
+  g_logBinaryOutputEnabled = false;
+  if (g_logBinaryOutput != 0)
+    {
+      delete g_logBinaryOutput;
+      g_logBinaryOutput = 0;
+    }
+}
+
+std::ostream &
+LogBinaryMessageBegin (void)
+{
+  LogMessageStreams *streams = GetLogMessageStreams ();
+  if (streams->depth == streams->streams.size ())
+    {
+      streams->streams.push_back (new std::ostringstream ());
+    }
+  std::ostringstream *os = streams->streams[streams->depth++];
+  os->str ("");
+  return *os;
+}
+
+void
+LogBinaryMessageEnd (std::ostream &os, const LogComponent &component, enum LogLevel level)
+{
+  LogMessageStreams *streams = GetLogMessageStreams ();
+  NS_ASSERT (streams->depth != 0 && streams->streams[streams->depth - 1] == &os);
+  streams->depth--;
+  if (g_logBinaryOutput != 0)
+    {
+      g_logBinaryOutput->WriteMessage (component, level, streams->streams[streams->depth]->str ());
+    }
+}
+
+bool
+LogDecodeBinary (std::istream &is, std::ostream &os)
+{
+  char magic[sizeof (g_logBinaryMagic)];
+  if (!is.read (magic, sizeof (magic)) ||
+      memcmp (magic, g_logBinaryMagic, sizeof (magic)) != 0)
+    {
+      return false;
+    }
+  std::vector<std::string> names;
+  std::string text;
+  uint8_t type;
+  while (is.read (reinterpret_cast<char *> (&type), sizeof (type)))
+    {
+      uint16_t id;
+      if (!is.read (reinterpret_cast<char *> (&id), sizeof (id)))
+        {
+          return false;
+        }
+      if (type == LOG_RECORD_COMPONENT)
+        {
+          uint16_t length;
+          if (!is.read (reinterpret_cast<char *> (&length), sizeof (length)))
+            {
+              return false;
+            }
+          text.resize (length);
+          if (length != 0 && !is.read (&text[0], length))
+            {
+              return false;
+            }
+          if (id >= names.size ())
+            {
+              names.resize (id + 1);
+            }
+          names[id] = text;
+          continue;
+        }
+      if (id >= names.size ())
+        {
+          return false;
+        }
+      if (type == LOG_RECORD_MESSAGE)
+        {
+          uint32_t level;
+          uint32_t length;
+          if (!is.read (reinterpret_cast<char *> (&level), sizeof (level)) ||
+              !is.read (reinterpret_cast<char *> (&length), sizeof (length)))
+            {
+              return false;
+            }
+          text.resize (length);
+          if (length != 0 && !is.read (&text[0], length))
+            {
+              return false;
+            }
+          os << text << std::endl;
+        }
+      else if (type == LOG_RECORD_DROPPED)
+        {
+          uint32_t count;
+          if (!is.read (reinterpret_cast<char *> (&count), sizeof (count)))
+            {
+              return false;
+            }
+          os << names[id] << ": " << count << " messages dropped" << std::endl;
+        }
+      else
+        {
+          return false;
+        }
+    }
+  return is.eof ();
+}
 
 ParameterLogger::ParameterLogger (std::ostream &os)
   : m_itemNumber (0),
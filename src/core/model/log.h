@@ -101,6 +101,55 @@ void LogComponentDisable (char const *name, enum LogLevel level);
  */
 void LogComponentDisableAll (enum LogLevel level);
 
+/**
+ * \param name a log component name
+ * \param maxMessagesPerSecond the maximum number of messages output
+ *        by this component in each second of simulation time, or zero
+ *        to output all messages.
+ * \ingroup logging
+ *
+ * Messages in excess of the limit are dropped before being formatted;
+ * the number of dropped messages is reported when the next message of
+ * the component is output.  The messages output while no simulation
+ * exists are all counted in a single second.
+ */
+void LogComponentSetRateLimit (char const *name, uint32_t maxMessagesPerSecond);
+
+/**
+ * \param filename the name of the output file.
+ * \ingroup logging
+ *
+ * Output the messages of all log components to the input file in a
+ * compact binary format rather than to std::clog.  The messages are
+ * buffered and written to the file by a background thread (if
+ * threads are available).  Messages may be output by several threads,
+ * but the output must not be changed while other threads are logging.  Use ns3::LogDecodeBinary or the
+ * decode-binary-log program to convert the file back to the text
+ * output of std::clog.
+ *
+ * Same as running your program with the NS_LOG_BINARY environment
+ * variable set to the name of the output file.
+ */
+void LogSetBinaryOutput (std::string filename);
+
+/**
+ * \ingroup logging
+ *
+ * Output the messages of all log components to std::clog, the
+ * default.  If a binary output file was in use, its buffered messages
+ * are written and the file is closed.
+ */
+void LogSetTextOutput (void);
+
+/**
+ * \param is a stream which contains the output of ns3::LogSetBinaryOutput
+ * \param os the stream to which the messages are output as text
+ * \returns true if the whole input stream could be decoded, false if
+ *          it is not a binary log or is truncated.
+ * \ingroup logging
+ */
+bool LogDecodeBinary (std::istream &is, std::ostream &os);
+
 
 } // namespace ns3
 
@@ -125,8 +174,8 @@ void LogComponentDisableAll (enum LogLevel level);
       ns3::LogTimePrinter printer = ns3::LogGetTimePrinter ();  \
       if (printer != 0)                                         \
         {                                                       \
-          (*printer)(std::clog);                               \
-          std::clog << " ";                                     \
+          (*printer)(ns3LogStream);                             \
+          ns3LogStream << " ";                                  \
         }                                                       \
     }
 
@@ -136,18 +185,23 @@ void LogComponentDisableAll (enum LogLevel level);
       ns3::LogNodePrinter printer = ns3::LogGetNodePrinter ();  \
       if (printer != 0)                                         \
         {                                                       \
-          (*printer)(std::clog);                               \
-          std::clog << " ";                                     \
+          (*printer)(ns3LogStream);                             \
+          ns3LogStream << " ";                                  \
         }                                                       \
     }
 
 #define NS_LOG_APPEND_FUNC_PREFIX                               \
   if (g_log.IsEnabled (ns3::LOG_PREFIX_FUNC))                   \
     {                                                           \
-      std::clog << g_log.Name () << ":" <<                      \
+      ns3LogStream << g_log.Name () << ":" <<                   \
       __FUNCTION__ << "(): ";                                 \
     }                                                           \
 
+/*
+ * A file can define NS_LOG_APPEND_CONTEXT before including this header
+ * to prefix its messages with some context: the definition must write
+ * to ns3LogStream, the stream of the message being output.
+ */
 #ifndef NS_LOG_APPEND_CONTEXT
 #define NS_LOG_APPEND_CONTEXT
 #endif /* NS_LOG_APPEND_CONTEXT */
@@ -202,13 +256,15 @@ void LogComponentDisableAll (enum LogLevel level);
 #define NS_LOG(level, msg)                                      \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (level))                              \
+      if (g_log.IsEnabled (level) && !g_log.IsRateLimited ())   \
         {                                                       \
+          std::ostream &ns3LogStream = ns3::LogMessageBegin (); \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
           NS_LOG_APPEND_CONTEXT;                                \
           NS_LOG_APPEND_FUNC_PREFIX;                            \
-          std::clog << msg << std::endl;                        \
+          ns3LogStream << msg;                                  \
+          ns3::LogMessageEnd (ns3LogStream, g_log, level);      \
         }                                                       \
     }                                                           \
   while (false)
@@ -257,13 +313,17 @@ void LogComponentDisableAll (enum LogLevel level);
 #define NS_LOG_FUNCTION_NOARGS()                                \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (g_log.IsEnabled (ns3::LOG_FUNCTION) &&                \
+          !g_log.IsRateLimited ())                              \
         {                                                       \
+          std::ostream &ns3LogStream = ns3::LogMessageBegin (); \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
           NS_LOG_APPEND_CONTEXT;                                \
-          std::clog << g_log.Name () << ":"                     \
-                    << __FUNCTION__ << "()" << std::endl;       \
+          ns3LogStream << g_log.Name () << ":"                  \
+                       << __FUNCTION__ << "()";                 \
+          ns3::LogMessageEnd (ns3LogStream, g_log,              \
+                              ns3::LOG_FUNCTION);               \
         }                                                       \
     }                                                           \
   while (false)
@@ -288,15 +348,19 @@ void LogComponentDisableAll (enum LogLevel level);
 #define NS_LOG_FUNCTION(parameters)                             \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (g_log.IsEnabled (ns3::LOG_FUNCTION) &&                \
+          !g_log.IsRateLimited ())                              \
         {                                                       \
+          std::ostream &ns3LogStream = ns3::LogMessageBegin (); \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
           NS_LOG_APPEND_CONTEXT;                                \
-          std::clog << g_log.Name () << ":"                     \
-                    << __FUNCTION__ << "(";                     \
-          ns3::ParameterLogger (std::clog) << parameters;      \
-          std::clog << ")" << std::endl;                        \
+          ns3LogStream << g_log.Name () << ":"                  \
+                       << __FUNCTION__ << "(";                  \
+          ns3::ParameterLogger (ns3LogStream) << parameters;   \
+          ns3LogStream << ")";                                  \
+          ns3::LogMessageEnd (ns3LogStream, g_log,              \
+                              ns3::LOG_FUNCTION);               \
         }                                                       \
     }                                                           \
   while (false)
@@ -358,6 +422,19 @@ LogTimePrinter LogGetTimePrinter (void);
 void LogSetNodePrinter (LogNodePrinter);
 LogNodePrinter LogGetNodePrinter (void);
 
+/**
+ * \returns the current second of simulation time.
+ */
+typedef int64_t (*LogRateClock)(void);
+
+/**
+ * \param clock the clock of the rate limits of the log components, or
+ *        zero if there is no simulation.
+ *
+ * Set by the simulator, like the time and node printers.
+ */
+void LogSetRateClock (LogRateClock clock);
+
 
 class LogComponent {
 public:
@@ -368,11 +445,72 @@ public:
   void Enable (enum LogLevel level);
   void Disable (enum LogLevel level);
   char const *Name (void) const;
+  /**
+   * \param maxMessagesPerSecond the maximum number of messages per
+   *        second of simulation time, or zero for no limit.
+   */
+  void SetRateLimit (uint32_t maxMessagesPerSecond);
+  /**
+   * \returns true if the next message must be dropped because this
+   *          component has already output its maximum number of
+   *          messages in the current second.
+   *
+   * This method counts the messages of the component: it must be
+   * called only once per message, just before the message is output.
+   */
+  bool IsRateLimited (void);
 private:
+  bool DoIsRateLimited (void);
   int32_t     m_levels;
   char const *m_name;
+  uint32_t    m_rateLimit;
+  uint32_t    m_rateCount;
+  uint32_t    m_rateDropped;
+  uint32_t    m_rateClock;
+  int64_t     m_rateSecond;
 };
 
+/**
+ * True if the messages are output by LogSetBinaryOutput rather than
+ * to std::clog.
+ */
+extern bool g_logBinaryOutputEnabled;
+std::ostream &LogBinaryMessageBegin (void);
+void LogBinaryMessageEnd (std::ostream &os, const LogComponent &component, enum LogLevel level);
+
+/**
+ * \returns the stream to which the NS_LOG macros output a message:
+ *          std::clog, or a stream of the calling thread buffering the
+ *          message for the binary output.
+ */
+inline std::ostream &
+LogMessageBegin (void)
+{
+  if (g_logBinaryOutputEnabled)
+    {
+      return LogBinaryMessageBegin ();
+    }
+  return std::clog;
+}
+
+/**
+ * \param os the stream returned by LogMessageBegin
+ * \param component the component which output the message
+ * \param level the level of the message
+ *
+ * End the output of a message: used by the NS_LOG macros.
+ */
+inline void
+LogMessageEnd (std::ostream &os, const LogComponent &component, enum LogLevel level)
+{
+  if (&os == &std::clog)
+    {
+      os << std::endl;
+      return;
+    }
+  LogBinaryMessageEnd (os, component, level);
+}
+
 class ParameterLogger : public std::ostream
 {
   int m_itemNumber;
@@ -397,6 +535,12 @@ public:
   }
 };
 
+inline bool
+LogComponent::IsRateLimited (void)
+{
+  return m_rateLimit != 0 && DoIsRateLimited ();
+}
+
 } // namespace ns3
 
 
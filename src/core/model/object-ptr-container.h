@@ -139,6 +139,25 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+  /**
+   * \param object the object which holds the container.
+   * \param n the number of items in the container.
+   * \returns true if the number of items could be retrieved, false
+   *          otherwise.
+   *
+   * Unlike Get, this method does not copy the content of the
+   * container.
+   */
+  bool GetN (const ObjectBase *object, uint32_t *n) const;
+  /**
+   * \param object the object which holds the container.
+   * \param i the index of the requested item.
+   * \returns the item at index i in the container.
+   *
+   * This method must be called only after a successful call to GetN
+   * on the same object, with i smaller than the number of items.
+   */
+  Ptr<Object> GetItem (const ObjectBase *object, uint32_t i) const;
 private:
   virtual bool DoGetN (const ObjectBase *object, uint32_t *n) const = 0;
   virtual Ptr<Object> DoGet (const ObjectBase *object, uint32_t i) const = 0;
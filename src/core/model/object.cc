@@ -85,10 +85,8 @@ Object::Object ()
   : m_tid (Object::GetTypeId ()),
     m_disposed (false),
     m_started (false),
-    m_aggregates ((struct Aggregates *) malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates (AllocateAggregates (1))
 {
-  m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object () 
@@ -106,11 +104,14 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  // the cached lookups might point to this object
+  free (m_aggregates->cache);
+  m_aggregates->cache = 0;
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
     {
-      free (m_aggregates);
+      FreeAggregates (m_aggregates);
     }
   m_aggregates = 0;
 }
@@ -118,10 +119,8 @@ Object::Object (const Object &o)
   : m_tid (o.m_tid),
     m_disposed (false),
     m_started (false),
-    m_aggregates ((struct Aggregates *) malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates (AllocateAggregates (1))
 {
-  m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
 }
 void
@@ -136,32 +135,43 @@ Object::DoGetObject (TypeId tid) const
   NS_ASSERT (CheckLoose ());
 
   uint32_t n = m_aggregates->n;
-  TypeId objectTid = Object::GetTypeId ();
-  for (uint32_t i = 0; i < n; i++)
+  if (n == 1)
     {
-      Object *current = m_aggregates->buffer[i];
+      Object *current = m_aggregates->buffer[0];
       TypeId cur = current->GetInstanceTypeId ();
-      while (cur != tid && cur != objectTid)
+      if (cur == tid || cur.IsChildOf (tid))
         {
-          cur = cur.GetParent ();
+          return current;
         }
-      if (cur == tid)
+      return 0;
+    }
+
+  // We are likely to perform the same lookup again later so, we
+  // remember its result, whether we find a matching object or not.
+  if (m_aggregates->cache == 0)
+    {
+      m_aggregates->cache = (struct CacheEntry *) calloc (AGGREGATE_CACHE_SIZE, sizeof (struct CacheEntry));
+    }
+  uint16_t uid = tid.GetUid ();
+  struct CacheEntry *entry = &m_aggregates->cache[uid % AGGREGATE_CACHE_SIZE];
+  if (entry->tid == uid)
+    {
+      return entry->object;
+    }
+  Object *found = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Object *current = m_aggregates->buffer[i];
+      TypeId cur = current->GetInstanceTypeId ();
+      if (cur == tid || cur.IsChildOf (tid))
         {
-          // This is an attempt to 'cache' the result of this lookup.
-          // the idea is that if we perform a lookup for a TypeId on this object,
-          // we are likely to perform the same lookup later so, we make sure
-          // that the aggregate array is sorted by the number of accesses
-          // to each object.
-
-          // first, increment the access count
-          current->m_getObjectCount++;
-          // then, update the sort
-          UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
-          return const_cast<Object *> (current);
+          found = current;
+          break;
         }
     }
-  return 0;
+  entry->tid = uid;
+  entry->object = found;
+  return found;
 }
 void
 Object::Start (void)
@@ -169,9 +179,8 @@ Object::Start (void)
   /**
    * Note: the code here is a bit tricky because we need to protect ourselves from
    * modifications in the aggregate array while DoStart is called. The user's
-   * implementation of the DoStart method could call GetObject (which could
-   * reorder the array) and it could call AggregateObject which would add an 
-   * object at the end of the array. To be safe, we restart iteration over the 
+   * implementation of the DoStart method could call AggregateObject which would
+   * replace the array by a larger one. To be safe, we restart iteration over the 
    * array whenever we call some user code, just in case.
    */
 restart:
@@ -193,10 +202,9 @@ Object::Dispose (void)
   /**
    * Note: the code here is a bit tricky because we need to protect ourselves from
    * modifications in the aggregate array while DoDispose is called. The user's
-   * DoDispose implementation could call GetObject (which could reorder the array) 
-   * and it could call AggregateObject which would add an object at the end of the array.
-   * So, to be safe, we restart the iteration over the array whenever we call some
-   * user code.
+   * DoDispose implementation could call AggregateObject which would replace the
+   * array by a larger one. So, to be safe, we restart the iteration over the array
+   * whenever we call some user code.
    */
 restart:
   uint32_t n = m_aggregates->n;
@@ -211,17 +219,20 @@ restart:
         }
     }
 }
+struct Object::Aggregates *
+Object::AllocateAggregates (uint32_t n)
+{
+  struct Aggregates *aggregates = 
+    (struct Aggregates *)malloc (sizeof(struct Aggregates)+(n-1)*sizeof(Object*));
+  aggregates->n = n;
+  aggregates->cache = 0;
+  return aggregates;
+}
 void
-Object::UpdateSortedArray (struct Aggregates *aggregates, uint32_t j) const
+Object::FreeAggregates (struct Aggregates *aggregates)
 {
-  while (j > 0 && 
-         aggregates->buffer[j]->m_getObjectCount > aggregates->buffer[j-1]->m_getObjectCount)
-    {
-      Object *tmp = aggregates->buffer[j-1];
-      aggregates->buffer[j-1] = aggregates->buffer[j];
-      aggregates->buffer[j] = tmp;
-      j--;
-    }
+  free (aggregates->cache);
+  free (aggregates);
 }
 void 
 Object::AggregateObject (Ptr<Object> o)
@@ -241,9 +252,7 @@ Object::AggregateObject (Ptr<Object> o)
   Object *other = PeekPointer (o);
   // first create the new aggregate buffer.
   uint32_t total = m_aggregates->n + other->m_aggregates->n;
-  struct Aggregates *aggregates = 
-    (struct Aggregates *)malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
-  aggregates->n = total;
+  struct Aggregates *aggregates = AllocateAggregates (total);
 
   // copy our buffer to the new buffer
   memcpy (&aggregates->buffer[0], 
@@ -254,7 +263,6 @@ Object::AggregateObject (Ptr<Object> o)
   for (uint32_t i = 0; i < other->m_aggregates->n; i++)
     {
       aggregates->buffer[m_aggregates->n+i] = other->m_aggregates->buffer[i];
-      UpdateSortedArray (aggregates, m_aggregates->n + i);
     }
 
   // keep track of the old aggregate buffers for the iteration
@@ -287,8 +295,8 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
-  free (a);
-  free (b);
+  FreeAggregates (a);
+  FreeAggregates (b);
 }
 /**
  * This function must be implemented in the stack that needs to notify
@@ -226,6 +226,18 @@ private:
   friend class AggregateIterator;
   friend struct ObjectDeleter;
 
+  /**
+   * The result of a lookup in an array of aggregates: the object of
+   * type tid (or a subclass of it), or zero if there is none.
+   */
+  struct CacheEntry {
+    uint16_t tid;
+    Object *object;
+  };
+  enum {
+    AGGREGATE_CACHE_SIZE = 16
+  };
+
   /**
    * This data structure uses a classic C-style trick to 
    * hold an array of variable size without performing
@@ -238,10 +250,19 @@ private:
    */
   struct Aggregates {
     uint32_t n;
+    /**
+     * The results of the last lookups done with DoGetObject, indexed
+     * by the uid of the requested TypeId modulo AGGREGATE_CACHE_SIZE.
+     * Allocated by the first lookup in an array of more than one
+     * object, and discarded whenever the array changes.
+     */
+    struct CacheEntry *cache;
     Object *buffer[1];
   };
 
   Ptr<Object> DoGetObject (TypeId tid) const;
+  static struct Aggregates *AllocateAggregates (uint32_t n);
+  static void FreeAggregates (struct Aggregates *aggregates);
   bool Check (void) const;
   bool CheckLoose (void) const;
   /**
@@ -262,7 +283,6 @@ private:
   */
   void Construct (const AttributeConstructionList &attributes);
 
-  void UpdateSortedArray (struct Aggregates *aggregates, uint32_t i) const;
   /**
    * Attempt to delete this object. This method iterates
    * over all aggregated objects to check if they all 
@@ -292,13 +312,6 @@ private:
    * so the size of the array is indirectly a reference count.
    */
   struct Aggregates * m_aggregates;
-  /**
-   * Indicates the number of times the object was accessed with a
-   * call to GetObject. This integer is used to implement a
-   * heuristic to sort the array of aggregates to put at the start
-   * of the array the most-frequently accessed elements.
-   */
-  uint32_t m_getObjectCount;
 };
 
 /**
@@ -31,6 +31,7 @@
 #include <fcntl.h>
 #include <sstream>
 #include <vector>
+#include <algorithm>
 
 #include "assert.h"
 #include "config.h"
@@ -38,6 +39,8 @@
 #include "random-variable.h"
 #include "rng-stream.h"
 #include "fatal-error.h"
+#include "ptr.h"
+#include "simple-ref-count.h"
 
 using namespace std;
 
@@ -93,6 +96,7 @@ public:
   RandomVariableBase (const RandomVariableBase &o);
   virtual ~RandomVariableBase ();
   virtual double  GetValue () = 0;
+  virtual void GetValues (uint32_t n, double *values);
   virtual uint32_t GetInteger ();
   virtual RandomVariableBase*   Copy (void) const = 0;
 
@@ -119,11 +123,54 @@ RandomVariableBase::~RandomVariableBase ()
   delete m_generator;
 }
 
+void RandomVariableBase::GetValues (uint32_t n, double *values)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      values[i] = GetValue ();
+    }
+}
+
 uint32_t RandomVariableBase::GetInteger ()
 {
   return (uint32_t)GetValue ();
 }
 
+/**
+ * Hands out uniform values generated in bulk, then one at a time from
+ * the stream.  A variable which needs at least n uniform values for its
+ * next outputs asks for n of them in bulk: it then consumes the stream
+ * exactly as if it called RandU01 for each of them.
+ */
+class UniformBlock
+{
+public:
+  static const uint32_t SIZE = 256;
+  UniformBlock (RngStream *generator, uint32_t n)
+    : m_generator (generator),
+      m_n (n),
+      m_next (0)
+  {
+    NS_ASSERT (n <= SIZE);
+    generator->RandU01 (n, m_values);
+  }
+  double Next (void)
+  {
+    if (m_next < m_n)
+      {
+        return m_values[m_next++];
+      }
+    return m_generator->RandU01 ();
+  }
+private:
+  RngStream *m_generator;
+  uint32_t m_n;
+  uint32_t m_next;
+  double m_values[SIZE];
+};
+
+const uint32_t UniformBlock::SIZE;
+
 // -------------------------------------------------------
 
 RandomVariable::RandomVariable ()
@@ -159,6 +206,12 @@ RandomVariable::GetValue (void) const
   return m_variable->GetValue ();
 }
 
+void
+RandomVariable::GetValues (uint32_t n, double *values) const
+{
+  m_variable->GetValues (n, values);
+}
+
 uint32_t
 RandomVariable::GetInteger (void) const
 {
@@ -210,6 +263,7 @@ public:
    */
   virtual double GetValue (double s, double l);
 
+  virtual void GetValues (uint32_t n, double *values);
   virtual RandomVariableBase*  Copy (void) const;
 
 private:
@@ -257,6 +311,19 @@ double UniformVariableImpl::GetValue ()
   return m_min + m_generator->RandU01 () * (m_max - m_min);
 }
 
+void UniformVariableImpl::GetValues (uint32_t n, double *values)
+{
+  if (!m_generator)
+    {
+      m_generator = new RngStream ();
+    }
+  m_generator->RandU01 (n, values);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      values[i] = m_min + values[i] * (m_max - m_min);
+    }
+}
+
 double UniformVariableImpl::GetValue (double s, double l)
 {
   if (!m_generator)
@@ -539,6 +606,7 @@ public:
    * \return A random value from this exponential distribution
    */
   virtual double GetValue ();
+  virtual void GetValues (uint32_t n, double *values);
   virtual RandomVariableBase* Copy (void) const;
 
 private:
@@ -588,6 +656,34 @@ double ExponentialVariableImpl::GetValue ()
     }
 }
 
+void ExponentialVariableImpl::GetValues (uint32_t n, double *values)
+{
+  if (!m_generator)
+    {
+      m_generator = new RngStream ();
+    }
+  while (n > 0)
+    {
+      // Each value needs at least one uniform value
+      uint32_t count = std::min (n, UniformBlock::SIZE);
+      UniformBlock uniforms (m_generator, count);
+      for (uint32_t i = 0; i < count; ++i)
+        {
+          while (1)
+            {
+              double r = -m_mean*log (uniforms.Next ());
+              if (m_bound == 0 || r <= m_bound)
+                {
+                  values[i] = r;
+                  break;
+                }
+            }
+        }
+      values += count;
+      n -= count;
+    }
+}
+
 RandomVariableBase* ExponentialVariableImpl::Copy () const
 {
   return new ExponentialVariableImpl (*this);
@@ -938,6 +1034,7 @@ public:
    * \return A value from this normal distribution
    */
   virtual double GetValue ();
+  virtual void GetValues (uint32_t n, double *values);
   virtual RandomVariableBase* Copy (void) const;
 
   double GetMean (void) const;
@@ -945,6 +1042,17 @@ public:
   double GetBound (void) const;
 
 private:
+  // Draw a value from the uniform values of a RngStream or of a UniformBlock
+  template <typename T>
+  double DrawValue (T *uniforms);
+  static double Uniform (RngStream *uniforms)
+  {
+    return uniforms->RandU01 ();
+  }
+  static double Uniform (UniformBlock *uniforms)
+  {
+    return uniforms->Next ();
+  }
   double m_mean;      // Mean value of RV
   double m_variance;  // Mean value of RV
   double m_bound;     // Bound on value's difference from the mean (absolute value)
@@ -985,6 +1093,33 @@ double NormalVariableImpl::GetValue ()
     {
       m_generator = new RngStream ();
     }
+  return DrawValue (m_generator);
+}
+
+void NormalVariableImpl::GetValues (uint32_t n, double *values)
+{
+  if (!m_generator)
+    {
+      m_generator = new RngStream ();
+    }
+  while (n > 0)
+    {
+      // Each value but the one which may be pending needs at least one
+      // uniform value
+      uint32_t count = std::min (n, UniformBlock::SIZE);
+      UniformBlock uniforms (m_generator, m_nextValid ? count - 1 : count);
+      for (uint32_t i = 0; i < count; ++i)
+        {
+          values[i] = DrawValue (&uniforms);
+        }
+      values += count;
+      n -= count;
+    }
+}
+
+template <typename T>
+double NormalVariableImpl::DrawValue (T *uniforms)
+{
   if (m_nextValid)
     { // use previously generated
       m_nextValid = false;
@@ -994,8 +1129,8 @@ double NormalVariableImpl::GetValue ()
     { // See Simulation Modeling and Analysis p. 466 (Averill Law)
       // for algorithm; basically a Box-Muller transform:
       // http://en.wikipedia.org/wiki/Box-Muller_transform
-      double u1 = m_generator->RandU01 ();
-      double u2 = m_generator->RandU01 ();
+      double u1 = Uniform (uniforms);
+      double u2 = Uniform (uniforms);
       double v1 = 2 * u1 - 1;
       double v2 = 2 * u2 - 1;
       double w = v1 * v1 + v2 * v2;
@@ -1074,6 +1209,7 @@ public:
    * \return A value from this empirical distribution
    */
   virtual double GetValue ();
+  virtual void GetValues (uint32_t n, double *values);
   virtual RandomVariableBase* Copy (void) const;
   /**
    * \brief Specifies a point in the empirical distribution
@@ -1081,6 +1217,10 @@ public:
    * \param c Probability that the function is less than or equal to v
    */
   virtual void CDF (double v, double c);  // Value, prob <= Value
+  /**
+   * \param alias true to draw the values with the alias method
+   */
+  void SetAliasMethod (bool alias);
 
 private:
   class ValueCDF
@@ -1094,10 +1234,73 @@ public:
   };
   virtual void Validate ();  // Insure non-decreasing emiprical values
   virtual double Interpolate (double, double, double, double, double);
+  double SearchValue ();
+  double AliasValue ();
   bool validated; // True if non-decreasing validated
   std::vector<ValueCDF> emp;       // Empicical CDF
+  bool m_alias; // True if the values are drawn with the alias method
+  // The alias table of the mass below the first point, of each segment
+  // of the CDF, and of the mass above the last point.
+  std::vector<double> m_aliasProb;
+  std::vector<uint32_t> m_aliasIndex;
 };
 
+/**
+ * Build the tables of Walker's alias method (in the variant of Vose)
+ * for a discrete distribution: i is drawn by picking a column j
+ * uniformly, and returning j with probability prob[j], alias[j]
+ * otherwise.
+ *
+ * \param weights the (unnormalized) weights of the values.
+ * \param prob the probabilities of the columns.
+ * \param alias the aliases of the columns.
+ */
+static void
+BuildAliasTable (const std::vector<double> &weights,
+                 std::vector<double> &prob, std::vector<uint32_t> &alias)
+{
+  uint32_t n = weights.size ();
+  double total = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      total += weights[i];
+    }
+  NS_ASSERT (total > 0);
+  prob.assign (n, 1.0);
+  alias.resize (n);
+  std::vector<double> scaled (n);
+  std::vector<uint32_t> small;
+  std::vector<uint32_t> large;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      alias[i] = i;
+      scaled[i] = weights[i] * n / total;
+      if (scaled[i] < 1.0)
+        {
+          small.push_back (i);
+        }
+      else
+        {
+          large.push_back (i);
+        }
+    }
+  while (!small.empty () && !large.empty ())
+    {
+      uint32_t s = small.back ();
+      small.pop_back ();
+      uint32_t l = large.back ();
+      prob[s] = scaled[s];
+      alias[s] = l;
+      scaled[l] -= 1.0 - scaled[s];
+      if (scaled[l] < 1.0)
+        {
+          large.pop_back ();
+          small.push_back (l);
+        }
+    }
+  // The columns left over are full, up to rounding errors.
+}
+
 
 // ValueCDF methods
 EmpiricalVariableImpl::ValueCDF::ValueCDF ()
@@ -1120,14 +1323,18 @@ EmpiricalVariableImpl::ValueCDF::ValueCDF (const ValueCDF& c)
 // -----------------------------------------------------------------------------
 // EmpiricalVariableImpl methods
 EmpiricalVariableImpl::EmpiricalVariableImpl ()
-  : validated (false)
+  : validated (false),
+    m_alias (false)
 {
 }
 
 EmpiricalVariableImpl::EmpiricalVariableImpl (const EmpiricalVariableImpl& c)
   : RandomVariableBase (c),
     validated (c.validated),
-    emp (c.emp)
+    emp (c.emp),
+    m_alias (c.m_alias),
+    m_aliasProb (c.m_aliasProb),
+    m_aliasIndex (c.m_aliasIndex)
 {
 }
 
@@ -1150,6 +1357,32 @@ double EmpiricalVariableImpl::GetValue ()
     {
       Validate ();      // Insure in non-decreasing
     }
+  return m_alias ? AliasValue () : SearchValue ();
+}
+
+void EmpiricalVariableImpl::GetValues (uint32_t n, double *values)
+{
+  if (!m_generator)
+    {
+      m_generator = new RngStream ();
+    }
+  if (emp.size () == 0)
+    {
+      std::fill (values, values + n, 0.0);
+      return;
+    }
+  if (!validated)
+    {
+      Validate ();
+    }
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      values[i] = m_alias ? AliasValue () : SearchValue ();
+    }
+}
+
+double EmpiricalVariableImpl::SearchValue ()
+{
   double r = m_generator->RandU01 ();
   if (r <= emp.front ().cdf)
     {
@@ -1183,6 +1416,28 @@ double EmpiricalVariableImpl::GetValue ()
     }
 }
 
+double EmpiricalVariableImpl::AliasValue ()
+{
+  // Pick the mass below the first point, a segment, or the mass above
+  // the last point, then a uniform probability within that segment.
+  uint32_t n = m_aliasProb.size ();
+  double u = m_generator->RandU01 () * n;
+  uint32_t column = std::min (static_cast<uint32_t> (u), n - 1);
+  uint32_t k = (u - column < m_aliasProb[column]) ? column : m_aliasIndex[column];
+  if (k == 0)
+    {
+      return emp.front ().value;
+    }
+  if (k == emp.size ())
+    {
+      return emp.back ().value;
+    }
+  double c1 = emp[k - 1].cdf;
+  double c2 = emp[k].cdf;
+  double r = c1 + m_generator->RandU01 () * (c2 - c1);
+  return Interpolate (c1, c2, emp[k - 1].value, emp[k].value, r);
+}
+
 RandomVariableBase* EmpiricalVariableImpl::Copy () const
 {
   return new EmpiricalVariableImpl (*this);
@@ -1192,6 +1447,13 @@ void EmpiricalVariableImpl::CDF (double v, double c)
 { // Add a new empirical datapoint to the empirical cdf
   // NOTE.   These MUST be inserted in non-decreasing order
   emp.push_back (ValueCDF (v, c));
+  validated = false;
+}
+
+void EmpiricalVariableImpl::SetAliasMethod (bool alias)
+{
+  m_alias = alias;
+  validated = false;
 }
 
 void EmpiricalVariableImpl::Validate ()
@@ -1211,6 +1473,17 @@ void EmpiricalVariableImpl::Validate ()
         }
       prior = current;
     }
+  if (m_alias)
+    {
+      std::vector<double> weights;
+      weights.push_back (emp.front ().cdf);
+      for (std::vector<ValueCDF>::size_type i = 1; i < emp.size (); ++i)
+        {
+          weights.push_back (emp[i].cdf - emp[i - 1].cdf);
+        }
+      weights.push_back (std::max (1.0 - emp.back ().cdf, 0.0));
+      BuildAliasTable (weights, m_aliasProb, m_aliasIndex);
+    }
   validated = true;
 }
 
@@ -1235,6 +1508,13 @@ EmpiricalVariable::CDF (double v, double c)
   NS_ASSERT (impl);
   impl->CDF (v, c);
 }
+void
+EmpiricalVariable::SetAliasMethod (bool alias)
+{
+  EmpiricalVariableImpl *impl = dynamic_cast<EmpiricalVariableImpl *> (Peek ());
+  NS_ASSERT (impl);
+  impl->SetAliasMethod (alias);
+}
 
 
 // -----------------------------------------------------------------------------
@@ -1773,32 +2053,51 @@ public:
    * \return A random value from this distribution
    */
   virtual double GetValue ();
+  virtual void GetValues (uint32_t n, double *values);
   virtual RandomVariableBase* Copy (void) const;
 
 private:
+  // The CDF of the distribution, shared by the copies of a variable
+  class Table : public SimpleRefCount<Table>
+  {
+public:
+    std::vector<double> cdf;
+  };
+  double DrawValue ();
   long m_n;
   double m_alpha;
   double m_c; // the normalization constant
+  Ptr<Table> m_table;
 };
 
 
 RandomVariableBase* ZipfVariableImpl::Copy () const
 {
-  return new ZipfVariableImpl (m_n, m_alpha);
+  // The copy starts with its own generator, as if it were created with
+  // the same parameters.
+  ZipfVariableImpl *copy = new ZipfVariableImpl ();
+  copy->m_n = m_n;
+  copy->m_alpha = m_alpha;
+  copy->m_c = m_c;
+  copy->m_table = m_table;
+  return copy;
 }
 
 ZipfVariableImpl::ZipfVariableImpl ()
   : m_n (1),
     m_alpha (0),
-    m_c (1)
+    m_c (1),
+    m_table (Create<Table> ())
 {
+  m_table->cdf.push_back (1.0);
 }
 
 
 ZipfVariableImpl::ZipfVariableImpl (long n, double alpha)
   : m_n (n),
     m_alpha (alpha),
-    m_c (0)
+    m_c (0),
+    m_table (Create<Table> ())
 {
   // calculate the normalization constant c
   for (int i = 1; i <= n; i++)
@@ -1806,6 +2105,29 @@ ZipfVariableImpl::ZipfVariableImpl (long n, double alpha)
       m_c += (1.0 / pow ((double)i,alpha));
     }
   m_c = 1.0 / m_c;
+  // and the CDF, summed in the same order as the normalization constant
+  m_table->cdf.reserve (n);
+  double sum_prob = 0;
+  for (int i = 1; i <= n; i++)
+    {
+      sum_prob += m_c / pow ((double)i,alpha);
+      m_table->cdf.push_back (sum_prob);
+    }
+}
+
+double
+ZipfVariableImpl::DrawValue ()
+{
+  // The value is the smallest i whose CDF exceeds u, or 0 if rounding
+  // errors left the last CDF below u.
+  double u = m_generator->RandU01 ();
+  const std::vector<double> &cdf = m_table->cdf;
+  std::vector<double>::const_iterator i = std::upper_bound (cdf.begin (), cdf.end (), u);
+  if (i == cdf.end ())
+    {
+      return 0;
+    }
+  return (i - cdf.begin ()) + 1;
 }
 
 double
@@ -1815,19 +2137,20 @@ ZipfVariableImpl::GetValue ()
     {
       m_generator = new RngStream ();
     }
+  return DrawValue ();
+}
 
-  double u = m_generator->RandU01 ();
-  double sum_prob = 0,zipf_value = 0;
-  for (int i = 1; i <= m_n; i++)
+void
+ZipfVariableImpl::GetValues (uint32_t n, double *values)
+{
+  if (!m_generator)
     {
-      sum_prob += m_c / pow ((double)i,m_alpha);
-      if (sum_prob > u)
-        {
-          zipf_value = i;
-          break;
-        }
+      m_generator = new RngStream ();
+    }
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      values[i] = DrawValue ();
     }
-  return zipf_value;
 }
 
 ZipfVariable::ZipfVariable ()
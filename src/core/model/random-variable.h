@@ -131,6 +131,16 @@ public:
    */
   double GetValue (void) const;
 
+  /**
+   * \brief Fills an array with random doubles from the underlying distribution
+   * \param n The number of values
+   * \param values The array, of at least n elements
+   *
+   * The values are the ones which n successive calls to GetValue would
+   * return, but some distributions draw them faster in bulk.
+   */
+  void GetValues (uint32_t n, double *values) const;
+
   /**
    * \brief Returns a random integer integer from the underlying distribution
    * \return  Integer cast of RandomVariable::GetValue
@@ -536,6 +546,18 @@ public:
    * \param c Probability that the function is less than or equal to v
    */
   void CDF (double v, double c);  // Value, prob <= Value
+
+  /**
+   * \brief Selects how the values are drawn
+   * \param alias If true, the segment of the CDF is drawn in constant
+   * time with Walker's alias method, then the value is interpolated
+   * within the segment; if false (the default), a binary search finds
+   * the segment which holds a uniform probability.
+   *
+   * Both methods yield the same distribution, but not the same sequence
+   * of values.  The alias method draws two uniform values per sample.
+   */
+  void SetAliasMethod (bool alias);
 protected:
   EmpiricalVariable (const RandomVariableBase &variable);
 };
@@ -729,6 +751,10 @@ public:
  * \f$ \alpha > 0 \f$ (real) and \f$ N \in \{1,2,3 \dots\}\f$ (integer).
  * Probability Mass Function is \f$ f(k; \alpha, N) = k^{-\alpha}/ H_{N,\alpha} \f$
  * where \f$ H_{N,\alpha} = \sum_{n=1}^N n^{-\alpha} \f$
+ *
+ * The CDF is computed once, when the variable is constructed, and is
+ * shared by its copies: each value is then found with a binary search,
+ * in O(log N).
  */
 class ZipfVariable : public RandomVariable
 {
@@ -554,6 +554,53 @@ double RngStream::RandU01 ()
 }
 
 
+//-------------------------------------------------------------------------
+// Generate the next n random numbers.
+//
+void RngStream::RandU01 (uint32_t n, double *u)
+{
+  if (incPrec)
+    {
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          u[i] = U01d ();
+        }
+      return;
+    }
+  // The same recurrences as U01, on a copy of the state held in
+  // integers.  The products fit in 53 bits, so U01 computes them
+  // exactly too, and its division followed by the correction of a
+  // negative remainder yields the exact modulo which is computed here
+  // without a division: the values are identical.
+  const int64_t im1 = 4294967087LL;
+  const int64_t im2 = 4294944443LL;
+  int64_t s10 = static_cast<int64_t> (Cg[0]);
+  int64_t s11 = static_cast<int64_t> (Cg[1]);
+  int64_t s12 = static_cast<int64_t> (Cg[2]);
+  int64_t s20 = static_cast<int64_t> (Cg[3]);
+  int64_t s21 = static_cast<int64_t> (Cg[4]);
+  int64_t s22 = static_cast<int64_t> (Cg[5]);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      /* Component 1 */
+      int64_t p1 = (1403580LL * s11 - 810728LL * s10) % im1;
+      if (p1 < 0) p1 += im1;
+      s10 = s11; s11 = s12; s12 = p1;
+
+      /* Component 2 */
+      int64_t p2 = (527612LL * s22 - 1370589LL * s20) % im2;
+      if (p2 < 0) p2 += im2;
+      s20 = s21; s21 = s22; s22 = p2;
+
+      /* Combination */
+      double v = static_cast<double> ((p1 > p2) ? (p1 - p2) : (p1 - p2 + im1)) * norm;
+      u[i] = (anti == false) ? v : (1 - v);
+    }
+  Cg[0] = s10; Cg[1] = s11; Cg[2] = s12;
+  Cg[3] = s20; Cg[4] = s21; Cg[5] = s22;
+}
+
+
 //-------------------------------------------------------------------------
 // Generate the next random integer.
 //
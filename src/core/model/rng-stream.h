@@ -51,6 +51,13 @@ public:  //public api
   void AdvanceState (int32_t e, int32_t c);
   void GetState (uint32_t seed[6]) const;
   double RandU01 ();
+  /**
+   * Fill an array with the next n values of RandU01 (), which are
+   * generated with the state of the stream held in local variables.
+   * The values, and the state of the stream afterwards, are the same
+   * as with n calls to RandU01 ().
+   */
+  void RandU01 (uint32_t n, double *u);
   int32_t RandInt (int32_t i, int32_t j);
 public: //public static api
   static bool SetPackageSeed (uint32_t seed);
@@ -70,6 +70,12 @@ NodePrinter (std::ostream &os)
     }
 }
 
+static int64_t
+RateClock (void)
+{
+  return static_cast<int64_t> (Simulator::Now ().GetSeconds ());
+}
+
 static SimulatorImpl **PeekImpl (void)
 {
   static SimulatorImpl *impl = 0;
@@ -109,6 +115,7 @@ static SimulatorImpl * GetImpl (void)
 //
       LogSetTimePrinter (&TimePrinter);
       LogSetNodePrinter (&NodePrinter);
+      LogSetRateClock (&RateClock);
     }
   return *pimpl;
 }
@@ -130,6 +137,7 @@ Simulator::Destroy (void)
    */
   LogSetTimePrinter (0);
   LogSetNodePrinter (0);
+  LogSetRateClock (0);
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
@@ -359,6 +367,7 @@ Simulator::SetImplementation (Ptr<SimulatorImpl> impl)
 //
   LogSetTimePrinter (&TimePrinter);
   LogSetNodePrinter (&NodePrinter);
+  LogSetRateClock (&RateClock);
 }
 Ptr<SimulatorImpl>
 Simulator::GetImplementation (void)
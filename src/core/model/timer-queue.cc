@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timer-queue.h"
+#include "simulator.h"
+#include "log.h"
+#include "assert.h"
+
+NS_LOG_COMPONENT_DEFINE ("TimerQueue");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (TimerQueue);
+
+TimerQueue::Event::Event ()
+  : m_item (0)
+{
+}
+
+void
+TimerQueue::Event::Cancel (void)
+{
+  if (IsRunning () && m_item->queue != 0)
+    {
+      m_item->queue->Cancel (m_item);
+    }
+}
+
+bool
+TimerQueue::Event::IsRunning (void) const
+{
+  return m_item != 0 && m_item->running;
+}
+
+TypeId
+TimerQueue::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TimerQueue")
+    .SetParent<Object> ()
+    .AddConstructor<TimerQueue> ()
+  ;
+  return tid;
+}
+
+TimerQueue::TimerQueue ()
+  : m_nScheduled (0),
+    m_processing (false),
+    m_nEvents (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TimerQueue::~TimerQueue ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+TimerQueue::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+  Object::DoDispose ();
+}
+
+void
+TimerQueue::Clear (void)
+{
+  m_event.Cancel ();
+  // the events of the timers may outlive the queue.
+  for (Timers::iterator i = m_timers.begin (); i != m_timers.end (); ++i)
+    {
+      i->second->running = false;
+      i->second->queue = 0;
+      i->second->callback = Callback<void> ();
+    }
+  m_timers.clear ();
+}
+
+TimerQueue::Event
+TimerQueue::Schedule (Time delay, Callback<void> callback)
+{
+  NS_LOG_FUNCTION (this << delay);
+  NS_ASSERT (!delay.IsStrictlyNegative ());
+  Ptr<Item> item = Create<Item> ();
+  item->running = true;
+  item->queue = this;
+  item->callback = callback;
+  std::pair<Time, uint64_t> key (Simulator::Now () + delay, m_nScheduled++);
+  item->position = m_timers.insert (std::make_pair (key, item)).first;
+  if (item->position == m_timers.begin () && !m_processing)
+    {
+      ScheduleNext ();
+    }
+  Event event;
+  event.m_item = item;
+  return event;
+}
+
+void
+TimerQueue::Cancel (Ptr<Item> item)
+{
+  NS_LOG_FUNCTION (this);
+  m_timers.erase (item->position);
+  item->running = false;
+  item->callback = Callback<void> ();
+  // the event of a cancelled first timer is left to expire: it then
+  // schedules the event of the next timer.
+  if (m_timers.empty ())
+    {
+      m_event.Cancel ();
+    }
+}
+
+void
+TimerQueue::ScheduleNext (void)
+{
+  if (m_timers.empty ())
+    {
+      return;
+    }
+  Time next = m_timers.begin ()->first.first;
+  if (m_event.IsRunning () && m_event.GetTs () == static_cast<uint64_t> (next.GetTimeStep ()))
+    {
+      return;
+    }
+  m_event.Cancel ();
+  m_event = Simulator::Schedule (next - Simulator::Now (), &TimerQueue::Process, this);
+  m_nEvents++;
+}
+
+void
+TimerQueue::Process (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time now = Simulator::Now ();
+  m_processing = true;
+  while (!m_timers.empty () && m_timers.begin ()->first.first <= now)
+    {
+      Ptr<Item> item = m_timers.begin ()->second;
+      m_timers.erase (m_timers.begin ());
+      item->running = false;
+      Callback<void> callback = item->callback;
+      item->callback = Callback<void> ();
+      // may schedule and cancel timers, including timers which expire now
+      callback ();
+    }
+  m_processing = false;
+  ScheduleNext ();
+}
+
+uint32_t
+TimerQueue::GetNTimers (void) const
+{
+  return m_timers.size ();
+}
+
+uint64_t
+TimerQueue::GetNEvents (void) const
+{
+  return m_nEvents;
+}
+
+Ptr<TimerQueue>
+TimerQueue::LookupOrAggregate (Ptr<Object> object)
+{
+  Ptr<TimerQueue> queue = object->GetObject<TimerQueue> ();
+  if (queue == 0)
+    {
+      queue = CreateObject<TimerQueue> ();
+      object->AggregateObject (queue);
+    }
+  return queue;
+}
+
+} // namespace ns3
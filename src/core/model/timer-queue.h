@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TIMER_QUEUE_H
+#define TIMER_QUEUE_H
+
+#include <stdint.h>
+#include <map>
+#include "object.h"
+#include "nstime.h"
+#include "event-id.h"
+#include "callback.h"
+#include "simple-ref-count.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \brief a queue of timers which shares one simulator event between
+ * many timers
+ *
+ * Protocols which keep a timer per entry of a large table (neighbor
+ * caches, reassembly buffers) would otherwise schedule one simulator
+ * event per entry, or scan the whole table periodically.  A TimerQueue
+ * keeps its timers sorted by expiration time, and schedules a single
+ * simulator event, at the expiration time of the first timer.
+ * Scheduling and cancelling a timer take a time logarithmic in the
+ * number of timers.
+ *
+ * A timer is invoked exactly at its expiration time.  The timers which
+ * expire at the same time are invoked in the order they were scheduled.
+ */
+class TimerQueue : public Object
+{
+private:
+  struct Item;
+  typedef std::map<std::pair<Time, uint64_t>, Ptr<Item> > Timers;
+  struct Item : public SimpleRefCount<Item>
+  {
+    bool running;
+    TimerQueue *queue;
+    Timers::iterator position;
+    Callback<void> callback;
+  };
+
+public:
+  /**
+   * \brief an identifier for a timer scheduled in a TimerQueue
+   */
+  class Event
+  {
+public:
+    Event ();
+    /**
+     * Cancel the timer, if it is running.
+     */
+    void Cancel (void);
+    /**
+     * \returns true if the timer was scheduled and was neither invoked
+     *          nor cancelled.
+     */
+    bool IsRunning (void) const;
+private:
+    friend class TimerQueue;
+    Ptr<Item> m_item;
+  };
+
+  static TypeId GetTypeId (void);
+
+  TimerQueue ();
+  virtual ~TimerQueue ();
+
+  /**
+   * \param delay the delay after which the callback is invoked.
+   * \param callback the function to invoke.
+   * \returns an identifier of the timer, to cancel it.
+   */
+  Event Schedule (Time delay, Callback<void> callback);
+
+  /**
+   * \returns the number of timers running.
+   */
+  uint32_t GetNTimers (void) const;
+  /**
+   * \returns the number of simulator events used by the queue since it
+   *          was created.
+   */
+  uint64_t GetNEvents (void) const;
+
+  /**
+   * \param object an object, typically a Node.
+   * \returns the TimerQueue aggregated to the object, after aggregating
+   *          a new one if there is none, such that all the users of the
+   *          object share the same queue.
+   */
+  static Ptr<TimerQueue> LookupOrAggregate (Ptr<Object> object);
+
+private:
+  friend class Event;
+
+  virtual void DoDispose (void);
+
+  void Clear (void);
+  void Cancel (Ptr<Item> item);
+  void ScheduleNext (void);
+  void Process (void);
+
+  Timers m_timers;
+  uint64_t m_nScheduled; // orders the timers which expire at the same time
+  EventId m_event;
+  bool m_processing;
+  uint64_t m_nEvents;
+};
+
+} // namespace ns3
+
+#endif /* TIMER_QUEUE_H */
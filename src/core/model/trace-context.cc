@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "trace-context.h"
+#include "log.h"
+#include <map>
+#include <cstdlib>
+
+NS_LOG_COMPONENT_DEFINE ("TraceContext");
+
+namespace ns3 {
+
+TraceContext::TraceContext ()
+  : m_record (Lookup (""))
+{
+}
+
+TraceContext::TraceContext (std::string path)
+  : m_record (Lookup (path))
+{
+}
+
+const struct TraceContext::Record *
+TraceContext::Lookup (std::string path)
+{
+  // The records of all the paths seen so far.  They live until the
+  // end of the program, such that a TraceContext stays valid as long
+  // as the callbacks it is bound to.
+  static std::map<std::string, struct Record> records;
+  std::map<std::string, struct Record>::iterator i = records.find (path);
+  if (i != records.end ())
+    {
+      return &i->second;
+    }
+  NS_LOG_FUNCTION (path);
+  struct Record record;
+  record.path = path;
+  record.nodeId = 0;
+  record.deviceId = 0;
+  std::string::size_type position = 0;
+  record.hasNodeId = ParseIndex (path, "/NodeList/", &position, &record.nodeId);
+  record.hasDeviceId = record.hasNodeId &&
+    ParseIndex (path, "/DeviceList/", &position, &record.deviceId);
+  i = records.insert (std::make_pair (path, record)).first;
+  return &i->second;
+}
+
+bool
+TraceContext::ParseIndex (const std::string &path, std::string list,
+                          std::string::size_type *position, uint32_t *index)
+{
+  // The first list can be anywhere in the path, the next one must
+  // follow the index of the previous one.
+  std::string::size_type start = path.find (list, *position);
+  if (start == std::string::npos || (*position != 0 && start != *position))
+    {
+      return false;
+    }
+  start += list.size ();
+  std::string::size_type end = path.find_first_not_of ("0123456789", start);
+  if (end == start || end == std::string::npos || path[end] != '/')
+    {
+      return false;
+    }
+  *index = std::strtoul (path.substr (start, end - start).c_str (), 0, 10);
+  *position = end;
+  return true;
+}
+
+std::ostream &
+operator << (std::ostream &os, const TraceContext &context)
+{
+  os << context.GetPath ();
+  return os;
+}
+
+} // namespace ns3
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TRACE_CONTEXT_H
+#define TRACE_CONTEXT_H
+
+#include <stdint.h>
+#include <string>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup tracing
+ *
+ * \brief the context of a trace sink connected with Config::Connect
+ *
+ * Config::Connect binds the path of every matched trace source as the
+ * first argument of the user callback.  A callback whose first
+ * argument is a std::string receives a copy of this path each time
+ * the trace source fires.  A callback whose first argument is a
+ * TraceContext instead receives a handle to an immutable record
+ * shared by all the connections made with the same path: passing it
+ * around copies a single pointer.
+ *
+ * The record also holds the node and device indexes found in the path
+ * ("/NodeList/n/DeviceList/d/..."), such that sinks do not need to
+ * parse the path to find them.
+ *
+ * \code
+ * void
+ * MacTxTrace (TraceContext context, Ptr<const Packet> p)
+ * {
+ *   std::cout << context << " node=" << context.GetNodeId () << std::endl;
+ * }
+ * Config::Connect ("/NodeList/[0-3]/DeviceList/0/Mac/MacTx", MakeCallback (&MacTxTrace));
+ * \endcode
+ */
+class TraceContext
+{
+public:
+  /**
+   * Create an empty context.
+   */
+  TraceContext ();
+  /**
+   * \param path the path of a trace source.
+   *
+   * Look up the record of the input path, and create it the first
+   * time this path is seen.
+   */
+  explicit TraceContext (std::string path);
+
+  /**
+   * \returns the path of the trace source.
+   */
+  const std::string &GetPath (void) const;
+  /**
+   * \returns true if the path contains a "/NodeList/n/" element.
+   */
+  bool HasNodeId (void) const;
+  /**
+   * \returns the index of the node in the NodeList, if HasNodeId.
+   */
+  uint32_t GetNodeId (void) const;
+  /**
+   * \returns true if the path contains a "/NodeList/n/DeviceList/d/"
+   *          element.
+   */
+  bool HasDeviceId (void) const;
+  /**
+   * \returns the index of the device in the DeviceList of its node,
+   *          if HasDeviceId.
+   */
+  uint32_t GetDeviceId (void) const;
+
+private:
+  friend bool operator == (const TraceContext &a, const TraceContext &b);
+
+  struct Record
+  {
+    std::string path;
+    bool hasNodeId;
+    uint32_t nodeId;
+    bool hasDeviceId;
+    uint32_t deviceId;
+  };
+  static const struct Record *Lookup (std::string path);
+  static bool ParseIndex (const std::string &path, std::string list,
+                          std::string::size_type *position, uint32_t *index);
+
+  const struct Record *m_record;
+};
+
+bool operator == (const TraceContext &a, const TraceContext &b);
+bool operator != (const TraceContext &a, const TraceContext &b);
+std::ostream & operator << (std::ostream &os, const TraceContext &context);
+
+} // namespace ns3
+
+namespace ns3 {
+
+inline const std::string &
+TraceContext::GetPath (void) const
+{
+  return m_record->path;
+}
+inline bool
+TraceContext::HasNodeId (void) const
+{
+  return m_record->hasNodeId;
+}
+inline uint32_t
+TraceContext::GetNodeId (void) const
+{
+  return m_record->nodeId;
+}
+inline bool
+TraceContext::HasDeviceId (void) const
+{
+  return m_record->hasDeviceId;
+}
+inline uint32_t
+TraceContext::GetDeviceId (void) const
+{
+  return m_record->deviceId;
+}
+
+inline bool
+operator == (const TraceContext &a, const TraceContext &b)
+{
+  return a.m_record == b.m_record;
+}
+inline bool
+operator != (const TraceContext &a, const TraceContext &b)
+{
+  return !(a == b);
+}
+
+} // namespace ns3
+
+#endif /* TRACE_CONTEXT_H */
@@ -23,6 +23,7 @@
 
 #include <list>
 #include "callback.h"
+#include "trace-context.h"
 
 namespace ns3 {
 
@@ -58,7 +59,9 @@ public:
    * Append the input callback to the end of the internal list 
    * of ns3::Callback. This method also will make sure that the
    * input path specified by the user will be give back to the
-   * user's callback as its first argument. 
+   * user's callback as its first argument. The first argument
+   * of the user callback can be either a std::string or an
+   * ns3::TraceContext.
    */
   void Connect (const CallbackBase & callback, std::string path);
   /**
@@ -125,6 +128,14 @@ template<typename T1, typename T2,
 void
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Connect (const CallbackBase & callback, std::string path)
 {
+  Callback<void,TraceContext,T1,T2,T3,T4,T5,T6,T7,T8> contextCb;
+  if (contextCb.CheckType (callback))
+    {
+      contextCb.Assign (callback);
+      Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = contextCb.Bind (TraceContext (path));
+      m_callbackList.push_back (realCb);
+      return;
+    }
   Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   cb.Assign (callback);
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
@@ -157,6 +168,14 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Disconnect (const CallbackBase & callback, std::string path)
 {
+  Callback<void,TraceContext,T1,T2,T3,T4,T5,T6,T7,T8> contextCb;
+  if (contextCb.CheckType (callback))
+    {
+      contextCb.Assign (callback);
+      Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = contextCb.Bind (TraceContext (path));
+      DisconnectWithoutContext (realCb);
+      return;
+    }
   Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   cb.Assign (callback);
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
@@ -21,7 +21,9 @@
 #include "singleton.h"
 #include "trace-source-accessor.h"
 #include <vector>
+#include <map>
 #include <sstream>
+#include <algorithm>
 
 /*********************************************************************
  *         Helper code
@@ -41,6 +43,7 @@ public:
   uint16_t GetUid (std::string name) const;
   std::string GetName (uint16_t uid) const;
   uint16_t GetParent (uint16_t uid) const;
+  bool IsChildOf (uint16_t uid, uint16_t other) const;
   std::string GetGroupName (uint16_t uid) const;
   ns3::Callback<ns3::ObjectBase *> GetConstructor (uint16_t uid) const;
   bool HasConstructor (uint16_t uid) const;
@@ -64,6 +67,9 @@ public:
                        ns3::Ptr<const ns3::TraceSourceAccessor> accessor);
   uint32_t GetTraceSourceN (uint16_t uid) const;
   struct ns3::TypeId::TraceSourceInformation GetTraceSource(uint16_t uid, uint32_t i) const;
+  bool LookupAttributeByName (uint16_t uid, std::string name,
+                              struct ns3::TypeId::AttributeInformation *info) const;
+  ns3::Ptr<const ns3::TraceSourceAccessor> LookupTraceSourceByName (uint16_t uid, std::string name) const;
   bool MustHideFromDocumentation (uint16_t uid) const;
 
 private:
@@ -79,12 +85,25 @@ private:
     bool mustHideFromDocumentation;
     std::vector<struct ns3::TypeId::AttributeInformation> attributes;
     std::vector<struct ns3::TypeId::TraceSourceInformation> traceSources;
+    // the uids of all the ancestors of this TypeId, starting from the
+    // root of the hierarchy and ending with this TypeId itself. Built
+    // on demand by GetAncestors.
+    std::vector<uint16_t> ancestors;
+    // the (uid, index) of all the attributes and trace sources of this
+    // TypeId and of its ancestors, indexed by name. Built on demand by
+    // BuildIndexes.
+    bool indexed;
+    std::map<std::string, std::pair<uint16_t, uint32_t> > attributeIndex;
+    std::map<std::string, std::pair<uint16_t, uint32_t> > traceSourceIndex;
   };
-  typedef std::vector<struct IidInformation>::const_iterator Iterator;
 
   struct IidManager::IidInformation *LookupInformation (uint16_t uid) const;
+  const std::vector<uint16_t> &GetAncestors (uint16_t uid) const;
+  void BuildIndexes (uint16_t uid) const;
+  void InvalidateIndexes (void);
 
   std::vector<struct IidInformation> m_information;
+  std::map<std::string, uint16_t> m_namesIndex;
 };
 
 IidManager::IidManager ()
@@ -94,15 +113,10 @@ IidManager::IidManager ()
 uint16_t
 IidManager::AllocateUid (std::string name)
 {
-  uint16_t j = 1;
-  for (Iterator i = m_information.begin (); i != m_information.end (); i++)
+  if (m_namesIndex.find (name) != m_namesIndex.end ())
     {
-      if (i->name == name)
-        {
-          NS_FATAL_ERROR ("Trying to allocate twice the same uid: " << name);
-          return 0;
-        }
-      j++;
+      NS_FATAL_ERROR ("Trying to allocate twice the same uid: " << name);
+      return 0;
     }
   struct IidInformation information;
   information.name = name;
@@ -110,9 +124,11 @@ IidManager::AllocateUid (std::string name)
   information.groupName = "";
   information.hasConstructor = false;
   information.mustHideFromDocumentation = false;
+  information.indexed = false;
   m_information.push_back (information);
   uint32_t uid = m_information.size ();
   NS_ASSERT (uid <= 0xffff);
+  m_namesIndex[name] = uid;
   return uid;
 }
 
@@ -129,6 +145,12 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  // the ancestors of this TypeId and of all its children are now stale.
+  for (std::vector<struct IidInformation>::iterator i = m_information.begin (); i != m_information.end (); i++)
+    {
+      i->ancestors.clear ();
+    }
+  InvalidateIndexes ();
 }
 void 
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -158,17 +180,12 @@ IidManager::AddConstructor (uint16_t uid, ns3::Callback<ns3::ObjectBase *> callb
 uint16_t 
 IidManager::GetUid (std::string name) const
 {
-  uint32_t j = 1;
-  for (Iterator i = m_information.begin (); i != m_information.end (); i++)
+  std::map<std::string, uint16_t>::const_iterator i = m_namesIndex.find (name);
+  if (i == m_namesIndex.end ())
     {
-      if (i->name == name)
-        {
-          NS_ASSERT (j <= 0xffff);
-          return j;
-        }
-      j++;
+      return 0;
     }
-  return 0;
+  return i->second;
 }
 std::string 
 IidManager::GetName (uint16_t uid) const
@@ -182,6 +199,36 @@ IidManager::GetParent (uint16_t uid) const
   struct IidInformation *information = LookupInformation (uid);
   return information->parent;
 }
+const std::vector<uint16_t> &
+IidManager::GetAncestors (uint16_t uid) const
+{
+  struct IidInformation *information = LookupInformation (uid);
+  if (information->ancestors.empty ())
+    {
+      uint16_t current = uid;
+      while (true)
+        {
+          information->ancestors.push_back (current);
+          uint16_t parent = LookupInformation (current)->parent;
+          if (parent == 0 || parent == current)
+            {
+              break;
+            }
+          current = parent;
+        }
+      std::reverse (information->ancestors.begin (), information->ancestors.end ());
+    }
+  return information->ancestors;
+}
+bool
+IidManager::IsChildOf (uint16_t uid, uint16_t other) const
+{
+  // other is an ancestor of uid if it sits at its own depth
+  // in the list of ancestors of uid.
+  const std::vector<uint16_t> &ancestors = GetAncestors (uid);
+  uint32_t depth = GetAncestors (other).size ();
+  return depth <= ancestors.size () && ancestors[depth - 1] == other;
+}
 std::string 
 IidManager::GetGroupName (uint16_t uid) const
 {
@@ -269,6 +316,7 @@ IidManager::AddAttribute (uint16_t uid,
   info.accessor = accessor;
   info.checker = checker;
   information->attributes.push_back (info);
+  InvalidateIndexes ();
 }
 void 
 IidManager::SetAttributeInitialValue(uint16_t uid,
@@ -340,6 +388,7 @@ IidManager::AddTraceSource (uint16_t uid,
   source.help = help;
   source.accessor = accessor;
   information->traceSources.push_back (source);
+  InvalidateIndexes ();
 }
 uint32_t 
 IidManager::GetTraceSourceN (uint16_t uid) const
@@ -354,6 +403,77 @@ IidManager::GetTraceSource(uint16_t uid, uint32_t i) const
   NS_ASSERT (i < information->traceSources.size ());
   return information->traceSources[i];
 }
+void
+IidManager::InvalidateIndexes (void)
+{
+  // Attributes and trace sources are registered when the TypeIds are
+  // created so, rebuilding all the indexes after a change is cheap
+  // compared to the lookups performed during a simulation.
+  for (std::vector<struct IidInformation>::iterator i = m_information.begin (); i != m_information.end (); i++)
+    {
+      if (i->indexed)
+        {
+          i->indexed = false;
+          i->attributeIndex.clear ();
+          i->traceSourceIndex.clear ();
+        }
+    }
+}
+void
+IidManager::BuildIndexes (uint16_t uid) const
+{
+  struct IidInformation *information = LookupInformation (uid);
+  // walk from the root of the hierarchy down to uid so that the
+  // attributes and trace sources of a child override those of its
+  // parents, and each TypeId backwards so that its first entry of a
+  // given name wins, as in the original lookup order.
+  const std::vector<uint16_t> &ancestors = GetAncestors (uid);
+  for (std::vector<uint16_t>::const_iterator i = ancestors.begin (); i != ancestors.end (); ++i)
+    {
+      struct IidInformation *ancestor = LookupInformation (*i);
+      for (uint32_t j = ancestor->attributes.size (); j > 0; j--)
+        {
+          information->attributeIndex[ancestor->attributes[j - 1].name] = std::make_pair (*i, j - 1);
+        }
+      for (uint32_t j = ancestor->traceSources.size (); j > 0; j--)
+        {
+          information->traceSourceIndex[ancestor->traceSources[j - 1].name] = std::make_pair (*i, j - 1);
+        }
+    }
+  information->indexed = true;
+}
+bool
+IidManager::LookupAttributeByName (uint16_t uid, std::string name,
+                                   struct ns3::TypeId::AttributeInformation *info) const
+{
+  struct IidInformation *information = LookupInformation (uid);
+  if (!information->indexed)
+    {
+      BuildIndexes (uid);
+    }
+  std::map<std::string, std::pair<uint16_t, uint32_t> >::const_iterator i = information->attributeIndex.find (name);
+  if (i == information->attributeIndex.end ())
+    {
+      return false;
+    }
+  *info = LookupInformation (i->second.first)->attributes[i->second.second];
+  return true;
+}
+ns3::Ptr<const ns3::TraceSourceAccessor>
+IidManager::LookupTraceSourceByName (uint16_t uid, std::string name) const
+{
+  struct IidInformation *information = LookupInformation (uid);
+  if (!information->indexed)
+    {
+      BuildIndexes (uid);
+    }
+  std::map<std::string, std::pair<uint16_t, uint32_t> >::const_iterator i = information->traceSourceIndex.find (name);
+  if (i == information->traceSourceIndex.end ())
+    {
+      return 0;
+    }
+  return LookupInformation (i->second.first)->traceSources[i->second.second].accessor;
+}
 bool 
 IidManager::MustHideFromDocumentation (uint16_t uid) const
 {
@@ -414,22 +534,7 @@ TypeId::GetRegistered (uint32_t i)
 bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
-        {
-          struct TypeId::AttributeInformation tmp = tid.GetAttribute(i);
-          if (tmp.name == name)
-            {
-              *info = tmp;
-              return true;
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return false;
+  return Singleton<IidManager>::Get ()->LookupAttributeByName (m_tid, name, info);
 }
 
 TypeId 
@@ -459,12 +564,7 @@ TypeId::HasParent (void) const
 bool 
 TypeId::IsChildOf (TypeId other) const
 {
-  TypeId tmp = *this;
-  while (tmp != other && tmp != tmp.GetParent ())
-    {
-      tmp = tmp.GetParent ();
-    }
-  return tmp == other && *this != other;
+  return *this != other && Singleton<IidManager>::Get ()->IsChildOf (m_tid, other.m_tid);
 }
 std::string 
 TypeId::GetGroupName (void) const
@@ -588,21 +688,7 @@ TypeId::HideFromDocumentation (void)
 Ptr<const TraceSourceAccessor> 
 TypeId::LookupTraceSourceByName (std::string name) const
 {
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetTraceSourceN (); i++)
-        {
-          struct TypeId::TraceSourceInformation info = tid.GetTraceSource (i);
-          if (info.name == name)
-            {
-              return info.accessor;
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return 0;
+  return Singleton<IidManager>::Get ()->LookupTraceSourceByName (m_tid, name);
 }
 
 uint16_t 
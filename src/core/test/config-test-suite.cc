@@ -595,6 +595,106 @@ ObjectVectorTraceConfigTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_path, "/NodeA/NodeB/NodesB/1/Source", "Trace 1 did not provide expected context");
 }
 
+// ===========================================================================
+// Test for the ability to reuse compiled paths and to connect paths in batch.
+// ===========================================================================
+class CompiledPathConfigTestCase : public TestCase
+{
+public:
+  CompiledPathConfigTestCase ();
+  virtual ~CompiledPathConfigTestCase () {}
+
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue) { m_paths.push_back (path); }
+
+private:
+  virtual void DoRun (void);
+
+  std::vector<std::string> m_paths;
+};
+
+CompiledPathConfigTestCase::CompiledPathConfigTestCase ()
+  : TestCase ("Check ability to reuse compiled paths and to connect sets of paths")
+{
+}
+
+void
+CompiledPathConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  //
+  // Create a named object, which is the only one matched by the paths
+  // below, with five objects in its ObjectVector Attribute.
+  //
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Names::Add ("CompiledRoot", root);
+  std::vector<Ptr<ConfigTestObject> > objs;
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      objs.push_back (CreateObject<ConfigTestObject> ());
+      root->AddNodeA (objs.back ());
+    }
+
+  //
+  // Redundant and unordered alternatives match each object only once,
+  // in increasing index order.
+  //
+  Config::MatchContainer matches = Config::LookupMatches (Config::CompiledPath ("/Names/CompiledRoot/NodesA/4|[1-2]|1"));
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 3, "Unexpected number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/Names/CompiledRoot/NodesA/1/", "Unexpected match");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (1), "/Names/CompiledRoot/NodesA/2/", "Unexpected match");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (2), "/Names/CompiledRoot/NodesA/4/", "Unexpected match");
+
+  //
+  // A compiled path can be used more than once, and its ranges are matched
+  // against the current size of the vector.
+  //
+  Config::CompiledPath path = Config::CompiledPath ("/Names/CompiledRoot/NodesA/[3-6]/A");
+  NS_TEST_ASSERT_MSG_EQ (path.GetPath (), "/Names/CompiledRoot/NodesA/[3-6]/A", "Unexpected path");
+  Config::Set (path, IntegerValue (-20));
+  objs[2]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 10, "Object Attribute \"A\" unexpectedly set");
+  objs[3]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -20, "Object Attribute \"A\" not set as expected");
+  objs[4]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -20, "Object Attribute \"A\" not set as expected");
+
+  objs.push_back (CreateObject<ConfigTestObject> ());
+  root->AddNodeA (objs.back ());
+  Config::Set (path, IntegerValue (-21));
+  objs[3]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -21, "Object Attribute \"A\" not set as expected");
+  objs[5]->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -21, "Object Attribute \"A\" not set as expected");
+
+  //
+  // Connect a set of paths at once and check the contexts of the traces.
+  //
+  std::vector<std::string> paths;
+  paths.push_back ("/Names/CompiledRoot/NodesA/0/Source");
+  paths.push_back ("/Names/CompiledRoot/NodesA/5/Source");
+  Config::Connect (paths, MakeCallback (&CompiledPathConfigTestCase::TraceWithPath, this));
+  objs[5]->SetAttribute ("Source", IntegerValue (-2));
+  objs[0]->SetAttribute ("Source", IntegerValue (-3));
+  objs[1]->SetAttribute ("Source", IntegerValue (-4));
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 2, "Unexpected number of traces");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[0], "/Names/CompiledRoot/NodesA/5/Source", "Unexpected trace context");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[1], "/Names/CompiledRoot/NodesA/0/Source", "Unexpected trace context");
+
+  //
+  // Disconnect one of them through a compiled path.
+  //
+  Config::Disconnect (Config::CompiledPath ("/Names/CompiledRoot/NodesA/5/Source"),
+                      MakeCallback (&CompiledPathConfigTestCase::TraceWithPath, this));
+  m_paths.clear ();
+  objs[5]->SetAttribute ("Source", IntegerValue (-5));
+  objs[0]->SetAttribute ("Source", IntegerValue (-6));
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 1, "Unexpected number of traces");
+  NS_TEST_ASSERT_MSG_EQ (m_paths[0], "/Names/CompiledRoot/NodesA/0/Source", "Unexpected trace context");
+
+  Names::Clear ();
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -610,6 +710,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new RootNamespaceConfigTestCase);
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
+  AddTestCase (new CompiledPathConfigTestCase);
 }
 
 static ConfigTestSuite configTestSuite;
@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+NS_LOG_COMPONENT_DEFINE ("LogTestSuite");
+
+namespace ns3 {
+
+#ifdef NS3_LOG_ENABLE
+
+static std::string
+DecodeFile (std::string filename, bool *ok)
+{
+  std::ifstream is (filename.c_str (), std::ios::binary);
+  std::ostringstream os;
+  *ok = LogDecodeBinary (is, os);
+  return os.str ();
+}
+
+static void
+LogMessage (std::string message)
+{
+  NS_LOG_INFO (message);
+}
+
+class BinaryLogTestCase : public TestCase
+{
+public:
+  BinaryLogTestCase ();
+  virtual void DoRun (void);
+  int Nested (void);
+};
+
+BinaryLogTestCase::BinaryLogTestCase ()
+  : TestCase ("Check that binary log messages decode to the text output")
+{
+}
+
+int
+BinaryLogTestCase::Nested (void)
+{
+  NS_LOG_WARN ("nested");
+  return 2;
+}
+
+void
+BinaryLogTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("log-test.bin");
+  LogSetBinaryOutput (filename);
+  LogComponentEnable ("LogTestSuite", LOG_LEVEL_INFO);
+  NS_LOG_INFO ("first " << 1);
+  NS_LOG_WARN ("second " << 2.5);
+  NS_LOG_LOGIC ("not enabled");
+  NS_LOG_INFO (Nested ());
+  LogComponentDisable ("LogTestSuite", LOG_LEVEL_ALL);
+  LogSetTextOutput ();
+
+  bool ok;
+  std::string text = DecodeFile (filename, &ok);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Could not decode the binary log");
+  NS_TEST_ASSERT_MSG_EQ (text, "first 1\nsecond 2.5\nnested\n2\n",
+                         "Unexpected decoded messages");
+  std::remove (filename.c_str ());
+
+  std::istringstream bad ("not a binary log");
+  std::ostringstream os;
+  ok = LogDecodeBinary (bad, os);
+  NS_TEST_ASSERT_MSG_EQ (ok, false, "Decoded an invalid log");
+}
+
+class RateLimitLogTestCase : public TestCase
+{
+public:
+  RateLimitLogTestCase ();
+  virtual void DoRun (void);
+};
+
+RateLimitLogTestCase::RateLimitLogTestCase ()
+  : TestCase ("Check that the messages in excess of the rate limit are dropped and counted")
+{
+}
+
+void
+RateLimitLogTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("log-rate-test.bin");
+  LogSetBinaryOutput (filename);
+  LogComponentEnable ("LogTestSuite", LOG_LEVEL_INFO);
+  LogComponentSetRateLimit ("LogTestSuite", 3);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      std::ostringstream message;
+      message << "message " << i;
+      Simulator::Schedule (MilliSeconds (1000 + 10 * i), &LogMessage, message.str ());
+    }
+  Simulator::Schedule (Seconds (2.5), &LogMessage, "last");
+  Simulator::Run ();
+  Simulator::Destroy ();
+  LogComponentSetRateLimit ("LogTestSuite", 0);
+  LogComponentDisable ("LogTestSuite", LOG_LEVEL_ALL);
+  LogSetTextOutput ();
+
+  bool ok;
+  std::string text = DecodeFile (filename, &ok);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Could not decode the binary log");
+  NS_TEST_ASSERT_MSG_EQ (text, "message 0\nmessage 1\nmessage 2\n"
+                         "LogTestSuite: 7 messages dropped\nlast\n",
+                         "Unexpected decoded messages");
+  std::remove (filename.c_str ());
+}
+
+#endif /* NS3_LOG_ENABLE */
+
+static class LogTestSuite : public TestSuite
+{
+public:
+  LogTestSuite ()
+    : TestSuite ("log", UNIT)
+  {
+#ifdef NS3_LOG_ENABLE
+    AddTestCase (new BinaryLogTestCase ());
+    AddTestCase (new RateLimitLogTestCase ());
+#endif
+  }
+} g_logTestSuite;
+
+} // namespace ns3
@@ -22,6 +22,10 @@
 #include "ns3/object.h"
 #include "ns3/object-factory.h"
 #include "ns3/assert.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/traced-callback.h"
+#include "ns3/trace-source-accessor.h"
 
 namespace {
 
@@ -89,10 +93,67 @@ public:
   }
 };
 
+class AttributeParent : public ns3::Object
+{
+public:
+  static ns3::TypeId GetTypeId (void) {
+    static ns3::TypeId tid = ns3::TypeId ("AttributeParent")
+      .SetParent (Object::GetTypeId ())
+      .HideFromDocumentation ()
+      .AddConstructor<AttributeParent> ()
+      .AddAttribute ("Shared", "Overridden by AttributeChild.",
+                     ns3::UintegerValue (1),
+                     ns3::MakeUintegerAccessor (&AttributeParent::m_shared),
+                     ns3::MakeUintegerChecker<uint32_t> ())
+      .AddAttribute ("Inherited", "Inherited by AttributeChild.",
+                     ns3::UintegerValue (2),
+                     ns3::MakeUintegerAccessor (&AttributeParent::m_inherited),
+                     ns3::MakeUintegerChecker<uint32_t> ())
+      .AddTraceSource ("SharedTrace", "Overridden by AttributeChild.",
+                       ns3::MakeTraceSourceAccessor (&AttributeParent::m_sharedTrace))
+      .AddTraceSource ("InheritedTrace", "Inherited by AttributeChild.",
+                       ns3::MakeTraceSourceAccessor (&AttributeParent::m_inheritedTrace));
+    return tid;
+  }
+  AttributeParent ()
+  {}
+  uint32_t m_shared;
+  uint32_t m_inherited;
+  ns3::TracedCallback<uint32_t> m_sharedTrace;
+  ns3::TracedCallback<uint32_t> m_inheritedTrace;
+};
+
+class AttributeChild : public AttributeParent
+{
+public:
+  static ns3::TypeId GetTypeId (void) {
+    // AddAttribute rejects the names of the ancestors, so the child
+    // registers its own under Object, then moves under AttributeParent.
+    static ns3::TypeId tid = ns3::TypeId ("AttributeChild")
+      .SetParent (Object::GetTypeId ())
+      .AddAttribute ("Shared", "Overrides the attribute of AttributeParent.",
+                     ns3::UintegerValue (10),
+                     ns3::MakeUintegerAccessor (&AttributeChild::m_childShared),
+                     ns3::MakeUintegerChecker<uint32_t> ())
+      .AddTraceSource ("SharedTrace", "Overrides the trace source of AttributeParent.",
+                       ns3::MakeTraceSourceAccessor (&AttributeChild::m_childSharedTrace))
+      .SetParent (AttributeParent::GetTypeId ())
+      .HideFromDocumentation ()
+      .AddConstructor<AttributeChild> ();
+    return tid;
+  }
+  AttributeChild ()
+  {}
+  uint32_t m_childShared;
+  ns3::TracedCallback<uint32_t> m_childSharedTrace;
+};
+
 NS_OBJECT_ENSURE_REGISTERED (BaseA);
 NS_OBJECT_ENSURE_REGISTERED (DerivedA);
 NS_OBJECT_ENSURE_REGISTERED (BaseB);
 NS_OBJECT_ENSURE_REGISTERED (DerivedB);
+NS_OBJECT_ENSURE_REGISTERED (AttributeParent);
+NS_OBJECT_ENSURE_REGISTERED (AttributeChild);
 
 } // namespace anonymous
 
@@ -333,6 +394,17 @@ AggregateObjectTestCase::DoRun (void)
 
   baseA = baseB->GetObject<BaseA> ();
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
+
+  //
+  // Failed lookups must not hide objects which are aggregated later.
+  //
+  baseA = CreateObject<BaseA> ();
+  baseA->AggregateObject (CreateObject<BaseB> ());
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (), 0, "Unexpectedly found a DerivedB through baseA");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (), 0, "Unexpectedly found a DerivedB through baseA");
+  baseB = CreateObject<DerivedB> ();
+  baseA->AggregateObject (baseB);
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (), baseB, "Cannot GetObject (through baseA) for late DerivedB Object");
 }
 
 // ===========================================================================
@@ -407,6 +479,126 @@ ObjectFactoryTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (a->GetObject<DerivedA> (), 0, "Unexpectedly able to work around C++ type system");
 }
 
+// ===========================================================================
+// Test case to make sure that TypeIds are found by name and that their
+// ancestry is correct.
+// ===========================================================================
+class TypeIdLookupTestCase : public TestCase
+{
+public:
+  TypeIdLookupTestCase ();
+  virtual ~TypeIdLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TypeIdLookupTestCase::TypeIdLookupTestCase ()
+  : TestCase ("Check TypeId lookups")
+{
+}
+
+TypeIdLookupTestCase::~TypeIdLookupTestCase ()
+{
+}
+
+void
+TypeIdLookupTestCase::DoRun (void)
+{
+  TypeId tid;
+  NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByNameFailSafe ("DerivedA", &tid), true, "Cannot find DerivedA by name");
+  NS_TEST_ASSERT_MSG_EQ (tid, DerivedA::GetTypeId (), "Found the wrong TypeId for DerivedA");
+  NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByNameFailSafe ("DerivedC", &tid), false, "Unexpectedly found DerivedC");
+
+  NS_TEST_ASSERT_MSG_EQ (DerivedA::GetTypeId ().IsChildOf (BaseA::GetTypeId ()), true, "DerivedA is a BaseA");
+  NS_TEST_ASSERT_MSG_EQ (DerivedA::GetTypeId ().IsChildOf (Object::GetTypeId ()), true, "DerivedA is an Object");
+  NS_TEST_ASSERT_MSG_EQ (DerivedA::GetTypeId ().IsChildOf (DerivedA::GetTypeId ()), false, "DerivedA is not its own child");
+  NS_TEST_ASSERT_MSG_EQ (BaseA::GetTypeId ().IsChildOf (DerivedA::GetTypeId ()), false, "BaseA is not a DerivedA");
+  NS_TEST_ASSERT_MSG_EQ (DerivedA::GetTypeId ().IsChildOf (BaseB::GetTypeId ()), false, "DerivedA is not a BaseB");
+}
+
+// ===========================================================================
+// Test case to make sure that the attributes and trace sources of a TypeId
+// are found by name along with those it inherits, that those of a child
+// override those of its parent, and that the lookups see the initial
+// values changed with Config::SetDefault.
+// ===========================================================================
+class TypeIdAttributeLookupTestCase : public TestCase
+{
+public:
+  TypeIdAttributeLookupTestCase ();
+  virtual ~TypeIdAttributeLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+  uint32_t LookupInitialValue (TypeId tid, std::string name);
+};
+
+TypeIdAttributeLookupTestCase::TypeIdAttributeLookupTestCase ()
+  : TestCase ("Check TypeId attribute and trace source lookups")
+{
+}
+
+TypeIdAttributeLookupTestCase::~TypeIdAttributeLookupTestCase ()
+{
+}
+
+uint32_t
+TypeIdAttributeLookupTestCase::LookupInitialValue (TypeId tid, std::string name)
+{
+  struct TypeId::AttributeInformation info;
+  if (!tid.LookupAttributeByName (name, &info))
+    {
+      return 0;
+    }
+  return DynamicCast<const UintegerValue> (info.initialValue)->Get ();
+}
+
+void
+TypeIdAttributeLookupTestCase::DoRun (void)
+{
+  TypeId parent = AttributeParent::GetTypeId ();
+  TypeId child = AttributeChild::GetTypeId ();
+  struct TypeId::AttributeInformation info;
+
+  NS_TEST_ASSERT_MSG_EQ (child.LookupAttributeByName ("Shared", &info), true, "Cannot find Shared in AttributeChild");
+  NS_TEST_EXPECT_MSG_EQ (info.help, "Overrides the attribute of AttributeParent.", "The child does not override Shared");
+  NS_TEST_EXPECT_MSG_EQ (LookupInitialValue (child, "Shared"), 10, "Wrong initial value of the Shared of the child");
+  NS_TEST_EXPECT_MSG_EQ (LookupInitialValue (parent, "Shared"), 1, "Wrong initial value of the Shared of the parent");
+  NS_TEST_ASSERT_MSG_EQ (child.LookupAttributeByName ("Inherited", &info), true, "Cannot find Inherited in AttributeChild");
+  NS_TEST_EXPECT_MSG_EQ (info.help, "Inherited by AttributeChild.", "Wrong Inherited attribute");
+  NS_TEST_EXPECT_MSG_EQ (child.LookupAttributeByName ("Missing", &info), false, "Unexpectedly found Missing");
+
+  NS_TEST_EXPECT_MSG_EQ (child.LookupTraceSourceByName ("SharedTrace"), child.GetTraceSource (0).accessor,
+                         "The child does not override SharedTrace");
+  NS_TEST_EXPECT_MSG_EQ (parent.LookupTraceSourceByName ("SharedTrace"), parent.GetTraceSource (0).accessor,
+                         "Wrong SharedTrace of the parent");
+  NS_TEST_EXPECT_MSG_EQ (child.LookupTraceSourceByName ("InheritedTrace"), parent.GetTraceSource (1).accessor,
+                         "Wrong InheritedTrace of the child");
+  NS_TEST_EXPECT_MSG_EQ (child.LookupTraceSourceByName ("Missing"), 0, "Unexpectedly found Missing");
+
+  Ptr<AttributeChild> object = CreateObject<AttributeChild> ();
+  UintegerValue value;
+  object->GetAttribute ("Shared", value);
+  NS_TEST_EXPECT_MSG_EQ (value.Get (), 10, "Shared does not set the attribute of the child");
+  NS_TEST_EXPECT_MSG_EQ (object->m_shared, 1, "Shared set the attribute of the parent");
+
+  //
+  // The defaults of the parent are seen through the child, those of the
+  // child do not leak to the parent.
+  //
+  Config::SetDefault ("AttributeParent::Inherited", UintegerValue (20));
+  Config::SetDefault ("AttributeChild::Shared", UintegerValue (30));
+  NS_TEST_EXPECT_MSG_EQ (LookupInitialValue (child, "Inherited"), 20, "The default of Inherited is not seen by the child");
+  NS_TEST_EXPECT_MSG_EQ (LookupInitialValue (child, "Shared"), 30, "The default of the Shared of the child is not seen");
+  NS_TEST_EXPECT_MSG_EQ (LookupInitialValue (parent, "Shared"), 1, "The default of the child changed the parent");
+  object = CreateObject<AttributeChild> ();
+  NS_TEST_EXPECT_MSG_EQ (object->m_inherited, 20, "The default of Inherited is not used by the child");
+  NS_TEST_EXPECT_MSG_EQ (object->m_childShared, 30, "The default of Shared is not used by the child");
+  Config::SetDefault ("AttributeParent::Inherited", UintegerValue (2));
+  Config::SetDefault ("AttributeChild::Shared", UintegerValue (10));
+}
+
 // ===========================================================================
 // The Test Suite that glues the Test Cases together.
 // ===========================================================================
@@ -422,6 +614,8 @@ ObjectTestSuite::ObjectTestSuite ()
   AddTestCase (new CreateObjectTestCase);
   AddTestCase (new AggregateObjectTestCase);
   AddTestCase (new ObjectFactoryTestCase);
+  AddTestCase (new TypeIdLookupTestCase);
+  AddTestCase (new TypeIdAttributeLookupTestCase);
 }
 
 static ObjectTestSuite objectTestSuite;
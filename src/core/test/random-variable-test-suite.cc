@@ -26,6 +26,7 @@
 #include "ns3/assert.h"
 #include "ns3/integer.h"
 #include "ns3/random-variable.h"
+#include "ns3/rng-stream.h"
 
 using namespace std;
 
@@ -129,6 +130,189 @@ RandomNumberSerializationTestCase::DoRun (void)
                          "Deserialize and Serialize \"Normal:0.1:0.2:0.15\" mismatch");
 }
 
+class DiscreteRandomNumberTestCase : public TestCase
+{
+public:
+  DiscreteRandomNumberTestCase ();
+  virtual ~DiscreteRandomNumberTestCase ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  void CheckEmpirical (bool alias);
+};
+
+DiscreteRandomNumberTestCase::DiscreteRandomNumberTestCase ()
+  : TestCase ("Check the zipf and empirical tables and bulk draws")
+{
+}
+
+void
+DiscreteRandomNumberTestCase::CheckEmpirical (bool alias)
+{
+  EmpiricalVariable empirical;
+  empirical.SetAliasMethod (alias);
+  empirical.CDF (0.0, 0.2);
+  empirical.CDF (10.0, 0.5);
+  empirical.CDF (20.0, 1.0);
+  const uint32_t NSAMPLES = 100000;
+  vector<double> samples (NSAMPLES);
+  empirical.GetValues (NSAMPLES, &samples[0]);
+  double sum = 0;
+  uint32_t nFirst = 0;
+  uint32_t nSecond = 0;
+  for (uint32_t i = 0; i < NSAMPLES; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((samples[i] >= 0.0 && samples[i] <= 20.0), true,
+                             "Empirical value out of range: " << samples[i]);
+      sum += samples[i];
+      nFirst += (samples[i] == 0.0);
+      nSecond += (samples[i] > 0.0 && samples[i] < 10.0);
+    }
+  double first = double (nFirst) / NSAMPLES;
+  double second = double (nSecond) / NSAMPLES;
+  double mean = sum / NSAMPLES;
+  NS_TEST_EXPECT_MSG_EQ_TOL (first, 0.2, 0.01, "Unexpected mass of the first point, alias=" << alias);
+  NS_TEST_EXPECT_MSG_EQ_TOL (second, 0.3, 0.01, "Unexpected mass of the first segment, alias=" << alias);
+  NS_TEST_EXPECT_MSG_EQ_TOL (mean, 9.0, 0.15, "Unexpected mean, alias=" << alias);
+
+  // A copy continues the same stream: draw with GetValue from the
+  // original and in bulk from the copy.
+  RandomVariable copy = empirical;
+  double bulk[10];
+  copy.GetValues (10, bulk);
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      double value = empirical.GetValue ();
+      NS_TEST_EXPECT_MSG_EQ (bulk[i], value, "GetValues differs from GetValue, alias=" << alias);
+    }
+}
+
+void
+DiscreteRandomNumberTestCase::DoRun (void)
+{
+  // Zipf with N=100 and alpha=1: P(k) = 1 / (k H_100)
+  double h = 0;
+  for (int k = 1; k <= 100; ++k)
+    {
+      h += 1.0 / k;
+    }
+  ZipfVariable zipf (100, 1.0);
+  const uint32_t NSAMPLES = 100000;
+  vector<double> samples (NSAMPLES);
+  zipf.GetValues (NSAMPLES, &samples[0]);
+  uint32_t nOne = 0;
+  uint32_t nTwo = 0;
+  for (uint32_t i = 0; i < NSAMPLES; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((samples[i] >= 1 && samples[i] <= 100 && samples[i] == floor (samples[i])), true,
+                             "Zipf value out of range: " << samples[i]);
+      nOne += (samples[i] == 1);
+      nTwo += (samples[i] == 2);
+    }
+  double one = double (nOne) / NSAMPLES;
+  double two = double (nTwo) / NSAMPLES;
+  NS_TEST_EXPECT_MSG_EQ_TOL (one, 1 / h, 0.01, "Unexpected frequency of rank 1");
+  NS_TEST_EXPECT_MSG_EQ_TOL (two, 1 / (2 * h), 0.01, "Unexpected frequency of rank 2");
+
+  ZipfVariable single;
+  double value = single.GetValue ();
+  NS_TEST_EXPECT_MSG_EQ (value, 1, "A default zipf variable always returns 1");
+
+  CheckEmpirical (false);
+  CheckEmpirical (true);
+}
+
+class BulkRandomNumberTestCase : public TestCase
+{
+public:
+  BulkRandomNumberTestCase ();
+  virtual ~BulkRandomNumberTestCase ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  void CheckStream (bool antithetic, bool precision);
+  void CheckVariable (RandomVariable variable, std::string name);
+};
+
+BulkRandomNumberTestCase::BulkRandomNumberTestCase ()
+  : TestCase ("Check that bulk draws match successive draws")
+{
+}
+
+void
+BulkRandomNumberTestCase::CheckStream (bool antithetic, bool precision)
+{
+  RngStream single;
+  single.SetAntithetic (antithetic);
+  single.IncreasedPrecis (precision);
+  RngStream bulk (single);
+  const uint32_t N = 100000;
+  vector<double> values (N);
+  bulk.RandU01 (N, &values[0]);
+  for (uint32_t i = 0; i < N; ++i)
+    {
+      double value = single.RandU01 ();
+      NS_TEST_ASSERT_MSG_EQ (values[i], value, "Bulk uniform " << i << " differs, antithetic="
+                             << antithetic << " precision=" << precision);
+    }
+  uint32_t singleState[6];
+  uint32_t bulkState[6];
+  single.GetState (singleState);
+  bulk.GetState (bulkState);
+  for (uint32_t i = 0; i < 6; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (bulkState[i], singleState[i], "Bulk state differs");
+    }
+}
+
+void
+BulkRandomNumberTestCase::CheckVariable (RandomVariable variable, std::string name)
+{
+  // Draw a first value to create the stream, then compare two copies
+  // which start from the same state (a copy drops the pending value of
+  // a NormalVariable).
+  variable.GetValue ();
+  RandomVariable copy = variable;
+  variable = RandomVariable (copy);
+  // More than one block of the bulk draws, then a few single draws to
+  // check that the stream is left where the single draws leave it.
+  const uint32_t N = 1000;
+  double values[N];
+  copy.GetValues (N, values);
+  for (uint32_t i = 0; i < N; ++i)
+    {
+      double value = variable.GetValue ();
+      NS_TEST_ASSERT_MSG_EQ (values[i], value, name << " bulk value " << i << " differs");
+    }
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      double bulkValue = copy.GetValue ();
+      double value = variable.GetValue ();
+      NS_TEST_ASSERT_MSG_EQ (bulkValue, value, name << " value after bulk draws differs");
+    }
+}
+
+void
+BulkRandomNumberTestCase::DoRun (void)
+{
+  CheckStream (false, false);
+  CheckStream (true, false);
+  CheckStream (false, true);
+  CheckStream (true, true);
+
+  CheckVariable (UniformVariable (2, 5), "Uniform");
+  CheckVariable (ExponentialVariable (1), "Exponential");
+  // A bound which rejects about one value in five
+  CheckVariable (ExponentialVariable (1, 1.6), "Bounded exponential");
+  CheckVariable (NormalVariable (0, 1), "Normal");
+  CheckVariable (NormalVariable (0, 1, 1.0), "Bounded normal");
+  CheckVariable (ParetoVariable (1, 1.5), "Pareto");
+}
+
 class BasicRandomNumberTestSuite : public TestSuite
 {
 public:
@@ -140,6 +324,8 @@ BasicRandomNumberTestSuite::BasicRandomNumberTestSuite ()
 {
   AddTestCase (new BasicRandomNumberTestCase);
   AddTestCase (new RandomNumberSerializationTestCase);
+  AddTestCase (new DiscreteRandomNumberTestCase);
+  AddTestCase (new BulkRandomNumberTestCase);
 }
 
 static BasicRandomNumberTestSuite BasicRandomNumberTestSuite;
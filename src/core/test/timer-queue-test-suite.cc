@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/timer-queue.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include <vector>
+
+namespace ns3 {
+
+class TimerQueueTestCase : public TestCase
+{
+public:
+  TimerQueueTestCase ();
+  virtual void DoRun (void);
+  void Expire (uint32_t id);
+  void Reschedule (void);
+  Callback<void> MakeExpire (uint32_t id);
+
+  // records the expiration of the timer id
+  struct Timer
+  {
+    void Expire (void) { test->Expire (id); }
+    TimerQueueTestCase *test;
+    uint32_t id;
+  };
+
+  Timer m_timers[12];
+  Ptr<TimerQueue> m_queue;
+  std::vector<Time> m_expired;
+  std::vector<uint32_t> m_ids;
+  TimerQueue::Event m_cancelled;
+};
+
+TimerQueueTestCase::TimerQueueTestCase ()
+  : TestCase ("Check the expiration times of the timers of a timer queue")
+{
+}
+
+void
+TimerQueueTestCase::Expire (uint32_t id)
+{
+  m_expired.push_back (Simulator::Now ());
+  m_ids.push_back (id);
+}
+
+Callback<void>
+TimerQueueTestCase::MakeExpire (uint32_t id)
+{
+  m_timers[id].test = this;
+  m_timers[id].id = id;
+  return MakeCallback (&Timer::Expire, &m_timers[id]);
+}
+
+void
+TimerQueueTestCase::Reschedule (void)
+{
+  Expire (7);
+  m_cancelled.Cancel ();
+  m_queue->Schedule (Seconds (0), MakeExpire (10));
+  m_queue->Schedule (MicroSeconds (1), MakeExpire (11));
+}
+
+void
+TimerQueueTestCase::DoRun (void)
+{
+  m_queue = CreateObject<TimerQueue> ();
+
+  m_queue->Schedule (MilliSeconds (25), MakeExpire (1));
+  m_queue->Schedule (MilliSeconds (30), MakeExpire (2));
+  m_queue->Schedule (Seconds (3000), MakeExpire (3));
+  m_queue->Schedule (Seconds (100), MakeExpire (4));
+  m_queue->Schedule (MilliSeconds (30), MakeExpire (5));
+  TimerQueue::Event event = m_queue->Schedule (Seconds (10), MakeExpire (6));
+  NS_TEST_EXPECT_MSG_EQ (event.IsRunning (), true, "The timer is running");
+  event.Cancel ();
+  NS_TEST_EXPECT_MSG_EQ (event.IsRunning (), false, "The timer was cancelled");
+  // a timer may cancel a timer which expires at the same time and
+  // schedule other ones.
+  m_queue->Schedule (MilliSeconds (7002), MakeCallback (&TimerQueueTestCase::Reschedule, this));
+  m_cancelled = m_queue->Schedule (MilliSeconds (7002), MakeExpire (8));
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNTimers (), 7, "Seven timers are running");
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_expired.size (), 8, "Eight timers expired");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[0], MilliSeconds (25), "First timer");
+  NS_TEST_EXPECT_MSG_EQ (m_ids[0], 1, "First timer");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[1], MilliSeconds (30), "Second timer");
+  NS_TEST_EXPECT_MSG_EQ (m_ids[1], 2, "Second timer");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[2], MilliSeconds (30), "Timer which expires at the same time");
+  NS_TEST_EXPECT_MSG_EQ (m_ids[2], 5, "Timers which expire at the same time, in schedule order");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[3], MilliSeconds (7002), "Rescheduling timer");
+  NS_TEST_EXPECT_MSG_EQ (m_ids[3], 7, "Rescheduling timer");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[4], MilliSeconds (7002), "Timer scheduled with no delay");
+  NS_TEST_EXPECT_MSG_EQ (m_ids[4], 10, "Timer scheduled with no delay");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[5], MilliSeconds (7002) + MicroSeconds (1), "Timer scheduled by a timer");
+  NS_TEST_EXPECT_MSG_EQ (m_ids[5], 11, "Timer scheduled by a timer");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[6], Seconds (100), "Sixth timer");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[7], Seconds (3000), "Last timer");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNTimers (), 0, "No timer is running");
+  NS_TEST_EXPECT_MSG_EQ ((m_queue->GetNEvents () <= 7), true, "One simulator event per expiration time");
+
+  // an earlier timer moves the event of the queue.
+  m_expired.clear ();
+  m_ids.clear ();
+  m_queue->Schedule (Seconds (2), MakeExpire (1));
+  m_queue->Schedule (Seconds (1), MakeExpire (2));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_expired.size (), 2, "The timers expired");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[0], Seconds (3001), "Earlier timer");
+  NS_TEST_EXPECT_MSG_EQ (m_ids[0], 2, "Earlier timer");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[1], Seconds (3002), "Later timer");
+
+  m_queue->Dispose ();
+  m_queue = 0;
+  Simulator::Destroy ();
+}
+
+static class TimerQueueTestSuite : public TestSuite
+{
+public:
+  TimerQueueTestSuite ()
+    : TestSuite ("timer-queue", UNIT)
+  {
+    AddTestCase (new TimerQueueTestCase ());
+  }
+} g_timerQueueTestSuite;
+
+} // namespace ns3
@@ -18,6 +18,7 @@
 
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
+#include "ns3/trace-context.h"
 
 using namespace ns3;
 
@@ -108,6 +109,83 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class ContextTracedCallbackTestCase : public TestCase
+{
+public:
+  ContextTracedCallbackTestCase ();
+  virtual ~ContextTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbString (std::string context, uint8_t a);
+  void CbContext (TraceContext context, uint8_t a);
+
+  std::string m_string;
+  TraceContext m_context;
+};
+
+ContextTracedCallbackTestCase::ContextTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback operation with a context")
+{
+}
+
+void
+ContextTracedCallbackTestCase::CbString (std::string context, uint8_t a)
+{
+  m_string = context;
+}
+
+void
+ContextTracedCallbackTestCase::CbContext (TraceContext context, uint8_t a)
+{
+  m_context = context;
+}
+
+void
+ContextTracedCallbackTestCase::DoRun (void)
+{
+  //
+  // The same path is interned once, and the node and device indexes are
+  // extracted from the path.
+  //
+  TraceContext context = TraceContext ("/NodeList/12/DeviceList/3/Mac/MacTx");
+  NS_TEST_ASSERT_MSG_EQ ((context == TraceContext ("/NodeList/12/DeviceList/3/Mac/MacTx")), true, "Context not interned");
+  NS_TEST_ASSERT_MSG_EQ (context.GetPath (), "/NodeList/12/DeviceList/3/Mac/MacTx", "Wrong path");
+  NS_TEST_ASSERT_MSG_EQ (context.HasNodeId (), true, "Node id not found");
+  NS_TEST_ASSERT_MSG_EQ (context.GetNodeId (), 12, "Wrong node id");
+  NS_TEST_ASSERT_MSG_EQ (context.HasDeviceId (), true, "Device id not found");
+  NS_TEST_ASSERT_MSG_EQ (context.GetDeviceId (), 3, "Wrong device id");
+
+  context = TraceContext ("/NodeList/5/$ns3::Ipv4L3Protocol/Tx");
+  NS_TEST_ASSERT_MSG_EQ (context.HasNodeId (), true, "Node id not found");
+  NS_TEST_ASSERT_MSG_EQ (context.GetNodeId (), 5, "Wrong node id");
+  NS_TEST_ASSERT_MSG_EQ (context.HasDeviceId (), false, "Unexpected device id");
+
+  context = TraceContext ("/Names/client/DeviceList/1/Mac/MacTx");
+  NS_TEST_ASSERT_MSG_EQ (context.HasNodeId (), false, "Unexpected node id");
+  NS_TEST_ASSERT_MSG_EQ (context.HasDeviceId (), false, "Unexpected device id");
+
+  //
+  // Callbacks which take either a string or a TraceContext as their first
+  // argument can be connected with a context, and disconnected.
+  //
+  TracedCallback<uint8_t> trace;
+  trace.Connect (MakeCallback (&ContextTracedCallbackTestCase::CbString, this), "/NodeList/1/DeviceList/0/Rx");
+  trace.Connect (MakeCallback (&ContextTracedCallbackTestCase::CbContext, this), "/NodeList/1/DeviceList/0/Rx");
+  trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_string, "/NodeList/1/DeviceList/0/Rx", "Callback CbString not called");
+  NS_TEST_ASSERT_MSG_EQ (m_context.GetPath (), "/NodeList/1/DeviceList/0/Rx", "Callback CbContext not called");
+  NS_TEST_ASSERT_MSG_EQ (m_context.GetNodeId (), 1, "Wrong node id");
+
+  trace.Disconnect (MakeCallback (&ContextTracedCallbackTestCase::CbContext, this), "/NodeList/1/DeviceList/0/Rx");
+  m_string = "";
+  m_context = TraceContext ();
+  trace (2);
+  NS_TEST_ASSERT_MSG_EQ (m_string, "/NodeList/1/DeviceList/0/Rx", "Callback CbString not called");
+  NS_TEST_ASSERT_MSG_EQ (m_context.GetPath (), "", "Callback CbContext called after Disconnect");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -118,6 +196,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase);
+  AddTestCase (new ContextTracedCallbackTestCase);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
@@ -18,6 +18,7 @@
 // Author: Gustavo J. A. M. Carneiro  <gjc@inescporto.pt> <gjcarneiro@gmail.com>
 //
 
+#include <string.h>
 #include "ns3/packet.h"
 
 #include "ipv4-flow-classifier.h"
@@ -114,24 +115,25 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
   tuple.destinationAddress = ipHeader.GetDestination ();
   tuple.protocol = ipHeader.GetProtocol ();
 
+  // only the ports are read, in place, rather than the whole header.
+  uint8_t scratch[4];
+  uint8_t const *bytes = scratch;
+  memset (scratch, 0, sizeof (scratch));
+  if (ipPayload->GetSize () >= sizeof (scratch))
+    {
+      bytes = ipPayload->PeekBytes (sizeof (scratch), scratch);
+    }
+
   switch (tuple.protocol)
     {
     case UDP_PROT_NUMBER:
-      {
-        UdpHeader udpHeader;
-        ipPayload->PeekHeader (udpHeader);
-        tuple.sourcePort = udpHeader.GetSourcePort ();
-        tuple.destinationPort = udpHeader.GetDestinationPort ();
-      }
+      tuple.sourcePort = UdpHeader::Layout::SourcePort::Read (bytes);
+      tuple.destinationPort = UdpHeader::Layout::DestinationPort::Read (bytes);
       break;
 
     case TCP_PROT_NUMBER:
-      {
-        TcpHeader tcpHeader;
-        ipPayload->PeekHeader (tcpHeader);
-        tuple.sourcePort = tcpHeader.GetSourcePort ();
-        tuple.destinationPort = tcpHeader.GetDestinationPort ();
-      }
+      tuple.sourcePort = TcpHeader::Layout::SourcePort::Read (bytes);
+      tuple.destinationPort = TcpHeader::Layout::DestinationPort::Read (bytes);
       break;
 
     default:
@@ -160,6 +160,7 @@
 #include "ns3/string.h"
 #include "ns3/net-device.h"
 #include "ns3/callback.h"
+#include "ns3/trace-context.h"
 #include "ns3/node.h"
 #include "ns3/core-config.h"
 #include "ns3/arp-l3-protocol.h"
@@ -659,7 +660,7 @@ Ipv4L3ProtocolRxSinkWithoutContext (
 static void
 Ipv4L3ProtocolDropSinkWithContext (
   Ptr<OutputStreamWrapper> stream,
-  std::string context,
+  TraceContext context,
   Ipv4Header const &header, 
   Ptr<const Packet> packet,
   Ipv4L3Protocol::DropReason reason, 
@@ -692,7 +693,7 @@ Ipv4L3ProtocolDropSinkWithContext (
 static void
 Ipv4L3ProtocolTxSinkWithContext (
   Ptr<OutputStreamWrapper> stream,
-  std::string context,
+  TraceContext context,
   Ptr<const Packet> packet,
   Ptr<Ipv4> ipv4, 
   uint32_t interface)
@@ -715,7 +716,7 @@ Ipv4L3ProtocolTxSinkWithContext (
 static void
 Ipv4L3ProtocolRxSinkWithContext (
   Ptr<OutputStreamWrapper> stream,
-  std::string context,
+  TraceContext context,
   Ptr<const Packet> packet,
   Ptr<Ipv4> ipv4, 
   uint32_t interface)
@@ -864,7 +865,7 @@ InternetStackHelper::EnableAsciiIpv4Internal (
       // functions that are always there waiting for just such a case.
       //
       oss << "/NodeList/" << node->GetId () << "/$ns3::ArpL3Protocol/Drop";
-      Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithContext, stream));
+      Config::Connect (oss.str (), MakeBoundCallback (&AsciiTraceHelper::DefaultDropSinkWithTraceContext, stream));
 
       //
       // This has all kinds of parameters coming with, so we have to cook up our
@@ -948,7 +949,7 @@ Ipv6L3ProtocolRxSinkWithoutContext (
 static void
 Ipv6L3ProtocolDropSinkWithContext (
   Ptr<OutputStreamWrapper> stream,
-  std::string context,
+  TraceContext context,
   Ipv6Header const &header, 
   Ptr<const Packet> packet,
   Ipv6L3Protocol::DropReason reason, 
@@ -981,7 +982,7 @@ Ipv6L3ProtocolDropSinkWithContext (
 static void
 Ipv6L3ProtocolTxSinkWithContext (
   Ptr<OutputStreamWrapper> stream,
-  std::string context,
+  TraceContext context,
   Ptr<const Packet> packet,
   Ptr<Ipv6> ipv6, 
   uint32_t interface)
@@ -1004,7 +1005,7 @@ Ipv6L3ProtocolTxSinkWithContext (
 static void
 Ipv6L3ProtocolRxSinkWithContext (
   Ptr<OutputStreamWrapper> stream,
-  std::string context,
+  TraceContext context,
   Ptr<const Packet> packet,
   Ptr<Ipv6> ipv6, 
   uint32_t interface)
@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <algorithm>
+#include "fragment-intervals.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+NS_LOG_COMPONENT_DEFINE ("FragmentIntervals");
+
+namespace ns3 {
+
+FragmentIntervals::FragmentIntervals ()
+  : m_size (0),
+    m_lengthKnown (false),
+    m_length (0)
+{
+}
+
+int32_t
+FragmentIntervals::AddFragment (Ptr<Packet> fragment, uint32_t offset, bool moreFragments)
+{
+  NS_LOG_FUNCTION (this << fragment << offset << moreFragments);
+  uint32_t size = m_size;
+  uint32_t end = offset + fragment->GetSize ();
+  if (!moreFragments && !m_lengthKnown)
+    {
+      m_lengthKnown = true;
+      m_length = end;
+      // drop what was received beyond the end of the datagram.
+      Intervals::iterator it = m_intervals.lower_bound (m_length);
+      for (Intervals::iterator i = it; i != m_intervals.end (); ++i)
+        {
+          m_size -= i->second->GetSize ();
+        }
+      m_intervals.erase (it, m_intervals.end ());
+      if (!m_intervals.empty ())
+        {
+          Intervals::iterator last = m_intervals.end ();
+          --last;
+          uint32_t lastEnd = last->first + last->second->GetSize ();
+          if (lastEnd > m_length)
+            {
+              m_size -= lastEnd - m_length;
+              last->second = last->second->CreateFragment (0, m_length - last->first);
+            }
+        }
+    }
+  if (m_lengthKnown && end > m_length)
+    {
+      end = m_length;
+    }
+  if (offset >= end)
+    {
+      return static_cast<int32_t> (m_size - size);
+    }
+
+  // store the gaps between the intervals which overlap [offset, end).
+  uint32_t stored = 0;
+  uint32_t cursor = offset;
+  Intervals::iterator next = m_intervals.upper_bound (offset);
+  if (next != m_intervals.begin ())
+    {
+      Intervals::iterator previous = next;
+      --previous;
+      uint32_t previousEnd = previous->first + previous->second->GetSize ();
+      cursor = std::max (cursor, previousEnd);
+    }
+  while (cursor < end)
+    {
+      uint32_t gapEnd = end;
+      if (next != m_intervals.end () && next->first < end)
+        {
+          gapEnd = next->first;
+        }
+      if (gapEnd > cursor)
+        {
+          Insert (fragment, offset, cursor, gapEnd);
+          stored += gapEnd - cursor;
+        }
+      if (next == m_intervals.end () || next->first >= end)
+        {
+          break;
+        }
+      cursor = std::max (cursor, next->first + next->second->GetSize ());
+      ++next;
+    }
+  m_size += stored;
+  return static_cast<int32_t> (m_size - size);
+}
+
+void
+FragmentIntervals::Insert (Ptr<Packet> fragment, uint32_t offset, uint32_t start, uint32_t end)
+{
+  if (start == offset && end == offset + fragment->GetSize ())
+    {
+      m_intervals[start] = fragment;
+    }
+  else
+    {
+      m_intervals[start] = fragment->CreateFragment (start - offset, end - start);
+    }
+}
+
+bool
+FragmentIntervals::IsEntire (void) const
+{
+  return m_lengthKnown && m_size == m_length;
+}
+
+Ptr<Packet>
+FragmentIntervals::GetPacket (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (IsEntire ());
+  if (m_intervals.empty ())
+    {
+      return Create<Packet> ();
+    }
+  Intervals::const_iterator it = m_intervals.begin ();
+  Ptr<Packet> p = it->second->Copy ();
+  for (++it; it != m_intervals.end (); ++it)
+    {
+      p->AddAtEnd (it->second);
+    }
+  return p;
+}
+
+Ptr<Packet>
+FragmentIntervals::GetPartialPacket (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<Packet> p = Create<Packet> ();
+  uint32_t end = 0;
+  for (Intervals::const_iterator it = m_intervals.begin (); it != m_intervals.end () && it->first == end; ++it)
+    {
+      p->AddAtEnd (it->second);
+      end += it->second->GetSize ();
+    }
+  return p;
+}
+
+uint32_t
+FragmentIntervals::GetSize (void) const
+{
+  return m_size;
+}
+
+} // namespace ns3
@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef FRAGMENT_INTERVALS_H
+#define FRAGMENT_INTERVALS_H
+
+#include <stdint.h>
+#include <map>
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ * \brief The fragments of a datagram being reassembled, kept as disjoint
+ * byte intervals sorted by offset
+ *
+ * The bytes of a new fragment which overlap the bytes already received
+ * are discarded, such that the intervals never overlap: adding a
+ * fragment is logarithmic in the number of intervals, and the number of
+ * bytes received, compared to the length of the datagram once its last
+ * fragment was received, tells in constant time whether the datagram is
+ * complete.  The datagram is concatenated once, when it is complete.
+ *
+ * Used by Ipv4L3Protocol and Ipv6ExtensionFragment.
+ */
+class FragmentIntervals
+{
+public:
+  FragmentIntervals ();
+
+  /**
+   * \param fragment the payload of the fragment
+   * \param offset the offset of the payload in the datagram, in bytes
+   * \param moreFragments false if this is the last fragment of the
+   *        datagram
+   * \returns the change of the number of bytes stored: the bytes of the
+   *          fragment already received, and the bytes after the end of
+   *          the datagram, are discarded.  It is negative when the last
+   *          fragment discards bytes stored beyond the end of the datagram.
+   */
+  int32_t AddFragment (Ptr<Packet> fragment, uint32_t offset, bool moreFragments);
+  /**
+   * \returns true if all the bytes of the datagram were received.
+   */
+  bool IsEntire (void) const;
+  /**
+   * \returns the payload of the datagram.  It must be entire.
+   */
+  Ptr<Packet> GetPacket (void) const;
+  /**
+   * \returns the bytes received from the start of the payload of the
+   *          datagram up to the first missing byte.
+   */
+  Ptr<Packet> GetPartialPacket (void) const;
+  /**
+   * \returns the number of bytes stored.
+   */
+  uint32_t GetSize (void) const;
+
+private:
+  void Insert (Ptr<Packet> fragment, uint32_t offset, uint32_t start, uint32_t end);
+
+  // offset of the first byte -> bytes
+  typedef std::map<uint32_t, Ptr<Packet> > Intervals;
+
+  Intervals m_intervals;
+  uint32_t m_size;
+  bool m_lengthKnown;
+  uint32_t m_length;
+};
+
+} // namespace ns3
+
+#endif /* FRAGMENT_INTERVALS_H */
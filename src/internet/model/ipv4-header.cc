@@ -40,7 +40,8 @@ Ipv4Header::Ipv4Header ()
     m_flags (0),
     m_fragmentOffset (0),
     m_checksum (0),
-    m_goodChecksum (true)
+    m_goodChecksum (true),
+    m_checksumValid (false)
 {
 }
 
@@ -53,6 +54,7 @@ Ipv4Header::EnableChecksum (void)
 void
 Ipv4Header::SetPayloadSize (uint16_t size)
 {
+  m_checksumValid = false;
   m_payloadSize = size;
 }
 uint16_t
@@ -69,18 +71,21 @@ Ipv4Header::GetIdentification (void) const
 void
 Ipv4Header::SetIdentification (uint16_t identification)
 {
+  m_checksumValid = false;
   m_identification = identification;
 }
 
 void 
 Ipv4Header::SetTos (uint8_t tos)
 {
+  m_checksumValid = false;
   m_tos = tos;
 }
 
 void
 Ipv4Header::SetDscp (DscpType dscp)
 {
+  m_checksumValid = false;
   m_tos &= 0x3; // Clear out the DSCP part, retain 2 bits of ECN
   m_tos |= dscp;
 }
@@ -88,6 +93,7 @@ Ipv4Header::SetDscp (DscpType dscp)
 void
 Ipv4Header::SetEcn (EcnType ecn)
 {
+  m_checksumValid = false;
   m_tos &= 0xFC; // Clear out the ECN part, retain 6 bits of DSCP
   m_tos |= ecn;
 }
@@ -185,11 +191,13 @@ Ipv4Header::GetTos (void) const
 void 
 Ipv4Header::SetMoreFragments (void)
 {
+  m_checksumValid = false;
   m_flags |= MORE_FRAGMENTS;
 }
 void
 Ipv4Header::SetLastFragment (void)
 {
+  m_checksumValid = false;
   m_flags &= ~MORE_FRAGMENTS;
 }
 bool 
@@ -201,11 +209,13 @@ Ipv4Header::IsLastFragment (void) const
 void 
 Ipv4Header::SetDontFragment (void)
 {
+  m_checksumValid = false;
   m_flags |= DONT_FRAGMENT;
 }
 void 
 Ipv4Header::SetMayFragment (void)
 {
+  m_checksumValid = false;
   m_flags &= ~DONT_FRAGMENT;
 }
 bool 
@@ -220,6 +230,7 @@ Ipv4Header::SetFragmentOffset (uint16_t offsetBytes)
   // check if the user is trying to set an invalid offset
   NS_ABORT_MSG_IF ((offsetBytes & 0x7), "offsetBytes must be multiple of 8 bytes");
   m_fragmentOffset = offsetBytes;
+  m_checksumValid = false;
 }
 uint16_t 
 Ipv4Header::GetFragmentOffset (void) const
@@ -235,6 +246,22 @@ Ipv4Header::GetFragmentOffset (void) const
 void 
 Ipv4Header::SetTtl (uint8_t ttl)
 {
+  if (m_checksumValid)
+    {
+      // RFC 1624 incremental update: HC' = ~(~HC + ~m + m') where m is
+      // the 16-bit word which holds the ttl and the protocol, read in
+      // the byte order of Buffer::Iterator::ReadU16.
+      uint16_t oldWord = m_ttl | (m_protocol << 8);
+      uint16_t newWord = ttl | (m_protocol << 8);
+      uint32_t sum = static_cast<uint16_t> (~m_checksum);
+      sum += static_cast<uint16_t> (~oldWord);
+      sum += newWord;
+      while (sum >> 16)
+        {
+          sum = (sum & 0xffff) + (sum >> 16);
+        }
+      m_checksum = ~sum;
+    }
   m_ttl = ttl;
 }
 uint8_t 
@@ -251,12 +278,14 @@ Ipv4Header::GetProtocol (void) const
 void 
 Ipv4Header::SetProtocol (uint8_t protocol)
 {
+  m_checksumValid = false;
   m_protocol = protocol;
 }
 
 void 
 Ipv4Header::SetSource (Ipv4Address source)
 {
+  m_checksumValid = false;
   m_source = source;
 }
 Ipv4Address
@@ -268,6 +297,7 @@ Ipv4Header::GetSource (void) const
 void 
 Ipv4Header::SetDestination (Ipv4Address dst)
 {
+  m_checksumValid = false;
   m_destination = dst;
 }
 Ipv4Address
@@ -347,31 +377,30 @@ Ipv4Header::Serialize (Buffer::Iterator start) const
 {
   Buffer::Iterator i = start;
 
-  uint8_t verIhl = (4 << 4) | (5);
-  i.WriteU8 (verIhl);
-  i.WriteU8 (m_tos);
-  i.WriteHtonU16 (m_payloadSize + 5*4);
-  i.WriteHtonU16 (m_identification);
-  uint32_t fragmentOffset = m_fragmentOffset / 8;
-  uint8_t flagsFrag = (fragmentOffset >> 8) & 0x1f;
+  uint8_t header[Layout::SIZE];
+  Layout::VersionIhl::Write (header, (4 << 4) | (5));
+  Layout::Tos::Write (header, m_tos);
+  Layout::TotalLength::Write (header, m_payloadSize + 5*4);
+  Layout::Identification::Write (header, m_identification);
+  uint16_t flagsFragment = (m_fragmentOffset / 8) & Layout::FRAGMENT_OFFSET;
   if (m_flags & DONT_FRAGMENT) 
     {
-      flagsFrag |= (1<<6);
+      flagsFragment |= Layout::DONT_FRAGMENT;
     }
   if (m_flags & MORE_FRAGMENTS) 
     {
-      flagsFrag |= (1<<5);
+      flagsFragment |= Layout::MORE_FRAGMENTS;
     }
-  i.WriteU8 (flagsFrag);
-  uint8_t frag = fragmentOffset & 0xff;
-  i.WriteU8 (frag);
-  i.WriteU8 (m_ttl);
-  i.WriteU8 (m_protocol);
-  i.WriteHtonU16 (0);
-  i.WriteHtonU32 (m_source.Get ());
-  i.WriteHtonU32 (m_destination.Get ());
-
-  if (m_calcChecksum) 
+  Layout::FlagsFragmentOffset::Write (header, flagsFragment);
+  Layout::Ttl::Write (header, m_ttl);
+  Layout::Protocol::Write (header, m_protocol);
+  // the checksum of the deserialized header was kept up to date by SetTtl
+  Layout::Checksum::Write (header, m_checksumValid ? m_checksum : 0);
+  Layout::Source::Write (header, m_source.Get ());
+  Layout::Destination::Write (header, m_destination.Get ());
+  i.Write (header, Layout::SIZE);
+
+  if (!m_checksumValid && m_calcChecksum) 
     {
       i = start;
       uint16_t checksum = i.CalculateIpChecksum (20);
@@ -385,35 +414,32 @@ uint32_t
 Ipv4Header::Deserialize (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
-  uint8_t verIhl = i.ReadU8 ();
+  uint8_t header[Layout::SIZE];
+  i.Read (header, Layout::SIZE);
+  uint8_t verIhl = Layout::VersionIhl::Read (header);
   uint8_t ihl = verIhl & 0x0f; 
   uint16_t headerSize = ihl * 4;
   NS_ASSERT ((verIhl >> 4) == 4);
-  m_tos = i.ReadU8 ();
-  uint16_t size = i.ReadNtohU16 ();
+  m_tos = Layout::Tos::Read (header);
+  uint16_t size = Layout::TotalLength::Read (header);
   m_payloadSize = size - headerSize;
-  m_identification = i.ReadNtohU16 ();
-  uint8_t flags = i.ReadU8 ();
+  m_identification = Layout::Identification::Read (header);
+  uint16_t flagsFragment = Layout::FlagsFragmentOffset::Read (header);
   m_flags = 0;
-  if (flags & (1<<6)) 
+  if (flagsFragment & Layout::DONT_FRAGMENT) 
     {
       m_flags |= DONT_FRAGMENT;
     }
-  if (flags & (1<<5)) 
+  if (flagsFragment & Layout::MORE_FRAGMENTS) 
     {
       m_flags |= MORE_FRAGMENTS;
     }
-  i.Prev ();
-  m_fragmentOffset = i.ReadU8 () & 0x1f;
-  m_fragmentOffset <<= 8;
-  m_fragmentOffset |= i.ReadU8 ();
-  m_fragmentOffset <<= 3;
-  m_ttl = i.ReadU8 ();
-  m_protocol = i.ReadU8 ();
-  m_checksum = i.ReadU16 ();
-  /* i.Next (2); // checksum */
-  m_source.Set (i.ReadNtohU32 ());
-  m_destination.Set (i.ReadNtohU32 ());
+  m_fragmentOffset = (flagsFragment & Layout::FRAGMENT_OFFSET) << 3;
+  m_ttl = Layout::Ttl::Read (header);
+  m_protocol = Layout::Protocol::Read (header);
+  m_checksum = Layout::Checksum::Read (header);
+  m_source.Set (Layout::Source::Read (header));
+  m_destination.Set (Layout::Destination::Read (header));
 
   if (m_calcChecksum) 
     {
@@ -423,6 +449,10 @@ Ipv4Header::Deserialize (Buffer::Iterator start)
 
       m_goodChecksum = (checksum == 0);
     }
+  // The header can be serialized again with its received checksum only
+  // if Serialize writes back the same bytes: no options, no reserved flag.
+  m_checksumValid = m_calcChecksum && m_goodChecksum &&
+    headerSize == 20 && (flagsFragment & 0x8000) == 0;
   return GetSerializedSize ();
 }
 
@@ -22,6 +22,7 @@
 #define IPV4_HEADER_H
 
 #include "ns3/header.h"
+#include "ns3/header-layout.h"
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -139,6 +140,10 @@ public:
   void SetFragmentOffset (uint16_t offsetBytes);
   /**
    * \param ttl the ipv4 TTL
+   *
+   * If this header was deserialized with a valid checksum, the checksum
+   * is updated incrementally (RFC 1624) rather than recomputed by the
+   * next Serialize, as done when forwarding a packet.
    */
   void SetTtl (uint8_t ttl);
   /**
@@ -224,6 +229,31 @@ public:
   virtual uint32_t GetSerializedSize (void) const;
   virtual void Serialize (Buffer::Iterator start) const;
   virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  /**
+   * \brief The fields of a serialized header without options
+   *
+   * Used by Serialize and Deserialize, and to read the fields of the
+   * header of a packet without deserializing it, see Packet::PeekBytes.
+   * The multi-byte fields are in network order, except the checksum,
+   * which is kept in the order of the bytes of the header.
+   */
+  struct Layout
+  {
+    enum { SIZE = 20 };
+    typedef HeaderField<0, uint8_t> VersionIhl;
+    typedef HeaderField<1, uint8_t> Tos;
+    typedef HeaderField<2, uint16_t> TotalLength;
+    typedef HeaderField<4, uint16_t> Identification;
+    // the flags in the 3 high bits, the offset in units of 8 bytes below.
+    typedef HeaderField<6, uint16_t> FlagsFragmentOffset;
+    typedef HeaderField<8, uint8_t> Ttl;
+    typedef HeaderField<9, uint8_t> Protocol;
+    typedef HeaderLsbField<10, uint16_t> Checksum;
+    typedef HeaderField<12, uint32_t> Source;
+    typedef HeaderField<16, uint32_t> Destination;
+    enum { DONT_FRAGMENT = 0x4000, MORE_FRAGMENTS = 0x2000, FRAGMENT_OFFSET = 0x1fff };
+  };
 private:
 
   enum FlagsE {
@@ -244,6 +274,9 @@ private:
   Ipv4Address m_destination;
   uint16_t m_checksum;
   bool m_goodChecksum;
+  // true if m_checksum holds the checksum of the current fields: it is
+  // set by a checked Deserialize and maintained incrementally by SetTtl.
+  bool m_checksumValid;
 };
 
 } // namespace ns3
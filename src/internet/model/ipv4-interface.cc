@@ -79,6 +79,7 @@ Ipv4Interface::DoDispose (void)
   NS_LOG_FUNCTION_NOARGS ();
   m_node = 0;
   m_device = 0;
+  m_addressChangeCallback = MakeNullCallback<void> ();
   Object::DoDispose ();
 }
 
@@ -290,6 +291,10 @@ Ipv4Interface::AddAddress (Ipv4InterfaceAddress addr)
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_ifaddrs.push_back (addr);
+  if (!m_addressChangeCallback.IsNull ())
+    {
+      m_addressChangeCallback ();
+    }
   return true;
 }
 
@@ -330,6 +335,10 @@ Ipv4Interface::RemoveAddress (uint32_t index)
         {
           Ipv4InterfaceAddress addr = *i;
           m_ifaddrs.erase (i);
+          if (!m_addressChangeCallback.IsNull ())
+            {
+              m_addressChangeCallback ();
+            }
           return addr;
         }
       ++tmp;
@@ -340,5 +349,11 @@ Ipv4Interface::RemoveAddress (uint32_t index)
   return (addr);  // quiet compiler
 }
 
+void
+Ipv4Interface::SetAddressChangeCallback (Callback<void> callback)
+{
+  m_addressChangeCallback = callback;
+}
+
 } // namespace ns3
 
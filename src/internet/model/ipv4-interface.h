@@ -27,6 +27,7 @@
 #include "ns3/ipv4-interface-address.h"
 #include "ns3/ptr.h"
 #include "ns3/object.h"
+#include "ns3/callback.h"
 
 namespace ns3 {
 
@@ -152,6 +153,14 @@ public:
    */
   Ipv4InterfaceAddress RemoveAddress (uint32_t index);
 
+  /**
+   * \param callback invoked each time an address is added to or
+   *        removed from this interface
+   *
+   * Ipv4L3Protocol uses it to maintain its address indexes.
+   */
+  void SetAddressChangeCallback (Callback<void> callback);
+
 protected:
   virtual void DoDispose (void);
 private:
@@ -164,6 +173,7 @@ private:
   bool m_forwarding;  // IN_DEV_FORWARD
   uint16_t m_metric;
   Ipv4InterfaceAddressList m_ifaddrs;
+  Callback<void> m_addressChangeCallback;
   Ptr<Node> m_node;
   Ptr<NetDevice> m_device;
   Ptr<ArpCache> m_cache; 
@@ -64,6 +64,11 @@ Ipv4L3Protocol::GetTypeId (void)
                    TimeValue (Seconds (30)),
                    MakeTimeAccessor (&Ipv4L3Protocol::m_fragmentExpirationTimeout),
                    MakeTimeChecker ())
+    .AddAttribute ("FragmentBufferSize",
+                   "The maximum number of bytes of the fragments of the packets being reassembled: the fragments received beyond are dropped.",
+                   UintegerValue (4194304),
+                   MakeUintegerAccessor (&Ipv4L3Protocol::m_fragmentBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
     .AddTraceSource ("Tx", "Send ipv4 packet to outgoing interface.",
                      MakeTraceSourceAccessor (&Ipv4L3Protocol::m_txTrace))
     .AddTraceSource ("Rx", "Receive ipv4 packet from incoming interface.",
@@ -87,7 +92,11 @@ Ipv4L3Protocol::GetTypeId (void)
 }
 
 Ipv4L3Protocol::Ipv4L3Protocol()
-  : m_identification (0)
+  : m_interfaceIndexValid (false),
+    m_identification (0),
+    m_fragmentBufferUsage (0),
+    m_nFragmentsDropped (0),
+    m_nReassemblyTimeouts (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -201,25 +210,20 @@ Ipv4L3Protocol::DoDispose (void)
       *i = 0;
     }
   m_interfaces.clear ();
+  InvalidateInterfaceIndex ();
   m_sockets.clear ();
   m_node = 0;
   m_routingProtocol = 0;
 
   for (MapFragments_t::iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
     {
+      it->second->CancelTimeout ();
       it->second = 0;
     }
 
-  for (MapFragmentsTimers_t::iterator it = m_fragmentsTimers.begin (); it != m_fragmentsTimers.end (); it++)
-    {
-      if (it->second.IsRunning ())
-        {
-          it->second.Cancel ();
-        }
-    }
-
   m_fragments.clear ();
-  m_fragmentsTimers.clear ();
+  m_fragmentBufferUsage = 0;
+  m_timerQueue = 0;
 
   Object::DoDispose ();
 }
@@ -289,6 +293,8 @@ Ipv4L3Protocol::AddIpv4Interface (Ptr<Ipv4Interface>interface)
   NS_LOG_FUNCTION (this << interface);
   uint32_t index = m_interfaces.size ();
   m_interfaces.push_back (interface);
+  interface->SetAddressChangeCallback (MakeCallback (&Ipv4L3Protocol::InvalidateInterfaceIndex, this));
+  InvalidateInterfaceIndex ();
   return index;
 }
 
@@ -308,24 +314,65 @@ Ipv4L3Protocol::GetNInterfaces (void) const
   return m_interfaces.size ();
 }
 
-int32_t 
-Ipv4L3Protocol::GetInterfaceForAddress (
-  Ipv4Address address) const
+size_t
+Ipv4L3Protocol::NetDevicePtrHash::operator() (const NetDevice *device) const
+{
+  return reinterpret_cast<size_t> (device) / sizeof (void *);
+}
+
+size_t
+Ipv4L3Protocol::FragmentsKeyHash::operator() (const FragmentsKey &key) const
+{
+  uint64_t h = key.first ^ (uint64_t (key.second) * 0x9e3779b97f4a7c15ULL);
+  return static_cast<size_t> (h ^ (h >> 32));
+}
+
+void
+Ipv4L3Protocol::InvalidateInterfaceIndex (void)
+{
+  m_interfaceIndexValid = false;
+  m_localAddressIndex.clear ();
+  m_broadcastAddressIndex.clear ();
+  m_deviceIndex.clear ();
+  m_prefixIndex.clear ();
+}
+
+void
+Ipv4L3Protocol::UpdateInterfaceIndex (void) const
 {
+  if (m_interfaceIndexValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  // insert keeps the first interface which has an address or a device,
+  // as the linear searches did.
   int32_t interface = 0;
   for (Ipv4InterfaceList::const_iterator i = m_interfaces.begin (); 
        i != m_interfaces.end (); 
        i++, interface++)
     {
+      m_deviceIndex.insert (std::make_pair (PeekPointer ((*i)->GetDevice ()), interface));
       for (uint32_t j = 0; j < (*i)->GetNAddresses (); j++)
         {
-          if ((*i)->GetAddress (j).GetLocal () == address)
-            {
-              return interface;
-            }
+          Ipv4InterfaceAddress address = (*i)->GetAddress (j);
+          m_localAddressIndex.insert (std::make_pair (address.GetLocal (), interface));
+          m_broadcastAddressIndex.insert (std::make_pair (address.GetBroadcast (), interface));
         }
     }
+  m_interfaceIndexValid = true;
+}
 
+int32_t 
+Ipv4L3Protocol::GetInterfaceForAddress (
+  Ipv4Address address) const
+{
+  UpdateInterfaceIndex ();
+  AddressIndex::const_iterator i = m_localAddressIndex.find (address);
+  if (i != m_localAddressIndex.end ())
+    {
+      return i->second;
+    }
   return -1;
 }
 
@@ -334,20 +381,30 @@ Ipv4L3Protocol::GetInterfaceForPrefix (
   Ipv4Address address, 
   Ipv4Mask mask) const
 {
-  int32_t interface = 0;
-  for (Ipv4InterfaceList::const_iterator i = m_interfaces.begin (); 
-       i != m_interfaces.end (); 
-       i++, interface++)
-    {
-      for (uint32_t j = 0; j < (*i)->GetNAddresses (); j++)
+  UpdateInterfaceIndex ();
+  PrefixIndex::iterator prefixes = m_prefixIndex.find (mask.Get ());
+  if (prefixes == m_prefixIndex.end ())
+    {
+      // first lookup with this mask: index the networks of all the
+      // addresses for it.
+      prefixes = m_prefixIndex.insert (std::make_pair (mask.Get (), AddressIndex ())).first;
+      int32_t interface = 0;
+      for (Ipv4InterfaceList::const_iterator i = m_interfaces.begin (); 
+           i != m_interfaces.end (); 
+           i++, interface++)
         {
-          if ((*i)->GetAddress (j).GetLocal ().CombineMask (mask) == address.CombineMask (mask))
+          for (uint32_t j = 0; j < (*i)->GetNAddresses (); j++)
             {
-              return interface;
+              Ipv4Address network = (*i)->GetAddress (j).GetLocal ().CombineMask (mask);
+              prefixes->second.insert (std::make_pair (network, interface));
             }
         }
     }
-
+  AddressIndex::const_iterator i = prefixes->second.find (address.CombineMask (mask));
+  if (i != prefixes->second.end ())
+    {
+      return i->second;
+    }
   return -1;
 }
 
@@ -355,17 +412,12 @@ int32_t
 Ipv4L3Protocol::GetInterfaceForDevice (
   Ptr<const NetDevice> device) const
 {
-  int32_t interface = 0;
-  for (Ipv4InterfaceList::const_iterator i = m_interfaces.begin (); 
-       i != m_interfaces.end (); 
-       i++, interface++)
+  UpdateInterfaceIndex ();
+  DeviceIndex::const_iterator i = m_deviceIndex.find (PeekPointer (device));
+  if (i != m_deviceIndex.end ())
     {
-      if ((*i)->GetDevice () == device)
-        {
-          return interface;
-        }
+      return i->second;
     }
-
   return -1;
 }
 
@@ -408,24 +460,19 @@ Ipv4L3Protocol::IsDestinationAddress (Ipv4Address address, uint32_t iif) const
 
   if (GetWeakEsModel ())  // Check other interfaces
     { 
-      for (uint32_t j = 0; j < GetNInterfaces (); j++)
+      // The addresses of the incoming interface were checked above, so
+      // any match in the indexes is on another interface.
+      UpdateInterfaceIndex ();
+      if (m_localAddressIndex.find (address) != m_localAddressIndex.end ())
         {
-          if (j == uint32_t (iif)) continue;
-          for (uint32_t i = 0; i < GetNAddresses (j); i++)
-            {
-              Ipv4InterfaceAddress iaddr = GetAddress (j, i);
-              if (address == iaddr.GetLocal ())
-                {
-                  NS_LOG_LOGIC ("For me (destination " << address << " match) on another interface");
-                  return true;
-                }
-              //  This is a small corner case:  match another interface's broadcast address
-              if (address == iaddr.GetBroadcast ())
-                {
-                  NS_LOG_LOGIC ("For me (interface broadcast address on another interface)");
-                  return true;
-                }
-            }
+          NS_LOG_LOGIC ("For me (destination " << address << " match) on another interface");
+          return true;
+        }
+      //  This is a small corner case:  match another interface's broadcast address
+      if (m_broadcastAddressIndex.find (address) != m_broadcastAddressIndex.end ())
+        {
+          NS_LOG_LOGIC ("For me (interface broadcast address on another interface)");
+          return true;
         }
     }
   return false;
@@ -440,31 +487,31 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
   NS_LOG_LOGIC ("Packet from " << from << " received on node " << 
                 m_node->GetId ());
 
-  uint32_t interface = 0;
+  uint32_t interface = m_interfaces.size ();
   Ptr<Packet> packet = p->Copy ();
 
   Ptr<Ipv4Interface> ipv4Interface;
-  for (Ipv4InterfaceList::const_iterator i = m_interfaces.begin (); 
-       i != m_interfaces.end (); 
-       i++, interface++)
+  int32_t deviceInterface = GetInterfaceForDevice (device);
+  if (deviceInterface >= 0)
     {
-      ipv4Interface = *i;
-      if (ipv4Interface->GetDevice () == device)
+      interface = deviceInterface;
+      ipv4Interface = m_interfaces[interface];
+      if (ipv4Interface->IsUp ())
         {
-          if (ipv4Interface->IsUp ())
-            {
-              m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
-              break;
-            }
-          else
-            {
-              NS_LOG_LOGIC ("Dropping received packet -- interface is down");
-              Ipv4Header ipHeader;
-              packet->RemoveHeader (ipHeader);
-              m_dropTrace (ipHeader, packet, DROP_INTERFACE_DOWN, m_node->GetObject<Ipv4> (), interface);
-              return;
-            }
+          m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
         }
+      else
+        {
+          NS_LOG_LOGIC ("Dropping received packet -- interface is down");
+          Ipv4Header ipHeader;
+          packet->RemoveHeader (ipHeader);
+          m_dropTrace (ipHeader, packet, DROP_INTERFACE_DOWN, m_node->GetObject<Ipv4> (), interface);
+          return;
+        }
+    }
+  else if (!m_interfaces.empty ())
+    {
+      ipv4Interface = m_interfaces.back ();
     }
 
   Ipv4Header ipHeader;
@@ -1078,6 +1125,24 @@ Ipv4L3Protocol::GetNetDevice (uint32_t i)
   return GetInterface (i)->GetDevice ();
 }
 
+uint32_t
+Ipv4L3Protocol::GetFragmentBufferUsage (void) const
+{
+  return m_fragmentBufferUsage;
+}
+
+uint64_t
+Ipv4L3Protocol::GetNFragmentsDropped (void) const
+{
+  return m_nFragmentsDropped;
+}
+
+uint64_t
+Ipv4L3Protocol::GetNReassemblyTimeouts (void) const
+{
+  return m_nReassemblyTimeouts;
+}
+
 void 
 Ipv4L3Protocol::SetIpForward (bool forward) 
 {
@@ -1213,25 +1278,34 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
 {
   NS_LOG_FUNCTION (this << packet << " " << ipHeader << " " << iif);
 
-  uint64_t addressCombination = uint64_t (ipHeader.GetSource ().Get ()) << 32 & uint64_t (ipHeader.GetDestination ().Get ());
-  uint32_t idProto = uint32_t (ipHeader.GetIdentification ()) << 16 & uint32_t (ipHeader.GetProtocol ());
-  std::pair<uint64_t, uint32_t> key;
+  uint64_t addressCombination = uint64_t (ipHeader.GetSource ().Get ()) << 32 | uint64_t (ipHeader.GetDestination ().Get ());
+  uint32_t idProto = uint32_t (ipHeader.GetIdentification ()) << 16 | uint32_t (ipHeader.GetProtocol ());
+  FragmentsKey key;
   bool ret = false;
-  Ptr<Packet> p = packet->Copy ();
 
   key.first = addressCombination;
   key.second = idProto;
 
+  if (m_fragmentBufferUsage + packet->GetSize () > m_fragmentBufferSize)
+    {
+      NS_LOG_LOGIC ("Dropping fragment - the fragment buffer is full");
+      m_nFragmentsDropped++;
+      m_dropTrace (ipHeader, packet, DROP_FRAGMENT_BUFFER_FULL, m_node->GetObject<Ipv4> (), iif);
+      return false;
+    }
+
   Ptr<Fragments> fragments;
 
   MapFragments_t::iterator it = m_fragments.find (key);
   if (it == m_fragments.end ())
     {
-      fragments = Create<Fragments> ();
+      if (m_timerQueue == 0)
+        {
+          m_timerQueue = TimerQueue::LookupOrAggregate (m_node);
+        }
+      fragments = Create<Fragments> (this, key, ipHeader, iif);
       m_fragments.insert (std::make_pair (key, fragments));
-      m_fragmentsTimers[key] = Simulator::Schedule (m_fragmentExpirationTimeout,
-                                                    &Ipv4L3Protocol::HandleFragmentsTimeout, this,
-                                                    key, ipHeader, iif);
+      fragments->StartTimeout (m_timerQueue, m_fragmentExpirationTimeout);
     }
   else
     {
@@ -1240,155 +1314,86 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
 
   NS_LOG_LOGIC ("Adding fragment - Size: " << packet->GetSize ( ) << " - Offset: " << (ipHeader.GetFragmentOffset ()) );
 
-  fragments->AddFragment (p, ipHeader.GetFragmentOffset (), !ipHeader.IsLastFragment () );
+  m_fragmentBufferUsage += fragments->AddFragment (packet, ipHeader.GetFragmentOffset (), !ipHeader.IsLastFragment () );
 
   if ( fragments->IsEntire () )
     {
+      NS_LOG_LOGIC ("Stopping WaitFragmentsTimer at " << Simulator::Now ().GetSeconds () << " due to complete packet");
+      fragments->CancelTimeout ();
+      m_fragmentBufferUsage -= fragments->GetSize ();
       packet = fragments->GetPacket ();
-      fragments = 0;
       m_fragments.erase (key);
-      if (m_fragmentsTimers[key].IsRunning ())
-        {
-          NS_LOG_LOGIC ("Stopping WaitFragmentsTimer at " << Simulator::Now ().GetSeconds () << " due to complete packet");
-          m_fragmentsTimers[key].Cancel ();
-        }
-      m_fragmentsTimers.erase (key);
       ret = true;
     }
 
   return ret;
 }
 
-Ipv4L3Protocol::Fragments::Fragments ()
-  : m_moreFragment (0)
+Ipv4L3Protocol::Fragments::Fragments (Ipv4L3Protocol *protocol, FragmentsKey key, const Ipv4Header &ipHeader, uint32_t iif)
+  : m_protocol (protocol),
+    m_key (key),
+    m_ipHeader (ipHeader),
+    m_iif (iif)
 {
 }
 
 Ipv4L3Protocol::Fragments::~Fragments ()
 {
+  m_timeout.Cancel ();
 }
 
-void
+int32_t
 Ipv4L3Protocol::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
 {
   NS_LOG_FUNCTION (this << fragment << " " << fragmentOffset << " " << moreFragment);
-
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
-
-  for (it = m_fragments.begin (); it != m_fragments.end (); it++)
-    {
-      if (it->second > fragmentOffset)
-        {
-          break;
-        }
-    }
-
-  if (it == m_fragments.end ())
-    {
-      m_moreFragment = moreFragment;
-    }
-
-  m_fragments.insert (it, std::make_pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+  // The overlapping bytes of a fragment are discarded: we do not overwrite
+  // the "old" with the "new".  This is different from what Linux does.
+  // It is not possible to emulate a fragmentation attack.
+  return m_intervals.AddFragment (fragment, fragmentOffset, moreFragment);
 }
 
 bool
 Ipv4L3Protocol::Fragments::IsEntire () const
 {
-  NS_LOG_FUNCTION (this);
-
-  bool ret = !m_moreFragment && m_fragments.size () > 0;
-
-  if (ret)
-    {
-      uint16_t lastEndOffset = 0;
-
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
-        {
-          // overlapping fragments do exist
-          NS_LOG_LOGIC ("Checking overlaps " << lastEndOffset << " - " << it->second );
-
-          if (lastEndOffset < it->second)
-            {
-              ret = false;
-              break;
-            }
-          // fragments might overlap in strange ways
-          uint16_t fragmentEnd = it->first->GetSize () + it->second;
-          lastEndOffset = std::max ( lastEndOffset, fragmentEnd );
-        }
-    }
-
-  return ret;
+  return m_intervals.IsEntire ();
 }
 
 Ptr<Packet>
 Ipv4L3Protocol::Fragments::GetPacket () const
 {
   NS_LOG_FUNCTION (this);
-
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
-
-  Ptr<Packet> p = Create<Packet> ();
-  uint16_t lastEndOffset = 0;
-
-  for ( it = m_fragments.begin (); it != m_fragments.end (); it++)
-    {
-      if ( lastEndOffset > it->second )
-        {
-          // The fragments are overlapping.
-          // We do not overwrite the "old" with the "new" because we do not know when each arrived.
-          // This is different from what Linux does.
-          // It is not possible to emulate a fragmentation attack.
-          uint32_t newStart = lastEndOffset - it->second;
-          if ( it->first->GetSize () > newStart )
-            {
-              uint32_t newSize = it->first->GetSize () - newStart;
-              Ptr<Packet> tempFragment = it->first->CreateFragment (newStart, newSize);
-              p->AddAtEnd (tempFragment);
-            }
-        }
-      else
-        {
-          NS_LOG_LOGIC ("Adding: " << *(it->first) );
-          p->AddAtEnd (it->first);
-        }
-      lastEndOffset = p->GetSize ();
-    }
-
-  return p;
+  return m_intervals.GetPacket ();
 }
 
 Ptr<Packet>
 Ipv4L3Protocol::Fragments::GetPartialPacket () const
 {
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
+  return m_intervals.GetPartialPacket ();
+}
 
-  Ptr<Packet> p = Create<Packet> ();
-  uint16_t lastEndOffset = 0;
+uint32_t
+Ipv4L3Protocol::Fragments::GetSize () const
+{
+  return m_intervals.GetSize ();
+}
 
-  if ( m_fragments.begin ()->second > 0 )
-    {
-      return p;
-    }
+void
+Ipv4L3Protocol::Fragments::StartTimeout (Ptr<TimerQueue> queue, Time delay)
+{
+  m_timeout = queue->Schedule (delay, MakeCallback (&Ipv4L3Protocol::Fragments::Timeout, this));
+}
 
-  for ( it = m_fragments.begin (); it != m_fragments.end (); it++)
-    {
-      if ( lastEndOffset > it->second )
-        {
-          uint32_t newStart = lastEndOffset - it->second;
-          uint32_t newSize = it->first->GetSize () - newStart;
-          Ptr<Packet> tempFragment = it->first->CreateFragment (newStart, newSize);
-          p->AddAtEnd (tempFragment);
-        }
-      else if ( lastEndOffset == it->second )
-        {
-          NS_LOG_LOGIC ("Adding: " << *(it->first) );
-          p->AddAtEnd (it->first);
-        }
-      lastEndOffset = p->GetSize ();
-    }
+void
+Ipv4L3Protocol::Fragments::CancelTimeout ()
+{
+  m_timeout.Cancel ();
+}
 
-  return p;
+void
+Ipv4L3Protocol::Fragments::Timeout ()
+{
+  // the protocol releases this object.
+  m_protocol->HandleFragmentsTimeout (m_key, m_ipHeader, m_iif);
 }
 
 void
@@ -1397,7 +1402,11 @@ Ipv4L3Protocol::HandleFragmentsTimeout (std::pair<uint64_t, uint32_t> key, Ipv4H
   NS_LOG_FUNCTION (this);
 
   MapFragments_t::iterator it = m_fragments.find (key);
-  Ptr<Packet> packet = it->second->GetPartialPacket ();
+  NS_ASSERT (it != m_fragments.end ());
+  Ptr<Fragments> fragments = it->second;
+  Ptr<Packet> packet = fragments->GetPartialPacket ();
+  m_nReassemblyTimeouts++;
+  m_fragmentBufferUsage -= fragments->GetSize ();
 
   // if we have at least 8 bytes, we can send an ICMP.
   if ( packet->GetSize () > 8 )
@@ -1408,10 +1417,7 @@ Ipv4L3Protocol::HandleFragmentsTimeout (std::pair<uint64_t, uint32_t> key, Ipv4H
   m_dropTrace (ipHeader, packet, DROP_FRAGMENT_TIMEOUT, m_node->GetObject<Ipv4> (), iif);
 
   // clear the buffers
-  it->second = 0;
-
-  m_fragments.erase (key);
-  m_fragmentsTimers.erase (key);
+  m_fragments.erase (it);
 }
 
 } // namespace ns3
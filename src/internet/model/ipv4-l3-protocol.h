@@ -34,6 +34,9 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
+#include "ns3/sgi-hashmap.h"
+#include "ns3/timer-queue.h"
+#include "fragment-intervals.h"
 
 namespace ns3 {
 
@@ -94,7 +97,8 @@ public:
     DROP_BAD_CHECKSUM,   /**< Bad checksum */
     DROP_INTERFACE_DOWN,   /**< Interface is down so can not send packet */
     DROP_ROUTE_ERROR,   /**< Route error */
-    DROP_FRAGMENT_TIMEOUT /**< Fragment timeout exceeded */
+    DROP_FRAGMENT_TIMEOUT, /**< Fragment timeout exceeded */
+    DROP_FRAGMENT_BUFFER_FULL /**< Fragment buffer size exceeded */
   };
 
   void SetNode (Ptr<Node> node);
@@ -210,6 +214,21 @@ public:
 
   Ptr<NetDevice> GetNetDevice (uint32_t i);
 
+  /**
+   * \returns the number of bytes of the fragments of the packets being
+   *          reassembled, bounded by the FragmentBufferSize attribute.
+   */
+  uint32_t GetFragmentBufferUsage (void) const;
+  /**
+   * \returns the number of fragments dropped because the fragment
+   *          buffer was full.
+   */
+  uint64_t GetNFragmentsDropped (void) const;
+  /**
+   * \returns the number of packets whose reassembly timed out.
+   */
+  uint64_t GetNReassemblyTimeouts (void) const;
+
 protected:
 
   virtual void DoDispose (void);
@@ -288,16 +307,50 @@ private:
    * \param ipHeader the IP header of the original packet
    * \param iif Input Interface
    */
-  void HandleFragmentsTimeout ( std::pair<uint64_t, uint32_t> key, Ipv4Header & ipHeader, uint32_t iif);
+  void HandleFragmentsTimeout (std::pair<uint64_t, uint32_t> key, Ipv4Header & ipHeader, uint32_t iif);
+
+  /**
+   * \brief Mark the address and device indexes as out of date.
+   */
+  void InvalidateInterfaceIndex (void);
+  /**
+   * \brief Rebuild the address and device indexes if they are out of date.
+   */
+  void UpdateInterfaceIndex (void) const;
 
   typedef std::vector<Ptr<Ipv4Interface> > Ipv4InterfaceList;
   typedef std::list<Ptr<Ipv4RawSocketImpl> > SocketList;
   typedef std::list<Ptr<Ipv4L4Protocol> > L4List_t;
 
+  class NetDevicePtrHash : public std::unary_function<const NetDevice *, size_t>
+  {
+public:
+    size_t operator() (const NetDevice *device) const;
+  };
+  // (source, destination) -> (identification, protocol)
+  typedef std::pair<uint64_t, uint32_t> FragmentsKey;
+  class FragmentsKeyHash : public std::unary_function<FragmentsKey, size_t>
+  {
+public:
+    size_t operator() (const FragmentsKey &key) const;
+  };
+  // address -> index of the first interface which has it
+  typedef sgi::hash_map<Ipv4Address, int32_t, Ipv4AddressHash> AddressIndex;
+  typedef sgi::hash_map<const NetDevice *, int32_t, NetDevicePtrHash> DeviceIndex;
+  // mask -> network address -> index of the first interface in it
+  typedef std::map<uint32_t, AddressIndex> PrefixIndex;
+
   bool m_ipForward;
   bool m_weakEsModel;
   L4List_t m_protocols;
   Ipv4InterfaceList m_interfaces;
+  // The indexes are rebuilt on the first lookup which follows a change of
+  // the interfaces or of their addresses.
+  mutable bool m_interfaceIndexValid;
+  mutable AddressIndex m_localAddressIndex;
+  mutable AddressIndex m_broadcastAddressIndex;
+  mutable DeviceIndex m_deviceIndex;
+  mutable PrefixIndex m_prefixIndex;
   uint8_t m_defaultTtl;
   uint16_t m_identification;
   Ptr<Node> m_node;
@@ -325,8 +378,12 @@ private:
 public:
     /**
      * \brief Constructor.
+     * \param protocol the protocol which reassembles the packet
+     * \param key the key of the packet
+     * \param ipHeader the IP header of the first fragment received
+     * \param iif Input Interface
      */
-    Fragments ();
+    Fragments (Ipv4L3Protocol *protocol, FragmentsKey key, const Ipv4Header &ipHeader, uint32_t iif);
 
     /**
      * \brief Destructor.
@@ -338,8 +395,10 @@ public:
      * \param fragment the fragment
      * \param fragmentOffset the offset of the fragment
      * \param moreFragment the bit "More Fragment"
+     * \return the change of the number of bytes stored, which is negative
+     * when the last fragment discards bytes beyond the end of the packet
      */
-    void AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment);
+    int32_t AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment);
 
     /**
      * \brief If all fragments have been added.
@@ -359,32 +418,58 @@ public:
      */
     Ptr<Packet> GetPartialPacket () const;
 
+    /**
+     * \brief Get the number of bytes stored.
+     * \return the number of bytes of the fragments, without overlaps
+     */
+    uint32_t GetSize () const;
+
+    /**
+     * \brief Start the timeout of the reassembly.
+     * \param queue the timer queue of the timeout
+     * \param delay the delay of the timeout
+     */
+    void StartTimeout (Ptr<TimerQueue> queue, Time delay);
+
+    /**
+     * \brief Cancel the timeout of the reassembly.
+     */
+    void CancelTimeout ();
+
 private:
     /**
-     * \brief True if other fragments will be sent.
+     * \brief Function called when the timeout expires.
      */
-    bool m_moreFragment;
+    void Timeout ();
+
+    Ipv4L3Protocol *m_protocol;
+    FragmentsKey m_key;
+    Ipv4Header m_ipHeader;
+    uint32_t m_iif;
 
     /**
-     * \brief The current fragments.
+     * \brief The bytes received.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_fragments;
+    FragmentIntervals m_intervals;
 
     /**
-     * \brief Number of references.
+     * \brief The timeout of the reassembly.
      */
-    mutable uint32_t m_refCount;
+    TimerQueue::Event m_timeout;
   };
 
-  typedef std::map< std::pair<uint64_t, uint32_t>, Ptr<Fragments> > MapFragments_t;
-  typedef std::map< std::pair<uint64_t, uint32_t>, EventId > MapFragmentsTimers_t;
+  typedef sgi::hash_map<FragmentsKey, Ptr<Fragments>, FragmentsKeyHash> MapFragments_t;
 
   /**
    * \brief The hash of fragmented packets.
    */
   MapFragments_t       m_fragments;
   Time                 m_fragmentExpirationTimeout;
-  MapFragmentsTimers_t m_fragmentsTimers;
+  uint32_t             m_fragmentBufferSize;
+  uint32_t             m_fragmentBufferUsage;
+  uint64_t             m_nFragmentsDropped;
+  uint64_t             m_nReassemblyTimeouts;
+  Ptr<TimerQueue>      m_timerQueue;
 
 };
 
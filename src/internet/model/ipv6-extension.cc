@@ -281,11 +281,19 @@ TypeId Ipv6ExtensionFragment::GetTypeId ()
   static TypeId tid = TypeId ("ns3::Ipv6ExtensionFragment")
     .SetParent<Ipv6Extension> ()
     .AddConstructor<Ipv6ExtensionFragment> ()
+    .AddAttribute ("FragmentBufferSize",
+                   "The maximum number of bytes of the fragments of the packets being reassembled: the fragments received beyond are dropped.",
+                   UintegerValue (4194304),
+                   MakeUintegerAccessor (&Ipv6ExtensionFragment::m_fragmentBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
 
 Ipv6ExtensionFragment::Ipv6ExtensionFragment ()
+  : m_fragmentBufferUsage (0),
+    m_nFragmentsDropped (0),
+    m_nReassemblyTimeouts (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -301,10 +309,13 @@ void Ipv6ExtensionFragment::DoDispose ()
 
   for (MapFragments_t::iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
     {
+      it->second->CancelTimeout ();
       it->second = 0;
     }
 
   m_fragments.clear ();
+  m_fragmentBufferUsage = 0;
+  m_timerQueue = 0;
   Ipv6Extension::DoDispose ();
 }
 
@@ -335,18 +346,28 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet, uint8_t offset, Ipv
   uint32_t identification = fragmentHeader.GetIdentification ();
   Ipv6Address src = ipv6Header.GetSourceAddress ();
 
-  std::pair<Ipv6Address, uint32_t> fragmentsId = std::make_pair<Ipv6Address, uint32_t> (src, identification);
+  FragmentsKey fragmentsId = std::make_pair<Ipv6Address, uint32_t> (src, identification);
   Ptr<Fragments> fragments;
 
+  if (m_fragmentBufferUsage + p->GetSize () > m_fragmentBufferSize)
+    {
+      NS_LOG_LOGIC ("Dropping fragment - the fragment buffer is full");
+      m_nFragmentsDropped++;
+      m_dropTrace (packet);
+      isDropped = true;
+      return 0;
+    }
+
   MapFragments_t::iterator it = m_fragments.find (fragmentsId);
   if (it == m_fragments.end ())
     {
-      fragments = Create<Fragments> ();
+      if (m_timerQueue == 0)
+        {
+          m_timerQueue = TimerQueue::LookupOrAggregate (GetNode ());
+        }
+      fragments = Create<Fragments> (this, fragmentsId, ipv6Header);
       m_fragments.insert (std::make_pair (fragmentsId, fragments));
-      EventId timeout = Simulator::Schedule (Seconds(60),
-                                             &Ipv6ExtensionFragment::HandleFragmentsTimeout, this,
-                                             fragmentsId, fragments, ipv6Header);
-      fragments->SetTimeoutEventId (timeout);
+      fragments->StartTimeout (m_timerQueue, Seconds (60));
     }
   else
     {
@@ -360,13 +381,14 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet, uint8_t offset, Ipv
       fragments->SetUnfragmentablePart (unfragmentablePart);
     }
 
-  fragments->AddFragment (p, fragmentOffset, moreFragment);
+  m_fragmentBufferUsage += fragments->AddFragment (p, fragmentOffset, moreFragment);
 
   if (fragments->IsEntire ())
     {
+      fragments->CancelTimeout ();
+      m_fragmentBufferUsage -= fragments->GetSize ();
       packet = fragments->GetPacket ();
-      fragments->CancelTimeout();
-      m_fragments.erase(fragmentsId);
+      m_fragments.erase (fragmentsId);
       isDropped = false;
     }
   else 
@@ -545,12 +567,29 @@ void Ipv6ExtensionFragment::GetFragments (Ptr<Packet> packet, uint32_t maxFragme
 }
 
 
+uint32_t Ipv6ExtensionFragment::GetFragmentBufferUsage () const
+{
+  return m_fragmentBufferUsage;
+}
+
+uint64_t Ipv6ExtensionFragment::GetNFragmentsDropped () const
+{
+  return m_nFragmentsDropped;
+}
+
+uint64_t Ipv6ExtensionFragment::GetNReassemblyTimeouts () const
+{
+  return m_nReassemblyTimeouts;
+}
+
 void Ipv6ExtensionFragment::HandleFragmentsTimeout (std::pair<Ipv6Address, uint32_t> fragmentsId, Ptr<Fragments> fragments, Ipv6Header & ipHeader)
 {
   Ptr<Packet> packet = fragments->GetPartialPacket ();
+  m_nReassemblyTimeouts++;
+  m_fragmentBufferUsage -= fragments->GetSize ();
 
   // if we have at least 8 bytes, we can send an ICMP.
-  if ( packet->GetSize () > 8 )
+  if ( packet && packet->GetSize () > 8 )
     {
 
       Ptr<Icmpv6L4Protocol> icmp = GetNode()->GetObject<Icmpv6L4Protocol> ();
@@ -559,36 +598,29 @@ void Ipv6ExtensionFragment::HandleFragmentsTimeout (std::pair<Ipv6Address, uint3
   m_dropTrace (packet);
 
   // clear the buffers
-  m_fragments.erase(fragmentsId);
+  m_fragments.erase (fragmentsId);
 }
 
-Ipv6ExtensionFragment::Fragments::Fragments ()
-  : m_moreFragment (0)
+size_t Ipv6ExtensionFragment::FragmentsKeyHash::operator() (const FragmentsKey &key) const
 {
+  return Ipv6AddressHash () (key.first) ^ (key.second * 0x9e3779b9U);
 }
 
-Ipv6ExtensionFragment::Fragments::~Fragments ()
+Ipv6ExtensionFragment::Fragments::Fragments (Ipv6ExtensionFragment *extension, FragmentsKey key, const Ipv6Header &ipHeader)
+  : m_extension (extension),
+    m_key (key),
+    m_ipHeader (ipHeader)
 {
 }
 
-void Ipv6ExtensionFragment::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
+Ipv6ExtensionFragment::Fragments::~Fragments ()
 {
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
-
-  for (it = m_fragments.begin (); it != m_fragments.end (); it++)
-    {
-      if (it->second > fragmentOffset)
-        {
-          break;
-        }
-    }
-
-  if (it == m_fragments.end ())
-    {
-      m_moreFragment = moreFragment;
-    }
+  m_timeout.Cancel ();
+}
 
-  m_fragments.insert (it, std::make_pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+int32_t Ipv6ExtensionFragment::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
+{
+  return m_intervals.AddFragment (fragment, fragmentOffset, moreFragment);
 }
 
 void Ipv6ExtensionFragment::Fragments::SetUnfragmentablePart (Ptr<Packet> unfragmentablePart) 
@@ -598,36 +630,13 @@ void Ipv6ExtensionFragment::Fragments::SetUnfragmentablePart (Ptr<Packet> unfrag
 
 bool Ipv6ExtensionFragment::Fragments::IsEntire () const
 {
-  bool ret = !m_moreFragment && m_fragments.size () > 0;
-
-  if (ret)
-    {
-      uint16_t lastEndOffset = 0;
-
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
-        {
-          if (lastEndOffset != it->second)
-            {
-              ret = false;
-              break;
-            }
-
-          lastEndOffset += it->first->GetSize ();
-        }
-    }
-
-  return ret;
+  return m_intervals.IsEntire ();
 }
 
 Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPacket () const
 {
   Ptr<Packet> p =  m_unfragmentable->Copy ();
-
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
-    {
-      p->AddAtEnd (it->first);
-    }
-
+  p->AddAtEnd (m_intervals.GetPacket ());
   return p;
 }
 
@@ -644,31 +653,29 @@ Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPartialPacket () const
       return p;
     }
 
-  uint16_t lastEndOffset = 0;
+  p->AddAtEnd (m_intervals.GetPartialPacket ());
+  return p;
+}
 
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
-    {
-      if (lastEndOffset != it->second)
-        {
-          break;
-        }
-      p->AddAtEnd (it->first);
-      lastEndOffset += it->first->GetSize ();
-    }
+uint32_t Ipv6ExtensionFragment::Fragments::GetSize () const
+{
+  return m_intervals.GetSize ();
+}
 
-  return p;
+void Ipv6ExtensionFragment::Fragments::StartTimeout (Ptr<TimerQueue> queue, Time delay)
+{
+  m_timeout = queue->Schedule (delay, MakeCallback (&Ipv6ExtensionFragment::Fragments::Timeout, this));
 }
 
-void Ipv6ExtensionFragment::Fragments::SetTimeoutEventId (EventId event)
+void Ipv6ExtensionFragment::Fragments::CancelTimeout ()
 {
-    m_timeoutEventId = event;
-    return;
+  m_timeout.Cancel ();
 }
 
-void Ipv6ExtensionFragment::Fragments::CancelTimeout()
+void Ipv6ExtensionFragment::Fragments::Timeout ()
 {
-    m_timeoutEventId.Cancel ();
-    return;
+  // the extension releases this object.
+  m_extension->HandleFragmentsTimeout (m_key, this, m_ipHeader);
 }
 
 
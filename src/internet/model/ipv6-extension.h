@@ -33,6 +33,9 @@
 #include "ns3/packet.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/traced-callback.h"
+#include "ns3/sgi-hashmap.h"
+#include "ns3/timer-queue.h"
+#include "fragment-intervals.h"
 
 
 namespace ns3
@@ -269,6 +272,26 @@ public:
    */
   void GetFragments (Ptr<Packet> packet, uint32_t fragmentSize, std::list<Ptr<Packet> >& listFragments);
 
+  /**
+   * \brief Get the number of bytes buffered.
+   * \return the number of bytes of the fragments of the packets being
+   * reassembled, bounded by the FragmentBufferSize attribute
+   */
+  uint32_t GetFragmentBufferUsage () const;
+
+  /**
+   * \brief Get the number of fragments dropped.
+   * \return the number of fragments dropped because the fragment buffer
+   * was full
+   */
+  uint64_t GetNFragmentsDropped () const;
+
+  /**
+   * \brief Get the number of reassembly timeouts.
+   * \return the number of packets whose reassembly timed out
+   */
+  uint64_t GetNReassemblyTimeouts () const;
+
 protected:
   /**
    * \brief Dispose this object.
@@ -276,6 +299,21 @@ protected:
   virtual void DoDispose ();
 
 private:
+  /**
+   * \brief The key of a packet: source address and identification.
+   */
+  typedef std::pair<Ipv6Address, uint32_t> FragmentsKey;
+
+  /**
+   * \class FragmentsKeyHash
+   * \brief Hash function of the key of a packet.
+   */
+  class FragmentsKeyHash : public std::unary_function<FragmentsKey, size_t>
+  {
+public:
+    size_t operator() (const FragmentsKey &key) const;
+  };
+
   /**
    * \class Fragments
    * \brief A Set of Fragment
@@ -285,8 +323,11 @@ private:
 public:
     /**
      * \brief Constructor.
+     * \param extension the extension which reassembles the packet
+     * \param key the key of the packet
+     * \param ipHeader the IPv6 header of the first fragment received
      */
-    Fragments ();
+    Fragments (Ipv6ExtensionFragment *extension, FragmentsKey key, const Ipv6Header &ipHeader);
 
     /**
      * \brief Destructor.
@@ -298,8 +339,10 @@ public:
      * \param fragment the fragment
      * \param fragmentOffset the offset of the fragment
      * \param moreFragment the bit "More Fragment"
+     * \return the change of the number of bytes stored, which is negative
+     * when the last fragment discards bytes beyond the end of the packet
      */
-    void AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment);
+    int32_t AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment);
 
     /**
      * \brief Set the unfragmentable part of the packet.
@@ -326,9 +369,17 @@ public:
     Ptr<Packet> GetPartialPacket () const;
 
     /**
-     * \brief Set the Timeout EventId.
+     * \brief Get the number of bytes stored.
+     * \return the number of bytes of the fragments, without overlaps
+     */
+    uint32_t GetSize () const;
+
+    /**
+     * \brief Start the timeout of the reassembly.
+     * \param queue the timer queue of the timeout
+     * \param delay the delay of the timeout
      */
-    void SetTimeoutEventId (EventId event);
+    void StartTimeout (Ptr<TimerQueue> queue, Time delay);
 
     /**
      * \brief Cancel the timeout event
@@ -337,29 +388,39 @@ public:
 
 private:
     /**
-     * \brief If other fragments will be sent.
+     * \brief Function called when the timeout expires.
      */
-    bool m_moreFragment;
+    void Timeout ();
 
     /**
-     * \brief The current fragments.
+     * \brief The extension which reassembles the packet.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_fragments;
+    Ipv6ExtensionFragment *m_extension;
 
     /**
-     * \brief The unfragmentable part.
+     * \brief The key of the packet.
      */
-    Ptr<Packet> m_unfragmentable;
+    FragmentsKey m_key;
+
+    /**
+     * \brief The IPv6 header of the first fragment received.
+     */
+    Ipv6Header m_ipHeader;
 
     /**
-     * \brief Number of references.
+     * \brief The bytes received.
      */
-    mutable uint32_t m_refCount;
+    FragmentIntervals m_intervals;
+
+    /**
+     * \brief The unfragmentable part.
+     */
+    Ptr<Packet> m_unfragmentable;
 
     /**
      * \brief Timeout handler event
      */
-    EventId m_timeoutEventId;
+    TimerQueue::Event m_timeout;
   };
 
   /**
@@ -370,28 +431,37 @@ private:
    */
   void HandleFragmentsTimeout (std::pair<Ipv6Address, uint32_t> key, Ptr<Fragments> fragments, Ipv6Header & ipHeader);
 
+  typedef sgi::hash_map<FragmentsKey, Ptr<Fragments>, FragmentsKeyHash> MapFragments_t;
+
+  /**
+   * \brief The hash of fragmented packets.
+   */
+  MapFragments_t m_fragments;
+
   /**
-   * \brief Get the packet parts so far received.
-   * \return the partial packet
+   * \brief The maximum number of bytes of the fragments.
    */
-  Ptr<Packet> GetPartialPacket () const;
+  uint32_t m_fragmentBufferSize;
 
   /**
-   * \brief Set the Timeout EventId.
+   * \brief The number of bytes of the fragments.
    */
-  void SetTimeoutEventId (EventId event);
+  uint32_t m_fragmentBufferUsage;
 
   /**
-   * \brief Cancel the timeout event
+   * \brief The number of fragments dropped because the buffer was full.
    */
-  void CancelTimeout ();
+  uint64_t m_nFragmentsDropped;
 
-  typedef std::map<std::pair<Ipv6Address, uint32_t>, Ptr<Fragments> > MapFragments_t;
+  /**
+   * \brief The number of reassembly timeouts.
+   */
+  uint64_t m_nReassemblyTimeouts;
 
   /**
-   * \brief The hash of fragmented packets.
+   * \brief The timer queue of the reassembly timeouts.
    */
-  MapFragments_t m_fragments;
+  Ptr<TimerQueue> m_timerQueue;
 };
 
 /**
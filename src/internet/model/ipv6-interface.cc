@@ -64,6 +64,7 @@ Ipv6Interface::~Ipv6Interface ()
 void Ipv6Interface::DoDispose ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  m_addressChangeCallback = MakeNullCallback<void> ();
   Object::DoDispose ();
 }
 
@@ -160,6 +161,10 @@ void Ipv6Interface::SetDown ()
   NS_LOG_FUNCTION_NOARGS ();
   m_ifup = false;
   m_addresses.clear ();
+  if (!m_addressChangeCallback.IsNull ())
+    {
+      m_addressChangeCallback ();
+    }
 }
 
 bool Ipv6Interface::IsForwarding () const
@@ -191,6 +196,10 @@ bool Ipv6Interface::AddAddress (Ipv6InterfaceAddress iface)
         }
 
       m_addresses.push_back (iface);
+      if (!m_addressChangeCallback.IsNull ())
+        {
+          m_addressChangeCallback ();
+        }
 
       if (!addr.IsAny () || !addr.IsLocalhost ())
         {
@@ -271,6 +280,10 @@ Ipv6InterfaceAddress Ipv6Interface::RemoveAddress (uint32_t index)
         {
           Ipv6InterfaceAddress iface = (*it);
           m_addresses.erase (it);
+          if (!m_addressChangeCallback.IsNull ())
+            {
+              m_addressChangeCallback ();
+            }
           return iface;
         }
 
@@ -450,5 +463,11 @@ void Ipv6Interface::SetNsDadUid (Ipv6Address address, uint32_t uid)
   /* not found, maybe address has expired */
 }
 
+void Ipv6Interface::SetAddressChangeCallback (Callback<void> callback)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_addressChangeCallback = callback;
+}
+
 } /* namespace ns3 */
 
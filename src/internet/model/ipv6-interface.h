@@ -28,6 +28,7 @@
 #include "ns3/ptr.h"
 #include "ns3/object.h"
 #include "ns3/timer.h"
+#include "ns3/callback.h"
 
 namespace ns3
 {
@@ -241,6 +242,15 @@ public:
    */
   void SetNsDadUid (Ipv6Address address, uint32_t uid);
 
+  /**
+   * \brief Set the callback invoked each time an address is added to
+   * or removed from this interface.
+   *
+   * Ipv6L3Protocol uses it to maintain its address indexes.
+   * \param callback the callback
+   */
+  void SetAddressChangeCallback (Callback<void> callback);
+
 protected:
   /**
    * \brief Dispose this object.
@@ -262,6 +272,11 @@ private:
    */
   Ipv6InterfaceAddressList m_addresses;
 
+  /**
+   * \brief Callback invoked when an address is added or removed.
+   */
+  Callback<void> m_addressChangeCallback;
+
   /**
    * \brief The state of this interface.
    */
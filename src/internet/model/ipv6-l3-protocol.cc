@@ -75,7 +75,8 @@ TypeId Ipv6L3Protocol::GetTypeId ()
 }
 
 Ipv6L3Protocol::Ipv6L3Protocol ()
-  : m_nInterfaces (0)
+  : m_nInterfaces (0),
+    m_interfaceIndexValid (false)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -102,6 +103,7 @@ void Ipv6L3Protocol::DoDispose ()
       *it = 0;
     }
   m_interfaces.clear ();
+  InvalidateInterfaceIndex ();
 
   /* remove raw sockets */
   for (SocketList::iterator it = m_sockets.begin (); it != m_sockets.end (); ++it)
@@ -157,21 +159,18 @@ uint32_t Ipv6L3Protocol::AddIpv6Interface (Ptr<Ipv6Interface> interface)
 
   m_interfaces.push_back (interface);
   m_nInterfaces++;
+  interface->SetAddressChangeCallback (MakeCallback (&Ipv6L3Protocol::InvalidateInterfaceIndex, this));
+  InvalidateInterfaceIndex ();
   return index;
 }
 
 Ptr<Ipv6Interface> Ipv6L3Protocol::GetInterface (uint32_t index) const
 {
   NS_LOG_FUNCTION (this << index);
-  uint32_t tmp = 0;
 
-  for (Ipv6InterfaceList::const_iterator it = m_interfaces.begin (); it != m_interfaces.end (); it++)
+  if (index < m_interfaces.size ())
     {
-      if (index == tmp)
-        {
-          return *it;
-        }
-      tmp++;
+      return m_interfaces[index];
     }
   return 0;
 }
@@ -182,44 +181,83 @@ uint32_t Ipv6L3Protocol::GetNInterfaces () const
   return m_nInterfaces;
 }
 
-int32_t Ipv6L3Protocol::GetInterfaceForAddress (Ipv6Address address) const
+size_t Ipv6L3Protocol::NetDevicePtrHash::operator () (const NetDevice *device) const
 {
-  NS_LOG_FUNCTION (this << address); 
+  return reinterpret_cast<size_t> (device) / sizeof (void *);
+}
+
+void Ipv6L3Protocol::InvalidateInterfaceIndex ()
+{
+  m_interfaceIndexValid = false;
+  m_addressIndex.clear ();
+  m_deviceIndex.clear ();
+  m_prefixIndex.clear ();
+}
+
+void Ipv6L3Protocol::UpdateInterfaceIndex () const
+{
+  if (m_interfaceIndexValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
   int32_t index = 0;
 
+  /* insert keeps the first interface which has an address or a device */
   for (Ipv6InterfaceList::const_iterator it = m_interfaces.begin (); it != m_interfaces.end (); it++)
     {
-      uint32_t j = 0;
-      uint32_t max = (*it)->GetNAddresses ();
-
-      for (j = 0; j < max; j++)
+      m_deviceIndex.insert (std::make_pair (PeekPointer ((*it)->GetDevice ()), index));
+      for (uint32_t j = 0; j < (*it)->GetNAddresses (); j++)
         {
-          if ((*it)->GetAddress (j).GetAddress () == address) 
-            {
-              return index;
-            }
+          m_addressIndex.insert (std::make_pair ((*it)->GetAddress (j).GetAddress (), index));
         }
       index++;
     }
+  m_interfaceIndexValid = true;
+}
+
+int32_t Ipv6L3Protocol::GetInterfaceForAddress (Ipv6Address address) const
+{
+  NS_LOG_FUNCTION (this << address); 
+  UpdateInterfaceIndex ();
+  AddressIndex::const_iterator it = m_addressIndex.find (address);
+
+  if (it != m_addressIndex.end ())
+    {
+      return it->second;
+    }
   return -1;
 }
 
 int32_t Ipv6L3Protocol::GetInterfaceForPrefix (Ipv6Address address, Ipv6Prefix mask) const
 {
   NS_LOG_FUNCTION (this << address << mask);
-  int32_t index = 0;
+  UpdateInterfaceIndex ();
+  uint8_t buf[16];
+  mask.GetBytes (buf);
+  Ipv6Address key (buf);
+  PrefixIndex::iterator prefixes = m_prefixIndex.find (key);
 
-  for (Ipv6InterfaceList::const_iterator it = m_interfaces.begin (); it != m_interfaces.end (); it++)
+  if (prefixes == m_prefixIndex.end ())
     {
-      uint32_t j = 0;
-      for (j = 0; j < (*it)->GetNAddresses (); j++)
+      /* first lookup with this prefix: index the networks of all the addresses */
+      prefixes = m_prefixIndex.insert (std::make_pair (key, AddressIndex ())).first;
+      int32_t index = 0;
+      for (Ipv6InterfaceList::const_iterator it = m_interfaces.begin (); it != m_interfaces.end (); it++)
         {
-          if ((*it)->GetAddress (j).GetAddress ().CombinePrefix (mask) == address.CombinePrefix (mask))
+          for (uint32_t j = 0; j < (*it)->GetNAddresses (); j++)
             {
-              return index;
+              Ipv6Address network = (*it)->GetAddress (j).GetAddress ().CombinePrefix (mask);
+              prefixes->second.insert (std::make_pair (network, index));
             }
+          index++;
         }
-      index++;
+    }
+
+  AddressIndex::const_iterator it = prefixes->second.find (address.CombinePrefix (mask));
+  if (it != prefixes->second.end ())
+    {
+      return it->second;
     }
   return -1;
 }
@@ -233,15 +271,12 @@ Ptr<NetDevice> Ipv6L3Protocol::GetNetDevice (uint32_t i)
 int32_t Ipv6L3Protocol::GetInterfaceForDevice (Ptr<const NetDevice> device) const
 {
   NS_LOG_FUNCTION (this << device);
-  int32_t index = 0;
+  UpdateInterfaceIndex ();
+  DeviceIndex::const_iterator it = m_deviceIndex.find (PeekPointer (device));
 
-  for (Ipv6InterfaceList::const_iterator it = m_interfaces.begin (); it != m_interfaces.end (); it++)
+  if (it != m_deviceIndex.end ())
     {
-      if ((*it)->GetDevice () == device)
-        {
-          return index;
-        }
-      index++;
+      return it->second;
     }
   return -1;
 }
@@ -665,31 +700,27 @@ void Ipv6L3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16
 {
   NS_LOG_FUNCTION (this << device << p << protocol << from << to << packetType);
   NS_LOG_LOGIC ("Packet from " << from << " received on node " << m_node->GetId ());
-  uint32_t interface = 0;
+  uint32_t interface = m_interfaces.size ();
   Ptr<Packet> packet = p->Copy ();
-  Ptr<Ipv6Interface> ipv6Interface = 0;
+  int32_t deviceInterface = GetInterfaceForDevice (device);
 
-  for (Ipv6InterfaceList::const_iterator it = m_interfaces.begin (); it != m_interfaces.end (); it++)
+  if (deviceInterface >= 0)
     {
-      ipv6Interface = *it;
+      interface = deviceInterface;
+      Ptr<Ipv6Interface> ipv6Interface = m_interfaces[interface];
 
-      if (ipv6Interface->GetDevice () == device)
+      if (ipv6Interface->IsUp ())
         {
-          if (ipv6Interface->IsUp ())
-            {
-              m_rxTrace (packet, m_node->GetObject<Ipv6> (), interface);
-              break;
-            }
-          else
-            {
-              NS_LOG_LOGIC ("Dropping received packet-- interface is down");
-              Ipv6Header hdr;
-              packet->RemoveHeader (hdr);
-              m_dropTrace (hdr, packet, DROP_INTERFACE_DOWN, m_node->GetObject<Ipv6> (), interface);
-              return;
-            }
+          m_rxTrace (packet, m_node->GetObject<Ipv6> (), interface);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("Dropping received packet-- interface is down");
+          Ipv6Header hdr;
+          packet->RemoveHeader (hdr);
+          m_dropTrace (hdr, packet, DROP_INTERFACE_DOWN, m_node->GetObject<Ipv6> (), interface);
+          return;
         }
-      interface++;
     }
 
   Ipv6Header hdr;
@@ -972,12 +1003,14 @@ void Ipv6L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv6Header const& i
           nextHeaderStep = ipv6Extension->Process (p, nextHeaderPosition, ip, dst, &nextHeader, isDropped);
           nextHeaderPosition += nextHeaderStep;
 
-          NS_ASSERT_MSG (nextHeaderStep != 0, "Zero-size IPv6 Option Header, aborting");
-
           if (isDropped)
             {
               return;
             }
+
+          // the fragment header is removed from the reassembled packet.
+          NS_ASSERT_MSG (nextHeaderStep != 0 || ipv6Extension->GetExtensionNumber () == Ipv6ExtensionFragment::EXT_NUMBER,
+                         "Zero-size IPv6 Option Header, aborting");
         }
       else
         {
@@ -22,12 +22,15 @@
 #define IPV6_L3_PROTOCOL_H
 
 #include <list>
+#include <map>
+#include <vector>
 
 #include "ns3/traced-callback.h"
 #include "ns3/net-device.h"
 #include "ns3/ipv6.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/ipv6-header.h"
+#include "ns3/sgi-hashmap.h"
 
 namespace ns3
 {
@@ -358,13 +361,39 @@ private:
   friend class Ipv6L3ProtocolTestCase;
   friend class Ipv6ExtensionLooseRouting;
 
-  typedef std::list<Ptr<Ipv6Interface> > Ipv6InterfaceList;
+  typedef std::vector<Ptr<Ipv6Interface> > Ipv6InterfaceList;
   typedef std::list<Ptr<Ipv6RawSocketImpl> > SocketList;
   typedef std::list<Ptr<Ipv6L4Protocol> > L4List_t;
 
   typedef std::list< Ptr<Ipv6AutoconfiguredPrefix> > Ipv6AutoconfiguredPrefixList;
   typedef std::list< Ptr<Ipv6AutoconfiguredPrefix> >::iterator Ipv6AutoconfiguredPrefixListI;
 
+  /**
+   * \class NetDevicePtrHash
+   * \brief Hash function class for NetDevice pointers.
+   */
+  class NetDevicePtrHash : public std::unary_function<const NetDevice *, size_t>
+  {
+public:
+    size_t operator () (const NetDevice *device) const;
+  };
+
+  /**
+   * \brief Index of the first interface which has an address.
+   */
+  typedef sgi::hash_map<Ipv6Address, int32_t, Ipv6AddressHash> AddressIndex;
+
+  /**
+   * \brief Index of the first interface attached to a device.
+   */
+  typedef sgi::hash_map<const NetDevice *, int32_t, NetDevicePtrHash> DeviceIndex;
+
+  /**
+   * \brief For each prefix (as an address), index of the first interface
+   * which has an address in a network.
+   */
+  typedef std::map<Ipv6Address, AddressIndex> PrefixIndex;
+
   /**
    * \brief Callback to trace TX (transmission) packets.
    */ 
@@ -456,6 +485,16 @@ private:
    */
   void SetupLoopback ();
 
+  /**
+   * \brief Mark the address and device indexes as out of date.
+   */
+  void InvalidateInterfaceIndex ();
+
+  /**
+   * \brief Rebuild the address and device indexes if they are out of date.
+   */
+  void UpdateInterfaceIndex () const;
+
   /**
    * \brief Set IPv6 forwarding state.
    * \param forward IPv6 forwarding enabled or not
@@ -493,6 +532,29 @@ private:
    */
   uint32_t m_nInterfaces;
 
+  /**
+   * \brief Whether the indexes below match the interfaces. They are
+   * rebuilt on the first lookup which follows a change of the interfaces
+   * or of their addresses.
+   */
+  mutable bool m_interfaceIndexValid;
+
+  /**
+   * \brief Index of the interface addresses.
+   */
+  mutable AddressIndex m_addressIndex;
+
+  /**
+   * \brief Index of the interface devices.
+   */
+  mutable DeviceIndex m_deviceIndex;
+
+  /**
+   * \brief Index of the networks of the interface addresses, built for
+   * each prefix used in a lookup.
+   */
+  mutable PrefixIndex m_prefixIndex;
+
   /**
    * \brief Default TTL for outgoing packets.
    */
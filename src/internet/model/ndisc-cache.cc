@@ -64,6 +64,7 @@ void NdiscCache::DoDispose ()
   Flush ();
   m_device = 0;
   m_interface = 0;
+  m_timerQueue = 0;
   Object::DoDispose ();
 }
 
@@ -137,6 +138,22 @@ void NdiscCache::Flush ()
   m_ndCache.erase (m_ndCache.begin (), m_ndCache.end ());
 }
 
+Ptr<TimerQueue> NdiscCache::GetTimerQueue ()
+{
+  if (m_timerQueue == 0)
+    {
+      if (m_device != 0 && m_device->GetNode () != 0)
+        {
+          m_timerQueue = TimerQueue::LookupOrAggregate (m_device->GetNode ());
+        }
+      else
+        {
+          m_timerQueue = CreateObject<TimerQueue> ();
+        }
+    }
+  return m_timerQueue;
+}
+
 void NdiscCache::SetUnresQlen (uint32_t unresQlen)
 {
   NS_LOG_FUNCTION (this << unresQlen);
@@ -153,16 +170,20 @@ NdiscCache::Entry::Entry (NdiscCache* nd)
   : m_ndCache (nd),
     m_waiting (),
     m_router (false),
-    m_reachableTimer (Timer::CANCEL_ON_DESTROY),
-    m_retransTimer (Timer::CANCEL_ON_DESTROY),
-    m_probeTimer (Timer::CANCEL_ON_DESTROY),
-    m_delayTimer (Timer::CANCEL_ON_DESTROY),
     m_lastReachabilityConfirmation (Seconds (0.0)),
     m_nsRetransmit (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+NdiscCache::Entry::~Entry ()
+{
+  m_reachableTimer.Cancel ();
+  m_retransTimer.Cancel ();
+  m_probeTimer.Cancel ();
+  m_delayTimer.Cancel ();
+}
+
 void NdiscCache::Entry::SetRouter (bool router)
 {
   NS_LOG_FUNCTION (this << router);
@@ -367,9 +388,8 @@ void NdiscCache::Entry::UpdateLastReachabilityconfirmation ()
 void NdiscCache::Entry::StartReachableTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_reachableTimer.SetFunction (&NdiscCache::Entry::FunctionReachableTimeout, this);
-  m_reachableTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME));
-  m_reachableTimer.Schedule ();
+  m_reachableTimer = m_ndCache->GetTimerQueue ()->Schedule (MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME),
+                                                            MakeCallback (&NdiscCache::Entry::FunctionReachableTimeout, this));
 }
 
 void NdiscCache::Entry::StopReachableTimer ()
@@ -381,9 +401,8 @@ void NdiscCache::Entry::StopReachableTimer ()
 void NdiscCache::Entry::StartProbeTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_probeTimer.SetFunction (&NdiscCache::Entry::FunctionProbeTimeout, this);
-  m_probeTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
-  m_probeTimer.Schedule ();
+  m_probeTimer = m_ndCache->GetTimerQueue ()->Schedule (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER),
+                                                        MakeCallback (&NdiscCache::Entry::FunctionProbeTimeout, this));
 }
 
 void NdiscCache::Entry::StopProbeTimer ()
@@ -397,9 +416,8 @@ void NdiscCache::Entry::StopProbeTimer ()
 void NdiscCache::Entry::StartDelayTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_delayTimer.SetFunction (&NdiscCache::Entry::FunctionDelayTimeout, this);
-  m_delayTimer.SetDelay (Seconds (Icmpv6L4Protocol::DELAY_FIRST_PROBE_TIME));
-  m_delayTimer.Schedule ();
+  m_delayTimer = m_ndCache->GetTimerQueue ()->Schedule (Seconds (Icmpv6L4Protocol::DELAY_FIRST_PROBE_TIME),
+                                                        MakeCallback (&NdiscCache::Entry::FunctionDelayTimeout, this));
 }
 
 void NdiscCache::Entry::StopDelayTimer ()
@@ -412,9 +430,8 @@ void NdiscCache::Entry::StopDelayTimer ()
 void NdiscCache::Entry::StartRetransmitTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_retransTimer.SetFunction (&NdiscCache::Entry::FunctionRetransmitTimeout, this);
-  m_retransTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
-  m_retransTimer.Schedule ();
+  m_retransTimer = m_ndCache->GetTimerQueue ()->Schedule (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER),
+                                                          MakeCallback (&NdiscCache::Entry::FunctionRetransmitTimeout, this));
 }
 
 void NdiscCache::Entry::StopRetransmitTimer ()
@@ -30,7 +30,7 @@
 #include "ns3/net-device.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/ptr.h"
-#include "ns3/timer.h"
+#include "ns3/timer-queue.h"
 #include "ns3/sgi-hashmap.h"
 
 namespace ns3
@@ -137,6 +137,11 @@ public:
      */
     Entry (NdiscCache* nd);
 
+    /**
+     * \brief Destructor, which cancels the timers.
+     */
+    ~Entry ();
+
     /**
      * \brief Changes the state to this entry to INCOMPLETE.
      * \param p packet that wait to be sent
@@ -383,22 +388,22 @@ private:
     /**
      * \brief Reachable timer (used for NUD in REACHABLE state).
      */
-    Timer m_reachableTimer;
+    TimerQueue::Event m_reachableTimer;
 
     /**
      * \brief Retransmission timer (used for NUD in INCOMPLETE state).
      */
-    Timer m_retransTimer;
+    TimerQueue::Event m_retransTimer;
 
     /**
      * \brief Probe timer (used for NUD in PROBE state).
      */
-    Timer m_probeTimer;
+    TimerQueue::Event m_probeTimer;
 
     /**
      * \brief Delay timer (used for NUD when in DELAY state).
      */
-    Timer m_delayTimer;
+    TimerQueue::Event m_delayTimer;
 
     /**
      * \brief Last time we see a reachability confirmation.
@@ -432,6 +437,13 @@ private:
    */
   void DoDispose ();
 
+  /**
+   * \brief Get the timer queue of the entries.
+   * \return the timer queue of the node of the device, shared by all
+   * the caches of the node, or a queue of this cache if it has no device
+   */
+  Ptr<TimerQueue> GetTimerQueue ();
+
   /**
    * \brief The NetDevice.
    */
@@ -451,6 +463,11 @@ private:
    * \brief Max number of packet stored in m_waiting.
    */
   uint32_t m_unresQlen;
+
+  /**
+   * \brief The timer queue of the entries.
+   */
+  Ptr<TimerQueue> m_timerQueue;
 };
 
 } /* namespace ns3 */
@@ -216,14 +216,16 @@ uint32_t TcpHeader::GetSerializedSize (void)  const
 void TcpHeader::Serialize (Buffer::Iterator start)  const
 {
   Buffer::Iterator i = start;
-  i.WriteHtonU16 (m_sourcePort);
-  i.WriteHtonU16 (m_destinationPort);
-  i.WriteHtonU32 (m_sequenceNumber.GetValue ());
-  i.WriteHtonU32 (m_ackNumber.GetValue ());
-  i.WriteHtonU16 (m_length << 12 | m_flags); //reserved bits are all zero
-  i.WriteHtonU16 (m_windowSize);
-  i.WriteHtonU16 (0);
-  i.WriteHtonU16 (m_urgentPointer);
+  uint8_t header[Layout::SIZE];
+  Layout::SourcePort::Write (header, m_sourcePort);
+  Layout::DestinationPort::Write (header, m_destinationPort);
+  Layout::SequenceNumber::Write (header, m_sequenceNumber.GetValue ());
+  Layout::AckNumber::Write (header, m_ackNumber.GetValue ());
+  Layout::LengthFlags::Write (header, m_length << 12 | m_flags); //reserved bits are all zero
+  Layout::Window::Write (header, m_windowSize);
+  Layout::Checksum::Write (header, 0);
+  Layout::UrgentPointer::Write (header, m_urgentPointer);
+  i.Write (header, Layout::SIZE);
 
   if(m_calcChecksum)
     {
@@ -239,16 +241,17 @@ void TcpHeader::Serialize (Buffer::Iterator start)  const
 uint32_t TcpHeader::Deserialize (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
-  m_sourcePort = i.ReadNtohU16 ();
-  m_destinationPort = i.ReadNtohU16 ();
-  m_sequenceNumber = i.ReadNtohU32 ();
-  m_ackNumber = i.ReadNtohU32 ();
-  uint16_t field = i.ReadNtohU16 ();
+  uint8_t header[Layout::SIZE];
+  i.Read (header, Layout::SIZE);
+  m_sourcePort = Layout::SourcePort::Read (header);
+  m_destinationPort = Layout::DestinationPort::Read (header);
+  m_sequenceNumber = Layout::SequenceNumber::Read (header);
+  m_ackNumber = Layout::AckNumber::Read (header);
+  uint16_t field = Layout::LengthFlags::Read (header);
   m_flags = field & 0x3F;
   m_length = field>>12;
-  m_windowSize = i.ReadNtohU16 ();
-  i.Next (2);
-  m_urgentPointer = i.ReadNtohU16 ();
+  m_windowSize = Layout::Window::Read (header);
+  m_urgentPointer = Layout::UrgentPointer::Read (header);
 
   if(m_calcChecksum)
     {
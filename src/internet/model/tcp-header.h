@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include "ns3/header.h"
+#include "ns3/header-layout.h"
 #include "ns3/buffer.h"
 #include "ns3/tcp-socket-factory.h"
 #include "ns3/ipv4-address.h"
@@ -149,6 +150,26 @@ public:
    */
   bool IsChecksumOk (void) const;
 
+  /**
+   * \brief The fields of a serialized header without options
+   *
+   * Used by Serialize and Deserialize, and to read the fields of the
+   * header of a packet without deserializing it, see Packet::PeekBytes.
+   */
+  struct Layout
+  {
+    enum { SIZE = 20 };
+    typedef HeaderField<0, uint16_t> SourcePort;
+    typedef HeaderField<2, uint16_t> DestinationPort;
+    typedef HeaderField<4, uint32_t> SequenceNumber;
+    typedef HeaderField<8, uint32_t> AckNumber;
+    // the header length in 32-bit words in the 4 high bits, the flags below.
+    typedef HeaderField<12, uint16_t> LengthFlags;
+    typedef HeaderField<14, uint16_t> Window;
+    typedef HeaderLsbField<16, uint16_t> Checksum;
+    typedef HeaderField<18, uint16_t> UrgentPointer;
+  };
+
 private:
   uint16_t CalculateHeaderChecksum (uint16_t size) const;
   uint16_t m_sourcePort;
@@ -19,7 +19,7 @@
  */
 
 #define NS_LOG_APPEND_CONTEXT \
-  if (m_node) { std::clog << Simulator::Now ().GetSeconds () << " [node " << m_node->GetId () << "] "; }
+  if (m_node) { ns3LogStream << Simulator::Now ().GetSeconds () << " [node " << m_node->GetId () << "] "; }
 
 #include "tcp-newreno.h"
 #include "ns3/log.h"
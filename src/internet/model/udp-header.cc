@@ -139,10 +139,12 @@ UdpHeader::Serialize (Buffer::Iterator start) const
 {
   Buffer::Iterator i = start;
 
-  i.WriteHtonU16 (m_sourcePort);
-  i.WriteHtonU16 (m_destinationPort);
-  i.WriteHtonU16 (start.GetSize ());
-  i.WriteU16 (0);
+  uint8_t header[Layout::SIZE];
+  Layout::SourcePort::Write (header, m_sourcePort);
+  Layout::DestinationPort::Write (header, m_destinationPort);
+  Layout::Length::Write (header, start.GetSize ());
+  Layout::Checksum::Write (header, 0);
+  i.Write (header, Layout::SIZE);
 
   if (m_calcChecksum)
     {
@@ -159,10 +161,11 @@ uint32_t
 UdpHeader::Deserialize (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
-  m_sourcePort = i.ReadNtohU16 ();
-  m_destinationPort = i.ReadNtohU16 ();
-  m_payloadSize = i.ReadNtohU16 () - GetSerializedSize ();
-  i.Next (2);
+  uint8_t header[Layout::SIZE];
+  i.Read (header, Layout::SIZE);
+  m_sourcePort = Layout::SourcePort::Read (header);
+  m_destinationPort = Layout::DestinationPort::Read (header);
+  m_payloadSize = Layout::Length::Read (header) - GetSerializedSize ();
 
   if(m_calcChecksum)
     {
@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <string>
 #include "ns3/header.h"
+#include "ns3/header-layout.h"
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -96,6 +97,21 @@ public:
    */
   bool IsChecksumOk (void) const;
 
+  /**
+   * \brief The fields of a serialized header
+   *
+   * Used by Serialize and Deserialize, and to read the ports of the
+   * header of a packet without deserializing it, see Packet::PeekBytes.
+   */
+  struct Layout
+  {
+    enum { SIZE = 8 };
+    typedef HeaderField<0, uint16_t> SourcePort;
+    typedef HeaderField<2, uint16_t> DestinationPort;
+    typedef HeaderField<4, uint16_t> Length;
+    typedef HeaderLsbField<6, uint16_t> Checksum;
+  };
+
 private:
   uint16_t CalculateHeaderChecksum (uint16_t size) const;
   uint16_t m_sourcePort;
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/fragment-intervals.h"
+
+namespace ns3 {
+
+class FragmentIntervalsTestCase : public TestCase
+{
+public:
+  FragmentIntervalsTestCase ();
+  virtual void DoRun (void);
+private:
+  // the bytes [start, end) of a datagram whose byte i is i + value.
+  Ptr<Packet> CreateFragment (uint32_t start, uint32_t end, uint8_t value);
+  // true if byte i of the packet is i.
+  bool Check (Ptr<Packet> p);
+};
+
+FragmentIntervalsTestCase::FragmentIntervalsTestCase ()
+  : TestCase ("Check the reassembly of overlapping fragments")
+{
+}
+
+Ptr<Packet>
+FragmentIntervalsTestCase::CreateFragment (uint32_t start, uint32_t end, uint8_t value)
+{
+  uint8_t buffer[256];
+  for (uint32_t i = start; i < end; i++)
+    {
+      buffer[i - start] = i + value;
+    }
+  return Create<Packet> (buffer, end - start);
+}
+
+bool
+FragmentIntervalsTestCase::Check (Ptr<Packet> p)
+{
+  uint8_t buffer[256];
+  p->CopyData (buffer, p->GetSize ());
+  for (uint32_t i = 0; i < p->GetSize (); i++)
+    {
+      if (buffer[i] != i)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+FragmentIntervalsTestCase::DoRun (void)
+{
+  // out of order, the bytes received first are kept.
+  Ptr<Packet> p;
+  FragmentIntervals a;
+  NS_TEST_EXPECT_MSG_EQ (a.AddFragment (CreateFragment (8, 24, 0), 8, true), 16, "All the bytes are new");
+  NS_TEST_EXPECT_MSG_EQ (a.AddFragment (CreateFragment (16, 40, 100), 16, true), 16, "The overlapping bytes are discarded");
+  NS_TEST_EXPECT_MSG_EQ (a.GetPartialPacket ()->GetSize (), 0, "No byte from the start");
+  NS_TEST_EXPECT_MSG_EQ (a.AddFragment (CreateFragment (0, 12, 0), 0, true), 8, "The overlapping bytes are discarded");
+  NS_TEST_EXPECT_MSG_EQ (a.IsEntire (), false, "The last fragment is missing");
+  p = a.GetPartialPacket ();
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 40, "The bytes received, without gap");
+  NS_TEST_EXPECT_MSG_EQ (Check (p->CreateFragment (0, 24)), true, "The bytes received first");
+  NS_TEST_EXPECT_MSG_EQ (a.AddFragment (CreateFragment (0, 48, 0), 0, false), 8, "The last bytes");
+  NS_TEST_EXPECT_MSG_EQ (a.IsEntire (), true, "The datagram is complete");
+  NS_TEST_EXPECT_MSG_EQ (a.AddFragment (CreateFragment (0, 48, 0), 0, false), 0, "All the bytes were received");
+  NS_TEST_EXPECT_MSG_EQ (a.GetSize (), 48, "The bytes of the datagram");
+
+  // a fragment which covers several gaps, before the last one.
+  FragmentIntervals b;
+  b.AddFragment (CreateFragment (8, 16, 0), 8, true);
+  b.AddFragment (CreateFragment (24, 32, 0), 24, true);
+  NS_TEST_EXPECT_MSG_EQ (b.AddFragment (CreateFragment (0, 40, 0), 0, true), 24, "Three gaps are filled");
+  NS_TEST_EXPECT_MSG_EQ (b.IsEntire (), false, "The last fragment is missing");
+  NS_TEST_EXPECT_MSG_EQ (b.AddFragment (CreateFragment (40, 48, 0), 40, false), 8, "The last fragment");
+  NS_TEST_EXPECT_MSG_EQ (b.IsEntire (), true, "The datagram is complete");
+  p = b.GetPacket ();
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 48, "The length of the datagram");
+  NS_TEST_EXPECT_MSG_EQ (Check (p), true, "The bytes are in order");
+
+  // the bytes received beyond the end of the datagram are discarded.
+  FragmentIntervals c;
+  c.AddFragment (CreateFragment (8, 32, 0), 8, true);
+  c.AddFragment (CreateFragment (40, 48, 0), 40, true);
+  NS_TEST_EXPECT_MSG_EQ (c.AddFragment (CreateFragment (0, 16, 0), 0, false), -16, "The bytes beyond the end are released");
+  NS_TEST_EXPECT_MSG_EQ (c.GetSize (), 16, "The bytes beyond the end were discarded");
+  NS_TEST_EXPECT_MSG_EQ (c.IsEntire (), true, "The datagram is complete");
+  p = c.GetPacket ();
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 16, "The length of the datagram");
+  NS_TEST_EXPECT_MSG_EQ (Check (p), true, "The bytes are in order");
+
+  // the last fragment shortens an interval already received.
+  FragmentIntervals d;
+  NS_TEST_EXPECT_MSG_EQ (d.AddFragment (Create<Packet> (1000), 0, true), 1000, "The first fragment");
+  NS_TEST_EXPECT_MSG_EQ (d.AddFragment (Create<Packet> (1000), 1000, true), 1000, "The second fragment");
+  NS_TEST_EXPECT_MSG_EQ (d.AddFragment (Create<Packet> (500), 1000, false), -500, "The bytes beyond the end are released");
+  NS_TEST_EXPECT_MSG_EQ (d.GetSize (), 1500, "The bytes of the datagram");
+  NS_TEST_EXPECT_MSG_EQ (d.IsEntire (), true, "The datagram is complete");
+  NS_TEST_EXPECT_MSG_EQ (d.GetPacket ()->GetSize (), 1500, "The length of the datagram");
+}
+
+static class FragmentIntervalsTestSuite : public TestSuite
+{
+public:
+  FragmentIntervalsTestSuite ()
+    : TestSuite ("fragment-intervals", UNIT)
+  {
+    AddTestCase (new FragmentIntervalsTestCase ());
+  }
+} g_fragmentIntervalsTestSuite;
+
+} // namespace ns3
@@ -46,8 +46,11 @@
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/ipv4-static-routing.h"
 #include "ns3/udp-l4-protocol.h"
+#include "ns3/udp-header.h"
+#include "ns3/ipv4-header.h"
 
 #include <string>
+#include <vector>
 #include <limits>
 #include <netinet/in.h>
 
@@ -402,6 +405,269 @@ Ipv4FragmentationTest::DoRun (void)
 
   Simulator::Destroy ();
 }
+
+//-----------------------------------------------------------------------------
+// The reassembly tests below hand crafted fragments to the IPv4 layer of a
+// server node, which receives the reassembled datagrams on a UDP socket.
+
+static Ptr<ErrorNetDevice>
+CreateReassemblyServer (Ptr<Node> node)
+{
+  AddInternetStack (node);
+  Ptr<ErrorNetDevice> device = CreateObject<ErrorNetDevice> ();
+  device->SetAddress (Mac48Address::ConvertFrom (Mac48Address::Allocate ()));
+  device->SetMtu (1500);
+  node->AddDevice (device);
+  Ptr<ErrorChannel> channel = CreateObject<ErrorChannel> ();
+  device->SetChannel (channel);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  uint32_t netdev_idx = ipv4->AddInterface (device);
+  ipv4->AddAddress (netdev_idx, Ipv4InterfaceAddress (Ipv4Address ("10.0.0.1"), Ipv4Mask (0xffff0000U)));
+  ipv4->SetUp (netdev_idx);
+  return device;
+}
+
+/**
+ * \returns a UDP datagram to port 9 whose payload is filled with the given byte.
+ */
+static Ptr<Packet>
+CreateDatagram (uint8_t fill, uint32_t payloadSize)
+{
+  std::vector<uint8_t> payload (payloadSize, fill);
+  Ptr<Packet> datagram = Create<Packet> (&payload[0], payloadSize);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (1000);
+  udpHeader.SetDestinationPort (9);
+  datagram->AddHeader (udpHeader);
+  return datagram;
+}
+
+static Ptr<Packet>
+CreateFragment (Ptr<Packet> datagram, Ipv4Address source, uint16_t identification,
+                uint32_t offset, uint32_t size)
+{
+  Ptr<Packet> fragment = datagram->CreateFragment (offset, size);
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (source);
+  ipHeader.SetDestination (Ipv4Address ("10.0.0.1"));
+  ipHeader.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+  ipHeader.SetIdentification (identification);
+  ipHeader.SetPayloadSize (size);
+  ipHeader.SetTtl (64);
+  ipHeader.SetFragmentOffset (offset);
+  if (offset + size < datagram->GetSize ())
+    {
+      ipHeader.SetMoreFragments ();
+    }
+  else
+    {
+      ipHeader.SetLastFragment ();
+    }
+  fragment->AddHeader (ipHeader);
+  return fragment;
+}
+
+static void
+DeliverFragment (Ptr<NetDevice> device, Ptr<Packet> fragment)
+{
+  Ptr<Ipv4L3Protocol> ipv4 = device->GetNode ()->GetObject<Ipv4L3Protocol> ();
+  ipv4->Receive (device, fragment, Ipv4L3Protocol::PROT_NUMBER,
+                 device->GetAddress (), device->GetAddress (), NetDevice::PACKET_HOST);
+}
+
+class Ipv4ReassemblyTest : public TestCase
+{
+public:
+  Ipv4ReassemblyTest (std::string name);
+
+protected:
+  void StartServer (Ptr<Node> node);
+  void HandleReadServer (Ptr<Socket> socket);
+  void ScheduleFragment (Time time, Ptr<NetDevice> device, Ptr<Packet> fragment);
+
+  Ptr<Socket> m_socketServer;
+  std::vector<Ptr<Packet> > m_receivedPackets;
+  std::vector<Ipv4Address> m_receivedFrom;
+};
+
+Ipv4ReassemblyTest::Ipv4ReassemblyTest (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+Ipv4ReassemblyTest::StartServer (Ptr<Node> node)
+{
+  m_socketServer = Socket::CreateSocket (node, UdpSocketFactory::GetTypeId ());
+  m_socketServer->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+  m_socketServer->SetRecvCallback (MakeCallback (&Ipv4ReassemblyTest::HandleReadServer, this));
+}
+
+void
+Ipv4ReassemblyTest::HandleReadServer (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  Address from;
+  while (packet = socket->RecvFrom (from))
+    {
+      m_receivedPackets.push_back (packet);
+      m_receivedFrom.push_back (InetSocketAddress::ConvertFrom (from).GetIpv4 ());
+    }
+}
+
+void
+Ipv4ReassemblyTest::ScheduleFragment (Time time, Ptr<NetDevice> device, Ptr<Packet> fragment)
+{
+  Simulator::ScheduleWithContext (device->GetNode ()->GetId (), time,
+                                  &DeliverFragment, device, fragment);
+}
+
+/**
+ * Two datagrams from different sources with the same identification,
+ * whose fragments arrive interleaved, must be reassembled apart.
+ */
+class Ipv4FragmentationInterleavedTest : public Ipv4ReassemblyTest
+{
+public:
+  Ipv4FragmentationInterleavedTest ();
+  virtual void DoRun (void);
+};
+
+Ipv4FragmentationInterleavedTest::Ipv4FragmentationInterleavedTest ()
+  : Ipv4ReassemblyTest ("Verify the IPv4 reassembly of interleaved fragments from two sources")
+{
+}
+
+void
+Ipv4FragmentationInterleavedTest::DoRun (void)
+{
+  Ptr<Node> serverNode = CreateObject<Node> ();
+  Ptr<ErrorNetDevice> serverDev = CreateReassemblyServer (serverNode);
+  StartServer (serverNode);
+
+  Ipv4Address sourceA ("10.0.0.2");
+  Ipv4Address sourceB ("10.0.0.3");
+  Ptr<Packet> datagramA = CreateDatagram ('a', 1992);
+  Ptr<Packet> datagramB = CreateDatagram ('b', 1992);
+  ScheduleFragment (Seconds (0.1), serverDev, CreateFragment (datagramA, sourceA, 7, 0, 1000));
+  ScheduleFragment (Seconds (0.2), serverDev, CreateFragment (datagramB, sourceB, 7, 0, 1000));
+  ScheduleFragment (Seconds (0.3), serverDev, CreateFragment (datagramA, sourceA, 7, 1000, 1000));
+  ScheduleFragment (Seconds (0.4), serverDev, CreateFragment (datagramB, sourceB, 7, 1000, 1000));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPackets.size (), 2, "The two datagrams were not reassembled");
+  Ipv4Address source[2] = { sourceA, sourceB };
+  uint8_t fill[2] = { 'a', 'b' };
+  for (uint32_t i = 0; i < m_receivedPackets.size () && i < 2; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_receivedFrom[i], source[i], "Wrong source of datagram " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_receivedPackets[i]->GetSize (), 1992, "Wrong size of datagram " << i);
+      uint8_t buffer[1992];
+      m_receivedPackets[i]->CopyData (buffer, 1992);
+      std::vector<uint8_t> expected (1992, fill[i]);
+      NS_TEST_EXPECT_MSG_EQ (memcmp (buffer, &expected[0], 1992), 0, "Mixed content in datagram " << i);
+    }
+
+  Ptr<Ipv4L3Protocol> ipv4 = serverNode->GetObject<Ipv4L3Protocol> ();
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetFragmentBufferUsage (), 0, "Bytes left in the fragment buffer");
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetNFragmentsDropped (), 0, "Fragments dropped");
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetNReassemblyTimeouts (), 0, "Reassembly timed out");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * A fragment beyond FragmentBufferSize is dropped, and the bytes of a
+ * datagram whose reassembly times out are released.
+ */
+class Ipv4FragmentationBufferTest : public Ipv4ReassemblyTest
+{
+public:
+  Ipv4FragmentationBufferTest ();
+  virtual void DoRun (void);
+private:
+  void CheckUsage (Ptr<Ipv4L3Protocol> ipv4);
+  uint32_t m_usage;
+};
+
+Ipv4FragmentationBufferTest::Ipv4FragmentationBufferTest ()
+  : Ipv4ReassemblyTest ("Verify the IPv4 fragment buffer limit and reassembly timeout")
+{
+}
+
+void
+Ipv4FragmentationBufferTest::CheckUsage (Ptr<Ipv4L3Protocol> ipv4)
+{
+  m_usage = ipv4->GetFragmentBufferUsage ();
+}
+
+void
+Ipv4FragmentationBufferTest::DoRun (void)
+{
+  Ptr<Node> serverNode = CreateObject<Node> ();
+  Ptr<ErrorNetDevice> serverDev = CreateReassemblyServer (serverNode);
+  StartServer (serverNode);
+  Ptr<Ipv4L3Protocol> ipv4 = serverNode->GetObject<Ipv4L3Protocol> ();
+  ipv4->SetAttribute ("FragmentBufferSize", UintegerValue (1500));
+
+  Ptr<Packet> datagramA = CreateDatagram ('a', 1992);
+  Ptr<Packet> datagramB = CreateDatagram ('b', 1992);
+  ScheduleFragment (Seconds (0.1), serverDev, CreateFragment (datagramA, Ipv4Address ("10.0.0.2"), 7, 0, 1000));
+  ScheduleFragment (Seconds (0.2), serverDev, CreateFragment (datagramB, Ipv4Address ("10.0.0.3"), 7, 0, 1000));
+  Simulator::Schedule (Seconds (1), &Ipv4FragmentationBufferTest::CheckUsage, this, ipv4);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_usage, 1000, "Wrong usage of the fragment buffer before the timeout");
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPackets.size (), 0, "Server got a packet, something wrong");
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetNFragmentsDropped (), 1, "The fragment beyond the buffer was not dropped");
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetNReassemblyTimeouts (), 1, "The reassembly did not time out");
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetFragmentBufferUsage (), 0, "Bytes left in the fragment buffer");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * A last fragment which ends within bytes already received releases the
+ * bytes beyond the end of the datagram from the fragment buffer.
+ */
+class Ipv4FragmentationTruncatedTest : public Ipv4ReassemblyTest
+{
+public:
+  Ipv4FragmentationTruncatedTest ();
+  virtual void DoRun (void);
+};
+
+Ipv4FragmentationTruncatedTest::Ipv4FragmentationTruncatedTest ()
+  : Ipv4ReassemblyTest ("Verify the IPv4 fragment buffer usage when the last fragment truncates the datagram")
+{
+}
+
+void
+Ipv4FragmentationTruncatedTest::DoRun (void)
+{
+  Ptr<Node> serverNode = CreateObject<Node> ();
+  Ptr<ErrorNetDevice> serverDev = CreateReassemblyServer (serverNode);
+  StartServer (serverNode);
+
+  Ipv4Address source ("10.0.0.2");
+  Ptr<Packet> datagram = CreateDatagram ('a', 1492);
+  Ptr<Packet> longDatagram = CreateDatagram ('a', 2992);
+  ScheduleFragment (Seconds (0.1), serverDev, CreateFragment (datagram, source, 7, 0, 1000));
+  ScheduleFragment (Seconds (0.2), serverDev, CreateFragment (longDatagram, source, 7, 1000, 1000));
+  ScheduleFragment (Seconds (0.3), serverDev, CreateFragment (datagram, source, 7, 1000, 500));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPackets.size (), 1, "The datagram was not reassembled");
+  if (m_receivedPackets.size () == 1)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_receivedPackets[0]->GetSize (), 1492, "Wrong size of the datagram");
+    }
+  Ptr<Ipv4L3Protocol> ipv4 = serverNode->GetObject<Ipv4L3Protocol> ();
+  NS_TEST_EXPECT_MSG_EQ (ipv4->GetFragmentBufferUsage (), 0, "Bytes left in the fragment buffer");
+
+  Simulator::Destroy ();
+}
+
 //-----------------------------------------------------------------------------
 class Ipv4FragmentationTestSuite : public TestSuite
 {
@@ -409,6 +675,9 @@ public:
   Ipv4FragmentationTestSuite () : TestSuite ("ipv4-fragmentation", UNIT)
   {
     AddTestCase (new Ipv4FragmentationTest);
+    AddTestCase (new Ipv4FragmentationInterleavedTest);
+    AddTestCase (new Ipv4FragmentationBufferTest);
+    AddTestCase (new Ipv4FragmentationTruncatedTest);
   }
 } g_ipv4fragmentationTestSuite;
 
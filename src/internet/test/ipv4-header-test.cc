@@ -257,6 +257,136 @@ Ipv4HeaderTest::DoRun (void)
  
   Simulator::Destroy ();
 }
+
+class Ipv4HeaderChecksumTest : public TestCase
+{
+public:
+  virtual void DoRun (void);
+  Ipv4HeaderChecksumTest ();
+};
+
+Ipv4HeaderChecksumTest::Ipv4HeaderChecksumTest ()
+  : TestCase ("IPv4 Header incremental checksum update")
+{
+}
+
+void
+Ipv4HeaderChecksumTest::DoRun (void)
+{
+  for (uint32_t ttl = 1; ttl < 256; ttl++)
+    {
+      Ipv4Header original;
+      original.EnableChecksum ();
+      original.SetSource (Ipv4Address ("10.1.2.3"));
+      original.SetDestination (Ipv4Address ("192.168.254.17"));
+      original.SetProtocol (ttl & 1 ? 6 : 17);
+      original.SetPayloadSize (ttl * 5);
+      original.SetIdentification (ttl * 251);
+      original.SetTtl (ttl);
+      Ptr<Packet> p = Create<Packet> ();
+      p->AddHeader (original);
+
+      // decrement the ttl of the received header as a router does: the
+      // serialized header must be the one of a fresh header with that ttl.
+      Ipv4Header forwarded;
+      forwarded.EnableChecksum ();
+      p->RemoveHeader (forwarded);
+      NS_TEST_EXPECT_MSG_EQ (forwarded.IsChecksumOk (), true, "bad checksum");
+      forwarded.SetTtl (ttl - 1);
+      p->AddHeader (forwarded);
+
+      original.SetTtl (ttl - 1);
+      Ptr<Packet> expected = Create<Packet> ();
+      expected->AddHeader (original);
+
+      uint8_t got[20];
+      uint8_t wanted[20];
+      p->CopyData (got, 20);
+      expected->CopyData (wanted, 20);
+      for (uint32_t j = 0; j < 20; j++)
+        {
+          uint32_t gotByte = got[j];
+          uint32_t wantedByte = wanted[j];
+          NS_TEST_EXPECT_MSG_EQ (gotByte, wantedByte, "byte " << j << " with ttl " << ttl);
+        }
+
+      Ipv4Header check;
+      check.EnableChecksum ();
+      p->RemoveHeader (check);
+      NS_TEST_EXPECT_MSG_EQ (check.IsChecksumOk (), true, "bad checksum after ttl decrement");
+      uint32_t checkTtl = check.GetTtl ();
+      NS_TEST_EXPECT_MSG_EQ (checkTtl, ttl - 1, "bad ttl");
+
+      // any other change falls back to a full computation.
+      check.SetTtl (check.GetTtl () + 1);
+      check.SetSource (Ipv4Address ("10.1.2.4"));
+      p->AddHeader (check);
+      Ipv4Header last;
+      last.EnableChecksum ();
+      p->RemoveHeader (last);
+      NS_TEST_EXPECT_MSG_EQ (last.IsChecksumOk (), true, "bad checksum after source change");
+    }
+}
+
+class Ipv4HeaderLayoutTest : public TestCase
+{
+public:
+  virtual void DoRun (void);
+  Ipv4HeaderLayoutTest ();
+};
+
+Ipv4HeaderLayoutTest::Ipv4HeaderLayoutTest ()
+  : TestCase ("IPv4 Header fields read without deserialization")
+{
+}
+
+void
+Ipv4HeaderLayoutTest::DoRun (void)
+{
+  Ipv4Header header;
+  header.EnableChecksum ();
+  header.SetTos (0x2e);
+  header.SetPayloadSize (1480);
+  header.SetIdentification (0xbeef);
+  header.SetMoreFragments ();
+  header.SetFragmentOffset (2960);
+  header.SetTtl (63);
+  header.SetProtocol (17);
+  header.SetSource (Ipv4Address ("10.1.2.3"));
+  header.SetDestination (Ipv4Address ("192.168.254.17"));
+  Ptr<Packet> p = Create<Packet> (1480);
+  p->AddHeader (header);
+
+  uint8_t scratch[Ipv4Header::Layout::SIZE];
+  uint8_t const *bytes = p->PeekBytes (Ipv4Header::Layout::SIZE, scratch);
+  uint32_t field = Ipv4Header::Layout::VersionIhl::Read (bytes);
+  NS_TEST_EXPECT_MSG_EQ (field, 0x45, "version and header length");
+  field = Ipv4Header::Layout::Tos::Read (bytes);
+  NS_TEST_EXPECT_MSG_EQ (field, 0x2e, "tos");
+  field = Ipv4Header::Layout::TotalLength::Read (bytes);
+  NS_TEST_EXPECT_MSG_EQ (field, 1500, "total length");
+  field = Ipv4Header::Layout::Identification::Read (bytes);
+  NS_TEST_EXPECT_MSG_EQ (field, 0xbeef, "identification");
+  field = Ipv4Header::Layout::FlagsFragmentOffset::Read (bytes);
+  NS_TEST_EXPECT_MSG_EQ (field, (Ipv4Header::Layout::MORE_FRAGMENTS | (2960 / 8)), "flags and fragment offset");
+  field = Ipv4Header::Layout::Ttl::Read (bytes);
+  NS_TEST_EXPECT_MSG_EQ (field, 63, "ttl");
+  field = Ipv4Header::Layout::Protocol::Read (bytes);
+  NS_TEST_EXPECT_MSG_EQ (field, 17, "protocol");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4Address (Ipv4Header::Layout::Source::Read (bytes)), Ipv4Address ("10.1.2.3"), "source");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4Address (Ipv4Header::Layout::Destination::Read (bytes)), Ipv4Address ("192.168.254.17"), "destination");
+
+  Ipv4Header deserialized;
+  deserialized.EnableChecksum ();
+  p->PeekHeader (deserialized);
+  NS_TEST_EXPECT_MSG_EQ (deserialized.IsChecksumOk (), true, "bad checksum");
+  NS_TEST_EXPECT_MSG_EQ (deserialized.IsLastFragment (), false, "more fragments");
+  NS_TEST_EXPECT_MSG_EQ (deserialized.IsDontFragment (), false, "don't fragment");
+  NS_TEST_EXPECT_MSG_EQ (deserialized.GetFragmentOffset (), 2960, "fragment offset");
+  NS_TEST_EXPECT_MSG_EQ (deserialized.GetPayloadSize (), 1480, "payload size");
+  uint32_t checksum = Ipv4Header::Layout::Checksum::Read (bytes);
+  NS_TEST_EXPECT_MSG_EQ ((checksum != 0), true, "checksum");
+}
 //-----------------------------------------------------------------------------
 class Ipv4HeaderTestSuite : public TestSuite
 {
@@ -264,6 +394,8 @@ public:
   Ipv4HeaderTestSuite () : TestSuite ("ipv4-header", UNIT)
   {
     AddTestCase (new Ipv4HeaderTest);
+    AddTestCase (new Ipv4HeaderChecksumTest);
+    AddTestCase (new Ipv4HeaderLayoutTest);
   }
 } g_ipv4HeaderTestSuite;
 
@@ -94,6 +94,55 @@ Ipv4L3ProtocolTestCase::DoRun (void)
   Ipv4InterfaceAddress output = interface->GetAddress (2);
   NS_TEST_ASSERT_MSG_EQ (ifaceAddr4, output,
                          "The addresses should be identical");
+
+  // the lookups follow the addresses added to and removed from the
+  // interfaces.
+  int32_t found = ipv4->GetInterfaceForAddress ("192.168.0.2");
+  NS_TEST_ASSERT_MSG_EQ (found, 0, "Address of the first interface not found");
+  found = ipv4->GetInterfaceForAddress ("10.30.0.1");
+  NS_TEST_ASSERT_MSG_EQ (found, -1, "Removed address should not be found");
+  found = ipv4->GetInterfaceForPrefix ("250.0.0.0", "255.255.255.0");
+  NS_TEST_ASSERT_MSG_EQ (found, 0, "Prefix of the first interface not found");
+  found = ipv4->GetInterfaceForPrefix ("10.30.0.0", "255.255.255.0");
+  NS_TEST_ASSERT_MSG_EQ (found, -1, "Removed prefix should not be found");
+  found = ipv4->GetInterfaceForDevice (device);
+  NS_TEST_ASSERT_MSG_EQ (found, 0, "Device of the first interface not found");
+
+  Ptr<Ipv4Interface> interface2 = CreateObject<Ipv4Interface> ();
+  Ptr<LoopbackNetDevice> device2 = CreateObject<LoopbackNetDevice> ();
+  node->AddDevice (device2);
+  interface2->SetDevice (device2);
+  interface2->SetNode (node);
+  index = ipv4->AddIpv4Interface (interface2);
+  NS_TEST_ASSERT_MSG_EQ (index, 1, "The index is not 1??");
+  found = ipv4->GetInterfaceForDevice (device2);
+  NS_TEST_ASSERT_MSG_EQ (found, 1, "Device of the second interface not found");
+  ipv4->AddAddress (1, Ipv4InterfaceAddress ("172.16.0.1", "255.255.0.0"));
+  found = ipv4->GetInterfaceForAddress ("172.16.0.1");
+  NS_TEST_ASSERT_MSG_EQ (found, 1, "Address of the second interface not found");
+  found = ipv4->GetInterfaceForPrefix ("172.16.3.4", "255.255.0.0");
+  NS_TEST_ASSERT_MSG_EQ (found, 1, "Prefix of the second interface not found");
+  found = ipv4->GetInterfaceForPrefix ("192.168.0.9", "255.255.0.0");
+  NS_TEST_ASSERT_MSG_EQ (found, 0, "Prefix of the first interface not found");
+  // the same address on both interfaces is found on the first one
+  ipv4->AddAddress (1, Ipv4InterfaceAddress ("192.168.0.1", "255.255.255.0"));
+  found = ipv4->GetInterfaceForAddress ("192.168.0.1");
+  NS_TEST_ASSERT_MSG_EQ (found, 0, "Address of both interfaces not found on the first");
+
+  ipv4->SetWeakEsModel (true);
+  NS_TEST_ASSERT_MSG_EQ (ipv4->IsDestinationAddress ("172.16.0.1", 0), true,
+                         "Address of another interface (weak ES)");
+  NS_TEST_ASSERT_MSG_EQ (ipv4->IsDestinationAddress ("172.16.255.255", 0), true,
+                         "Broadcast of another interface (weak ES)");
+  NS_TEST_ASSERT_MSG_EQ (ipv4->IsDestinationAddress ("172.17.0.1", 0), false,
+                         "Unknown address");
+  ipv4->SetWeakEsModel (false);
+  NS_TEST_ASSERT_MSG_EQ (ipv4->IsDestinationAddress ("172.16.0.1", 0), false,
+                         "Address of another interface (strong ES)");
+  ipv4->RemoveAddress (1, 0);
+  ipv4->SetWeakEsModel (true);
+  NS_TEST_ASSERT_MSG_EQ (ipv4->IsDestinationAddress ("172.16.0.1", 0), false,
+                         "Removed address of another interface");
   Simulator::Destroy ();
 }
 
@@ -0,0 +1,190 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/**
+ * This is the test code for the reassembly of the IPv6 fragments, with
+ * an ICMPv6 echo too large for the links in both directions.
+ */
+
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/internet-stack-helper.h"
+
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/ipv6-extension.h"
+#include "ns3/ipv6-extension-demux.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/icmpv6-header.h"
+
+namespace ns3 {
+
+class Ipv6FragmentationEchoTest : public TestCase
+{
+public:
+  Ipv6FragmentationEchoTest ();
+  virtual void DoRun (void);
+
+private:
+  Ptr<SimpleNetDevice> AddInterface (Ptr<Node> node, Ptr<SimpleChannel> channel, Ipv6Address address);
+  void SendEchoRequest (Ptr<Node> node, Ipv6Address destination, uint32_t size);
+  void TxServer (Ptr<const Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface);
+  void RxClient (Ptr<const Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface);
+  void Drop (const Ipv6Header &header, Ptr<const Packet> packet,
+             Ipv6L3Protocol::DropReason reason, Ptr<Ipv6> ipv6, uint32_t interface);
+  static Ptr<Ipv6ExtensionFragment> GetFragmentExtension (Ptr<Node> node);
+
+  uint32_t m_serverTxFragments;
+  uint32_t m_serverTxBytes;
+  uint32_t m_clientRxFragments;
+  uint32_t m_drops;
+};
+
+Ipv6FragmentationEchoTest::Ipv6FragmentationEchoTest ()
+  : TestCase ("Verify the IPv6 reassembly of a fragmented ICMPv6 echo and of its reply"),
+    m_serverTxFragments (0),
+    m_serverTxBytes (0),
+    m_clientRxFragments (0),
+    m_drops (0)
+{
+}
+
+Ptr<SimpleNetDevice>
+Ipv6FragmentationEchoTest::AddInterface (Ptr<Node> node, Ptr<SimpleChannel> channel, Ipv6Address address)
+{
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  device->SetMtu (1500);
+  device->SetChannel (channel);
+  node->AddDevice (device);
+  Ptr<Ipv6> ipv6 = node->GetObject<Ipv6> ();
+  uint32_t index = ipv6->AddInterface (device);
+  ipv6->AddAddress (index, Ipv6InterfaceAddress (address, Ipv6Prefix (64)));
+  ipv6->SetUp (index);
+  return device;
+}
+
+void
+Ipv6FragmentationEchoTest::SendEchoRequest (Ptr<Node> node, Ipv6Address destination, uint32_t size)
+{
+  Icmpv6Echo echo (true);
+  echo.SetId (1);
+  echo.SetSeq (1);
+  node->GetObject<Icmpv6L4Protocol> ()->SendMessage (Create<Packet> (size), destination, echo, 64);
+}
+
+void
+Ipv6FragmentationEchoTest::TxServer (Ptr<const Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface)
+{
+  Ipv6Header header;
+  packet->PeekHeader (header);
+  if (header.GetNextHeader () == Ipv6ExtensionFragment::EXT_NUMBER)
+    {
+      m_serverTxFragments++;
+      m_serverTxBytes += packet->GetSize ();
+    }
+}
+
+void
+Ipv6FragmentationEchoTest::RxClient (Ptr<const Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface)
+{
+  Ipv6Header header;
+  packet->PeekHeader (header);
+  if (header.GetNextHeader () == Ipv6ExtensionFragment::EXT_NUMBER)
+    {
+      m_clientRxFragments++;
+    }
+}
+
+void
+Ipv6FragmentationEchoTest::Drop (const Ipv6Header &header, Ptr<const Packet> packet,
+                                 Ipv6L3Protocol::DropReason reason, Ptr<Ipv6> ipv6, uint32_t interface)
+{
+  m_drops++;
+}
+
+Ptr<Ipv6ExtensionFragment>
+Ipv6FragmentationEchoTest::GetFragmentExtension (Ptr<Node> node)
+{
+  Ptr<Ipv6ExtensionDemux> demux = node->GetObject<Ipv6ExtensionDemux> ();
+  return DynamicCast<Ipv6ExtensionFragment> (demux->GetExtension (Ipv6ExtensionFragment::EXT_NUMBER));
+}
+
+void
+Ipv6FragmentationEchoTest::DoRun (void)
+{
+  Config::SetDefault ("ns3::Icmpv6L4Protocol::DAD", BooleanValue (false));
+
+  Ptr<Node> serverNode = CreateObject<Node> ();
+  Ptr<Node> clientNode = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (serverNode);
+  internet.Install (clientNode);
+
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  AddInterface (serverNode, channel, Ipv6Address ("2001:1::1"));
+  AddInterface (clientNode, channel, Ipv6Address ("2001:1::2"));
+
+  serverNode->GetObject<Ipv6L3Protocol> ()->TraceConnectWithoutContext (
+    "Tx", MakeCallback (&Ipv6FragmentationEchoTest::TxServer, this));
+  clientNode->GetObject<Ipv6L3Protocol> ()->TraceConnectWithoutContext (
+    "Rx", MakeCallback (&Ipv6FragmentationEchoTest::RxClient, this));
+  serverNode->GetObject<Ipv6L3Protocol> ()->TraceConnectWithoutContext (
+    "Drop", MakeCallback (&Ipv6FragmentationEchoTest::Drop, this));
+  clientNode->GetObject<Ipv6L3Protocol> ()->TraceConnectWithoutContext (
+    "Drop", MakeCallback (&Ipv6FragmentationEchoTest::Drop, this));
+
+  // an echo request of 4000 bytes of data does not fit in 1500 bytes,
+  // and neither does the echo reply which carries the same data.
+  Simulator::ScheduleWithContext (clientNode->GetId (), Seconds (1),
+                                  &Ipv6FragmentationEchoTest::SendEchoRequest, this,
+                                  clientNode, Ipv6Address ("2001:1::1"), 4000);
+  Simulator::Run ();
+
+  // The server replies only if it reassembled the request.
+  NS_TEST_EXPECT_MSG_EQ (m_serverTxFragments, 3, "The server did not send a fragmented echo reply");
+  NS_TEST_EXPECT_MSG_EQ (m_clientRxFragments, m_serverTxFragments, "The client did not receive the fragments of the reply");
+  NS_TEST_EXPECT_MSG_EQ (m_serverTxBytes, 4000 + 8 + 3 * (40 + 8), "Wrong size of the fragments of the echo reply");
+  NS_TEST_EXPECT_MSG_EQ (m_drops, 0, "A packet was dropped");
+
+  // Both reassemblies completed: no bytes left and no timeout, although
+  // the simulation ran beyond the reassembly timeout.
+  Ptr<Ipv6ExtensionFragment> serverFragment = GetFragmentExtension (serverNode);
+  Ptr<Ipv6ExtensionFragment> clientFragment = GetFragmentExtension (clientNode);
+  NS_TEST_EXPECT_MSG_EQ (serverFragment->GetFragmentBufferUsage (), 0, "Bytes left in the fragment buffer of the server");
+  NS_TEST_EXPECT_MSG_EQ (serverFragment->GetNReassemblyTimeouts (), 0, "The reassembly of the request timed out");
+  NS_TEST_EXPECT_MSG_EQ (clientFragment->GetFragmentBufferUsage (), 0, "Bytes left in the fragment buffer of the client");
+  NS_TEST_EXPECT_MSG_EQ (clientFragment->GetNReassemblyTimeouts (), 0, "The reassembly of the reply timed out");
+
+  Simulator::Destroy ();
+}
+
+static class Ipv6FragmentationTestSuite : public TestSuite
+{
+public:
+  Ipv6FragmentationTestSuite ()
+    : TestSuite ("ipv6-fragmentation", UNIT)
+  {
+    AddTestCase (new Ipv6FragmentationEchoTest);
+  }
+} g_ipv6FragmentationTestSuite;
+
+} // namespace ns3
@@ -41,6 +41,7 @@
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-header.h"
 
 #include <string>
 
@@ -326,6 +327,68 @@ TcpTestCase::SetupDefaultSim (void)
   source->Connect (serverremoteaddr);
 }
 
+class TcpHeaderLayoutTest : public TestCase
+{
+public:
+  virtual void DoRun (void);
+  TcpHeaderLayoutTest ();
+};
+
+TcpHeaderLayoutTest::TcpHeaderLayoutTest ()
+  : TestCase ("TCP Header fields read without deserialization")
+{
+}
+
+void
+TcpHeaderLayoutTest::DoRun (void)
+{
+  TcpHeader header;
+  header.EnableChecksums ();
+  header.SetSourcePort (0xc001);
+  header.SetDestinationPort (80);
+  header.SetSequenceNumber (SequenceNumber32 (0x01020304));
+  header.SetAckNumber (SequenceNumber32 (0xfffefdfc));
+  header.SetLength (5);
+  header.SetFlags (TcpHeader::SYN | TcpHeader::ACK);
+  header.SetWindowSize (0x8001);
+  header.SetUrgentPointer (7);
+  header.InitializeChecksum (Ipv4Address ("10.1.2.3"), Ipv4Address ("192.168.254.17"), 6);
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddHeader (header);
+
+  uint8_t scratch[TcpHeader::Layout::SIZE];
+  uint8_t const *bytes = p->PeekBytes (TcpHeader::Layout::SIZE, scratch);
+  uint32_t sourcePort = TcpHeader::Layout::SourcePort::Read (bytes);
+  uint32_t destinationPort = TcpHeader::Layout::DestinationPort::Read (bytes);
+  uint32_t sequenceNumber = TcpHeader::Layout::SequenceNumber::Read (bytes);
+  uint32_t ackNumber = TcpHeader::Layout::AckNumber::Read (bytes);
+  uint32_t lengthFlags = TcpHeader::Layout::LengthFlags::Read (bytes);
+  uint32_t window = TcpHeader::Layout::Window::Read (bytes);
+  uint32_t checksum = TcpHeader::Layout::Checksum::Read (bytes);
+  uint32_t urgentPointer = TcpHeader::Layout::UrgentPointer::Read (bytes);
+  NS_TEST_EXPECT_MSG_EQ (sourcePort, 0xc001, "source port");
+  NS_TEST_EXPECT_MSG_EQ (destinationPort, 80, "destination port");
+  NS_TEST_EXPECT_MSG_EQ (sequenceNumber, 0x01020304, "sequence number");
+  NS_TEST_EXPECT_MSG_EQ (ackNumber, 0xfffefdfc, "ack number");
+  NS_TEST_EXPECT_MSG_EQ (lengthFlags, ((5u << 12) | TcpHeader::SYN | TcpHeader::ACK), "length and flags");
+  NS_TEST_EXPECT_MSG_EQ (window, 0x8001, "window");
+  NS_TEST_EXPECT_MSG_EQ ((checksum != 0), true, "checksum");
+  NS_TEST_EXPECT_MSG_EQ (urgentPointer, 7, "urgent pointer");
+
+  TcpHeader deserialized;
+  deserialized.EnableChecksums ();
+  deserialized.InitializeChecksum (Ipv4Address ("10.1.2.3"), Ipv4Address ("192.168.254.17"), 6);
+  p->PeekHeader (deserialized);
+  NS_TEST_EXPECT_MSG_EQ (deserialized.IsChecksumOk (), true, "bad checksum");
+  NS_TEST_EXPECT_MSG_EQ (sourcePort, deserialized.GetSourcePort (), "deserialized source port");
+  NS_TEST_EXPECT_MSG_EQ (destinationPort, deserialized.GetDestinationPort (), "deserialized destination port");
+  NS_TEST_EXPECT_MSG_EQ (sequenceNumber, deserialized.GetSequenceNumber ().GetValue (), "deserialized sequence number");
+  NS_TEST_EXPECT_MSG_EQ (ackNumber, deserialized.GetAckNumber ().GetValue (), "deserialized ack number");
+  NS_TEST_EXPECT_MSG_EQ (lengthFlags, ((uint32_t (deserialized.GetLength ()) << 12) | deserialized.GetFlags ()), "deserialized length and flags");
+  NS_TEST_EXPECT_MSG_EQ (window, deserialized.GetWindowSize (), "deserialized window");
+  NS_TEST_EXPECT_MSG_EQ (urgentPointer, deserialized.GetUrgentPointer (), "deserialized urgent pointer");
+}
+
 static class TcpTestSuite : public TestSuite
 {
 public:
@@ -339,6 +402,7 @@ public:
     AddTestCase (new TcpTestCase (13, 200, 200, 200, 200));
     AddTestCase (new TcpTestCase (13, 1, 1, 1, 1));
     AddTestCase (new TcpTestCase (100000, 100, 50, 100, 20));
+    AddTestCase (new TcpHeaderLayoutTest);
   }
 
 } g_tcpTestSuite;
@@ -39,6 +39,7 @@
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/udp-l4-protocol.h"
+#include "ns3/udp-header.h"
 #include "ns3/tcp-l4-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/ipv4-static-routing.h"
@@ -320,6 +321,50 @@ UdpSocketImplTest::DoRun (void)
 
 }
 
+//-----------------------------------------------------------------------------
+class UdpHeaderLayoutTest : public TestCase
+{
+public:
+  virtual void DoRun (void);
+  UdpHeaderLayoutTest ();
+};
+
+UdpHeaderLayoutTest::UdpHeaderLayoutTest ()
+  : TestCase ("UDP Header fields read without deserialization")
+{
+}
+
+void
+UdpHeaderLayoutTest::DoRun (void)
+{
+  UdpHeader header;
+  header.EnableChecksums ();
+  header.SetSourcePort (0xc001);
+  header.SetDestinationPort (53);
+  header.InitializeChecksum (Ipv4Address ("10.1.2.3"), Ipv4Address ("192.168.254.17"), 17);
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddHeader (header);
+
+  uint8_t scratch[UdpHeader::Layout::SIZE];
+  uint8_t const *bytes = p->PeekBytes (UdpHeader::Layout::SIZE, scratch);
+  uint32_t sourcePort = UdpHeader::Layout::SourcePort::Read (bytes);
+  uint32_t destinationPort = UdpHeader::Layout::DestinationPort::Read (bytes);
+  uint32_t length = UdpHeader::Layout::Length::Read (bytes);
+  uint32_t checksum = UdpHeader::Layout::Checksum::Read (bytes);
+  NS_TEST_EXPECT_MSG_EQ (sourcePort, 0xc001, "source port");
+  NS_TEST_EXPECT_MSG_EQ (destinationPort, 53, "destination port");
+  NS_TEST_EXPECT_MSG_EQ (length, 108, "length");
+  NS_TEST_EXPECT_MSG_EQ ((checksum != 0), true, "checksum");
+
+  UdpHeader deserialized;
+  deserialized.EnableChecksums ();
+  deserialized.InitializeChecksum (Ipv4Address ("10.1.2.3"), Ipv4Address ("192.168.254.17"), 17);
+  p->PeekHeader (deserialized);
+  NS_TEST_EXPECT_MSG_EQ (deserialized.IsChecksumOk (), true, "bad checksum");
+  NS_TEST_EXPECT_MSG_EQ (sourcePort, deserialized.GetSourcePort (), "deserialized source port");
+  NS_TEST_EXPECT_MSG_EQ (destinationPort, deserialized.GetDestinationPort (), "deserialized destination port");
+  NS_TEST_EXPECT_MSG_EQ (length, p->GetSize (), "length of the datagram");
+}
 //-----------------------------------------------------------------------------
 class UdpTestSuite : public TestSuite
 {
@@ -328,6 +373,7 @@ public:
   {
     AddTestCase (new UdpSocketImplTest);
     AddTestCase (new UdpSocketLoopbackTest);
+    AddTestCase (new UdpHeaderLayoutTest);
   }
 } g_udpTestSuite;
 
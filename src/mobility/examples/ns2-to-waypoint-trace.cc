@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Convert an ns-2 movement trace into a binary waypoint trace which can
+ * be memory-mapped by ns3::WaypointTrace and followed by
+ * ns3::WaypointMobilityModel.
+ *
+ * The ns-2 trace is replayed with Ns2MobilityHelper (in streaming mode)
+ * and the position of each node is recorded at each course change.
+ * Since nodes move in straight lines between course changes, these
+ * waypoints describe exactly the same movements, except that position
+ * jumps ("set X_" statements after time 0) become movements which end
+ * at the time of the jump.
+ *
+ * Usage example:
+ *
+ *   ./waf --run "ns2-to-waypoint-trace --traceFile=mobility.tcl
+ *                --outFile=mobility.wpt --nodeNum=1000 --duration=86400"
+ *
+ * and, in the simulation:
+ *
+ *   Ptr<WaypointTrace> trace = Create<WaypointTrace> ("mobility.wpt");
+ *   ...
+ *   node->GetObject<WaypointMobilityModel> ()->SetWaypointTrace (trace, node->GetId ());
+ */
+
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns2ToWaypointTrace");
+
+static std::vector<std::vector<Waypoint> > g_waypoints;
+
+static void
+Record (uint32_t node, Vector position)
+{
+  std::vector<Waypoint> &waypoints = g_waypoints[node];
+  Time now = Simulator::Now ();
+  if (!waypoints.empty () && waypoints.back ().time == now)
+    {
+      // several course changes at the same time: keep the last one
+      waypoints.back ().position = position;
+    }
+  else
+    {
+      waypoints.push_back (Waypoint (now, position));
+    }
+}
+
+static void
+CourseChange (std::string context, Ptr<const MobilityModel> mobility)
+{
+  Ptr<Node> node = mobility->GetObject<Node> ();
+  Record (node->GetId (), mobility->GetPosition ());
+}
+
+int main (int argc, char *argv[])
+{
+  std::string traceFile;
+  std::string outFile = "waypoints.wpt";
+  uint32_t nodeNum = 0;
+  double duration = 0;
+
+  CommandLine cmd;
+  cmd.AddValue ("traceFile", "Ns2 movement trace file", traceFile);
+  cmd.AddValue ("outFile", "Binary waypoint trace to write", outFile);
+  cmd.AddValue ("nodeNum", "Number of nodes", nodeNum);
+  cmd.AddValue ("duration", "Duration of the trace (seconds)", duration);
+  cmd.Parse (argc, argv);
+
+  if (traceFile.empty () || nodeNum == 0 || duration <= 0)
+    {
+      std::cout << "Usage of " << argv[0] << " :\n\n"
+      "./waf --run \"ns2-to-waypoint-trace"
+      " --traceFile=examples/mobility/default.ns_movements"
+      " --outFile=default.wpt --nodeNum=2 --duration=100.0\"\n";
+      return 0;
+    }
+
+  NodeContainer nodes;
+  nodes.Create (nodeNum);
+  g_waypoints.resize (nodeNum);
+
+  Ns2MobilityHelper ns2 (traceFile);
+  ns2.EnableStreaming (Seconds (1.0));
+  ns2.Install ();
+
+  // initial positions
+  for (uint32_t i = 0; i < nodeNum; i++)
+    {
+      Ptr<MobilityModel> mobility = nodes.Get (i)->GetObject<MobilityModel> ();
+      if (mobility != 0)
+        {
+          Record (i, mobility->GetPosition ());
+        }
+    }
+
+  Config::Connect ("/NodeList/*/$ns3::MobilityModel/CourseChange",
+                   MakeCallback (&CourseChange));
+
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+
+  // nodes still moving at the end of the trace
+  for (uint32_t i = 0; i < nodeNum; i++)
+    {
+      Ptr<MobilityModel> mobility = nodes.Get (i)->GetObject<MobilityModel> ();
+      if (mobility == 0)
+        {
+          continue;
+        }
+      Vector velocity = mobility->GetVelocity ();
+      if (velocity.x != 0 || velocity.y != 0 || velocity.z != 0)
+        {
+          Record (i, mobility->GetPosition ());
+        }
+    }
+  Simulator::Destroy ();
+
+  WaypointTrace::Write (outFile, g_waypoints);
+  return 0;
+}
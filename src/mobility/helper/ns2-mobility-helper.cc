@@ -41,8 +41,10 @@
 #include <fstream>
 #include <sstream>
 #include <map>
+#include <vector>
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/simple-ref-count.h"
 #include "ns3/node-list.h"
 #include "ns3/node.h"
 #include "ns3/constant-velocity-mobility-model.h"
@@ -137,34 +139,97 @@ static bool IsSchedSetPos (ParseResult pr);
 // Check if this corresponds to a line like this: $ns_ at 1 "$node_(0) set X_ 2"
 static bool IsSchedMobilityPos (ParseResult pr);
 
-// Set waypoints and speed for movement.
-static DestinationPoint SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector lastPos, double at,
+// Set waypoints and speed for movement.  Events are scheduled relative to
+// the time elapsed since the trace was installed.
+static DestinationPoint SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector lastPos, double at, Time elapsed,
                                      double xFinalPosition, double yFinalPosition, double speed);
 
 // Set initial position for a node
 static Vector SetInitialPosition (Ptr<ConstantVelocityMobilityModel> model, string coord, double coordVal);
 
 // Schedule a set of position for a node
-static Vector SetSchedPosition (Ptr<ConstantVelocityMobilityModel> model, double at, string coord, double coordVal);
+static Vector SetSchedPosition (Ptr<ConstantVelocityMobilityModel> model, double at, Time elapsed, string coord, double coordVal);
+
+/**
+ * \brief Reads a ns-2 movement trace and schedules the movements it describes.
+ *
+ * In streaming mode, the reader stops at the first scheduled statement which
+ * lies more than the streaming window ahead of the current simulation time
+ * and schedules itself to resume reading when the simulation gets there.
+ * Otherwise, the whole trace is read at once.
+ */
+class Ns2TraceReader : public SimpleRefCount<Ns2TraceReader>
+{
+public:
+  Ns2TraceReader (std::string filename, const std::vector<Ptr<Object> > &objects,
+                  bool streaming, Time window);
+  void Read (void);
+private:
+  Ptr<ConstantVelocityMobilityModel> GetMobilityModel (std::string idString);
+  void ProcessLine (const std::string &line, const ParseResult &pr);
+
+  std::ifstream m_file;
+  std::vector<Ptr<Object> > m_objects;
+  map<int, DestinationPoint> m_lastPos; // Stores previous movement scheduled for each node
+  bool m_streaming;
+  Time m_window;
+  Time m_start;                         // Simulation time when the trace was installed
+  std::string m_pendingLine;            // Line read ahead of the streaming window
+  ParseResult m_pendingResult;
+  bool m_hasPending;
+};
 
 
 Ns2MobilityHelper::Ns2MobilityHelper (std::string filename)
-  : m_filename (filename)
+  : m_filename (filename),
+    m_streaming (false),
+    m_window (Seconds (0))
+{
+}
+
+void
+Ns2MobilityHelper::EnableStreaming (Time window)
+{
+  NS_ASSERT (window >= Seconds (0));
+  m_streaming = true;
+  m_window = window;
+}
+
+void
+Ns2MobilityHelper::ConfigNodesMovements (const ObjectStore &store) const
+{
+  std::vector<Ptr<Object> > objects;
+  for (Ptr<Object> object = store.Get (0); object != 0; object = store.Get (objects.size ()))
+    {
+      objects.push_back (object);
+    }
+  Ptr<Ns2TraceReader> reader = Create<Ns2TraceReader> (m_filename, objects, m_streaming, m_window);
+  reader->Read ();
+}
+
+Ns2TraceReader::Ns2TraceReader (std::string filename, const std::vector<Ptr<Object> > &objects,
+                                bool streaming, Time window)
+  : m_file (filename.c_str (), std::ios::in),
+    m_objects (objects),
+    m_streaming (streaming),
+    m_window (window),
+    m_start (Simulator::Now ()),
+    m_hasPending (false)
 {
 }
 
 Ptr<ConstantVelocityMobilityModel>
-Ns2MobilityHelper::GetMobilityModel (std::string idString, const ObjectStore &store) const
+Ns2TraceReader::GetMobilityModel (std::string idString)
 {
   std::istringstream iss;
   iss.str (idString);
   uint32_t id (0);
   iss >> id;
-  Ptr<Object> object = store.Get (id);
-  if (object == 0)
+  if (id >= m_objects.size ())
     {
       return 0;
     }
+  Ptr<Object> object = m_objects[id];
   Ptr<ConstantVelocityMobilityModel> model = object->GetObject<ConstantVelocityMobilityModel> ();
   if (model == 0)
     {
@@ -174,148 +239,176 @@ Ns2MobilityHelper::GetMobilityModel (std::string idString, const ObjectStore &st
   return model;
 }
 
-
 void
-Ns2MobilityHelper::ConfigNodesMovements (const ObjectStore &store) const
+Ns2TraceReader::Read (void)
 {
-  map<int, DestinationPoint> last_pos;    // Stores previous movement scheduled for each node
+  if (m_hasPending)
+    {
+      m_hasPending = false;
+      ProcessLine (m_pendingLine, m_pendingResult);
+    }
 
-  std::ifstream file (m_filename.c_str (), std::ios::in);
-  if (file.is_open ())
+  while (m_file.is_open () && !m_file.eof ())
     {
-      while (!file.eof () )
+      std::string line;
+
+      getline (m_file, line);
+
+      // ignore empty lines
+      if (line.empty ())
         {
-          int         iNodeId = 0;
-          std::string nodeId;
-          std::string line;
+          continue;
+        }
 
-          getline (file, line);
+      ParseResult pr = ParseNs2Line (line); // Parse line and obtain tokens
 
-          // ignore empty lines
-          if (line.empty ())
+      if (m_streaming && pr.tokens.size () > 2 && pr.tokens[0] == NS2_NS_SCH && pr.has_dval[2])
+        {
+          Time resume = m_start + Seconds (pr.dvals[2]) - m_window;
+          if (resume > Simulator::Now ())
             {
-              continue;
+              // Statement lies beyond the streaming window: keep it and
+              // come back when the simulation gets closer to it.
+              m_pendingLine = line;
+              m_pendingResult = pr;
+              m_hasPending = true;
+              Simulator::Schedule (resume - Simulator::Now (), &Ns2TraceReader::Read, Ptr<Ns2TraceReader> (this));
+              return;
             }
+        }
 
-          ParseResult pr = ParseNs2Line (line); // Parse line and obtain tokens
+      ProcessLine (line, pr);
+    }
+  m_file.close ();
+}
 
-          // Check if the line corresponds with one of the three types of line
-          if (pr.tokens.size () != 4 && pr.tokens.size () != 7 && pr.tokens.size () != 8)
-            {
-              NS_LOG_ERROR ("Line has not correct number of parameters (corrupted file?): " << line << "\n");
-              continue;
-            }
+void
+Ns2TraceReader::ProcessLine (const std::string &line, const ParseResult &pr)
+{
+  int         iNodeId = 0;
+  std::string nodeId;
 
-          // Get the node Id
-          nodeId  = GetNodeIdString (pr);
-          iNodeId = GetNodeIdInt (pr);
-          if (iNodeId == -1)
-            {
-              NS_LOG_ERROR ("Node number couldn't be obtained (corrupted file?): " << line << "\n");
-              continue;
-            }
+  // Check if the line corresponds with one of the three types of line
+  if (pr.tokens.size () != 4 && pr.tokens.size () != 7 && pr.tokens.size () != 8)
+    {
+      NS_LOG_ERROR ("Line has not correct number of parameters (corrupted file?): " << line << "\n");
+      return;
+    }
 
-          // get mobility model of node
-          Ptr<ConstantVelocityMobilityModel> model = GetMobilityModel (nodeId,store);
+  // Get the node Id
+  nodeId  = GetNodeIdString (pr);
+  iNodeId = GetNodeIdInt (pr);
+  if (iNodeId == -1)
+    {
+      NS_LOG_ERROR ("Node number couldn't be obtained (corrupted file?): " << line << "\n");
+      return;
+    }
 
-          // if model not exists, continue
-          if (model == 0)
-            {
-              NS_LOG_ERROR ("Unknown node ID (corrupted file?): " << nodeId << "\n");
-              continue;
-            }
+  // get mobility model of node
+  Ptr<ConstantVelocityMobilityModel> model = GetMobilityModel (nodeId);
+
+  // if model not exists, continue
+  if (model == 0)
+    {
+      NS_LOG_ERROR ("Unknown node ID (corrupted file?): " << nodeId << "\n");
+      return;
+    }
+
+
+  /*
+   * In this case a initial position is being seted
+   * line like $node_(0) set X_ 151.05190721688197
+   */
+  if (IsSetInitialPos (pr))
+    {
+      DestinationPoint point;
+      //                                                    coord         coord value
+      point.m_finalPosition = SetInitialPosition (model, pr.tokens[2], pr.dvals[3]);
+      m_lastPos[iNodeId] = point;
+
+      // Log new position
+      NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId <<
+                    " position = " << m_lastPos[iNodeId].m_finalPosition);
+    }
+
+  else // NOW EVENTS TO BE SCHEDULED
+    {
+
+      // This is a scheduled event, so time at should be present
+      double at;
 
+      if (!IsNumber (pr.tokens[2]))
+        {
+          NS_LOG_WARN ("Time is not a number: " << pr.tokens[2]);
+          return;
+        }
+
+      at = pr.dvals[2]; // set time at
+
+      if ( at < 0 )
+        {
+          NS_LOG_WARN ("Time is less than cero: " << at);
+          return;
+        }
+
+      // time elapsed since the trace was installed; non-zero only when streaming
+      Time elapsed = Simulator::Now () - m_start;
+      if (Seconds (at) < elapsed)
+        {
+          NS_LOG_WARN ("Time is in the past (unsorted trace?): " << at);
+          return;
+        }
 
-          /*
-           * In this case a initial position is being seted
-           * line like $node_(0) set X_ 151.05190721688197
-           */
-          if (IsSetInitialPos (pr))
+
+      /*
+       * In this case a new waypoint is added
+       * line like $ns_ at 1 "$node_(0) setdest 2 3 4"
+       */
+      if (IsSchedMobilityPos (pr))
+        {
+          if (m_lastPos[iNodeId].m_targetArrivalTime > at)
             {
-              DestinationPoint point;
-              //                                                    coord         coord value
-              point.m_finalPosition = SetInitialPosition (model, pr.tokens[2], pr.dvals[3]);
-              last_pos[iNodeId] = point;
-
-              // Log new position
-              NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId <<
-                            " position = " << last_pos[iNodeId].m_finalPosition);
+              NS_LOG_LOGIC ("Did not reach a destination! stoptime = " << m_lastPos[iNodeId].m_targetArrivalTime << ", at = "<<  at);
+              double actuallytraveled = at - m_lastPos[iNodeId].m_travelStartTime;
+              Vector reached = Vector (
+                  m_lastPos[iNodeId].m_startPosition.x + m_lastPos[iNodeId].m_speed.x * actuallytraveled,
+                  m_lastPos[iNodeId].m_startPosition.y + m_lastPos[iNodeId].m_speed.y * actuallytraveled,
+                  0
+                  );
+              NS_LOG_LOGIC ("Final point = " << m_lastPos[iNodeId].m_finalPosition << ", actually reached = " << reached);
+              m_lastPos[iNodeId].m_stopEvent.Cancel ();
+              m_lastPos[iNodeId].m_finalPosition = reached;
             }
+          //                                     last position     time  X coord     Y coord      velocity
+          m_lastPos[iNodeId] = SetMovement (model, m_lastPos[iNodeId].m_finalPosition, at, elapsed, pr.dvals[5], pr.dvals[6], pr.dvals[7]);
+
+          // Log new position
+          NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId << " position =" << m_lastPos[iNodeId].m_finalPosition);
+        }
 
-          else // NOW EVENTS TO BE SCHEDULED
-            {
 
-              // This is a scheduled event, so time at should be present
-              double at;
-
-              if (!IsNumber (pr.tokens[2]))
-                {
-                  NS_LOG_WARN ("Time is not a number: " << pr.tokens[2]);
-                  continue;
-                }
-
-              at = pr.dvals[2]; // set time at
-
-              if ( at < 0 )
-                {
-                  NS_LOG_WARN ("Time is less than cero: " << at);
-                  continue;
-                }
-
-
-
-              /*
-               * In this case a new waypoint is added
-               * line like $ns_ at 1 "$node_(0) setdest 2 3 4"
-               */
-              if (IsSchedMobilityPos (pr))
-                {
-                  if (last_pos[iNodeId].m_targetArrivalTime > at)
-                    {
-                      NS_LOG_LOGIC ("Did not reach a destination! stoptime = " << last_pos[iNodeId].m_targetArrivalTime << ", at = "<<  at);
-                      double actuallytraveled = at - last_pos[iNodeId].m_travelStartTime;
-                      Vector reached = Vector (
-                          last_pos[iNodeId].m_startPosition.x + last_pos[iNodeId].m_speed.x * actuallytraveled,
-                          last_pos[iNodeId].m_startPosition.y + last_pos[iNodeId].m_speed.y * actuallytraveled,
-                          0
-                          );
-                      NS_LOG_LOGIC ("Final point = " << last_pos[iNodeId].m_finalPosition << ", actually reached = " << reached);
-                      last_pos[iNodeId].m_stopEvent.Cancel ();
-                      last_pos[iNodeId].m_finalPosition = reached;
-                    }
-                  //                                     last position     time  X coord     Y coord      velocity
-                  last_pos[iNodeId] = SetMovement (model, last_pos[iNodeId].m_finalPosition, at, pr.dvals[5], pr.dvals[6], pr.dvals[7]);
-
-                  // Log new position
-                  NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId << " position =" << last_pos[iNodeId].m_finalPosition);
-                }
-
-
-              /*
-               * Scheduled set position
-               * line like $ns_ at 4.634906291962 "$node_(0) set X_ 28.675920486450"
-               */
-              else if (IsSchedSetPos (pr))
-                {
-                  //                                         time  coordinate   coord value
-                  last_pos[iNodeId].m_finalPosition = SetSchedPosition (model, at, pr.tokens[5], pr.dvals[6]);
-                  if (last_pos[iNodeId].m_targetArrivalTime > at)
-                    {
-                      last_pos[iNodeId].m_stopEvent.Cancel ();
-                    }
-                  last_pos[iNodeId].m_targetArrivalTime = at;
-                  last_pos[iNodeId].m_travelStartTime = at;
-                  // Log new position
-                  NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId <<
-                                " position =" << last_pos[iNodeId].m_finalPosition);
-                }
-              else
-                {
-                  NS_LOG_WARN ("Format Line is not correct: " << line << "\n");
-                }
+      /*
+       * Scheduled set position
+       * line like $ns_ at 4.634906291962 "$node_(0) set X_ 28.675920486450"
+       */
+      else if (IsSchedSetPos (pr))
+        {
+          //                                         time  coordinate   coord value
+          m_lastPos[iNodeId].m_finalPosition = SetSchedPosition (model, at, elapsed, pr.tokens[5], pr.dvals[6]);
+          if (m_lastPos[iNodeId].m_targetArrivalTime > at)
+            {
+              m_lastPos[iNodeId].m_stopEvent.Cancel ();
             }
+          m_lastPos[iNodeId].m_targetArrivalTime = at;
+          m_lastPos[iNodeId].m_travelStartTime = at;
+          // Log new position
+          NS_LOG_DEBUG ("Positions after parse for node " << iNodeId << " " << nodeId <<
+                        " position =" << m_lastPos[iNodeId].m_finalPosition);
+        }
+      else
+        {
+          NS_LOG_WARN ("Format Line is not correct: " << line << "\n");
         }
-      file.close ();
     }
 }
 
@@ -621,7 +714,7 @@ IsSchedMobilityPos (ParseResult pr)
 }
 
 DestinationPoint
-SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector last_pos, double at,
+SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector last_pos, double at, Time elapsed,
              double xFinalPosition, double yFinalPosition, double speed)
 {
   DestinationPoint retval;
@@ -633,7 +726,7 @@ SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector last_pos, double a
   if (speed == 0)
     {
       // We have to maintain last position, and stop the movement
-      retval.m_stopEvent = Simulator::Schedule (Seconds (at), &ConstantVelocityMobilityModel::SetVelocity, model,
+      retval.m_stopEvent = Simulator::Schedule (Seconds (at) - elapsed, &ConstantVelocityMobilityModel::SetVelocity, model,
                                                 Vector (0, 0, 0));
       return retval;
     }
@@ -657,8 +750,8 @@ SetMovement (Ptr<ConstantVelocityMobilityModel> model, Vector last_pos, double a
       NS_LOG_DEBUG ("Calculated Speed: X=" << xSpeed << " Y=" << ySpeed << " Z=" << zSpeed);
 
       // Set the Values
-      Simulator::Schedule (Seconds (at), &ConstantVelocityMobilityModel::SetVelocity, model, Vector (xSpeed, ySpeed, zSpeed));
-      retval.m_stopEvent = Simulator::Schedule (Seconds (at + time), &ConstantVelocityMobilityModel::SetVelocity, model, Vector (0, 0, 0));
+      Simulator::Schedule (Seconds (at) - elapsed, &ConstantVelocityMobilityModel::SetVelocity, model, Vector (xSpeed, ySpeed, zSpeed));
+      retval.m_stopEvent = Simulator::Schedule (Seconds (at + time) - elapsed, &ConstantVelocityMobilityModel::SetVelocity, model, Vector (0, 0, 0));
       retval.m_finalPosition.x += xSpeed * time;
       retval.m_finalPosition.y += ySpeed * time;
       retval.m_targetArrivalTime += time;
@@ -682,7 +775,7 @@ SetInitialPosition (Ptr<ConstantVelocityMobilityModel> model, string coord, doub
 
 // Schedule a set of position for a node
 Vector
-SetSchedPosition (Ptr<ConstantVelocityMobilityModel> model, double at, string coord, double coordVal)
+SetSchedPosition (Ptr<ConstantVelocityMobilityModel> model, double at, Time elapsed, string coord, double coordVal)
 {
   // update position
   model->SetPosition (SetOneInitialCoord (model->GetPosition (), coord, coordVal));
@@ -693,7 +786,7 @@ SetSchedPosition (Ptr<ConstantVelocityMobilityModel> model, double at, string co
   position.z = model->GetPosition ().z;
 
   // Chedule next positions
-  Simulator::Schedule (Seconds (at), &ConstantVelocityMobilityModel::SetPosition, model,position);
+  Simulator::Schedule (Seconds (at) - elapsed, &ConstantVelocityMobilityModel::SetPosition, model,position);
 
   return position;
 }
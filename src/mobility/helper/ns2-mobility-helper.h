@@ -27,11 +27,10 @@
 #include <stdint.h>
 #include "ns3/ptr.h"
 #include "ns3/object.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
-class ConstantVelocityMobilityModel;
-
 /**
  * \ingroup mobility
  * \brief Helper class which can read ns-2 movement files and configure nodes mobility.
@@ -76,6 +75,21 @@ public:
    */
   Ns2MobilityHelper (std::string filename);
 
+  /**
+   * \param window how far ahead of the current simulation time the
+   *        trace file is read.
+   *
+   * Read the trace file incrementally during the simulation instead of
+   * scheduling every movement when Install is called: only the
+   * statements which fall within window of the current simulation time
+   * are scheduled, which keeps memory usage and the number of pending
+   * events bounded for long traces.  Streaming requires the scheduled
+   * statements of the trace to be sorted by time (as generated by
+   * e.g. SUMO or BonnMotion); a statement which is already in the past
+   * when it is read is ignored.
+   */
+  void EnableStreaming (Time window);
+
   /**
    * Read the ns2 trace file and configure the movement
    * patterns of all nodes contained in the global ns3::NodeList
@@ -105,8 +119,9 @@ public:
     virtual Ptr<Object> Get (uint32_t i) const = 0;
   };
   void ConfigNodesMovements (const ObjectStore &store) const;
-  Ptr<ConstantVelocityMobilityModel> GetMobilityModel (std::string idString, const ObjectStore &store) const;
   std::string m_filename;
+  bool m_streaming;
+  Time m_window;
 };
 
 } // namespace ns3
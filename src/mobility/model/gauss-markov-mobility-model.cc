@@ -92,6 +92,7 @@ GaussMarkovMobilityModel::GaussMarkovMobilityModel ()
   m_meanPitch = 0.0;
   m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
   m_helper.Unpause ();
+  EnablePositionCache ();
 }
 
 void
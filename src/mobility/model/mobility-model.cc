@@ -22,11 +22,26 @@
 
 #include "mobility-model.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/simulator.h"
 
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (MobilityModel);
 
+/*
+ * Simulation runs start again at time zero: a cached position is only
+ * valid within the run in which it was computed.
+ */
+static uint32_t g_positionCacheRun = 0;
+static bool g_positionCacheRunEndScheduled = false;
+
+static void
+EndPositionCacheRun (void)
+{
+  g_positionCacheRun++;
+  g_positionCacheRunEndScheduled = false;
+}
+
 TypeId 
 MobilityModel::GetTypeId (void)
 {
@@ -51,6 +66,9 @@ MobilityModel::GetTypeId (void)
 }
 
 MobilityModel::MobilityModel ()
+  : m_positionCacheEnabled (false),
+    m_positionCached (false),
+    m_positionCacheRun (0)
 {
 }
 
@@ -61,7 +79,25 @@ MobilityModel::~MobilityModel ()
 Vector
 MobilityModel::GetPosition (void) const
 {
-  return DoGetPosition ();
+  if (!m_positionCacheEnabled)
+    {
+      return DoGetPosition ();
+    }
+  Time now = Simulator::Now ();
+  if (!m_positionCached || m_positionCacheRun != g_positionCacheRun
+      || m_positionCacheTime != now)
+    {
+      if (!g_positionCacheRunEndScheduled)
+        {
+          Simulator::ScheduleDestroy (&EndPositionCacheRun);
+          g_positionCacheRunEndScheduled = true;
+        }
+      m_positionCache = DoGetPosition ();
+      m_positionCacheRun = g_positionCacheRun;
+      m_positionCacheTime = now;
+      m_positionCached = true;
+    }
+  return m_positionCache;
 }
 Vector
 MobilityModel::GetVelocity (void) const
@@ -72,14 +108,16 @@ MobilityModel::GetVelocity (void) const
 void 
 MobilityModel::SetPosition (const Vector &position)
 {
+  m_positionCached = false;
   DoSetPosition (position);
+  m_positionCached = false;
 }
 
 double 
 MobilityModel::GetDistanceFrom (Ptr<const MobilityModel> other) const
 {
-  Vector oPosition = other->DoGetPosition ();
-  Vector position = DoGetPosition ();
+  Vector oPosition = other->GetPosition ();
+  Vector position = GetPosition ();
   return CalculateDistance (position, oPosition);
 }
 
@@ -95,7 +133,20 @@ MobilityModel::GetRelativeSpeed (Ptr<const MobilityModel> other) const
 void
 MobilityModel::NotifyCourseChange (void) const
 {
+  m_positionCached = false;
   m_courseChangeTrace (this);
 }
 
+void
+MobilityModel::EnablePositionCache (void)
+{
+  m_positionCacheEnabled = true;
+}
+
+void
+MobilityModel::InvalidatePositionCache (void) const
+{
+  m_positionCached = false;
+}
+
 } // namespace ns3
@@ -22,6 +22,7 @@
 
 #include "ns3/vector.h"
 #include "ns3/object.h"
+#include "ns3/nstime.h"
 #include "ns3/traced-callback.h"
 
 namespace ns3 {
@@ -35,6 +36,13 @@ namespace ns3 {
  * metric international units.
  *
  * This is a base class for all specific mobility models.
+ *
+ * Subclasses whose DoGetPosition is costly can call EnablePositionCache,
+ * such that the position returned by GetPosition is computed at most
+ * once per simulation timestamp: it is then cached until the simulation
+ * time advances, the simulator is destroyed, SetPosition is called, or
+ * the subclass notifies a course change.  Such subclasses must call
+ * InvalidatePositionCache when they move the object in any other way.
  */
 class MobilityModel : public Object
 {
@@ -72,6 +80,19 @@ protected:
    * position changes to notify course change listeners.
    */
   void NotifyCourseChange (void) const;
+  /**
+   * Cache the position computed by DoGetPosition within a simulation
+   * timestamp.  Meant to be invoked from the constructor of subclasses
+   * which always call NotifyCourseChange or InvalidatePositionCache when
+   * the current position changes.
+   */
+  void EnablePositionCache (void);
+  /**
+   * Must be invoked by subclasses which enabled the position cache when
+   * the current position changes without a call to SetPosition or
+   * NotifyCourseChange.
+   */
+  void InvalidatePositionCache (void) const;
 private:
   /**
    * \return the current position.
@@ -101,6 +122,11 @@ private:
    */
   TracedCallback<Ptr<const MobilityModel> > m_courseChangeTrace;
 
+  bool m_positionCacheEnabled;
+  mutable bool m_positionCached;
+  mutable uint32_t m_positionCacheRun;
+  mutable Time m_positionCacheTime;
+  mutable Vector m_positionCache;
 };
 
 } // namespace ns3
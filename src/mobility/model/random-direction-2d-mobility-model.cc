@@ -55,6 +55,11 @@ RandomDirection2dMobilityModel::GetTypeId (void)
   return tid;
 }
 
+RandomDirection2dMobilityModel::RandomDirection2dMobilityModel ()
+{
+  EnablePositionCache ();
+}
+
 void 
 RandomDirection2dMobilityModel::DoDispose (void)
 {
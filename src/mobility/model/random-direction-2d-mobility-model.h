@@ -45,6 +45,7 @@ class RandomDirection2dMobilityModel : public MobilityModel
 {
 public:
   static TypeId GetTypeId (void);
+  RandomDirection2dMobilityModel ();
 
 private:
   void ResetDirectionAndSpeed (void);
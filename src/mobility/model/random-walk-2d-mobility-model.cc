@@ -72,6 +72,11 @@ RandomWalk2dMobilityModel::GetTypeId (void)
   return tid;
 }
 
+RandomWalk2dMobilityModel::RandomWalk2dMobilityModel ()
+{
+  EnablePositionCache ();
+}
+
 void
 RandomWalk2dMobilityModel::DoStart (void)
 {
@@ -47,6 +47,7 @@ class RandomWalk2dMobilityModel : public MobilityModel
 {
 public:
   static TypeId GetTypeId (void);
+  RandomWalk2dMobilityModel ();
 
   enum Mode  {
     MODE_DISTANCE,
@@ -54,6 +54,11 @@ RandomWaypointMobilityModel::GetTypeId (void)
   return tid;
 }
 
+RandomWaypointMobilityModel::RandomWaypointMobilityModel ()
+{
+  EnablePositionCache ();
+}
+
 void
 RandomWaypointMobilityModel::BeginWalk (void)
 {
@@ -46,6 +46,7 @@ class RandomWaypointMobilityModel : public MobilityModel
 {
 public:
   static TypeId GetTypeId (void);
+  RandomWaypointMobilityModel ();
 protected:
   virtual void DoStart (void);
 private:
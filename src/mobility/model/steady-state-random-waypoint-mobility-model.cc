@@ -81,6 +81,7 @@ SteadyStateRandomWaypointMobilityModel::GetTypeId (void)
 SteadyStateRandomWaypointMobilityModel::SteadyStateRandomWaypointMobilityModel () :
   alreadyStarted (false)
 {
+  EnablePositionCache ();
 }
 
 void
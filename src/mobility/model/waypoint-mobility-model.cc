@@ -67,8 +67,11 @@ WaypointMobilityModel::GetTypeId (void)
 WaypointMobilityModel::WaypointMobilityModel ()
   : m_first (true),
     m_lazyNotify (false),
-    m_initialPositionIsWaypoint (false)
+    m_initialPositionIsWaypoint (false),
+    m_traceNext (0),
+    m_traceEnd (0)
 {
+  EnablePositionCache ();
 }
 WaypointMobilityModel::~WaypointMobilityModel ()
 {
@@ -76,11 +79,16 @@ WaypointMobilityModel::~WaypointMobilityModel ()
 void
 WaypointMobilityModel::DoDispose (void)
 {
+  m_trace = 0;
+  m_traceNext = 0;
+  m_traceEnd = 0;
   MobilityModel::DoDispose ();
 }
 void
 WaypointMobilityModel::AddWaypoint (const Waypoint &waypoint)
 {
+  // a waypoint at the current time can move the node
+  InvalidatePositionCache ();
   if ( m_first )
     {
       m_first = false;
@@ -90,6 +98,9 @@ WaypointMobilityModel::AddWaypoint (const Waypoint &waypoint)
     {
       NS_ABORT_MSG_IF ( !m_waypoints.empty () && (m_waypoints.back ().time >= waypoint.time),
                         "Waypoints must be added in ascending time order");
+      NS_ABORT_MSG_IF ( m_waypoints.empty () && m_traceNext != m_traceEnd
+                        && (Seconds ((m_traceEnd - 1)->time) >= waypoint.time),
+                        "Waypoints must be added after the last waypoint of the trace");
       m_waypoints.push_back (waypoint);
     }
 
@@ -108,7 +119,60 @@ uint32_t
 WaypointMobilityModel::WaypointsLeft (void) const
 {
   Update ();
-  return m_waypoints.size ();
+  return m_waypoints.size () + (m_traceEnd - m_traceNext);
+}
+void
+WaypointMobilityModel::SetWaypointTrace (Ptr<const WaypointTrace> trace, uint32_t node)
+{
+  NS_ABORT_MSG_IF (!m_first, "A waypoint trace must be set before any waypoint is added");
+  NS_ABORT_MSG_IF (node >= trace->GetNNodes (), "Node " << node << " is not in the waypoint trace");
+  const Time now = Simulator::Now ();
+  const WaypointTrace::Record *begin = trace->GetWaypoints (node);
+  const WaypointTrace::Record *end = begin + trace->GetNWaypoints (node);
+  m_trace = trace;
+  // Start from the last waypoint which is not in the future, so that
+  // the current position can be interpolated from it.
+  m_traceNext = begin + trace->Find (node, now);
+  if (m_traceNext != begin && (m_traceNext == end || Seconds (m_traceNext->time) > now))
+    {
+      m_traceNext--;
+    }
+  m_traceEnd = end;
+  if (m_traceNext != m_traceEnd)
+    {
+      m_first = false;
+      m_current = m_next = PopWaypoint ();
+      InvalidatePositionCache ();
+      if ( !m_lazyNotify && m_current.time < now )
+        {
+          Simulator::ScheduleNow (&WaypointMobilityModel::Update, this);
+        }
+    }
+}
+bool
+WaypointMobilityModel::HasWaypoints (void) const
+{
+  return m_traceNext != m_traceEnd || !m_waypoints.empty ();
+}
+Waypoint
+WaypointMobilityModel::PopWaypoint (void) const
+{
+  if (m_traceNext != m_traceEnd)
+    {
+      Waypoint waypoint = WaypointTrace::GetWaypoint (*m_traceNext);
+      m_traceNext++;
+      // Waypoints of the trace are scheduled one at a time, when they
+      // become the next waypoint.
+      const Time now = Simulator::Now ();
+      if ( !m_lazyNotify && waypoint.time >= now )
+        {
+          Simulator::Schedule (waypoint.time - now, &WaypointMobilityModel::Update, this);
+        }
+      return waypoint;
+    }
+  Waypoint waypoint = m_waypoints.front ();
+  m_waypoints.pop_front ();
+  return waypoint;
 }
 void
 WaypointMobilityModel::Update (void) const
@@ -123,7 +187,7 @@ WaypointMobilityModel::Update (void) const
 
   while ( now >= m_next.time  )
     {
-      if ( m_waypoints.empty () )
+      if ( !HasWaypoints () )
         {
           if ( m_current.time <= m_next.time )
             {
@@ -146,8 +210,7 @@ WaypointMobilityModel::Update (void) const
         }
 
       m_current = m_next;
-      m_next = m_waypoints.front ();
-      m_waypoints.pop_front ();
+      m_next = PopWaypoint ();
       newWaypoint = true;
 
       const double t_span = (m_next.time - m_current.time).GetSeconds ();
@@ -203,6 +266,9 @@ void
 WaypointMobilityModel::EndMobility (void)
 {
   m_waypoints.clear ();
+  m_trace = 0;
+  m_traceNext = 0;
+  m_traceEnd = 0;
   m_current.time = Time(std::numeric_limits<uint64_t>::infinity());
   m_next.time = m_current.time;
   m_first = true;
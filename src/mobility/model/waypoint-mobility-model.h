@@ -25,6 +25,7 @@
 #include "mobility-model.h"
 #include "ns3/vector.h"
 #include "waypoint.h"
+#include "waypoint-trace.h"
 
 namespace ns3 {
 
@@ -80,6 +81,11 @@ namespace ns3 {
  * In such a case, when SetPosition() is treated as an initial waypoint,
  * it should be noted that attempts to add a waypoint at the same time
  * will cause the program to fail.
+ *
+ * Instead of adding waypoints one by one, the waypoints of an object can
+ * be read from a ns3::WaypointTrace with SetWaypointTrace().  The
+ * waypoints are then read directly from the memory-mapped trace as the
+ * object moves, and only one event at a time is scheduled for them.
  */
 class WaypointMobilityModel : public MobilityModel
 {
@@ -122,10 +128,24 @@ public:
    */
   void EndMobility (void);
 
+  /**
+   * \param trace the waypoint trace to read waypoints from.
+   * \param node the id of this object in the trace.
+   *
+   * Follow the waypoints of the given node in trace.  This must be
+   * called before any waypoint is added.  Waypoints of the trace which
+   * are already in the past are skipped, the object starts from the
+   * position it has at the current time.  Waypoints added later with
+   * AddWaypoint() are followed after the last waypoint of the trace.
+   */
+  void SetWaypointTrace (Ptr<const WaypointTrace> trace, uint32_t node);
+
 private:
   friend class WaypointMobilityModelNotifyTest; // To allow Update() calls and access to m_current
 
   void Update (void) const;
+  bool HasWaypoints (void) const;
+  Waypoint PopWaypoint (void) const;
   virtual void DoDispose (void);
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
@@ -135,6 +155,9 @@ private:
   bool m_lazyNotify;
   bool m_initialPositionIsWaypoint;
   mutable std::deque<Waypoint> m_waypoints;
+  Ptr<const WaypointTrace> m_trace;
+  mutable const WaypointTrace::Record *m_traceNext;
+  const WaypointTrace::Record *m_traceEnd;
   mutable Waypoint m_current;
   mutable Waypoint m_next;
   mutable Vector m_velocity;
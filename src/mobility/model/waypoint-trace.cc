@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <algorithm>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "waypoint-trace.h"
+
+NS_LOG_COMPONENT_DEFINE ("WaypointTrace");
+
+namespace ns3 {
+
+static const uint32_t WAYPOINT_TRACE_MAGIC = 0x5733534e; // "NS3W" in little endian
+static const uint32_t WAYPOINT_TRACE_VERSION = 1;
+
+/**
+ * Order waypoint records by time, for std::lower_bound
+ */
+static bool
+RecordBefore (const WaypointTrace::Record &record, double time)
+{
+  return record.time < time;
+}
+
+WaypointTrace::WaypointTrace (std::string filename)
+  : m_map (0),
+    m_size (0),
+    m_header (0),
+    m_index (0),
+    m_records (0)
+{
+  NS_LOG_FUNCTION (this << filename);
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd == -1)
+    {
+      NS_FATAL_ERROR ("WaypointTrace::WaypointTrace(): Unable to open " << filename);
+    }
+  struct stat st;
+  if (fstat (fd, &st) == -1 || st.st_size < (off_t) sizeof (Header))
+    {
+      close (fd);
+      NS_FATAL_ERROR ("WaypointTrace::WaypointTrace(): " << filename << " is too short to be a waypoint trace");
+    }
+  m_size = st.st_size;
+  m_map = mmap (0, m_size, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (m_map == MAP_FAILED)
+    {
+      m_map = 0;
+      NS_FATAL_ERROR ("WaypointTrace::WaypointTrace(): Unable to map " << filename);
+    }
+
+  m_header = static_cast<const Header *> (m_map);
+  if (m_header->magic != WAYPOINT_TRACE_MAGIC || m_header->version != WAYPOINT_TRACE_VERSION)
+    {
+      NS_FATAL_ERROR ("WaypointTrace::WaypointTrace(): " << filename << " is not a version "
+                      << WAYPOINT_TRACE_VERSION << " waypoint trace (or was written on a host with a different endianness)");
+    }
+  uint64_t recordsOffset = sizeof (Header) + (uint64_t) m_header->nNodes * sizeof (IndexEntry);
+  if (m_size < recordsOffset)
+    {
+      NS_FATAL_ERROR ("WaypointTrace::WaypointTrace(): " << filename << " is truncated");
+    }
+  m_index = reinterpret_cast<const IndexEntry *> (static_cast<const uint8_t *> (m_map) + sizeof (Header));
+  m_records = reinterpret_cast<const Record *> (static_cast<const uint8_t *> (m_map) + recordsOffset);
+  uint64_t nRecords = (m_size - recordsOffset) / sizeof (Record);
+  for (uint32_t i = 0; i < m_header->nNodes; i++)
+    {
+      // checked such that a crafted first or count can not overflow
+      if (m_index[i].first > nRecords || m_index[i].count > nRecords - m_index[i].first)
+        {
+          NS_FATAL_ERROR ("WaypointTrace::WaypointTrace(): " << filename << " is truncated");
+        }
+    }
+}
+
+WaypointTrace::~WaypointTrace ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_map != 0)
+    {
+      munmap (m_map, m_size);
+    }
+  m_map = 0;
+  m_header = 0;
+  m_index = 0;
+  m_records = 0;
+}
+
+uint32_t
+WaypointTrace::GetNNodes (void) const
+{
+  return m_header->nNodes;
+}
+
+uint64_t
+WaypointTrace::GetNWaypoints (uint32_t node) const
+{
+  NS_ASSERT (node < m_header->nNodes);
+  return m_index[node].count;
+}
+
+const WaypointTrace::Record *
+WaypointTrace::GetWaypoints (uint32_t node) const
+{
+  NS_ASSERT (node < m_header->nNodes);
+  return m_records + m_index[node].first;
+}
+
+uint64_t
+WaypointTrace::Find (uint32_t node, Time time) const
+{
+  const Record *begin = GetWaypoints (node);
+  const Record *end = begin + GetNWaypoints (node);
+  return std::lower_bound (begin, end, time.GetSeconds (), &RecordBefore) - begin;
+}
+
+Waypoint
+WaypointTrace::GetWaypoint (const Record &record)
+{
+  return Waypoint (Seconds (record.time), Vector (record.x, record.y, record.z));
+}
+
+void
+WaypointTrace::Write (std::string filename, const std::vector<std::vector<Waypoint> > &waypoints)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ofstream file (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("WaypointTrace::Write(): Unable to open " << filename);
+    }
+
+  Header header;
+  header.magic = WAYPOINT_TRACE_MAGIC;
+  header.version = WAYPOINT_TRACE_VERSION;
+  header.nNodes = waypoints.size ();
+  header.reserved = 0;
+  file.write ((const char *) &header, sizeof (header));
+
+  uint64_t first = 0;
+  for (uint32_t i = 0; i < waypoints.size (); i++)
+    {
+      IndexEntry entry;
+      entry.first = first;
+      entry.count = waypoints[i].size ();
+      file.write ((const char *) &entry, sizeof (entry));
+      first += entry.count;
+    }
+
+  for (uint32_t i = 0; i < waypoints.size (); i++)
+    {
+      for (std::vector<Waypoint>::const_iterator j = waypoints[i].begin (); j != waypoints[i].end (); ++j)
+        {
+          NS_ABORT_MSG_IF (j != waypoints[i].begin () && (j - 1)->time >= j->time,
+                           "Waypoints of node " << i << " must be sorted by ascending time");
+          Record record;
+          record.time = j->time.GetSeconds ();
+          record.x = j->position.x;
+          record.y = j->position.y;
+          record.z = j->position.z;
+          file.write ((const char *) &record, sizeof (record));
+        }
+    }
+
+  if (!file.good ())
+    {
+      NS_FATAL_ERROR ("WaypointTrace::Write(): Error while writing " << filename);
+    }
+  file.close ();
+}
+
+} // namespace ns3
@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef WAYPOINT_TRACE_H
+#define WAYPOINT_TRACE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "waypoint.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief a read-only, memory-mapped file of per-node waypoints.
+ *
+ * The file starts with a small header, followed by an index which
+ * gives, for each node id, the position and number of its waypoints,
+ * followed by the waypoints themselves, grouped by node and sorted by
+ * time.  All values are stored in host byte order, so a trace file is
+ * only portable between hosts of the same endianness.
+ *
+ * The file is mapped in memory when the object is created: the
+ * waypoints are never copied and only the pages which are actually
+ * used by the simulation are read from disk.  A WaypointTrace is
+ * typically shared by all the ns3::WaypointMobilityModel objects of a
+ * simulation (see WaypointMobilityModel::SetWaypointTrace).
+ *
+ * Trace files are written with WaypointTrace::Write.  The program
+ * src/mobility/examples/ns2-to-waypoint-trace.cc converts an ns-2
+ * movement trace into this format.
+ */
+class WaypointTrace : public SimpleRefCount<WaypointTrace>
+{
+public:
+  /**
+   * A single waypoint, as stored in the file.
+   */
+  struct Record
+  {
+    double time; //!< waypoint time, in seconds
+    double x;    //!< x coordinate, in meters
+    double y;    //!< y coordinate, in meters
+    double z;    //!< z coordinate, in meters
+  };
+
+  /**
+   * \param filename the trace file to map.
+   *
+   * Map the trace file in memory and check its header. A fatal
+   * error is raised if the file cannot be mapped or is not a
+   * waypoint trace.
+   */
+  WaypointTrace (std::string filename);
+  ~WaypointTrace ();
+
+  /**
+   * \returns the number of node ids in the index.
+   */
+  uint32_t GetNNodes (void) const;
+  /**
+   * \param node the node id.
+   * \returns the number of waypoints of this node.
+   */
+  uint64_t GetNWaypoints (uint32_t node) const;
+  /**
+   * \param node the node id.
+   * \returns a pointer to the first of the GetNWaypoints (node)
+   *          waypoints of this node, sorted by time.
+   *
+   * The returned pointer points into the file mapping, and remains
+   * valid for the lifetime of this object.
+   */
+  const Record * GetWaypoints (uint32_t node) const;
+  /**
+   * \param node the node id.
+   * \param time the time to look for.
+   * \returns the index of the first waypoint of this node whose time
+   *          is not before time, or GetNWaypoints (node) if there is
+   *          none.
+   */
+  uint64_t Find (uint32_t node, Time time) const;
+  /**
+   * \param record a waypoint stored in the file.
+   * \returns the corresponding ns3::Waypoint.
+   */
+  static Waypoint GetWaypoint (const Record &record);
+
+  /**
+   * \param filename the file to write.
+   * \param waypoints the waypoints of each node, indexed by node id.
+   *        The waypoints of each node must be sorted by time.
+   *
+   * Write a trace file which can be read back by WaypointTrace.
+   */
+  static void Write (std::string filename, const std::vector<std::vector<Waypoint> > &waypoints);
+
+private:
+  struct Header
+  {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nNodes;
+    uint32_t reserved;
+  };
+  struct IndexEntry
+  {
+    uint64_t first;
+    uint64_t count;
+  };
+
+  WaypointTrace (const WaypointTrace &o);
+  WaypointTrace &operator = (const WaypointTrace &o);
+
+  void *m_map;
+  uint64_t m_size;
+  const Header *m_header;
+  const IndexEntry *m_index;
+  const Record *m_records;
+};
+
+} // namespace ns3
+
+#endif /* WAYPOINT_TRACE_H */
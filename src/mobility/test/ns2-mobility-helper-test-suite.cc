@@ -99,7 +99,8 @@ public:
     : TestCase (name),
       m_timeLimit (timeLimit),
       m_nodeCount (nodes),
-      m_nextRefPoint (0)
+      m_nextRefPoint (0),
+      m_streaming (false)
   {
   }
   /// Empty
@@ -121,6 +122,12 @@ public:
   {
     AddReferencePoint (ReferencePoint (id, Seconds (sec), p, v));
   }
+  /// Read the trace in streaming mode with the given window
+  void SetStreaming (Time window)
+  {
+    m_streaming = true;
+    m_window = window;
+  }
 
 private:
   /// Test time limit
@@ -135,6 +142,10 @@ private:
   size_t m_nextRefPoint;
   /// TMP trace file name
   std::string m_traceFile;
+  /// Read the trace in streaming mode
+  bool m_streaming;
+  /// Streaming window
+  Time m_window;
 
 private:
   /// Dump NS-2 trace to tmp file
@@ -225,6 +236,10 @@ private:
         return;
       }
     Ns2MobilityHelper mobility (m_traceFile);
+    if (m_streaming)
+      {
+        mobility.EnableStreaming (m_window);
+      }
     mobility.Install ();
     if (CheckInitialPositions ())
       {
@@ -450,6 +465,43 @@ public:
     t->AddReferencePoint ("0", 0, Vector (10, 0, 0), Vector (0,  0, 0));
     AddTestCase (t);
 
+    // Same movements as "square setdest", reading the trace half a second ahead
+    t = new Ns2MobilityHelperTest ("streaming square setdest", Seconds (6));
+    t->SetStreaming (Seconds (0.5));
+    t->SetTrace ("$node_(0) set X_ 0.0\n"
+                 "$node_(0) set Y_ 0.0\n"
+                 "$ns_ at 1.0 \"$node_(0) setdest 5  0  5\"\n"
+                 "$ns_ at 2.0 \"$node_(0) setdest 5  5  5\"\n"
+                 "$ns_ at 3.0 \"$node_(0) setdest 0  5  5\"\n"
+                 "$ns_ at 4.0 \"$node_(0) setdest 0  0  5\"\n"
+                 );
+    //                     id  t  position         velocity
+    t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0,  0, 0));
+    t->AddReferencePoint ("0", 1, Vector (0, 0, 0), Vector (5,  0, 0));
+    t->AddReferencePoint ("0", 2, Vector (5, 0, 0), Vector (0,  0, 0));
+    t->AddReferencePoint ("0", 2, Vector (5, 0, 0), Vector (0,  5, 0));
+    t->AddReferencePoint ("0", 3, Vector (5, 5, 0), Vector (0,  0, 0));
+    t->AddReferencePoint ("0", 3, Vector (5, 5, 0), Vector (-5, 0, 0));
+    t->AddReferencePoint ("0", 4, Vector (0, 5, 0), Vector (0, 0, 0));
+    t->AddReferencePoint ("0", 4, Vector (0, 5, 0), Vector (0, -5, 0));
+    t->AddReferencePoint ("0", 5, Vector (0, 0, 0), Vector (0,  0, 0));
+    AddTestCase (t);
+
+    // Interrupted movement (Bug 1219) where the interrupting setdest is
+    // only read from the trace after the first movement has started
+    t = new Ns2MobilityHelperTest ("streaming interrupted setdest", Seconds (16));
+    t->SetStreaming (Seconds (1));
+    t->SetTrace ("$node_(0) set X_ 0.0\n"
+                 "$node_(0) set Y_ 0.0\n"
+                 "$ns_ at 1.0 \"$node_(0) setdest 0  10       1\"\n"
+                 "$ns_ at 6.0 \"$node_(0) setdest 0  -10       1\"\n"
+                 );
+    //                     id  t  position         velocity
+    t->AddReferencePoint ("0", 0, Vector (0, 0, 0), Vector (0,  0, 0));
+    t->AddReferencePoint ("0", 1, Vector (0, 0, 0), Vector (0,  1, 0));
+    t->AddReferencePoint ("0", 6, Vector (0, 5, 0), Vector (0,  -1, 0));
+    t->AddReferencePoint ("0", 16, Vector (0, -10, 0), Vector (0, 0, 0));
+    AddTestCase (t);
 
   }
 } g_ns2TransmobilityHelperTestSuite;
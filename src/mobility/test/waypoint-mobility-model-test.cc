@@ -22,7 +22,9 @@
 #include "ns3/boolean.h"
 #include "ns3/config.h"
 #include "ns3/waypoint-mobility-model.h"
+#include "ns3/waypoint-trace.h"
 #include "ns3/test.h"
+#include <cstdio>
 
 namespace ns3 {
 
@@ -147,12 +149,97 @@ WaypointMobilityModelNotifyTest::CourseChangeCallback (std::string path, Ptr<con
     }
 }
 
+class WaypointTraceTest : public TestCase
+{
+public:
+  WaypointTraceTest ()
+    : TestCase ("Check Waypoint Mobility Model following a memory-mapped waypoint trace")
+  {
+  }
+  virtual ~WaypointTraceTest ()
+  {
+  }
+
+private:
+  std::string m_traceFile;
+  Ptr<WaypointMobilityModel> m_model;
+  Ptr<WaypointMobilityModel> m_lateModel;
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void AttachLateModel (Ptr<const WaypointTrace> trace);
+  void CheckPosition (Ptr<WaypointMobilityModel> model, Vector expected);
+};
+
+void
+WaypointTraceTest::DoTeardown (void)
+{
+  m_model = 0;
+  m_lateModel = 0;
+  std::remove (m_traceFile.c_str ());
+}
+
+void
+WaypointTraceTest::DoRun (void)
+{
+  m_traceFile = CreateTempDirFilename ("waypoint-trace-test.wpt");
+
+  std::vector<std::vector<Waypoint> > waypoints (2);
+  waypoints[0].push_back (Waypoint (Seconds (0.0), Vector (0.0, 0.0, 0.0)));
+  waypoints[0].push_back (Waypoint (Seconds (2.0), Vector (10.0, 0.0, 0.0)));
+  waypoints[0].push_back (Waypoint (Seconds (4.0), Vector (10.0, 20.0, 0.0)));
+  waypoints[1].push_back (Waypoint (Seconds (1.0), Vector (5.0, 5.0, 5.0)));
+  WaypointTrace::Write (m_traceFile, waypoints);
+
+  Ptr<WaypointTrace> trace = Create<WaypointTrace> (m_traceFile);
+  NS_TEST_ASSERT_MSG_EQ (trace->GetNNodes (), 2, "Wrong number of nodes in the trace");
+  NS_TEST_ASSERT_MSG_EQ (trace->GetNWaypoints (0), 3, "Wrong number of waypoints for node 0");
+  NS_TEST_ASSERT_MSG_EQ (trace->GetNWaypoints (1), 1, "Wrong number of waypoints for node 1");
+  NS_TEST_ASSERT_MSG_EQ (trace->GetWaypoints (1)->x, 5.0, "Wrong waypoint for node 1");
+  NS_TEST_ASSERT_MSG_EQ (trace->Find (0, Seconds (0.0)), 0, "Wrong waypoint found at 0s");
+  NS_TEST_ASSERT_MSG_EQ (trace->Find (0, Seconds (3.0)), 2, "Wrong waypoint found at 3s");
+  NS_TEST_ASSERT_MSG_EQ (trace->Find (0, Seconds (5.0)), 3, "Wrong waypoint found at 5s");
+
+  m_model = CreateObject<WaypointMobilityModel> ();
+  m_model->SetWaypointTrace (trace, 0);
+  NS_TEST_ASSERT_MSG_EQ (m_model->WaypointsLeft (), 1, "Wrong number of waypoints left");
+
+  Simulator::Schedule (Seconds (1.0), &WaypointTraceTest::CheckPosition, this, m_model, Vector (5.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (3.0), &WaypointTraceTest::CheckPosition, this, m_model, Vector (10.0, 10.0, 0.0));
+  Simulator::Schedule (Seconds (5.0), &WaypointTraceTest::CheckPosition, this, m_model, Vector (10.0, 20.0, 0.0));
+  // A model attached in the middle of the trace starts from its current position
+  m_lateModel = CreateObject<WaypointMobilityModel> ();
+  Simulator::Schedule (Seconds (1.5), &WaypointTraceTest::AttachLateModel, this, trace);
+  Simulator::Schedule (Seconds (1.5), &WaypointTraceTest::CheckPosition, this, m_lateModel, Vector (7.5, 0.0, 0.0));
+  Simulator::Schedule (Seconds (3.5), &WaypointTraceTest::CheckPosition, this, m_lateModel, Vector (10.0, 15.0, 0.0));
+
+  Simulator::Stop (Seconds (6.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+WaypointTraceTest::AttachLateModel (Ptr<const WaypointTrace> trace)
+{
+  m_lateModel->SetWaypointTrace (trace, 0);
+}
+
+void
+WaypointTraceTest::CheckPosition (Ptr<WaypointMobilityModel> model, Vector expected)
+{
+  Vector position = model->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.x, expected.x, 1e-6, "Wrong x position at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.y, expected.y, 1e-6, "Wrong y position at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.z, expected.z, 1e-6, "Wrong z position at " << Simulator::Now ().GetSeconds ());
+}
+
 static struct WaypointMobilityModelTestSuite : public TestSuite
 {
   WaypointMobilityModelTestSuite () : TestSuite ("waypoint-mobility-model", UNIT)
   {
     AddTestCase (new WaypointMobilityModelNotifyTest (true));
     AddTestCase (new WaypointMobilityModelNotifyTest (false));
+    AddTestCase (new WaypointTraceTest);
   }
 } g_waypointMobilityModelTestSuite;
 
@@ -37,12 +37,14 @@ int main (int argc, char *argv[])
   uint32_t    nRightLeaf = 5;
   uint32_t    nLeaf = 0; // If non-zero, number of both left and right
   std::string animFile = "dumbbell-animation.xml" ;  // Name of file for animation output
+  bool binary = false; // Write a binary animation, see convert-binary-anim
 
   CommandLine cmd;
   cmd.AddValue ("nLeftLeaf", "Number of left side leaf nodes", nLeftLeaf);
   cmd.AddValue ("nRightLeaf","Number of right side leaf nodes", nRightLeaf);
   cmd.AddValue ("nLeaf",     "Number of left and right side leaf nodes", nLeaf);
   cmd.AddValue ("animFile",  "File Name for Animation Output", animFile);
+  cmd.AddValue ("binary",    "Write the animation in the binary format", binary);
 
   cmd.Parse (argc,argv);
   if (nLeaf > 0)
@@ -95,6 +97,10 @@ int main (int argc, char *argv[])
   d.BoundingBox (1, 1, 100, 100);
 
   // Create the animation object and configure for specified output
+  if (binary)
+    {
+      AnimationInterface::EnableBinaryOutput ();
+    }
   AnimationInterface anim (animFile);
   
   // Set up the acutal simulation
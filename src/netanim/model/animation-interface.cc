@@ -40,6 +40,7 @@
 #include <string>
 #include <iomanip>
 #include <map>
+#include <cstring>
 
 // Socket related includes
 #if defined(HAVE_SYS_SOCKET_H) && defined(HAVE_NETINET_IN_H)
@@ -56,8 +57,47 @@ static bool initialized = false;
 
 namespace ns3 {
 
+// Size above which the output buffer of a file is written
+static const uint32_t OUTPUT_BUFFER_SIZE = 1 << 16;
+
+/**
+ * The binary animation stream: the magic, then a sequence of records,
+ * each made of a one byte type followed by the fields below, all in
+ * host byte order.  Every record matches one xml element.
+ */
+enum AnimRecordType {
+  ANIM_RECORD_TOPOLOGY = 1,       // double minX, minY, maxX, maxY
+  ANIM_RECORD_TOPOLOGY_CLOSE = 2, //
+  ANIM_RECORD_NODE = 3,           // uint32_t id, double locX, locY
+  ANIM_RECORD_LINK = 4,           // uint32_t fromId, toId
+  ANIM_RECORD_PACKET = 5,         // uint32_t fromId, double fbTx, lbTx,
+                                  // uint32_t toId, double fbRx, lbRx
+  ANIM_RECORD_WPACKET = 6,        // uint32_t fromId, double fbTx, lbTx, range,
+                                  // uint32_t toId, double fbRx, lbRx
+  ANIM_RECORD_DUMMY = 7,          // double now
+  ANIM_RECORD_END = 8             //
+};
+static const char g_animBinaryMagic[8] = { 'N', 'S', '3', 'A', 'N', 'I', 'M', 1 };
+static bool g_animBinaryOutput = false;
+
+template <typename T>
+static void
+AppendValue (std::string &buffer, T value)
+{
+  buffer.append (reinterpret_cast<const char *> (&value), sizeof (value));
+}
+
+template <typename T>
+static T
+ReadValue (std::istream &is)
+{
+  T value = T ();
+  is.read (reinterpret_cast<char *> (&value), sizeof (value));
+  return value;
+}
+
 AnimationInterface::AnimationInterface ()
-  : m_fHandle (STDOUT_FILENO), m_xml (false), mobilitypollinterval (Seconds(0.25)),
+  : m_fHandle (STDOUT_FILENO), m_xml (false), m_binary (false), mobilitypollinterval (Seconds(0.25)),
     usingSockets (false), mport (0), outputfilename (""),
     OutputFileSet (false), ServerPortSet (false), gAnimUid (0),randomPosition (true),
     m_writeCallback (0), m_started (false)
@@ -67,7 +107,7 @@ AnimationInterface::AnimationInterface ()
 }
 
 AnimationInterface::AnimationInterface (const std::string fn, bool usingXML)
-  : m_fHandle (STDOUT_FILENO), m_xml (usingXML), mobilitypollinterval (Seconds(0.25)), 
+  : m_fHandle (STDOUT_FILENO), m_xml (usingXML), m_binary (false), mobilitypollinterval (Seconds(0.25)), 
     usingSockets (false), mport (0), outputfilename (fn),
     OutputFileSet (false), ServerPortSet (false), gAnimUid (0), randomPosition (true),
     m_writeCallback (0), m_started (false)
@@ -77,7 +117,7 @@ AnimationInterface::AnimationInterface (const std::string fn, bool usingXML)
 }
 
 AnimationInterface::AnimationInterface (const uint16_t port, bool usingXML)
-  : m_fHandle (STDOUT_FILENO), m_xml (usingXML), mobilitypollinterval (Seconds(0.25)), 
+  : m_fHandle (STDOUT_FILENO), m_xml (usingXML), m_binary (false), mobilitypollinterval (Seconds(0.25)), 
     usingSockets (true), mport (port), outputfilename (""),
     OutputFileSet (false), ServerPortSet (false), gAnimUid (0), randomPosition (true),
     m_writeCallback (0), m_started (false)
@@ -97,6 +137,16 @@ void AnimationInterface::SetXMLOutput ()
   m_xml = true;
 }
 
+void AnimationInterface::EnableBinaryOutput ()
+{
+  g_animBinaryOutput = true;
+}
+
+void AnimationInterface::DisableBinaryOutput ()
+{
+  g_animBinaryOutput = false;
+}
+
 bool AnimationInterface::SetOutputFile (const std::string& fn)
 {
   if (OutputFileSet)
@@ -335,6 +385,16 @@ void AnimationInterface::StartAnimation ()
     {
       SetOutputFile (outputfilename);
     }      
+  m_binary = g_animBinaryOutput && !usingSockets;
+  if (g_animBinaryOutput && usingSockets)
+    {
+      NS_LOG_WARN ("Binary output is not supported on a socket, using xml");
+    }
+  if (m_binary)
+    {
+      // The binary records are converted to xml
+      m_xml = true;
+    }
 
   // Find the min/max x/y for the xml topology element
   topo_minX = -2;
@@ -353,7 +413,12 @@ void AnimationInterface::StartAnimation ()
     }
 
   AddMargin ();
-  if (m_xml)
+  if (m_binary)
+    {
+      WriteN (m_fHandle, g_animBinaryMagic, sizeof (g_animBinaryMagic));
+      WriteTopologyOpen ();
+    }
+  else if (m_xml)
     { // output the xml headers
       std::ostringstream oss;
       oss << GetXMLOpen_anim (0);
@@ -369,9 +434,7 @@ void AnimationInterface::StartAnimation ()
       std::ostringstream oss;
       if (m_xml)
         {
-          Vector v = GetPosition (n);
-          oss << GetXMLOpenClose_node (0, n->GetId (), v.x, v.y);
-	  WriteN (m_fHandle, oss.str ());
+          WriteNode (n->GetId (), GetPosition (n));
         }
       else
         {
@@ -410,16 +473,16 @@ void AnimationInterface::StartAnimation ()
                   uint32_t n2Id = chDev->GetNode ()->GetId ();
                   if (n1Id < n2Id)
                     { // ouptut the p2p link
-                      std::ostringstream oss;
                       if (m_xml)
                         {
-                          oss << GetXMLOpenClose_link (0,n1Id,0,n2Id);
+                          WriteLink (n1Id, n2Id);
                         }
                       else
                         {
+                          std::ostringstream oss;
                           oss << "0.0 L "  << n1Id << " " << n2Id << std::endl;
+                          WriteN (m_fHandle, oss.str ());
                         }
-                      WriteN (m_fHandle, oss.str ());
                     }
                 }
             }
@@ -431,7 +494,7 @@ void AnimationInterface::StartAnimation ()
     }
   if (m_xml)
     {
-      WriteN (m_fHandle, GetXMLClose ("topology"));
+      WriteTopologyClose ();
       Simulator::Schedule (mobilitypollinterval, &AnimationInterface::MobilityAutoCheck, this);
     }
 
@@ -453,7 +516,7 @@ void AnimationInterface::ConnectCallbacks ()
                    MakeCallback (&AnimationInterface::WifiPhyRxEndTrace, this));
   Config::Connect ("NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/MacRx",
                    MakeCallback (&AnimationInterface::WifiMacRxTrace, this));
-  Config::ConnectWithoutContext ("/NodeList/*/$ns3::MobilityModel/CourseChange",
+  Config::Connect ("/NodeList/*/$ns3::MobilityModel/CourseChange",
                    MakeCallback (&AnimationInterface::MobilityCourseChangeTrace, this));
   Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WimaxNetDevice/Tx",
                    MakeCallback (&AnimationInterface::WimaxTxTrace, this));
@@ -479,10 +542,17 @@ void AnimationInterface::StopAnimation ()
   ResetAnimWriteCallback ();
   if (m_fHandle > 0) 
     {
-      if (m_xml)
+      if (m_binary)
+        {
+          std::string record;
+          AppendValue<uint8_t> (record, ANIM_RECORD_END);
+          WriteN (m_fHandle, record.c_str (), record.size ());
+        }
+      else if (m_xml)
         { // Terminate the anim element
           WriteN (m_fHandle, GetXMLClose ("anim"));
         }
+      FlushOutput (true);
       if (m_fHandle != STDOUT_FILENO)
         {
           close (m_fHandle);
@@ -523,6 +593,8 @@ void AnimationInterface::AddMargin ()
 std::vector <Ptr <Node> >  AnimationInterface::RecalcTopoBounds ()
 {
   std::vector < Ptr <Node> > MovedNodes;
+  // Every node is polled: some mobility models, e.g. the lazy
+  // WaypointMobilityModel, only notify a course change when queried
   for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
     {
       Ptr<Node> n = *i;
@@ -571,6 +643,37 @@ void AnimationInterface::RecalcTopoBounds (Vector v)
 
 int AnimationInterface::WriteN (HANDLETYPE h, const char* data, uint32_t count)
 { 
+  if (h < 0)
+    {
+      return 0;
+    }
+  if (usingSockets)
+    {
+      // The animator reads the socket while the simulation runs
+      return WriteRaw (h, data, count);
+    }
+  NS_ASSERT (h == m_fHandle);
+  m_outputBuffer.append (data, count);
+  FlushOutput (false);
+  return count;
+}
+
+void AnimationInterface::FlushOutput (bool force)
+{
+  if (m_outputBuffer.empty () || (!force && m_outputBuffer.size () < OUTPUT_BUFFER_SIZE))
+    {
+      return;
+    }
+  uint32_t written = WriteRaw (m_fHandle, m_outputBuffer.c_str (), m_outputBuffer.size ());
+  if (written != m_outputBuffer.size ())
+    {
+      NS_LOG_WARN ("Unable to write the animation output");
+    }
+  m_outputBuffer.clear ();
+}
+
+int AnimationInterface::WriteRaw (HANDLETYPE h, const char* data, uint32_t count)
+{
   if (h < 0)
     {
       return 0;
@@ -601,6 +704,14 @@ void AnimationInterface::WriteDummyPacket ()
   double lbTx = now.GetSeconds ();
   double fbRx = now.GetSeconds ();
   double lbRx = now.GetSeconds ();
+  if (m_binary)
+    {
+      std::string record;
+      AppendValue<uint8_t> (record, ANIM_RECORD_DUMMY);
+      AppendValue<double> (record, fbTx);
+      WriteN (m_fHandle, record.c_str (), record.size ());
+      return;
+    }
   if (m_xml)
     {
       oss << GetXMLOpen_packet (0,0,fbTx,lbTx,"DummyPktIgnoreThis");
@@ -611,7 +722,214 @@ void AnimationInterface::WriteDummyPacket ()
 
 
 }
-void AnimationInterface::DevTxTrace (std::string context, Ptr<const Packet> p,
+
+void AnimationInterface::WriteTopologyOpen ()
+{
+  if (m_binary)
+    {
+      std::string record;
+      AppendValue<uint8_t> (record, ANIM_RECORD_TOPOLOGY);
+      AppendValue<double> (record, topo_minX);
+      AppendValue<double> (record, topo_minY);
+      AppendValue<double> (record, topo_maxX);
+      AppendValue<double> (record, topo_maxY);
+      WriteN (m_fHandle, record.c_str (), record.size ());
+    }
+  else
+    {
+      WriteN (m_fHandle, GetXMLOpen_topology (topo_minX, topo_minY, topo_maxX, topo_maxY));
+    }
+}
+
+void AnimationInterface::WriteTopologyClose ()
+{
+  if (m_binary)
+    {
+      std::string record;
+      AppendValue<uint8_t> (record, ANIM_RECORD_TOPOLOGY_CLOSE);
+      WriteN (m_fHandle, record.c_str (), record.size ());
+    }
+  else
+    {
+      WriteN (m_fHandle, GetXMLClose ("topology"));
+    }
+}
+
+void AnimationInterface::WriteNode (uint32_t id, Vector v)
+{
+  if (m_binary)
+    {
+      std::string record;
+      AppendValue<uint8_t> (record, ANIM_RECORD_NODE);
+      AppendValue<uint32_t> (record, id);
+      AppendValue<double> (record, v.x);
+      AppendValue<double> (record, v.y);
+      WriteN (m_fHandle, record.c_str (), record.size ());
+    }
+  else
+    {
+      WriteN (m_fHandle, GetXMLOpenClose_node (0, id, v.x, v.y));
+    }
+}
+
+void AnimationInterface::WriteLink (uint32_t fromId, uint32_t toId)
+{
+  if (m_binary)
+    {
+      std::string record;
+      AppendValue<uint8_t> (record, ANIM_RECORD_LINK);
+      AppendValue<uint32_t> (record, fromId);
+      AppendValue<uint32_t> (record, toId);
+      WriteN (m_fHandle, record.c_str (), record.size ());
+    }
+  else
+    {
+      WriteN (m_fHandle, GetXMLOpenClose_link (0, fromId, 0, toId));
+    }
+}
+
+void AnimationInterface::WritePacket (uint32_t fromId, double fbTx, double lbTx,
+                                      uint32_t toId, double fbRx, double lbRx)
+{
+  if (m_binary)
+    {
+      std::string record;
+      AppendValue<uint8_t> (record, ANIM_RECORD_PACKET);
+      AppendValue<uint32_t> (record, fromId);
+      AppendValue<double> (record, fbTx);
+      AppendValue<double> (record, lbTx);
+      AppendValue<uint32_t> (record, toId);
+      AppendValue<double> (record, fbRx);
+      AppendValue<double> (record, lbRx);
+      WriteN (m_fHandle, record.c_str (), record.size ());
+    }
+  else
+    {
+      std::ostringstream oss;
+      oss << GetXMLOpen_packet (0, fromId, fbTx, lbTx);
+      oss << GetXMLOpenClose_rx (0, toId, fbRx, lbRx);
+      oss << GetXMLClose ("packet");
+      WriteN (m_fHandle, oss.str ());
+    }
+}
+
+void AnimationInterface::WriteWirelessPacket (uint32_t fromId, double fbTx, double lbTx, double range,
+                                              uint32_t toId, double fbRx, double lbRx)
+{
+  if (m_binary)
+    {
+      std::string record;
+      AppendValue<uint8_t> (record, ANIM_RECORD_WPACKET);
+      AppendValue<uint32_t> (record, fromId);
+      AppendValue<double> (record, fbTx);
+      AppendValue<double> (record, lbTx);
+      AppendValue<double> (record, range);
+      AppendValue<uint32_t> (record, toId);
+      AppendValue<double> (record, fbRx);
+      AppendValue<double> (record, lbRx);
+      WriteN (m_fHandle, record.c_str (), record.size ());
+    }
+  else
+    {
+      std::ostringstream oss;
+      oss << GetXMLOpen_wpacket (0, fromId, fbTx, lbTx, range);
+      oss << GetXMLOpenClose_rx (0, toId, fbRx, lbRx);
+      oss << GetXMLClose ("wpacket");
+      WriteN (m_fHandle, oss.str ());
+    }
+}
+
+bool AnimationInterface::ConvertToXml (std::istream &is, std::ostream &os)
+{
+  char magic[sizeof (g_animBinaryMagic)];
+  is.read (magic, sizeof (magic));
+  if (!is || std::memcmp (magic, g_animBinaryMagic, sizeof (magic)) != 0)
+    {
+      return false;
+    }
+  os << GetXMLOpen_anim (0);
+  os << GetPreamble ();
+  while (true)
+    {
+      uint8_t type = ReadValue<uint8_t> (is);
+      if (!is)
+        {
+          return false;
+        }
+      if (type == ANIM_RECORD_TOPOLOGY)
+        {
+          double minX = ReadValue<double> (is);
+          double minY = ReadValue<double> (is);
+          double maxX = ReadValue<double> (is);
+          double maxY = ReadValue<double> (is);
+          os << GetXMLOpen_topology (minX, minY, maxX, maxY);
+        }
+      else if (type == ANIM_RECORD_TOPOLOGY_CLOSE)
+        {
+          os << GetXMLClose ("topology");
+        }
+      else if (type == ANIM_RECORD_NODE)
+        {
+          uint32_t id = ReadValue<uint32_t> (is);
+          double locX = ReadValue<double> (is);
+          double locY = ReadValue<double> (is);
+          os << GetXMLOpenClose_node (0, id, locX, locY);
+        }
+      else if (type == ANIM_RECORD_LINK)
+        {
+          uint32_t fromId = ReadValue<uint32_t> (is);
+          uint32_t toId = ReadValue<uint32_t> (is);
+          os << GetXMLOpenClose_link (0, fromId, 0, toId);
+        }
+      else if (type == ANIM_RECORD_PACKET)
+        {
+          uint32_t fromId = ReadValue<uint32_t> (is);
+          double fbTx = ReadValue<double> (is);
+          double lbTx = ReadValue<double> (is);
+          uint32_t toId = ReadValue<uint32_t> (is);
+          double fbRx = ReadValue<double> (is);
+          double lbRx = ReadValue<double> (is);
+          os << GetXMLOpen_packet (0, fromId, fbTx, lbTx);
+          os << GetXMLOpenClose_rx (0, toId, fbRx, lbRx);
+          os << GetXMLClose ("packet");
+        }
+      else if (type == ANIM_RECORD_WPACKET)
+        {
+          uint32_t fromId = ReadValue<uint32_t> (is);
+          double fbTx = ReadValue<double> (is);
+          double lbTx = ReadValue<double> (is);
+          double range = ReadValue<double> (is);
+          uint32_t toId = ReadValue<uint32_t> (is);
+          double fbRx = ReadValue<double> (is);
+          double lbRx = ReadValue<double> (is);
+          os << GetXMLOpen_wpacket (0, fromId, fbTx, lbTx, range);
+          os << GetXMLOpenClose_rx (0, toId, fbRx, lbRx);
+          os << GetXMLClose ("wpacket");
+        }
+      else if (type == ANIM_RECORD_DUMMY)
+        {
+          double now = ReadValue<double> (is);
+          os << GetXMLOpen_packet (0, 0, now, now, "DummyPktIgnoreThis");
+          os << GetXMLOpenClose_rx (0, 0, now, now);
+          os << GetXMLClose ("packet");
+        }
+      else if (type == ANIM_RECORD_END)
+        {
+          os << GetXMLClose ("anim");
+          return true;
+        }
+      else
+        {
+          return false;
+        }
+      if (!is)
+        {
+          return false;
+        }
+    }
+}
+
+void AnimationInterface::DevTxTrace (TraceContext context, Ptr<const Packet> p,
                                      Ptr<NetDevice> tx, Ptr<NetDevice> rx,
                                      Time txTime, Time rxTime)
 {
@@ -627,9 +945,8 @@ void AnimationInterface::DevTxTrace (std::string context, Ptr<const Packet> p,
   double lbRx = (now + rxTime).GetSeconds ();
   if (m_xml)
     {
-      oss << GetXMLOpen_packet (0,tx->GetNode ()->GetId (),fbTx,lbTx);
-      oss << GetXMLOpenClose_rx (0,rx->GetNode ()->GetId (),fbRx,lbRx); 
-      oss << GetXMLClose ("packet");
+      WritePacket (tx->GetNode ()->GetId (), fbTx, lbTx, rx->GetNode ()->GetId (), fbRx, lbRx);
+      return;
     }
   else
     {
@@ -646,16 +963,13 @@ void AnimationInterface::DevTxTrace (std::string context, Ptr<const Packet> p,
 
 
 Ptr <NetDevice>
-AnimationInterface::GetNetDeviceFromContext (std::string context)
+AnimationInterface::GetNetDeviceFromContext (TraceContext context)
 {
   // Use "NodeList/*/DeviceList/*/ as reference
-  // where element [1] is the Node Id
-  // element [2] is the NetDevice Id
-
-  std::vector <std::string> elements = GetElementsFromContext (context);
-  Ptr <Node> n = NodeList::GetNode (atoi (elements[1].c_str ()));
+  NS_ASSERT (context.HasDeviceId ());
+  Ptr <Node> n = NodeList::GetNode (context.GetNodeId ());
   NS_ASSERT (n);
-  return n->GetDevice (atoi (elements[3].c_str ()));
+  return n->GetDevice (context.GetDeviceId ());
 }
                                   
 void AnimationInterface::AddPendingWifiPacket (uint64_t AnimUid, AnimPacketInfo &pktinfo)
@@ -690,7 +1004,7 @@ uint64_t AnimationInterface::GetAnimUidFromPacket (Ptr <const Packet> p)
     }
 }
 
-void AnimationInterface::WifiPhyTxBeginTrace (std::string context,
+void AnimationInterface::WifiPhyTxBeginTrace (TraceContext context,
                                           Ptr<const Packet> p)
 {
   if (!m_started)
@@ -709,12 +1023,12 @@ void AnimationInterface::WifiPhyTxBeginTrace (std::string context,
   AddPendingWifiPacket (gAnimUid, pktinfo);
 }
 
-void AnimationInterface::WifiPhyTxEndTrace (std::string context,
+void AnimationInterface::WifiPhyTxEndTrace (TraceContext context,
                                             Ptr<const Packet> p)
 {
 }
 
-void AnimationInterface::WifiPhyTxDropTrace (std::string context,
+void AnimationInterface::WifiPhyTxDropTrace (TraceContext context,
                                              Ptr<const Packet> p)
 {
   if (!m_started)
@@ -729,7 +1043,7 @@ void AnimationInterface::WifiPhyTxDropTrace (std::string context,
 }
 
 
-void AnimationInterface::WifiPhyRxBeginTrace (std::string context,
+void AnimationInterface::WifiPhyRxBeginTrace (TraceContext context,
                                               Ptr<const Packet> p)
 {
   if (!m_started)
@@ -748,7 +1062,7 @@ void AnimationInterface::WifiPhyRxBeginTrace (std::string context,
 }
 
 
-void AnimationInterface::WifiPhyRxEndTrace (std::string context,
+void AnimationInterface::WifiPhyRxEndTrace (TraceContext context,
                                             Ptr<const Packet> p)
 {
   if (!m_started)
@@ -768,7 +1082,7 @@ void AnimationInterface::WifiPhyRxEndTrace (std::string context,
   pktInfo.ProcessRxEnd (ndev, Simulator::Now (), UpdatePosition (n));
 }
 
-void AnimationInterface::WifiMacRxTrace (std::string context,
+void AnimationInterface::WifiMacRxTrace (TraceContext context,
                                          Ptr<const Packet> p)
 {
   if (!m_started)
@@ -793,12 +1107,12 @@ void AnimationInterface::WifiMacRxTrace (std::string context,
     }
 
 }
-void AnimationInterface::WifiPhyRxDropTrace (std::string context,
+void AnimationInterface::WifiPhyRxDropTrace (TraceContext context,
                                              Ptr<const Packet> p)
 {
 }
 
-void AnimationInterface::WimaxTxTrace (std::string context, Ptr<const Packet> p, const Mac48Address & m)
+void AnimationInterface::WimaxTxTrace (TraceContext context, Ptr<const Packet> p, const Mac48Address & m)
 {
   if (!m_started)
     return;
@@ -817,7 +1131,7 @@ void AnimationInterface::WimaxTxTrace (std::string context, Ptr<const Packet> p,
 }
 
 
-void AnimationInterface::WimaxRxTrace (std::string context, Ptr<const Packet> p, const Mac48Address & m)
+void AnimationInterface::WimaxRxTrace (TraceContext context, Ptr<const Packet> p, const Mac48Address & m)
 {
   if (!m_started)
     return;
@@ -835,7 +1149,7 @@ void AnimationInterface::WimaxRxTrace (std::string context, Ptr<const Packet> p,
   OutputWirelessPacket (pktInfo, pktrxInfo);
 }
 
-void AnimationInterface::CsmaPhyTxBeginTrace (std::string context, Ptr<const Packet> p)
+void AnimationInterface::CsmaPhyTxBeginTrace (TraceContext context, Ptr<const Packet> p)
 {
   if (!m_started)
     return;
@@ -853,7 +1167,7 @@ void AnimationInterface::CsmaPhyTxBeginTrace (std::string context, Ptr<const Pac
 
 }
 
-void AnimationInterface::CsmaPhyTxEndTrace (std::string context, Ptr<const Packet> p)
+void AnimationInterface::CsmaPhyTxEndTrace (TraceContext context, Ptr<const Packet> p)
 {
   if (!m_started)
     return;
@@ -871,7 +1185,7 @@ void AnimationInterface::CsmaPhyTxEndTrace (std::string context, Ptr<const Packe
   pktInfo.m_lbTx = Simulator::Now ().GetSeconds ();
 }
 
-void AnimationInterface::CsmaPhyRxEndTrace (std::string context, Ptr<const Packet> p)
+void AnimationInterface::CsmaPhyRxEndTrace (TraceContext context, Ptr<const Packet> p)
 {
   if (!m_started)
     return;
@@ -893,7 +1207,7 @@ void AnimationInterface::CsmaPhyRxEndTrace (std::string context, Ptr<const Packe
 }
 
 
-void AnimationInterface::CsmaMacRxTrace (std::string context,
+void AnimationInterface::CsmaMacRxTrace (TraceContext context,
                                          Ptr<const Packet> p)
 {
   if (!m_started)
@@ -920,29 +1234,20 @@ void AnimationInterface::CsmaMacRxTrace (std::string context,
 }
 
 
-void AnimationInterface::MobilityCourseChangeTrace (Ptr <const MobilityModel> mobility)
+void AnimationInterface::MobilityCourseChangeTrace (TraceContext context,
+                                                    Ptr <const MobilityModel> mobility)
 
 {
   if (!m_started)
     return;
-  Ptr <Node> n = mobility->GetObject <Node> ();
-  NS_ASSERT (n);
-  Vector v ;
-  if (!mobility)
-    {
-      v = GetPosition (n);
-    } 
-  else
-    {
-      v = mobility->GetPosition ();
-    }
-  UpdatePosition (n,v);
+  NS_ASSERT (context.HasNodeId ());
+  uint32_t nodeId = context.GetNodeId ();
+  Vector v = mobility->GetPosition ();
+  nodeLocation[nodeId] = v;
   RecalcTopoBounds (v);
-  std::ostringstream oss; 
-  oss << GetXMLOpen_topology (topo_minX,topo_minY,topo_maxX,topo_maxY);
-  oss << GetXMLOpenClose_node (0,n->GetId (),v.x,v.y);
-  oss << GetXMLClose ("topology");
-  WriteN (m_fHandle, oss.str ());
+  WriteTopologyOpen ();
+  WriteNode (nodeId, v);
+  WriteTopologyClose ();
   WriteDummyPacket ();
 }
 
@@ -963,19 +1268,21 @@ bool AnimationInterface::NodeHasMoved (Ptr <Node> n, Vector newLocation)
 
 void AnimationInterface::MobilityAutoCheck ()
 {
+  if (!m_started)
+    return;
   std::vector <Ptr <Node> > MovedNodes = RecalcTopoBounds ();
-  std::ostringstream oss;
-  oss << GetXMLOpen_topology (topo_minX, topo_minY, topo_maxX, topo_maxY);
-  for (uint32_t i = 0; i < MovedNodes.size (); i++)
+  if (!MovedNodes.empty ())
     {
-      Ptr <Node> n = MovedNodes [i];
-      NS_ASSERT (n);
-      Vector v = GetPosition (n);
-      oss << GetXMLOpenClose_node (0, n->GetId (), v.x, v.y);
+      WriteTopologyOpen ();
+      for (uint32_t i = 0; i < MovedNodes.size (); i++)
+        {
+          Ptr <Node> n = MovedNodes [i];
+          NS_ASSERT (n);
+          WriteNode (n->GetId (), GetPosition (n));
+        }
+      WriteTopologyClose ();
+      WriteDummyPacket ();
     }
-  oss << GetXMLClose ("topology");
-  WriteN (m_fHandle, oss.str ());
-  WriteDummyPacket ();
   if (!Simulator::IsFinished ())
     {
       PurgePendingWifi ();
@@ -1040,32 +1347,24 @@ return s;
 void AnimationInterface::OutputWirelessPacket (AnimPacketInfo &pktInfo, AnimRxInfo pktrxInfo)
 {
   NS_ASSERT (m_xml);
-  std::ostringstream oss;
   NS_ASSERT (pktInfo.m_txnd);
   uint32_t nodeId = pktInfo.m_txnd->GetNode ()->GetId ();
 
   double lbTx = pktInfo.firstlastbitDelta + pktInfo.m_fbTx;
-  oss << GetXMLOpen_wpacket (0, nodeId, pktInfo.m_fbTx, lbTx, pktrxInfo.rxRange);
-
   uint32_t rxId = pktrxInfo.m_rxnd->GetNode ()->GetId ();
-  oss << GetXMLOpenClose_rx (0, rxId, pktrxInfo.m_fbRx, pktrxInfo.m_lbRx);
-
-  oss << GetXMLClose ("wpacket");
-  WriteN (m_fHandle, oss.str ());
+  WriteWirelessPacket (nodeId, pktInfo.m_fbTx, lbTx, pktrxInfo.rxRange,
+                       rxId, pktrxInfo.m_fbRx, pktrxInfo.m_lbRx);
 }
 
 void AnimationInterface::OutputCsmaPacket (AnimPacketInfo &pktInfo, AnimRxInfo pktrxInfo)
 {
   NS_ASSERT (m_xml);
-  std::ostringstream oss;
   NS_ASSERT (pktInfo.m_txnd);
   uint32_t nodeId = pktInfo.m_txnd->GetNode ()->GetId ();
 
-  oss << GetXMLOpen_packet (0, nodeId, pktInfo.m_fbTx, pktInfo.m_lbTx);
   uint32_t rxId = pktrxInfo.m_rxnd->GetNode ()->GetId ();
-  oss << GetXMLOpenClose_rx (0, rxId, pktrxInfo.m_fbRx, pktrxInfo.m_lbRx);
-  oss << GetXMLClose ("packet");
-  WriteN (m_fHandle, oss.str ());
+  WritePacket (nodeId, pktInfo.m_fbTx, pktInfo.m_lbTx,
+               rxId, pktrxInfo.m_fbRx, pktrxInfo.m_lbRx);
 }
 
 void AnimationInterface::SetConstantPosition (Ptr <Node> n, double x, double y, double z)
@@ -1154,21 +1453,6 @@ std::string AnimationInterface::GetXMLOpenClose_rx (uint32_t toLp, uint32_t toId
   return oss.str ();
 }
 
-std::vector<std::string> AnimationInterface::GetElementsFromContext (std::string context)
-{
-  std::vector <std::string> elements;
-  size_t pos1=0, pos2;
-  while (pos1 != context.npos)
-  {
-    pos1 = context.find ("/",pos1);
-    pos2 = context.find ("/",pos1+1);
-    elements.push_back (context.substr (pos1+1,pos2-(pos1+1)));
-    pos1 = pos2; 
-    pos2 = context.npos;
-  }
-  return elements;
-}
-
 TypeId
 AnimByteTag::GetTypeId (void)
 {
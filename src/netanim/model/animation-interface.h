@@ -24,6 +24,8 @@
 #include <string>
 #include <stdio.h>
 #include <map>
+#include <istream>
+#include <ostream>
 #include "ns3/ptr.h"
 #include "ns3/net-device.h"
 #include "ns3/nstime.h"
@@ -31,6 +33,7 @@
 #include "ns3/node-list.h"
 #include "ns3/simulator.h"
 #include "ns3/config.h"
+#include "ns3/trace-context.h"
 #include "ns3/animation-interface-helper.h"
 #include "ns3/mac48-address.h"
 
@@ -127,6 +130,39 @@ public:
    */
   void SetXMLOutput ();
 
+  /**
+   * \brief Write the animation of the interfaces started afterwards in
+   * a compact binary format instead of XML.
+   *
+   * The binary stream holds the elements of the XML output as
+   * fixed-size records in host byte order, and is written to the output
+   * file through a large buffer.  ConvertToXml and the
+   * convert-binary-anim program regenerate the XML trace read by the
+   * animator.  Binary output is not supported when writing to a socket,
+   * and the write callback is not called for binary records.
+   *
+   */
+  static void EnableBinaryOutput (void);
+
+  /**
+   * \brief Write the animation of the interfaces started afterwards in
+   * the format selected by the constructor.
+   *
+   */
+  static void DisableBinaryOutput (void);
+
+  /**
+   * \brief Convert a binary animation stream to the XML trace format
+   *
+   * \param is a stream which contains the output of an interface started
+   * after EnableBinaryOutput.
+   * \param os the stream to which the XML trace is written.
+   * \returns true if the whole input stream could be converted, false if
+   * it is not a binary animation stream or is truncated.
+   *
+   */
+  static bool ConvertToXml (std::istream &is, std::ostream &os);
+
   /**
    * \brief (Deprecated) Specify that animation commands are to be written to
    * a socket.
@@ -164,6 +200,8 @@ public:
    * \brief Set mobility poll interval:WARNING: setting a low interval can 
    * cause slowness
    *
+   * Nothing is written at a poll if none of the nodes moved.
+   *
    * \param t Time interval between fetching mobility/position information
    * Default: 0.25s
    *
@@ -226,52 +264,69 @@ private:
   SOCKET m_fHandle;  // File handle for output (-1 if none)
   int  WriteN (SOCKET, const char*, uint32_t);
 #endif
+  // Write directly to the handle, bypassing the output buffer
+  int WriteRaw (HANDLETYPE, const char*, uint32_t);
+  // Write the output buffer if it is full, or whatever it holds if force
+  void FlushOutput (bool force);
   bool m_xml;      // True if xml format desired
+  bool m_binary;   // True if binary records are written instead of xml
+  std::string m_outputBuffer; // Pending output of file handles
   Time mobilitypollinterval;
   bool usingSockets;
   uint16_t mport;
   std::string outputfilename;
   bool OutputFileSet;
   bool ServerPortSet;
-  void DevTxTrace (std::string context,
+  void DevTxTrace (TraceContext context,
                    Ptr<const Packet> p,
                    Ptr<NetDevice> tx,
                    Ptr<NetDevice> rx,
                    Time txTime,
                    Time rxTime);
-  void WifiPhyTxBeginTrace (std::string context,
+  void WifiPhyTxBeginTrace (TraceContext context,
                             Ptr<const Packet> p);
-  void WifiPhyTxEndTrace (std::string context,
+  void WifiPhyTxEndTrace (TraceContext context,
                           Ptr<const Packet> p);
-  void WifiPhyTxDropTrace (std::string context,
+  void WifiPhyTxDropTrace (TraceContext context,
                            Ptr<const Packet> p);
-  void WifiPhyRxBeginTrace (std::string context,
+  void WifiPhyRxBeginTrace (TraceContext context,
                             Ptr<const Packet> p);
-  void WifiPhyRxEndTrace (std::string context,
+  void WifiPhyRxEndTrace (TraceContext context,
                           Ptr<const Packet> p);
-  void WifiMacRxTrace (std::string context,
+  void WifiMacRxTrace (TraceContext context,
                        Ptr<const Packet> p);
-  void WifiPhyRxDropTrace (std::string context,
+  void WifiPhyRxDropTrace (TraceContext context,
                            Ptr<const Packet> p);
-  void WimaxTxTrace (std::string context,
+  void WimaxTxTrace (TraceContext context,
                      Ptr<const Packet> p,
 		     const Mac48Address &);
-  void WimaxRxTrace (std::string context,
+  void WimaxRxTrace (TraceContext context,
                      Ptr<const Packet> p,
                      const Mac48Address &);
-  void CsmaPhyTxBeginTrace (std::string context,
+  void CsmaPhyTxBeginTrace (TraceContext context,
                             Ptr<const Packet> p);
-  void CsmaPhyTxEndTrace (std::string context,
+  void CsmaPhyTxEndTrace (TraceContext context,
                             Ptr<const Packet> p);
-  void CsmaPhyRxEndTrace (std::string context,
+  void CsmaPhyRxEndTrace (TraceContext context,
                           Ptr<const Packet> p);
-  void CsmaMacRxTrace (std::string context,
+  void CsmaMacRxTrace (TraceContext context,
                        Ptr<const Packet> p);
-  void MobilityCourseChangeTrace (Ptr <const MobilityModel> mob);
+  void MobilityCourseChangeTrace (TraceContext context,
+                                  Ptr <const MobilityModel> mob);
 
   // Write a string to the specified handle;
   int  WriteN (int, const std::string&);
 
+  // Write an element in the xml or binary format
+  void WriteTopologyOpen ();
+  void WriteTopologyClose ();
+  void WriteNode (uint32_t id, Vector v);
+  void WriteLink (uint32_t fromId, uint32_t toId);
+  void WritePacket (uint32_t fromId, double fbTx, double lbTx,
+                    uint32_t toId, double fbRx, double lbRx);
+  void WriteWirelessPacket (uint32_t fromId, double fbTx, double lbTx, double range,
+                            uint32_t toId, double fbRx, double lbRx);
+
   void OutputWirelessPacket (AnimPacketInfo& pktInfo, AnimRxInfo pktrxInfo);
   void OutputCsmaPacket (AnimPacketInfo& pktInfo, AnimRxInfo pktrxInfo);
   void MobilityAutoCheck ();
@@ -315,25 +370,24 @@ private:
   bool m_started;
 
   // Path helper
-  std::vector<std::string> GetElementsFromContext (std::string context);
-  Ptr <NetDevice> GetNetDeviceFromContext (std::string context);
+  Ptr <NetDevice> GetNetDeviceFromContext (TraceContext context);
 
   // XML helpers
-  std::string GetPreamble (void);
+  static std::string GetPreamble (void);
   // Topology element dimensions
   double topo_minX;
   double topo_minY;
   double topo_maxX;
   double topo_maxY;
 
-  std::string GetXMLOpen_anim (uint32_t lp);
-  std::string GetXMLOpen_topology (double minX,double minY,double maxX,double maxY);
-  std::string GetXMLOpenClose_node (uint32_t lp,uint32_t id,double locX,double locY);
-  std::string GetXMLOpenClose_link (uint32_t fromLp,uint32_t fromId, uint32_t toLp, uint32_t toId);
-  std::string GetXMLOpen_packet (uint32_t fromLp,uint32_t fromId, double fbTx, double lbTx, std::string auxInfo = "");
-  std::string GetXMLOpenClose_rx (uint32_t toLp, uint32_t toId, double fbRx, double lbRx);
-  std::string GetXMLOpen_wpacket (uint32_t fromLp,uint32_t fromId, double fbTx, double lbTx, double range);
-  std::string GetXMLClose (std::string name) {return "</" + name + ">\n"; }
+  static std::string GetXMLOpen_anim (uint32_t lp);
+  static std::string GetXMLOpen_topology (double minX,double minY,double maxX,double maxY);
+  static std::string GetXMLOpenClose_node (uint32_t lp,uint32_t id,double locX,double locY);
+  static std::string GetXMLOpenClose_link (uint32_t fromLp,uint32_t fromId, uint32_t toLp, uint32_t toId);
+  static std::string GetXMLOpen_packet (uint32_t fromLp,uint32_t fromId, double fbTx, double lbTx, std::string auxInfo = "");
+  static std::string GetXMLOpenClose_rx (uint32_t toLp, uint32_t toId, double fbRx, double lbRx);
+  static std::string GetXMLOpen_wpacket (uint32_t fromLp,uint32_t fromId, double fbTx, double lbTx, double range);
+  static std::string GetXMLClose (std::string name) {return "</" + name + ">\n"; }
 
 };
 
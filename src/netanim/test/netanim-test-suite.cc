@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/packet.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/csma-helper.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/waypoint-mobility-model.h"
+#include "ns3/animation-interface.h"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+namespace ns3 {
+
+static std::string
+ReadFile (std::string filename)
+{
+  std::ifstream is (filename.c_str (), std::ios::binary);
+  std::ostringstream os;
+  os << is.rdbuf ();
+  return os.str ();
+}
+
+class AnimationBinaryOutputTestCase : public TestCase
+{
+public:
+  AnimationBinaryOutputTestCase ();
+  virtual void DoRun (void);
+private:
+  void RunAnimation (std::string filename, bool binary);
+  static void Send (Ptr<NetDevice> device);
+};
+
+AnimationBinaryOutputTestCase::AnimationBinaryOutputTestCase ()
+  : TestCase ("Check that the binary animation converts to the xml animation")
+{
+}
+
+void
+AnimationBinaryOutputTestCase::Send (Ptr<NetDevice> device)
+{
+  device->Send (Create<Packet> (100), device->GetBroadcast (), 0x0800);
+}
+
+void
+AnimationBinaryOutputTestCase::RunAnimation (std::string filename, bool binary)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  CsmaHelper csma;
+  NetDeviceContainer devices = csma.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+
+  Ptr<ConstantPositionMobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+  position->SetPosition (Vector (0, 0, 0));
+  nodes.Get (0)->AggregateObject (position);
+  position = CreateObject<ConstantPositionMobilityModel> ();
+  position->SetPosition (Vector (10, 0, 0));
+  nodes.Get (1)->AggregateObject (position);
+
+  // A lazy model reports its course changes only when queried, so the
+  // animator has to poll this node although it starts stationary.
+  Ptr<WaypointMobilityModel> waypoints = CreateObject<WaypointMobilityModel> ();
+  waypoints->SetAttribute ("LazyNotify", BooleanValue (true));
+  waypoints->AddWaypoint (Waypoint (Seconds (0), Vector (0, 10, 0)));
+  waypoints->AddWaypoint (Waypoint (Seconds (1), Vector (0, 10, 0)));
+  waypoints->AddWaypoint (Waypoint (Seconds (3), Vector (50, 10, 0)));
+  nodes.Get (2)->AggregateObject (waypoints);
+
+  Simulator::Schedule (Seconds (0.5), &AnimationBinaryOutputTestCase::Send, devices.Get (0));
+  Simulator::Schedule (Seconds (2), &AnimationBinaryOutputTestCase::Send, devices.Get (1));
+
+  if (binary)
+    {
+      AnimationInterface::EnableBinaryOutput ();
+    }
+  AnimationInterface anim (filename);
+  AnimationInterface::DisableBinaryOutput ();
+  Simulator::Stop (Seconds (4));
+  Simulator::Run ();
+  anim.StopAnimation ();
+  Simulator::Destroy ();
+}
+
+void
+AnimationBinaryOutputTestCase::DoRun (void)
+{
+  std::string xmlFilename = CreateTempDirFilename ("netanim-test.xml");
+  std::string binaryFilename = CreateTempDirFilename ("netanim-test.bin");
+  RunAnimation (xmlFilename, false);
+  RunAnimation (binaryFilename, true);
+
+  std::string xml = ReadFile (xmlFilename);
+  std::ifstream is (binaryFilename.c_str (), std::ios::binary);
+  std::ostringstream converted;
+  bool ok = AnimationInterface::ConvertToXml (is, converted);
+  is.close ();
+  std::remove (xmlFilename.c_str ());
+  std::remove (binaryFilename.c_str ());
+
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Could not convert the binary animation");
+  NS_TEST_EXPECT_MSG_EQ (converted.str (), xml, "The converted animation differs from the xml animation");
+  NS_TEST_EXPECT_MSG_NE (xml.find ("<packet "), std::string::npos, "No packet in the animation");
+  NS_TEST_EXPECT_MSG_NE (xml.find ("<node lp = \"0\" id = \"2\" locX = \"50\" locY = \"10\" />"),
+                         std::string::npos, "The last position of the lazy node is missing");
+
+  std::istringstream bad ("not a binary animation");
+  std::ostringstream os;
+  ok = AnimationInterface::ConvertToXml (bad, os);
+  NS_TEST_EXPECT_MSG_EQ (ok, false, "Converted an invalid animation");
+}
+
+static class NetAnimTestSuite : public TestSuite
+{
+public:
+  NetAnimTestSuite ()
+    : TestSuite ("netanim", UNIT)
+  {
+    AddTestCase (new AnimationBinaryOutputTestCase ());
+  }
+} g_netAnimTestSuite;
+
+} // namespace ns3
@@ -35,6 +35,29 @@ NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
 namespace ns3 {
 
+/**
+ * Holds the pcapng file shared by all the pcap traces, if any, and
+ * closes it at the end of the program: the wrappers which write to it
+ * may never be destroyed.
+ */
+static class SharedPcapNgFile
+{
+public:
+  ~SharedPcapNgFile ()
+  {
+    Reset ();
+  }
+  void Reset (void)
+  {
+    if (m_file != 0)
+      {
+        m_file->Close ();
+        m_file = 0;
+      }
+  }
+  Ptr<PcapNgFile> m_file;
+} g_sharedPcapNgFile;
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -56,6 +79,18 @@ PcapHelper::CreateFile (
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  if (g_sharedPcapNgFile.m_file != 0)
+    {
+      std::string name = filename;
+      std::string::size_type dot = name.rfind (".pcap");
+      if (dot != std::string::npos && dot + 5 == name.size ())
+        {
+          name.erase (dot);
+        }
+      file->Init (g_sharedPcapNgFile.m_file, name, dataLinkType, snapLen);
+      NS_ABORT_MSG_IF (file->Fail (), "Unable to add interface " << name << " to the pcapng file");
+      return file;
+    }
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -76,6 +111,24 @@ PcapHelper::CreateFile (
   return file;
 }
 
+void
+PcapHelper::EnablePcapNg (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  g_sharedPcapNgFile.Reset ();
+  Ptr<PcapNgFile> file = Create<PcapNgFile> ();
+  file->Open (filename);
+  NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename);
+  g_sharedPcapNgFile.m_file = file;
+}
+
+void
+PcapHelper::DisablePcapNg (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_sharedPcapNgFile.Reset ();
+}
+
 std::string
 PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -180,11 +233,45 @@ AsciiTraceHelper::~AsciiTraceHelper ()
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+static bool g_asciiBinaryOutput = false;
+static bool g_asciiBinaryStorePackets = true;
+
+void
+AsciiTraceHelper::EnableBinaryOutput (bool storePackets)
+{
+  NS_LOG_FUNCTION (storePackets);
+  g_asciiBinaryOutput = true;
+  g_asciiBinaryStorePackets = storePackets;
+}
+
+void
+AsciiTraceHelper::DisableBinaryOutput (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_asciiBinaryOutput = false;
+}
+
+Ptr<OutputStreamWrapper>
+AsciiTraceHelper::CreateBinaryFileStream (std::string filename, bool storePackets)
+{
+  NS_LOG_FUNCTION (filename << storePackets);
+
+  Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> ();
+  file->Open (filename, storePackets);
+  NS_ABORT_MSG_IF (file->Fail (), "AsciiTraceHelper::CreateBinaryFileStream():  Unable to Open " << filename);
+  return Create<OutputStreamWrapper> (file);
+}
+
 Ptr<OutputStreamWrapper>
 AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode filemode)
 {
   NS_LOG_FUNCTION (filename << filemode);
 
+  if (g_asciiBinaryOutput)
+    {
+      return CreateBinaryFileStream (filename, g_asciiBinaryStorePackets);
+    }
+
   Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper> (filename, filemode);
 
   //
@@ -303,13 +390,31 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryTraceFile ();
+  if (binary != 0)
+    {
+      binary->Write (BinaryTraceFile::ENQUEUE, Simulator::Now (), p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
 void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
+{
+  DefaultEnqueueSinkWithTraceContext (stream, TraceContext (context), p);
+}
+
+void
+AsciiTraceHelper::DefaultEnqueueSinkWithTraceContext (Ptr<OutputStreamWrapper> stream, TraceContext context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryTraceFile ();
+  if (binary != 0)
+    {
+      binary->Write (BinaryTraceFile::ENQUEUE, Simulator::Now (), context, p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -329,13 +434,31 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryTraceFile ();
+  if (binary != 0)
+    {
+      binary->Write (BinaryTraceFile::DROP, Simulator::Now (), p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
 void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
+{
+  DefaultDropSinkWithTraceContext (stream, TraceContext (context), p);
+}
+
+void
+AsciiTraceHelper::DefaultDropSinkWithTraceContext (Ptr<OutputStreamWrapper> stream, TraceContext context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryTraceFile ();
+  if (binary != 0)
+    {
+      binary->Write (BinaryTraceFile::DROP, Simulator::Now (), context, p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -356,13 +479,31 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryTraceFile ();
+  if (binary != 0)
+    {
+      binary->Write (BinaryTraceFile::DEQUEUE, Simulator::Now (), p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
 void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
+{
+  DefaultDequeueSinkWithTraceContext (stream, TraceContext (context), p);
+}
+
+void
+AsciiTraceHelper::DefaultDequeueSinkWithTraceContext (Ptr<OutputStreamWrapper> stream, TraceContext context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryTraceFile ();
+  if (binary != 0)
+    {
+      binary->Write (BinaryTraceFile::DEQUEUE, Simulator::Now (), context, p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -380,13 +521,31 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryTraceFile ();
+  if (binary != 0)
+    {
+      binary->Write (BinaryTraceFile::RECEIVE, Simulator::Now (), p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
 void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
+{
+  DefaultReceiveSinkWithTraceContext (stream, TraceContext (context), p);
+}
+
+void
+AsciiTraceHelper::DefaultReceiveSinkWithTraceContext (Ptr<OutputStreamWrapper> stream, TraceContext context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryTraceFile ();
+  if (binary != 0)
+    {
+      binary->Write (BinaryTraceFile::RECEIVE, Simulator::Now (), context, p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
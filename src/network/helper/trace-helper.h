@@ -25,6 +25,7 @@
 #include "ns3/simulator.h"
 #include "ns3/pcap-file-wrapper.h"
 #include "ns3/output-stream-wrapper.h"
+#include "ns3/trace-context.h"
 
 namespace ns3 {
 
@@ -79,6 +80,11 @@ public:
 
   /**
    * @brief Create and initialize a pcap file.
+   *
+   * If EnablePcapNg has been called, the returned wrapper writes to a
+   * new interface of the shared pcapng file instead, named after the
+   * input filename without its extension; filemode and tzCorrection
+   * are then ignored.
    */
   Ptr<PcapFileWrapper> CreateFile (std::string filename, std::ios::openmode filemode,
                                    uint32_t dataLinkType,  uint32_t snapLen = 65535, int32_t tzCorrection = 0);
@@ -87,6 +93,24 @@ public:
    */
   template <typename T> void HookDefaultSink (Ptr<T> object, std::string traceName, Ptr<PcapFileWrapper> file);
 
+  /**
+   * @brief Write all the pcap traces enabled from now on to a single
+   * pcapng file, with one interface per traced device, rather than to
+   * one pcap file per device.
+   *
+   * This avoids opening thousands of files when tracing every device of
+   * a large topology.  The file is closed by DisablePcapNg or at the end
+   * of the program.
+   *
+   * @param filename the name of the pcapng file.
+   */
+  static void EnablePcapNg (std::string filename);
+  /**
+   * @brief Close the pcapng file opened by EnablePcapNg; the pcap traces
+   * enabled afterwards are written to one pcap file per device again.
+   */
+  static void DisablePcapNg (void);
+
 private:
   static void DefaultSink (Ptr<PcapFileWrapper> file, Ptr<const Packet> p);
 };
@@ -151,10 +175,41 @@ public:
    * run into object lifetime issues.  Ns-3 has a nice reference counted object
    * that can solve the problem so we use one of those to carry the stream
    * around and deal with the lifetime issues.
+   *
+   * If EnableBinaryOutput has been called, the stream is a binary trace
+   * file (see CreateBinaryFileStream) and filemode is ignored.
    */
   Ptr<OutputStreamWrapper> CreateFileStream (std::string filename, 
                                              std::ios::openmode filemode = std::ios::out);
 
+  /**
+   * @brief Create a stream which stores the traced events in a compact
+   * binary file rather than as text.
+   *
+   * The default trace sinks store their packet events as binary records;
+   * the text written by other trace sinks to the stream is stored in the
+   * same file.  BinaryTraceFile::ConvertToAscii, or the
+   * convert-binary-trace program, regenerates the text trace.
+   *
+   * @param filename the name of the file.
+   * @param storePackets whether the serialized packets are stored.  If
+   * not, the converted trace shows the uid and size of the packets
+   * instead of their headers.
+   */
+  Ptr<OutputStreamWrapper> CreateBinaryFileStream (std::string filename, bool storePackets = true);
+
+  /**
+   * @brief Make CreateFileStream create binary trace files, for all the
+   * ascii traces enabled from now on.
+   *
+   * @param storePackets whether the serialized packets are stored.
+   */
+  static void EnableBinaryOutput (bool storePackets = true);
+  /**
+   * @brief Make CreateFileStream create text files again, the default.
+   */
+  static void DisableBinaryOutput (void);
+
   /**
    * @brief Hook a trace source to the default enqueue operation trace sink that
    * does not accept nor log a trace context.
@@ -217,15 +272,19 @@ public:
 
   static void DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> file, Ptr<const Packet> p);
   static void DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> file, std::string context, Ptr<const Packet> p);
+  static void DefaultEnqueueSinkWithTraceContext (Ptr<OutputStreamWrapper> file, TraceContext context, Ptr<const Packet> p);
 
   static void DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> file, Ptr<const Packet> p);
   static void DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> file, std::string context, Ptr<const Packet> p);
+  static void DefaultDropSinkWithTraceContext (Ptr<OutputStreamWrapper> file, TraceContext context, Ptr<const Packet> p);
 
   static void DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> file, Ptr<const Packet> p);
   static void DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> file, std::string context, Ptr<const Packet> p);
+  static void DefaultDequeueSinkWithTraceContext (Ptr<OutputStreamWrapper> file, TraceContext context, Ptr<const Packet> p);
 
   static void DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> file, Ptr<const Packet> p);
   static void DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> file, std::string context, Ptr<const Packet> p);
+  static void DefaultReceiveSinkWithTraceContext (Ptr<OutputStreamWrapper> file, TraceContext context, Ptr<const Packet> p);
 };
 
 template <typename T> void
@@ -245,7 +304,7 @@ AsciiTraceHelper::HookDefaultEnqueueSinkWithContext (
   Ptr<OutputStreamWrapper> stream)
 {
   bool __attribute__ ((unused)) result = 
-    object->TraceConnect (tracename, context, MakeBoundCallback (&DefaultEnqueueSinkWithContext, stream));
+    object->TraceConnect (tracename, context, MakeBoundCallback (&DefaultEnqueueSinkWithTraceContext, stream));
   NS_ASSERT_MSG (result == true, "AsciiTraceHelper::HookDefaultEnqueueSinkWithContext():  Unable to hook \"" 
                  << tracename << "\"");
 }
@@ -267,7 +326,7 @@ AsciiTraceHelper::HookDefaultDropSinkWithContext (
   Ptr<OutputStreamWrapper> stream)
 {
   bool __attribute__ ((unused)) result = 
-    object->TraceConnect (tracename, context, MakeBoundCallback (&DefaultDropSinkWithContext, stream));
+    object->TraceConnect (tracename, context, MakeBoundCallback (&DefaultDropSinkWithTraceContext, stream));
   NS_ASSERT_MSG (result == true, "AsciiTraceHelper::HookDefaultDropSinkWithContext():  Unable to hook \"" 
                  << tracename << "\"");
 }
@@ -289,7 +348,7 @@ AsciiTraceHelper::HookDefaultDequeueSinkWithContext (
   Ptr<OutputStreamWrapper> stream)
 {
   bool __attribute__ ((unused)) result = 
-    object->TraceConnect (tracename, context, MakeBoundCallback (&DefaultDequeueSinkWithContext, stream));
+    object->TraceConnect (tracename, context, MakeBoundCallback (&DefaultDequeueSinkWithTraceContext, stream));
   NS_ASSERT_MSG (result == true, "AsciiTraceHelper::HookDefaultDequeueSinkWithContext():  Unable to hook \"" 
                  << tracename << "\"");
 }
@@ -311,7 +370,7 @@ AsciiTraceHelper::HookDefaultReceiveSinkWithContext (
   Ptr<OutputStreamWrapper> stream)
 {
   bool __attribute__ ((unused)) result = 
-    object->TraceConnect (tracename, context, MakeBoundCallback (&DefaultReceiveSinkWithContext, stream));
+    object->TraceConnect (tracename, context, MakeBoundCallback (&DefaultReceiveSinkWithTraceContext, stream));
   NS_ASSERT_MSG (result == true, "AsciiTraceHelper::HookDefaultReceiveSinkWithContext():  Unable to hook \"" 
                  << tracename << "\"");
 }
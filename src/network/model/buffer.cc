@@ -20,6 +20,8 @@
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include <cstring>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
@@ -721,6 +723,18 @@ Buffer::PeekData (void) const
   return m_data->m_data + m_start;
 }
 
+uint8_t const *
+Buffer::PeekBytes (uint32_t size, uint8_t *scratch) const
+{
+  NS_ASSERT (size <= GetSize ());
+  if (size <= m_zeroAreaStart - m_start || m_zeroAreaStart == m_zeroAreaEnd)
+    {
+      return m_data->m_data + m_start;
+    }
+  CopyData (scratch, size);
+  return scratch;
+}
+
 void
 Buffer::CopyData (std::ostream *os, uint32_t size) const
 {
@@ -1109,9 +1123,26 @@ Buffer::Iterator::ReadLsbtohU64 (void)
 void 
 Buffer::Iterator::Read (uint8_t *buffer, uint32_t size)
 {
-  for (uint32_t i = 0; i < size; i++)
+  NS_ASSERT_MSG (m_current >= m_dataStart &&
+                 m_current + size <= m_dataEnd,
+                 GetReadErrorMessage ());
+  // a span on one side of the zero area is copied at once.
+  if (m_current + size <= m_zeroStart)
     {
-      buffer[i] = ReadU8 ();
+      memcpy (buffer, &m_data[m_current], size);
+      m_current += size;
+    }
+  else if (m_current >= m_zeroEnd)
+    {
+      memcpy (buffer, &m_data[m_current - (m_zeroEnd - m_zeroStart)], size);
+      m_current += size;
+    }
+  else
+    {
+      for (uint32_t i = 0; i < size; i++)
+        {
+          buffer[i] = ReadU8 ();
+        }
     }
 }
 
@@ -1121,21 +1152,92 @@ Buffer::Iterator::CalculateIpChecksum (uint16_t size)
   return CalculateIpChecksum (size, 0);
 }
 
+/* Sum the bytes of a contiguous span as 16-bit words with the first
+ * byte of each word in the low half, as ReadU16 would read them.  A
+ * trailing odd byte is added as a low byte.  The words are loaded eight
+ * bytes at a time into a 64-bit accumulator which cannot overflow for
+ * the sizes of a Buffer.
+ */
+static uint16_t
+SumSpan (const uint8_t *data, uint32_t size)
+{
+  uint64_t sum = 0;
+  while (size >= 8)
+    {
+      uint64_t word;
+      memcpy (&word, data, 8);
+      sum += (word & 0xffffffff) + (word >> 32);
+      data += 8;
+      size -= 8;
+    }
+  while (size >= 2)
+    {
+      uint16_t word;
+      memcpy (&word, data, 2);
+      sum += word;
+      data += 2;
+      size -= 2;
+    }
+  if (size == 1)
+    {
+      // store the tail byte where a 16-bit load would have put it.
+      uint16_t word = 0;
+      memcpy (&word, data, 1);
+      sum += word;
+    }
+  while (sum >> 16)
+    {
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+  uint16_t folded = sum;
+  const uint16_t one = 1;
+  if (*reinterpret_cast<const uint8_t *> (&one) == 0)
+    {
+      // big-endian host: the ones' complement sum is byte-order
+      // independent (RFC 1071), only the final result is swapped.
+      folded = (folded >> 8) | (folded << 8);
+    }
+  return folded;
+}
+
 uint16_t
 Buffer::Iterator::CalculateIpChecksum (uint16_t size, uint32_t initialChecksum)
 {
-  /* see RFC 1071 to understand this code. */
-  uint32_t sum = initialChecksum;
-
-  for (int j = 0; j < size/2; j++)
-    sum += ReadU16 ();
-
-  if (size & 1)
-    sum += ReadU8 ();
+  /* see RFC 1071 to understand this code. The bytes are summed by
+   * contiguous spans: the data before the virtual zero area, which adds
+   * nothing to the sum, and the data after it. A span which starts at an
+   * odd offset from the start of the checksummed area has its words
+   * shifted by one byte so its partial sum is byte-swapped.
+   */
+  NS_ASSERT_MSG (m_current >= m_dataStart &&
+                 m_current + size <= m_dataEnd,
+                 GetReadErrorMessage ());
+  uint64_t sum = initialChecksum;
+  uint32_t start = m_current;
+  uint32_t end = m_current + size;
+  if (start < m_zeroStart)
+    {
+      uint32_t spanEnd = std::min (end, m_zeroStart);
+      sum += SumSpan (&m_data[start], spanEnd - start);
+    }
+  uint32_t afterZero = std::max (start, m_zeroEnd);
+  if (afterZero < end)
+    {
+      uint16_t partial = SumSpan (&m_data[afterZero - (m_zeroEnd - m_zeroStart)],
+                                  end - afterZero);
+      if ((afterZero - start) & 1)
+        {
+          partial = (partial >> 8) | (partial << 8);
+        }
+      sum += partial;
+    }
+  m_current = end;
 
   while (sum >> 16)
-    sum = (sum & 0xffff) + (sum >> 16);
-  return ~sum;
+    {
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+  return ~static_cast<uint16_t> (sum);
 }
 
 uint32_t 
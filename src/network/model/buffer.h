@@ -521,6 +521,18 @@ private:
 
   uint32_t CopyData (uint8_t *buffer, uint32_t size) const;
 
+  /**
+   * \param size the number of bytes to read from the start of the
+   *        buffer, not larger than the size of the buffer.
+   * \param scratch a byte buffer of at least \b size bytes.
+   * \returns a pointer to the first \b size bytes of the buffer: a
+   *          pointer to the internal byte buffer if these bytes are
+   *          contiguous, \b scratch, where they were copied, otherwise.
+   *
+   * Unlike PeekData, the buffer is never transformed.
+   */
+  uint8_t const *PeekBytes (uint32_t size, uint8_t *scratch) const;
+
   inline Buffer (Buffer const &o);
   Buffer &operator = (Buffer const &o);
   Buffer ();
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef HEADER_LAYOUT_H
+#define HEADER_LAYOUT_H
+
+#include <stdint.h>
+#include <string.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ * \brief A field of a serialized header, in network byte order
+ *
+ * The offset and the type of the field are template parameters, such
+ * that a header describes its fixed layout with a list of typedefs,
+ * e.g. Ipv4Header::Layout, and that reading or writing a field over
+ * the bytes of a header compiles to a few loads or stores:
+ * \code
+ * uint8_t scratch[Ipv4Header::Layout::SIZE];
+ * uint8_t const *bytes = packet->PeekBytes (Ipv4Header::Layout::SIZE, scratch);
+ * uint8_t protocol = Ipv4Header::Layout::Protocol::Read (bytes);
+ * \endcode
+ *
+ * \tparam OFFSET the offset of the field from the start of the header,
+ *         in bytes
+ * \tparam T the unsigned integer type of the field
+ */
+template <uint32_t OFFSET, typename T>
+struct HeaderField
+{
+  typedef T Type;
+  enum { START = OFFSET, END = OFFSET + sizeof (T) };
+
+  /**
+   * \param header the first byte of the header
+   * \returns the value of the field, in host order
+   */
+  static T Read (uint8_t const *header)
+  {
+    T value = 0;
+    for (uint32_t k = 0; k < sizeof (T); k++)
+      {
+        value = (value << 8) | header[OFFSET + k];
+      }
+    return value;
+  }
+  /**
+   * \param header the first byte of the header
+   * \param value the value of the field, in host order
+   */
+  static void Write (uint8_t *header, T value)
+  {
+    for (uint32_t k = sizeof (T); k > 0; k--)
+      {
+        header[OFFSET + k - 1] = value & 0xff;
+        value >>= 8;
+      }
+  }
+};
+
+/**
+ * \ingroup packet
+ * \brief A field of a serialized header, in least significant byte
+ * order
+ *
+ * The order of Buffer::Iterator::WriteHtolsbU16 and WriteU16, used by
+ * the fields of the 802.11 headers and by the checksums.
+ */
+template <uint32_t OFFSET, typename T>
+struct HeaderLsbField
+{
+  typedef T Type;
+  enum { START = OFFSET, END = OFFSET + sizeof (T) };
+
+  static T Read (uint8_t const *header)
+  {
+    T value = 0;
+    for (uint32_t k = sizeof (T); k > 0; k--)
+      {
+        value = (value << 8) | header[OFFSET + k - 1];
+      }
+    return value;
+  }
+  static void Write (uint8_t *header, T value)
+  {
+    for (uint32_t k = 0; k < sizeof (T); k++)
+      {
+        header[OFFSET + k] = value & 0xff;
+        value >>= 8;
+      }
+  }
+};
+
+/**
+ * \ingroup packet
+ * \brief A field of a serialized header which is copied as is, e.g. a
+ * MAC address
+ */
+template <uint32_t OFFSET, uint32_t SIZE>
+struct HeaderBytesField
+{
+  enum { START = OFFSET, END = OFFSET + SIZE };
+
+  /**
+   * \param header the first byte of the header
+   * \returns the first byte of the field, without copy.
+   */
+  static uint8_t const *Get (uint8_t const *header)
+  {
+    return header + OFFSET;
+  }
+  static void Read (uint8_t const *header, uint8_t *bytes)
+  {
+    memcpy (bytes, header + OFFSET, SIZE);
+  }
+  static void Write (uint8_t *header, uint8_t const *bytes)
+  {
+    memcpy (header + OFFSET, bytes, SIZE);
+  }
+};
+
+} // namespace ns3
+
+#endif /* HEADER_LAYOUT_H */
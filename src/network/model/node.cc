@@ -68,14 +68,18 @@ Node::GetTypeId (void)
 
 Node::Node()
   : m_id (0),
-    m_sid (0)
+    m_sid (0),
+    m_handlerSequence (1),
+    m_handlerGeneration (0)
 {
   Construct ();
 }
 
 Node::Node(uint32_t sid)
   : m_id (0),
-    m_sid (sid)
+    m_sid (sid),
+    m_handlerSequence (1),
+    m_handlerGeneration (0)
 { 
   Construct ();
 }
@@ -110,6 +114,7 @@ Node::AddDevice (Ptr<NetDevice> device)
   device->SetNode (this);
   device->SetIfIndex (index);
   device->SetReceiveCallback (MakeCallback (&Node::NonPromiscReceiveFromDevice, this));
+  InvalidateProtocolHandlerIndex ();
   Simulator::ScheduleWithContext (GetId (), Seconds (0.0), 
                                   &NetDevice::Start, device);
   NotifyDeviceAdded (device);
@@ -156,6 +161,7 @@ Node::DoDispose ()
 {
   m_deviceAdditionListeners.clear ();
   m_handlers.clear ();
+  m_handlerIndex.clear ();
   for (std::vector<Ptr<NetDevice> >::iterator i = m_devices.begin ();
        i != m_devices.end (); i++)
     {
@@ -204,6 +210,8 @@ Node::RegisterProtocolHandler (ProtocolHandler handler,
   entry.protocol = protocolType;
   entry.device = device;
   entry.promiscuous = promiscuous;
+  entry.sequence = m_handlerSequence++;
+  entry.dispatched = 0;
 
   // On demand enable promiscuous mode in netdevices
   if (promiscuous)
@@ -224,6 +232,7 @@ Node::RegisterProtocolHandler (ProtocolHandler handler,
     }
 
   m_handlers.push_back (entry);
+  InvalidateProtocolHandlerIndex ();
 }
 
 void
@@ -235,11 +244,71 @@ Node::UnregisterProtocolHandler (ProtocolHandler handler)
       if (i->handler.IsEqual (handler))
         {
           m_handlers.erase (i);
+          InvalidateProtocolHandlerIndex ();
           break;
         }
     }
 }
 
+uint64_t
+Node::GetNDispatchedFrames (ProtocolHandler handler) const
+{
+  for (ProtocolHandlerList::const_iterator i = m_handlers.begin ();
+       i != m_handlers.end (); i++)
+    {
+      if (i->handler.IsEqual (handler))
+        {
+          return i->dispatched;
+        }
+    }
+  return 0;
+}
+
+bool
+Node::ProtocolHandlerKey::operator < (const ProtocolHandlerKey &o) const
+{
+  if (device != o.device)
+    {
+      return device < o.device;
+    }
+  if (protocol != o.protocol)
+    {
+      return protocol < o.protocol;
+    }
+  return promiscuous < o.promiscuous;
+}
+
+void
+Node::InvalidateProtocolHandlerIndex (void)
+{
+  m_handlerIndex.clear ();
+  m_handlerGeneration++;
+}
+
+const std::vector<uint32_t> &
+Node::LookupProtocolHandlers (const ProtocolHandlerKey &key)
+{
+  ProtocolHandlerIndex::iterator found = m_handlerIndex.find (key);
+  if (found != m_handlerIndex.end ())
+    {
+      return found->second;
+    }
+  // The first frame with this key: collect the exact and the wildcard
+  // handlers in the order of their registration.
+  std::vector<uint32_t> &handlers = m_handlerIndex[key];
+  for (uint32_t j = 0; j < m_handlers.size (); j++)
+    {
+      const struct ProtocolHandlerEntry &entry = m_handlers[j];
+      if ((entry.device == 0 || PeekPointer (entry.device) == key.device)
+          && (entry.protocol == 0 || entry.protocol == key.protocol)
+          && entry.promiscuous == key.promiscuous)
+        {
+          handlers.push_back (j);
+        }
+    }
+  return handlers;
+}
+
 bool
 Node::ChecksumEnabled (void)
 {
@@ -275,22 +344,36 @@ Node::ReceiveFromDevice (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16
                         << device->GetIfIndex () << " (type=" << device->GetInstanceTypeId ().GetName ()
                         << ") Packet UID " << packet->GetUid ());
   bool found = false;
-
-  for (ProtocolHandlerList::iterator i = m_handlers.begin ();
-       i != m_handlers.end (); i++)
+  struct ProtocolHandlerKey key;
+  key.device = PeekPointer (device);
+  key.protocol = protocol;
+  key.promiscuous = promiscuous;
+  uint32_t generation = m_handlerGeneration;
+  const std::vector<uint32_t> *handlers = &LookupProtocolHandlers (key);
+  uint32_t lastSequence = 0;
+  uint32_t j = 0;
+  while (j < handlers->size ())
     {
-      if (i->device == 0 ||
-          (i->device != 0 && i->device == device))
+      struct ProtocolHandlerEntry &entry = m_handlers[(*handlers)[j]];
+      j++;
+      if (entry.sequence <= lastSequence)
         {
-          if (i->protocol == 0 || 
-              i->protocol == protocol)
-            {
-              if (promiscuous == i->promiscuous)
-                {
-                  i->handler (device, packet, protocol, from, to, packetType);
-                  found = true;
-                }
-            }
+          // already invoked before the handlers changed
+          continue;
+        }
+      lastSequence = entry.sequence;
+      entry.dispatched++;
+      // the handler may unregister itself.
+      ProtocolHandler handler = entry.handler;
+      handler (device, packet, protocol, from, to, packetType);
+      found = true;
+      if (generation != m_handlerGeneration)
+        {
+          // A handler was registered or unregistered: resume with the
+          // handlers registered after the one just invoked.
+          generation = m_handlerGeneration;
+          handlers = &LookupProtocolHandlers (key);
+          j = 0;
         }
     }
   return found;
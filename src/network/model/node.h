@@ -22,6 +22,7 @@
 #define NODE_H
 
 #include <vector>
+#include <map>
 
 #include "ns3/object.h"
 #include "ns3/callback.h"
@@ -171,6 +172,15 @@ public:
    * be invoked anymore.
    */
   void UnregisterProtocolHandler (ProtocolHandler handler);
+  /**
+   * \param handler a registered handler
+   * \returns the number of frames which were dispatched to this
+   *          handler since it was registered, or zero if it is
+   *          not registered.
+   *
+   * This counter is meant to profile the receive path of a node.
+   */
+  uint64_t GetNDispatchedFrames (ProtocolHandler handler) const;
 
   /**
    * A callback invoked whenever a device is added to a node.
@@ -223,8 +233,27 @@ private:
     Ptr<NetDevice> device;
     uint16_t protocol;
     bool promiscuous;
+    uint32_t sequence;   // registration order
+    uint64_t dispatched; // number of frames given to the handler
   };
   typedef std::vector<struct Node::ProtocolHandlerEntry> ProtocolHandlerList;
+  /**
+   * The key of the handlers which match a received frame.
+   */
+  struct ProtocolHandlerKey {
+    NetDevice *device;
+    uint16_t protocol;
+    bool promiscuous;
+    bool operator < (const ProtocolHandlerKey &o) const;
+  };
+  /**
+   * For each (device, protocol, promiscuous) key seen on receive, the
+   * indexes in m_handlers of the matching handlers, including the
+   * wildcard ones, in registration order.
+   */
+  typedef std::map<ProtocolHandlerKey, std::vector<uint32_t> > ProtocolHandlerIndex;
+  const std::vector<uint32_t> &LookupProtocolHandlers (const ProtocolHandlerKey &key);
+  void InvalidateProtocolHandlerIndex (void);
   typedef std::vector<DeviceAdditionListener> DeviceAdditionListenerList;
 
   uint32_t    m_id;         // Node id for this node
@@ -232,6 +261,9 @@ private:
   std::vector<Ptr<NetDevice> > m_devices;
   std::vector<Ptr<Application> > m_applications;
   ProtocolHandlerList m_handlers;
+  ProtocolHandlerIndex m_handlerIndex;
+  uint32_t m_handlerSequence;   // sequence number of the next handler
+  uint32_t m_handlerGeneration; // incremented when m_handlers changes
   DeviceAdditionListenerList m_deviceAdditionListeners;
 };
 
@@ -381,6 +381,12 @@ Packet::CopyData (uint8_t *buffer, uint32_t size) const
   return m_buffer.CopyData (buffer, size);
 }
 
+uint8_t const *
+Packet::PeekBytes (uint32_t size, uint8_t *scratch) const
+{
+  return m_buffer.PeekBytes (size, scratch);
+}
+
 void
 Packet::CopyData (std::ostream *os, uint32_t size) const
 {
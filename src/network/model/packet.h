@@ -357,6 +357,26 @@ public:
    */
   uint32_t CopyData (uint8_t *buffer, uint32_t size) const;
 
+  /**
+   * \param size the number of bytes to read from the start of the
+   *        packet.  It must not be larger than the size of the packet.
+   * \param scratch a byte buffer of at least \b size bytes.
+   * \returns a pointer to the first \b size bytes of the packet.
+   *
+   * The returned bytes are read in place if they are stored contiguously
+   * in the packet, which is the case of the headers added to a packet,
+   * and are otherwise copied in \b scratch.  Unlike PeekData, the packet
+   * is not modified: the pointer is valid until the packet is.  Together
+   * with the Layout of a header, this reads the fields of a header
+   * without deserializing it:
+   * \code
+   * uint8_t scratch[UdpHeader::Layout::SIZE];
+   * uint8_t const *bytes = packet->PeekBytes (UdpHeader::Layout::SIZE, scratch);
+   * uint16_t port = UdpHeader::Layout::DestinationPort::Read (bytes);
+   * \endcode
+   */
+  uint8_t const *PeekBytes (uint32_t size, uint8_t *scratch) const;
+
   /**
    * \param os pointer to output stream in which we want
    *        to write the packet data.
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/trace-helper.h"
+
+namespace ns3 {
+
+/**
+ * Feed the same events to a text stream and to a binary trace file
+ * through the default ascii trace sinks, and check that the converted
+ * binary trace matches the text.
+ */
+class BinaryTraceTestCase : public TestCase
+{
+public:
+  BinaryTraceTestCase (bool storePackets, uint32_t nEvents);
+  virtual void DoRun (void);
+
+private:
+  void Fire (Ptr<OutputStreamWrapper> stream, uint32_t i);
+  bool m_storePackets;
+  uint32_t m_nEvents;
+};
+
+BinaryTraceTestCase::BinaryTraceTestCase (bool storePackets, uint32_t nEvents)
+  : TestCase (storePackets ?
+              "Check that a binary trace converts to the text of the ascii trace sinks" :
+              "Check that a binary trace without packets converts to uids and sizes"),
+    m_storePackets (storePackets),
+    m_nEvents (nEvents)
+{
+}
+
+void
+BinaryTraceTestCase::Fire (Ptr<OutputStreamWrapper> stream, uint32_t i)
+{
+  Ptr<Packet> p = Create<Packet> (100 + i % 7);
+  LlcSnapHeader llc;
+  llc.SetType (0x0800);
+  p->AddHeader (llc);
+  TraceContext context ("/NodeList/3/DeviceList/1/TxQueue/Enqueue");
+  AsciiTraceHelper::DefaultEnqueueSinkWithTraceContext (stream, context, p);
+  AsciiTraceHelper::DefaultDequeueSinkWithoutContext (stream, p);
+  if (i % 10 == 0)
+    {
+      *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " a custom sink" << std::endl;
+    }
+  AsciiTraceHelper::DefaultDropSinkWithoutContext (stream, p);
+  // the std::string context sinks write the same records
+  AsciiTraceHelper::DefaultReceiveSinkWithContext (stream, "/NodeList/4/DeviceList/0/MacRx", p);
+}
+
+void
+BinaryTraceTestCase::DoRun (void)
+{
+  Packet::EnablePrinting ();
+  std::string filename = CreateTempDirFilename ("binary-trace-test.bin");
+  std::ostringstream text;
+  Ptr<OutputStreamWrapper> textStream = Create<OutputStreamWrapper> (&text);
+  Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> ();
+  file->Open (filename, m_storePackets);
+  Ptr<OutputStreamWrapper> binaryStream = Create<OutputStreamWrapper> (file);
+
+  for (uint32_t i = 0; i < m_nEvents; i++)
+    {
+      Time t = MicroSeconds (1250000 + 37 * i);
+      Simulator::Schedule (t, &BinaryTraceTestCase::Fire, this, textStream, i);
+      Simulator::Schedule (t, &BinaryTraceTestCase::Fire, this, binaryStream, i);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  *binaryStream->GetStream () << "trailing text" << std::endl;
+  file->Close ();
+  NS_TEST_ASSERT_MSG_EQ (file->Fail (), false, "Could not write " << filename);
+
+  std::ifstream is (filename.c_str (), std::ios::binary);
+  std::ostringstream converted;
+  bool ok = BinaryTraceFile::ConvertToAscii (is, converted);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Could not convert " << filename);
+
+  std::string expected = text.str () + "trailing text\n";
+  if (!m_storePackets)
+    {
+      // The converted trace shows the uid and size of each packet
+      // instead of its headers: check the first lines only.
+      std::istringstream lines (converted.str ());
+      std::string line;
+      std::getline (lines, line);
+      NS_TEST_EXPECT_MSG_EQ (line.substr (0, 51), "+ 1.25 /NodeList/3/DeviceList/1/TxQueue/Enqueue uid",
+                             "Unexpected converted line");
+      NS_TEST_EXPECT_MSG_EQ (line.substr (line.size () - 9), " size=108", "Unexpected converted line");
+      std::getline (lines, line);
+      NS_TEST_EXPECT_MSG_EQ (line.substr (0, 11), "- 1.25 uid=", "Unexpected converted line");
+      std::getline (lines, line);
+      NS_TEST_EXPECT_MSG_EQ (line, "t 1.25 a custom sink", "Unexpected converted line");
+    }
+  else
+    {
+      std::string actual = converted.str ();
+      NS_TEST_EXPECT_MSG_EQ (actual.size (), expected.size (), "Converted trace has the wrong size");
+      NS_TEST_EXPECT_MSG_EQ ((actual == expected), true, "Converted trace differs from the text trace");
+    }
+  std::remove (filename.c_str ());
+}
+
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ();
+};
+
+BinaryTraceTestSuite::BinaryTraceTestSuite ()
+  : TestSuite ("binary-trace", UNIT)
+{
+  AddTestCase (new BinaryTraceTestCase (true, 10));
+  AddTestCase (new BinaryTraceTestCase (true, 3000));
+  AddTestCase (new BinaryTraceTestCase (false, 10));
+}
+
+static BinaryTraceTestSuite binaryTraceTestSuite;
+
+} // namespace ns3
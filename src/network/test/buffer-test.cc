@@ -320,6 +320,95 @@ BufferTest::DoRun (void)
   free (cBuf);
 }
 //-----------------------------------------------------------------------------
+class BufferChecksumTest : public TestCase
+{
+public:
+  virtual void DoRun (void);
+  BufferChecksumTest ();
+private:
+  static uint16_t ReferenceChecksum (Buffer::Iterator i, uint16_t size, uint32_t initial);
+};
+
+BufferChecksumTest::BufferChecksumTest ()
+  : TestCase ("Check Buffer::Iterator::CalculateIpChecksum against a byte-wise sum")
+{
+}
+
+uint16_t
+BufferChecksumTest::ReferenceChecksum (Buffer::Iterator i, uint16_t size, uint32_t initial)
+{
+  uint32_t sum = initial;
+  for (int j = 0; j < size/2; j++)
+    {
+      sum += i.ReadU16 ();
+    }
+  if (size & 1)
+    {
+      sum += i.ReadU8 ();
+    }
+  while (sum >> 16)
+    {
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+  return ~sum;
+}
+
+void
+BufferChecksumTest::DoRun (void)
+{
+  UniformVariable random (0, 256);
+  // a buffer with 37 bytes of data, a zero area of 61 bytes and 45
+  // bytes of data, such that the spans start at every parity.
+  Buffer buffer (61);
+  buffer.AddAtStart (37);
+  buffer.AddAtEnd (45);
+  Buffer::Iterator i = buffer.Begin ();
+  for (uint32_t j = 0; j < 37; j++)
+    {
+      i.WriteU8 (random.GetInteger (0, 255));
+    }
+  i.Next (61);
+  for (uint32_t j = 0; j < 45; j++)
+    {
+      i.WriteU8 (random.GetInteger (0, 255));
+    }
+  uint32_t total = buffer.GetSize ();
+  for (uint32_t start = 0; start < total; start++)
+    {
+      for (uint32_t size = 0; start + size <= total; size++)
+        {
+          Buffer::Iterator a = buffer.Begin ();
+          a.Next (start);
+          Buffer::Iterator b = a;
+          uint32_t initial = (start * 7919 + size) & 0xfffff;
+          uint16_t got = a.CalculateIpChecksum (size, initial);
+          uint16_t expected = ReferenceChecksum (b, size, initial);
+          NS_TEST_ASSERT_MSG_EQ (got, expected, "checksum of " << size << " bytes at " << start);
+          uint32_t position = a.GetDistanceFrom (buffer.Begin ());
+          NS_TEST_ASSERT_MSG_EQ (position, start + size, "iterator not advanced");
+        }
+    }
+
+  // a buffer without zero area
+  Buffer plain;
+  plain.AddAtStart (1500);
+  i = plain.Begin ();
+  for (uint32_t j = 0; j < 1500; j++)
+    {
+      i.WriteU8 (random.GetInteger (0, 255));
+    }
+  for (uint32_t start = 0; start < 8; start++)
+    {
+      Buffer::Iterator a = plain.Begin ();
+      a.Next (start);
+      Buffer::Iterator b = a;
+      uint16_t size = 1500 - start;
+      uint16_t got = a.CalculateIpChecksum (size);
+      uint16_t expected = ReferenceChecksum (b, size, 0);
+      NS_TEST_ASSERT_MSG_EQ (got, expected, "checksum of " << size << " bytes at " << start);
+    }
+}
+//-----------------------------------------------------------------------------
 class BufferTestSuite : public TestSuite
 {
 public:
@@ -330,6 +419,7 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest);
+  AddTestCase (new BufferChecksumTest);
 }
 
 static BufferTestSuite g_bufferTestSuite;
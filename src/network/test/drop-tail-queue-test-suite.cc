@@ -18,7 +18,9 @@
 
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
+#include "ns3/packet-ring.h"
 #include "ns3/uinteger.h"
+#include "ns3/simulator.h"
 
 namespace ns3 {
 
@@ -77,6 +79,124 @@ DropTailQueueTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ ((p == 0), true, "There are really no packets in there");
 }
 
+class PacketRingTestCase : public TestCase
+{
+public:
+  PacketRingTestCase ();
+  virtual void DoRun (void);
+};
+
+PacketRingTestCase::PacketRingTestCase ()
+  : TestCase ("Check the order of the packets of a ring which wraps around and grows")
+{
+}
+void
+PacketRingTestCase::DoRun (void)
+{
+  PacketRing ring;
+  ring.Reserve (3);
+  NS_TEST_EXPECT_MSG_EQ (ring.GetCapacity (), 4, "The capacity is rounded up to a power of two");
+
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      packets.push_back (Create<Packet> (i));
+    }
+  // move the head of the ring before it wraps around and grows.
+  ring.PushBack (packets[0]);
+  ring.PushBack (packets[1]);
+  ring.PushBack (packets[2]);
+  NS_TEST_EXPECT_MSG_EQ (ring.PopFront (), packets[0], "First packet");
+  NS_TEST_EXPECT_MSG_EQ (ring.PopFront (), packets[1], "Second packet");
+  for (uint32_t i = 3; i < 10; i++)
+    {
+      ring.PushBack (packets[i]);
+    }
+  NS_TEST_EXPECT_MSG_EQ (ring.GetSize (), 8, "Eight packets are stored");
+  NS_TEST_EXPECT_MSG_EQ (ring.GetCapacity (), 8, "The ring doubled once");
+  for (uint32_t i = 2; i < 10; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (ring.Front (), packets[i], "Front packet");
+      NS_TEST_EXPECT_MSG_EQ (ring.PopFront (), packets[i], "Packets are stored in order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (ring.IsEmpty (), true, "All the packets were removed");
+  ring.PushBack (packets[0]);
+  ring.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (ring.GetSize (), 0, "The ring was cleared");
+  NS_TEST_EXPECT_MSG_EQ (ring.GetCapacity (), 8, "The capacity is kept");
+}
+
+class QueueStatisticsTestCase : public TestCase
+{
+public:
+  QueueStatisticsTestCase ();
+  virtual void DoRun (void);
+private:
+  void PacketsInQueue (uint32_t oldValue, uint32_t newValue);
+  void Enqueue (Ptr<Queue> queue, uint32_t n);
+  uint32_t m_packetsInQueue;
+};
+
+QueueStatisticsTestCase::QueueStatisticsTestCase ()
+  : TestCase ("Check the batch dequeue and the occupancy of a queue")
+{
+}
+void
+QueueStatisticsTestCase::PacketsInQueue (uint32_t oldValue, uint32_t newValue)
+{
+  m_packetsInQueue = newValue;
+}
+void
+QueueStatisticsTestCase::Enqueue (Ptr<Queue> queue, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      queue->Enqueue (Create<Packet> (100));
+    }
+}
+void
+QueueStatisticsTestCase::DoRun (void)
+{
+  m_packetsInQueue = 0;
+  Ptr<DropTailQueue> queue = CreateObject<DropTailQueue> ();
+  queue->SetAttribute ("MaxPackets", UintegerValue (10));
+  queue->TraceConnectWithoutContext ("PacketsInQueue",
+                                     MakeCallback (&QueueStatisticsTestCase::PacketsInQueue, this));
+  queue->EnableOccupancyHistogram (2);
+
+  // 0 packet during 1s, 3 packets during 2s, 1 packet during 4s and
+  // 0 packet during 1s.
+  Simulator::Schedule (Seconds (1), &QueueStatisticsTestCase::Enqueue, this, queue, 3);
+  Simulator::Schedule (Seconds (3), &Queue::Dequeue, queue);
+  Simulator::Schedule (Seconds (3), &Queue::Dequeue, queue);
+  Simulator::Schedule (Seconds (7), &Queue::Dequeue, queue);
+  Simulator::Stop (Seconds (8));
+  Simulator::Run ();
+
+  std::vector<Time> histogram = queue->GetOccupancyHistogram ();
+  NS_TEST_ASSERT_MSG_EQ (histogram.size (), 2, "Two bins of two packets were used");
+  NS_TEST_EXPECT_MSG_EQ (histogram[0], Seconds (6), "Time spent with 0 or 1 packet");
+  NS_TEST_EXPECT_MSG_EQ (histogram[1], Seconds (2), "Time spent with 2 or 3 packets");
+
+  Enqueue (queue, 5);
+  NS_TEST_EXPECT_MSG_EQ (m_packetsInQueue, 5, "PacketsInQueue follows the enqueued packets");
+  std::vector<Ptr<Packet> > packets;
+  uint32_t n = queue->DequeueBatch (3, packets);
+  NS_TEST_EXPECT_MSG_EQ (n, 3, "Three packets were removed");
+  NS_TEST_EXPECT_MSG_EQ (m_packetsInQueue, 2, "PacketsInQueue follows the dequeued packets");
+  n = queue->DequeueBatch (3, packets);
+  NS_TEST_EXPECT_MSG_EQ (n, 2, "The two last packets were removed");
+  NS_TEST_EXPECT_MSG_EQ (packets.size (), 5, "The packets were appended");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "The queue is empty");
+
+  queue->ResetStatistics ();
+  histogram = queue->GetOccupancyHistogram ();
+  NS_TEST_EXPECT_MSG_EQ (histogram.size (), 1, "The histogram was reset");
+  NS_TEST_EXPECT_MSG_EQ (histogram[0], Seconds (0), "The histogram was reset");
+
+  Simulator::Destroy ();
+}
+
 static class DropTailQueueTestSuite : public TestSuite
 {
 public:
@@ -84,6 +204,8 @@ public:
     : TestSuite ("drop-tail-queue", UNIT)
   {
     AddTestCase (new DropTailQueueTestCase ());
+    AddTestCase (new PacketRingTestCase ());
+    AddTestCase (new QueueStatisticsTestCase ());
   }
 } g_dropTailQueueTestSuite;
 
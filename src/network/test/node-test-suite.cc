@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/mac48-address.h"
+#include <string>
+
+namespace ns3 {
+
+// the names of the protocol handlers invoked for the last frame
+static std::string g_calls;
+
+static void
+NamedHandler (std::string name, Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+              const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  g_calls += name;
+}
+
+class NodeProtocolHandlerTestCase : public TestCase
+{
+public:
+  NodeProtocolHandlerTestCase ();
+private:
+  virtual void DoRun (void);
+  void SelfRemovingHandler (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                            const Address &from, const Address &to, NetDevice::PacketType packetType);
+  void Receive (Ptr<SimpleNetDevice> device, uint16_t protocol);
+
+  Ptr<Node> m_node;
+};
+
+NodeProtocolHandlerTestCase::NodeProtocolHandlerTestCase ()
+  : TestCase ("Check the order and the counters of the protocol handlers of a node")
+{
+}
+
+void
+NodeProtocolHandlerTestCase::SelfRemovingHandler (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                                  uint16_t protocol, const Address &from, const Address &to,
+                                                  NetDevice::PacketType packetType)
+{
+  g_calls += "x";
+  m_node->UnregisterProtocolHandler (MakeCallback (&NodeProtocolHandlerTestCase::SelfRemovingHandler, this));
+}
+
+void
+NodeProtocolHandlerTestCase::Receive (Ptr<SimpleNetDevice> device, uint16_t protocol)
+{
+  g_calls = "";
+  Simulator::ScheduleWithContext (m_node->GetId (), Seconds (0),
+                                  &SimpleNetDevice::Receive, device, Create<Packet> (10), protocol,
+                                  Mac48Address::GetBroadcast (), Mac48Address ("00:00:00:00:00:01"));
+  Simulator::Run ();
+}
+
+void
+NodeProtocolHandlerTestCase::DoRun (void)
+{
+  m_node = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> a = CreateObject<SimpleNetDevice> ();
+  a->SetAddress (Mac48Address::Allocate ());
+  m_node->AddDevice (a);
+  Ptr<SimpleNetDevice> b = CreateObject<SimpleNetDevice> ();
+  b->SetAddress (Mac48Address::Allocate ());
+  m_node->AddDevice (b);
+
+  // registration order mixes exact and wildcard handlers
+  Node::ProtocolHandler any = MakeBoundCallback (&NamedHandler, std::string ("1"));
+  m_node->RegisterProtocolHandler (any, 0, 0);
+  m_node->RegisterProtocolHandler (MakeBoundCallback (&NamedHandler, std::string ("2")),
+                                   0x800, a);
+  m_node->RegisterProtocolHandler (MakeBoundCallback (&NamedHandler, std::string ("3")),
+                                   0x800, 0);
+  m_node->RegisterProtocolHandler (MakeBoundCallback (&NamedHandler, std::string ("4")),
+                                   0, b);
+  m_node->RegisterProtocolHandler (MakeBoundCallback (&NamedHandler, std::string ("p")),
+                                   0, 0, true);
+
+  Receive (a, 0x800);
+  NS_TEST_EXPECT_MSG_EQ (g_calls, std::string ("123p"), "handlers of an IPv4 frame on device a");
+  Receive (b, 0x800);
+  NS_TEST_EXPECT_MSG_EQ (g_calls, std::string ("134p"), "handlers of an IPv4 frame on device b");
+  Receive (a, 0x806);
+  NS_TEST_EXPECT_MSG_EQ (g_calls, std::string ("1p"), "handlers of an ARP frame on device a");
+  Receive (a, 0x800);
+  NS_TEST_EXPECT_MSG_EQ (g_calls, std::string ("123p"), "handlers of an IPv4 frame on device a, from the index");
+  uint64_t count = m_node->GetNDispatchedFrames (any);
+  NS_TEST_EXPECT_MSG_EQ (count, 4, "frames dispatched to the wildcard handler");
+
+  // a handler which unregisters itself does not prevent the next ones
+  // from running, and is not called again.
+  m_node->UnregisterProtocolHandler (any);
+  count = m_node->GetNDispatchedFrames (any);
+  NS_TEST_EXPECT_MSG_EQ (count, 0, "unregistered handler");
+  m_node->RegisterProtocolHandler (MakeCallback (&NodeProtocolHandlerTestCase::SelfRemovingHandler, this),
+                                   0x800, 0);
+  m_node->RegisterProtocolHandler (any, 0x800, a);
+  Receive (a, 0x800);
+  NS_TEST_EXPECT_MSG_EQ (g_calls, std::string ("23x1p"), "handlers with a self removing one");
+  Receive (a, 0x800);
+  NS_TEST_EXPECT_MSG_EQ (g_calls, std::string ("231p"), "handlers after the self removing one");
+
+  m_node->Dispose ();
+  m_node = 0;
+  Simulator::Destroy ();
+}
+
+class NodeTestSuite : public TestSuite
+{
+public:
+  NodeTestSuite ();
+};
+
+NodeTestSuite::NodeTestSuite ()
+  : TestSuite ("node", UNIT)
+{
+  AddTestCase (new NodeProtocolHandlerTestCase);
+}
+
+static NodeTestSuite g_nodeTestSuite;
+
+} // namespace ns3
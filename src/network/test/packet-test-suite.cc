@@ -18,9 +18,12 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "ns3/packet.h"
+#include "ns3/header-layout.h"
+#include "ns3/ethernet-header.h"
 #include "ns3/test.h"
 #include <string>
 #include <stdarg.h>
+#include <string.h>
 
 namespace ns3 {
 
@@ -436,6 +439,104 @@ PacketTest::DoRun (void)
   }
 }
 //-----------------------------------------------------------------------------
+class PacketPeekBytesTest : public TestCase
+{
+public:
+  PacketPeekBytesTest ();
+  virtual void DoRun (void);
+};
+
+PacketPeekBytesTest::PacketPeekBytesTest ()
+  : TestCase ("Check Packet::PeekBytes and the header fields")
+{
+}
+
+void
+PacketPeekBytesTest::DoRun (void)
+{
+  // 4 header bytes, 10 zero bytes, 3 trailer bytes.
+  Ptr<Packet> p = Create<Packet> (10);
+  p->AddHeader (ATestHeader<4> ());
+  p->AddTrailer (ATestTrailer<3> ());
+  uint8_t expected[17];
+  p->CopyData (expected, 17);
+
+  uint8_t scratch[17];
+  uint8_t const *bytes = p->PeekBytes (4, scratch);
+  NS_TEST_EXPECT_MSG_EQ ((bytes != scratch), true, "The header bytes are read in place");
+  NS_TEST_EXPECT_MSG_EQ ((memcmp (bytes, expected, 4) == 0), true, "The header bytes");
+  bytes = p->PeekBytes (17, scratch);
+  NS_TEST_EXPECT_MSG_EQ ((bytes == scratch), true, "The zero bytes are copied");
+  NS_TEST_EXPECT_MSG_EQ ((memcmp (bytes, expected, 17) == 0), true, "All the bytes");
+
+  // the bytes after the zero area are read at once as well.
+  Buffer buffer (10);
+  buffer.AddAtEnd (3);
+  Buffer::Iterator i = buffer.End ();
+  i.Prev (3);
+  i.Write (expected + 14, 3);
+  uint8_t read[3];
+  i = buffer.Begin ();
+  i.Next (10);
+  i.Read (read, 3);
+  NS_TEST_EXPECT_MSG_EQ ((memcmp (read, expected + 14, 3) == 0), true, "The bytes after the zero area");
+  NS_TEST_EXPECT_MSG_EQ (i.IsEnd (), true, "The iterator moved past the bytes read");
+
+  uint8_t header[8];
+  HeaderField<0, uint16_t>::Write (header, 0x0102);
+  HeaderField<2, uint32_t>::Write (header, 0x03040506);
+  HeaderLsbField<6, uint16_t>::Write (header, 0x0807);
+  for (uint32_t j = 0; j < 8; j++)
+    {
+      uint32_t byte = header[j];
+      NS_TEST_EXPECT_MSG_EQ (byte, j + 1, "Byte " << j);
+    }
+  NS_TEST_EXPECT_MSG_EQ ((HeaderField<2, uint32_t>::Read (header)), 0x03040506, "Network order");
+  NS_TEST_EXPECT_MSG_EQ ((HeaderLsbField<6, uint16_t>::Read (header)), 0x0807, "Least significant byte order");
+  uint32_t byte = HeaderField<1, uint8_t>::Read (header);
+  NS_TEST_EXPECT_MSG_EQ (byte, 2, "One byte");
+}
+//-----------------------------------------------------------------------------
+class EthernetHeaderLayoutTest : public TestCase
+{
+public:
+  EthernetHeaderLayoutTest ();
+  virtual void DoRun (void);
+};
+
+EthernetHeaderLayoutTest::EthernetHeaderLayoutTest ()
+  : TestCase ("Check the EthernetHeader fields read without deserialization")
+{
+}
+
+void
+EthernetHeaderLayoutTest::DoRun (void)
+{
+  EthernetHeader header (false);
+  header.SetDestination (Mac48Address ("00:11:22:33:44:55"));
+  header.SetSource (Mac48Address ("66:77:88:99:aa:bb"));
+  header.SetLengthType (0x86dd);
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddHeader (header);
+
+  uint8_t scratch[EthernetHeader::Layout::SIZE];
+  uint8_t const *bytes = p->PeekBytes (EthernetHeader::Layout::SIZE, scratch);
+  Mac48Address destination;
+  destination.CopyFrom (EthernetHeader::Layout::Destination::Get (bytes));
+  Mac48Address source;
+  source.CopyFrom (EthernetHeader::Layout::Source::Get (bytes));
+  uint32_t lengthType = EthernetHeader::Layout::LengthType::Read (bytes);
+  NS_TEST_EXPECT_MSG_EQ (destination, Mac48Address ("00:11:22:33:44:55"), "destination");
+  NS_TEST_EXPECT_MSG_EQ (source, Mac48Address ("66:77:88:99:aa:bb"), "source");
+  NS_TEST_EXPECT_MSG_EQ (lengthType, 0x86dd, "length or type");
+
+  EthernetHeader deserialized (false);
+  p->PeekHeader (deserialized);
+  NS_TEST_EXPECT_MSG_EQ (destination, deserialized.GetDestination (), "deserialized destination");
+  NS_TEST_EXPECT_MSG_EQ (source, deserialized.GetSource (), "deserialized source");
+  NS_TEST_EXPECT_MSG_EQ (lengthType, deserialized.GetLengthType (), "deserialized length or type");
+}
+//-----------------------------------------------------------------------------
 class PacketTestSuite : public TestSuite
 {
 public:
@@ -446,6 +547,8 @@ PacketTestSuite::PacketTestSuite ()
   : TestSuite ("packet", UNIT)
 {
   AddTestCase (new PacketTest);
+  AddTestCase (new PacketPeekBytesTest);
+  AddTestCase (new EthernetHeaderLayoutTest);
 }
 
 static PacketTestSuite g_packetTestSuite;
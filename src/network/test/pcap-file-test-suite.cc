@@ -21,9 +21,11 @@
 #include <stdlib.h>
 #include <sstream>
 #include <cstring>
+#include <vector>
 
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/pcapng-file.h"
 
 using namespace ns3;
 
@@ -1101,6 +1103,107 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that a pcapng file multiplexes the packets of
+// several interfaces, truncated to the snap length of their interface.
+// ===========================================================================
+class PcapNgTestCase : public TestCase
+{
+public:
+  PcapNgTestCase ();
+
+private:
+  virtual void DoRun (void);
+  uint32_t ReadUint32 (uint32_t offset);
+  std::vector<uint8_t> m_data;
+};
+
+PcapNgTestCase::PcapNgTestCase ()
+  : TestCase ("Check to see that PcapNgFile writes interfaces and packets blocks")
+{
+}
+
+uint32_t
+PcapNgTestCase::ReadUint32 (uint32_t offset)
+{
+  uint32_t value;
+  memcpy (&value, &m_data[offset], sizeof (value));
+  return value;
+}
+
+void
+PcapNgTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("pcapng-test.pcapng");
+  PcapNgFile f;
+  f.Open (filename);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ") returns error");
+
+  uint32_t first = f.AddInterface ("first", 1, 100);
+  uint32_t second = f.AddInterface ("node-1", 9, 10);
+  NS_TEST_ASSERT_MSG_EQ (first, 0, "Unexpected interface identifier");
+  NS_TEST_ASSERT_MSG_EQ (second, 1, "Unexpected interface identifier");
+
+  uint8_t buffer[64];
+  for (uint32_t i = 0; i < sizeof (buffer); i++)
+    {
+      buffer[i] = i;
+    }
+  f.Write (second, 1234567890123ULL, buffer, 13);
+  f.Write (first, 5, buffer, 3);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Write returns error");
+  f.Close ();
+
+  FILE *p = fopen (filename.c_str (), "rb");
+  NS_TEST_ASSERT_MSG_NE (p, 0, "Cannot read " << filename);
+  uint8_t byte;
+  while (fread (&byte, 1, 1, p) == 1)
+    {
+      m_data.push_back (byte);
+    }
+  fclose (p);
+  remove (filename.c_str ());
+
+  //
+  // Section header: 28 bytes.  Interface descriptions: 16 bytes, the
+  // padded if_name and if_tsresol options, the end of options and the
+  // trailing length.
+  //
+  uint32_t firstLength = 16 + 4 + 8 + 8 + 4 + 4;
+  uint32_t secondLength = 16 + 4 + 8 + 8 + 4 + 4;
+  uint32_t packetsOffset = 28 + firstLength + secondLength;
+  NS_TEST_ASSERT_MSG_EQ (m_data.size (), packetsOffset + (32 + 12) + (32 + 4), "Unexpected file size");
+
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (0), 0x0a0d0d0a, "Expected a section header block");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (8), 0x1a2b3c4d, "Expected the byte order magic");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (28), 1, "Expected an interface description block");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (28 + 4), firstLength, "Unexpected block length");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (28 + 12), 100, "Unexpected snap length");
+  NS_TEST_EXPECT_MSG_EQ (std::string ((const char *)&m_data[28 + 20], 5), "first", "Unexpected interface name");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (28 + firstLength + 12), 10, "Unexpected snap length");
+
+  //
+  // The first packet is truncated to the 10 bytes of the snap length of
+  // its interface.
+  //
+  uint32_t offset = packetsOffset;
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (offset), 6, "Expected an enhanced packet block");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (offset + 4), 44, "Unexpected block length");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (offset + 8), 1, "Unexpected interface");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (offset + 12), 287, "Unexpected timestamp (high)");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (offset + 16), 1912276171, "Unexpected timestamp (low)");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (offset + 20), 10, "Unexpected captured length");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (offset + 24), 13, "Unexpected original length");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)m_data[offset + 28 + 9], 9, "Unexpected packet data");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)m_data[offset + 28 + 10], 0, "Expected padding");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (offset + 40), 44, "Unexpected trailing block length");
+
+  offset += 44;
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (offset + 8), 0, "Unexpected interface");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (offset + 20), 3, "Unexpected captured length");
+  NS_TEST_EXPECT_MSG_EQ (ReadUint32 (offset + 32), 36, "Unexpected trailing block length");
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1118,6 +1221,7 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase);
   AddTestCase (new ReadFileTestCase);
   AddTestCase (new DiffTestCase);
+  AddTestCase (new PcapNgTestCase);
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
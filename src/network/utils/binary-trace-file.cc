@@ -0,0 +1,627 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <vector>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/network-config.h"
+#include "binary-trace-file.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+//
+// The file starts with an 8 byte magic and a 32 bit version number,
+// followed by blocks.  Each block is made of a one byte type, a one byte
+// compression method, the 32 bit size of its decompressed data and the
+// 32 bit size of its stored data.  All the integers are little endian.
+//
+// A block of contexts holds a count, then the length and bytes of each
+// new context path.  Contexts are numbered from 1 in their order in the
+// file; 0 stands for no context.
+//
+// A block of events holds the number of events and a flags byte, then
+// the columns: the kind of every event, then, for the packet events,
+// the time deltas, the context ids, the uid deltas, the sizes and, if
+// the packets are stored, their serialized sizes followed by their
+// bytes; and finally, for the text events, their sizes followed by
+// their bytes.  The deltas are zigzag-encoded; all the integers of the
+// columns are variable-length.
+//
+
+namespace ns3 {
+
+static const char BINARY_TRACE_MAGIC[8] = { 'N', 'S', '3', 'T', 'R', 'A', 'C', 'E' };
+static const uint32_t BINARY_TRACE_VERSION = 1;
+
+static const uint8_t BLOCK_CONTEXTS = 1;
+static const uint8_t BLOCK_EVENTS = 2;
+static const uint8_t COMPRESSION_NONE = 0;
+static const uint8_t COMPRESSION_ZLIB = 1;
+static const uint8_t EVENT_TEXT = 0;
+static const uint8_t FLAG_PACKETS = 1;
+
+static const uint32_t MAX_BLOCK_EVENTS = 4096;
+static const uint32_t MAX_BLOCK_BYTES = 1 << 20;
+
+static void
+AppendUint32 (std::string &s, uint32_t v)
+{
+  char bytes[4] = { char (v & 0xff), char ((v >> 8) & 0xff), char ((v >> 16) & 0xff), char ((v >> 24) & 0xff) };
+  s.append (bytes, 4);
+}
+
+static void
+AppendVarint (std::string &s, uint64_t v)
+{
+  while (v >= 0x80)
+    {
+      s.push_back (char ((v & 0x7f) | 0x80));
+      v >>= 7;
+    }
+  s.push_back (char (v));
+}
+
+static uint64_t
+ZigZag (int64_t v)
+{
+  return (uint64_t (v) << 1) ^ uint64_t (v >> 63);
+}
+
+static int64_t
+UnZigZag (uint64_t v)
+{
+  return int64_t (v >> 1) ^ -int64_t (v & 1);
+}
+
+BinaryTraceFile::TextBuffer::int_type
+BinaryTraceFile::TextBuffer::overflow (int_type c)
+{
+  if (c != traits_type::eof ())
+    {
+      m_text.push_back (traits_type::to_char_type (c));
+    }
+  return traits_type::not_eof (c);
+}
+
+std::streamsize
+BinaryTraceFile::TextBuffer::xsputn (const char *s, std::streamsize n)
+{
+  m_text.append (s, n);
+  return n;
+}
+
+BinaryTraceFile::FlushBuffer::FlushBuffer (BinaryTraceFile *file)
+  : m_file (file)
+{
+}
+
+int
+BinaryTraceFile::FlushBuffer::sync (void)
+{
+  m_file->Flush ();
+  return 0;
+}
+
+BinaryTraceFile::BinaryTraceFile ()
+  : m_storePackets (true),
+    m_textStream (&m_textBuffer),
+    m_flushBuffer (this),
+    m_flushStream (&m_flushBuffer),
+    m_nNewContexts (0),
+    m_nEvents (0),
+    m_lastTime (0),
+    m_lastUid (0)
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::RegisterStream (&m_flushStream);
+}
+
+BinaryTraceFile::~BinaryTraceFile ()
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::UnregisterStream (&m_flushStream);
+  Close ();
+}
+
+void
+BinaryTraceFile::Open (std::string const &filename, bool storePackets)
+{
+  NS_LOG_FUNCTION (this << filename << storePackets);
+  NS_ASSERT (!m_file.is_open ());
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary);
+  m_storePackets = storePackets;
+  m_contexts.clear ();
+  std::string header (BINARY_TRACE_MAGIC, sizeof (BINARY_TRACE_MAGIC));
+  AppendUint32 (header, BINARY_TRACE_VERSION);
+  m_file.write (header.data (), header.size ());
+}
+
+void
+BinaryTraceFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file.is_open ())
+    {
+      Flush ();
+      m_file.close ();
+    }
+}
+
+bool
+BinaryTraceFile::Fail (void) const
+{
+  return m_file.fail ();
+}
+
+std::ostream *
+BinaryTraceFile::GetTextStream (void)
+{
+  return &m_textStream;
+}
+
+void
+BinaryTraceFile::Write (enum Event event, Time now, Ptr<const Packet> p)
+{
+  DoWrite (event, now, 0, p);
+}
+
+void
+BinaryTraceFile::Write (enum Event event, Time now, TraceContext context, Ptr<const Packet> p)
+{
+  const std::string *path = &context.GetPath ();
+  std::map<const std::string *, uint32_t>::const_iterator i = m_contexts.find (path);
+  uint32_t id;
+  if (i != m_contexts.end ())
+    {
+      id = i->second;
+    }
+  else
+    {
+      id = m_contexts.size () + 1;
+      m_contexts[path] = id;
+      AppendVarint (m_newContexts, path->size ());
+      m_newContexts.append (*path);
+      m_nNewContexts++;
+    }
+  DoWrite (event, now, id, p);
+}
+
+void
+BinaryTraceFile::DoWrite (enum Event event, Time now, uint32_t context, Ptr<const Packet> p)
+{
+  WriteText ();
+  int64_t time = now.GetNanoSeconds ();
+  uint64_t uid = p->GetUid ();
+  m_kinds.push_back (char (event));
+  AppendVarint (m_times, ZigZag (time - m_lastTime));
+  AppendVarint (m_contextIds, context);
+  AppendVarint (m_uids, ZigZag (int64_t (uid - m_lastUid)));
+  AppendVarint (m_sizes, p->GetSize ());
+  m_lastTime = time;
+  m_lastUid = uid;
+  if (m_storePackets)
+    {
+      uint32_t size = p->GetSerializedSize ();
+      // Packet::Serialize writes 32 bit words.
+      std::vector<uint32_t> buffer ((size + 3) / 4);
+      uint32_t serialized = p->Serialize (reinterpret_cast<uint8_t *> (&buffer[0]), buffer.size () * 4);
+      NS_ASSERT (serialized != 0);
+      AppendVarint (m_packetSizes, size);
+      m_packets.append (reinterpret_cast<const char *> (&buffer[0]), size);
+    }
+  m_nEvents++;
+  if (m_nEvents >= MAX_BLOCK_EVENTS || m_packets.size () + m_texts.size () >= MAX_BLOCK_BYTES)
+    {
+      WriteEvents ();
+    }
+}
+
+void
+BinaryTraceFile::WriteText (void)
+{
+  std::string &text = m_textBuffer.m_text;
+  if (text.empty ())
+    {
+      return;
+    }
+  m_kinds.push_back (char (EVENT_TEXT));
+  AppendVarint (m_textSizes, text.size ());
+  m_texts.append (text);
+  text.clear ();
+  m_nEvents++;
+  if (m_nEvents >= MAX_BLOCK_EVENTS || m_packets.size () + m_texts.size () >= MAX_BLOCK_BYTES)
+    {
+      WriteEvents ();
+    }
+}
+
+void
+BinaryTraceFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_file.is_open ())
+    {
+      return;
+    }
+  WriteText ();
+  WriteEvents ();
+  m_file.flush ();
+}
+
+void
+BinaryTraceFile::WriteBlock (uint8_t type, const std::string &data)
+{
+  uint8_t compression = COMPRESSION_NONE;
+  const char *stored = data.data ();
+  uint32_t storedSize = data.size ();
+#ifdef HAVE_ZLIB
+  uLongf compressedSize = compressBound (data.size ());
+  std::vector<Bytef> compressed (compressedSize);
+  if (compress2 (&compressed[0], &compressedSize, reinterpret_cast<const Bytef *> (data.data ()),
+                 data.size (), Z_BEST_SPEED) == Z_OK
+      && compressedSize < data.size ())
+    {
+      compression = COMPRESSION_ZLIB;
+      stored = reinterpret_cast<const char *> (&compressed[0]);
+      storedSize = compressedSize;
+    }
+#endif
+  std::string header;
+  header.push_back (char (type));
+  header.push_back (char (compression));
+  AppendUint32 (header, data.size ());
+  AppendUint32 (header, storedSize);
+  m_file.write (header.data (), header.size ());
+  m_file.write (stored, storedSize);
+}
+
+void
+BinaryTraceFile::WriteContexts (void)
+{
+  if (m_nNewContexts == 0)
+    {
+      return;
+    }
+  std::string data;
+  AppendVarint (data, m_nNewContexts);
+  data.append (m_newContexts);
+  WriteBlock (BLOCK_CONTEXTS, data);
+  m_newContexts.clear ();
+  m_nNewContexts = 0;
+}
+
+void
+BinaryTraceFile::WriteEvents (void)
+{
+  if (m_nEvents == 0)
+    {
+      return;
+    }
+  // The contexts used by the events must be known before the events
+  // are read.
+  WriteContexts ();
+  std::string data;
+  AppendVarint (data, m_nEvents);
+  data.push_back (char (m_storePackets ? FLAG_PACKETS : 0));
+  data.append (m_kinds);
+  data.append (m_times);
+  data.append (m_contextIds);
+  data.append (m_uids);
+  data.append (m_sizes);
+  data.append (m_packetSizes);
+  data.append (m_packets);
+  data.append (m_textSizes);
+  data.append (m_texts);
+  WriteBlock (BLOCK_EVENTS, data);
+
+  m_nEvents = 0;
+  m_kinds.clear ();
+  m_times.clear ();
+  m_contextIds.clear ();
+  m_uids.clear ();
+  m_sizes.clear ();
+  m_packetSizes.clear ();
+  m_packets.clear ();
+  m_textSizes.clear ();
+  m_texts.clear ();
+  m_lastTime = 0;
+  m_lastUid = 0;
+}
+
+namespace {
+
+/**
+ * Reads the integers and bytes of the columns of a decompressed block.
+ */
+class ColumnReader
+{
+public:
+  ColumnReader (const std::string &data, uint32_t start = 0)
+    : m_data (data), m_current (start), m_ok (true) {}
+  uint64_t ReadVarint (void)
+  {
+    uint64_t v = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+      {
+        if (m_current >= m_data.size ())
+          {
+            m_ok = false;
+            return 0;
+          }
+        uint8_t byte = m_data[m_current++];
+        v |= uint64_t (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+          {
+            return v;
+          }
+      }
+    m_ok = false;
+    return 0;
+  }
+  uint8_t ReadU8 (void)
+  {
+    if (m_current >= m_data.size ())
+      {
+        m_ok = false;
+        return 0;
+      }
+    return m_data[m_current++];
+  }
+  const char *ReadBytes (uint64_t size)
+  {
+    if (size > m_data.size () - m_current)
+      {
+        m_ok = false;
+        return 0;
+      }
+    const char *bytes = m_data.data () + m_current;
+    m_current += size;
+    return bytes;
+  }
+  void Skip (uint64_t size)
+  {
+    ReadBytes (size);
+  }
+  uint32_t GetCurrent (void) const
+  {
+    return m_current;
+  }
+  bool IsOk (void) const
+  {
+    return m_ok;
+  }
+private:
+  const std::string &m_data;
+  uint32_t m_current;
+  bool m_ok;
+};
+
+bool
+ReadUint32 (std::istream &is, uint32_t *v)
+{
+  uint8_t bytes[4];
+  if (!is.read (reinterpret_cast<char *> (bytes), 4))
+    {
+      return false;
+    }
+  *v = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (uint32_t (bytes[3]) << 24);
+  return true;
+}
+
+bool
+ReadBlock (std::istream &is, uint8_t *type, std::string *data)
+{
+  char header[2];
+  uint32_t rawSize;
+  uint32_t storedSize;
+  if (!is.read (header, 2) || !ReadUint32 (is, &rawSize) || !ReadUint32 (is, &storedSize))
+    {
+      return false;
+    }
+  *type = header[0];
+  std::string stored (storedSize, '\0');
+  if (storedSize != 0 && !is.read (&stored[0], storedSize))
+    {
+      return false;
+    }
+  if (header[1] == COMPRESSION_NONE)
+    {
+      *data = stored;
+      return rawSize == storedSize;
+    }
+#ifdef HAVE_ZLIB
+  if (header[1] == COMPRESSION_ZLIB)
+    {
+      data->resize (rawSize);
+      uLongf size = rawSize;
+      return uncompress (reinterpret_cast<Bytef *> (&(*data)[0]), &size,
+                         reinterpret_cast<const Bytef *> (stored.data ()), storedSize) == Z_OK
+             && size == rawSize;
+    }
+#endif
+  NS_LOG_WARN ("Unsupported compression method " << uint32_t (header[1]));
+  return false;
+}
+
+bool
+ConvertEvents (const std::string &data, const std::vector<std::string> &contexts, std::ostream &os)
+{
+  ColumnReader header (data);
+  uint32_t nEvents = header.ReadVarint ();
+  bool packets = (header.ReadU8 () & FLAG_PACKETS) != 0;
+  const char *kinds = header.ReadBytes (nEvents);
+  if (!header.IsOk ())
+    {
+      return false;
+    }
+  uint32_t nPackets = 0;
+  for (uint32_t i = 0; i < nEvents; i++)
+    {
+      nPackets += kinds[i] != EVENT_TEXT;
+    }
+
+  //
+  // Find the start of each column, then read them side by side.
+  //
+  ColumnReader times (data, header.GetCurrent ());
+  ColumnReader scan (data, header.GetCurrent ());
+  for (uint32_t i = 0; i < nPackets; i++)
+    {
+      scan.ReadVarint ();
+    }
+  ColumnReader contextIds (data, scan.GetCurrent ());
+  for (uint32_t i = 0; i < nPackets; i++)
+    {
+      scan.ReadVarint ();
+    }
+  ColumnReader uids (data, scan.GetCurrent ());
+  for (uint32_t i = 0; i < nPackets; i++)
+    {
+      scan.ReadVarint ();
+    }
+  ColumnReader sizes (data, scan.GetCurrent ());
+  for (uint32_t i = 0; i < nPackets; i++)
+    {
+      scan.ReadVarint ();
+    }
+  ColumnReader packetSizes (data, scan.GetCurrent ());
+  uint64_t packetBytes = 0;
+  if (packets)
+    {
+      for (uint32_t i = 0; i < nPackets; i++)
+        {
+          packetBytes += scan.ReadVarint ();
+        }
+    }
+  ColumnReader packetData (data, scan.GetCurrent ());
+  scan.Skip (packetBytes);
+  ColumnReader textSizes (data, scan.GetCurrent ());
+  uint64_t textBytes = 0;
+  for (uint32_t i = nPackets; i < nEvents; i++)
+    {
+      textBytes += scan.ReadVarint ();
+    }
+  ColumnReader texts (data, scan.GetCurrent ());
+  scan.Skip (textBytes);
+  if (!scan.IsOk ())
+    {
+      return false;
+    }
+
+  int64_t time = 0;
+  uint64_t uid = 0;
+  std::vector<uint32_t> buffer;
+  for (uint32_t i = 0; i < nEvents; i++)
+    {
+      if (kinds[i] == EVENT_TEXT)
+        {
+          uint64_t size = textSizes.ReadVarint ();
+          os.write (texts.ReadBytes (size), size);
+          continue;
+        }
+      time += UnZigZag (times.ReadVarint ());
+      uid += UnZigZag (uids.ReadVarint ());
+      uint32_t context = contextIds.ReadVarint ();
+      uint32_t size = sizes.ReadVarint ();
+      if (context > contexts.size ())
+        {
+          return false;
+        }
+      os << kinds[i] << " " << NanoSeconds (time).GetSeconds () << " ";
+      if (context != 0)
+        {
+          os << contexts[context - 1] << " ";
+        }
+      if (packets)
+        {
+          uint64_t serializedSize = packetSizes.ReadVarint ();
+          buffer.resize ((serializedSize + 3) / 4);
+          std::memcpy (&buffer[0], packetData.ReadBytes (serializedSize), serializedSize);
+          Ptr<Packet> p = Create<Packet> (reinterpret_cast<uint8_t const *> (&buffer[0]), serializedSize, true);
+          os << *p;
+        }
+      else
+        {
+          os << "uid=" << uid << " size=" << size;
+        }
+      os << std::endl;
+    }
+  return true;
+}
+
+} // anonymous namespace
+
+bool
+BinaryTraceFile::ConvertToAscii (std::istream &is, std::ostream &os)
+{
+  char magic[sizeof (BINARY_TRACE_MAGIC)];
+  uint32_t version;
+  if (!is.read (magic, sizeof (magic)) ||
+      std::memcmp (magic, BINARY_TRACE_MAGIC, sizeof (magic)) != 0 ||
+      !ReadUint32 (is, &version) || version != BINARY_TRACE_VERSION)
+    {
+      return false;
+    }
+  std::vector<std::string> contexts;
+  std::string data;
+  while (is.peek () != std::istream::traits_type::eof ())
+    {
+      uint8_t type;
+      if (!ReadBlock (is, &type, &data))
+        {
+          return false;
+        }
+      if (type == BLOCK_CONTEXTS)
+        {
+          ColumnReader reader (data);
+          uint32_t n = reader.ReadVarint ();
+          for (uint32_t i = 0; i < n && reader.IsOk (); i++)
+            {
+              uint64_t size = reader.ReadVarint ();
+              const char *path = reader.ReadBytes (size);
+              if (path != 0)
+                {
+                  contexts.push_back (std::string (path, size));
+                }
+            }
+          if (!reader.IsOk ())
+            {
+              return false;
+            }
+        }
+      else if (type == BLOCK_EVENTS)
+        {
+          if (!ConvertEvents (data, contexts, os))
+            {
+              return false;
+            }
+        }
+      else
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <string>
+#include <fstream>
+#include <map>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/trace-context.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \brief A compact binary alternative to the text files of AsciiTraceHelper
+ *
+ * The ascii trace sinks format every packet with Packet::Print, which
+ * is slow and yields very large files.  A BinaryTraceFile instead
+ * stores each packet event as a row of columns: the event type, the
+ * time in nanoseconds, the trace context (which holds the node and
+ * device indexes), the packet uid and size and, optionally, the
+ * serialized packet.  Rows are accumulated in blocks of a few thousand
+ * events; each column of a block is encoded as variable-length
+ * integers (times and uids as deltas), and the block is compressed
+ * with zlib when it is available.
+ *
+ * Text written to the stream returned by GetTextStream is stored in
+ * the same sequence of events, such that trace sinks which do not know
+ * about this format keep working.
+ *
+ * ConvertToAscii regenerates the text which the ascii trace sinks
+ * would have written.  If the packets were not stored, their Print
+ * output is replaced by their uid and size.  The convert-binary-trace
+ * program wraps this function.
+ */
+class BinaryTraceFile : public SimpleRefCount<BinaryTraceFile>
+{
+public:
+  /**
+   * The types of packet events, which match the first character of
+   * the lines of the ascii traces.
+   */
+  enum Event
+  {
+    ENQUEUE = '+',
+    DEQUEUE = '-',
+    DROP = 'd',
+    RECEIVE = 'r'
+  };
+
+  BinaryTraceFile ();
+  ~BinaryTraceFile ();
+
+  /**
+   * Create a new binary trace file.
+   *
+   * \param filename the name of the file.
+   * \param storePackets whether the serialized packets are stored, to
+   * regenerate their Print output.
+   */
+  void Open (std::string const &filename, bool storePackets = true);
+
+  /**
+   * Write the pending events and close the file.
+   */
+  void Close (void);
+
+  /**
+   * \return true if the 'fail' bit is set in the underlying file, false otherwise.
+   */
+  bool Fail (void) const;
+
+  /**
+   * \return a stream whose text is stored in the file, in sequence with
+   * the packet events.
+   */
+  std::ostream *GetTextStream (void);
+
+  /**
+   * Store a packet event which has no context.
+   *
+   * \param event the type of event.
+   * \param now the time of the event.
+   * \param p the packet.
+   */
+  void Write (enum Event event, Time now, Ptr<const Packet> p);
+  /**
+   * Store a packet event.
+   *
+   * \param event the type of event.
+   * \param now the time of the event.
+   * \param context the context of the trace source.
+   * \param p the packet.
+   */
+  void Write (enum Event event, Time now, TraceContext context, Ptr<const Packet> p);
+
+  /**
+   * Write the pending events to the file.
+   */
+  void Flush (void);
+
+  /**
+   * Convert a binary trace file to the output of the ascii trace sinks.
+   *
+   * The header types of the stored packets must be registered, that is,
+   * the program must be linked with the modules which define them, and
+   * the packet metadata must be enabled (Packet::EnablePrinting) to
+   * print them.
+   *
+   * \param is a stream which contains a binary trace file.
+   * \param os the stream to which the text is written.
+   * \return true if the whole input stream could be converted, false if
+   * it is not a binary trace file or is truncated.
+   */
+  static bool ConvertToAscii (std::istream &is, std::ostream &os);
+
+private:
+  /**
+   * Accumulates the text written to the text stream until the next
+   * packet event.
+   */
+  class TextBuffer : public std::streambuf
+  {
+public:
+    std::string m_text;
+private:
+    virtual int_type overflow (int_type c);
+    virtual std::streamsize xsputn (const char *s, std::streamsize n);
+  };
+  /**
+   * Flushes the file when the program stops on a fatal error: the text
+   * stream itself is flushed by every std::endl.
+   */
+  class FlushBuffer : public std::streambuf
+  {
+public:
+    FlushBuffer (BinaryTraceFile *file);
+private:
+    virtual int sync (void);
+    BinaryTraceFile *m_file;
+  };
+
+  void DoWrite (enum Event event, Time now, uint32_t context, Ptr<const Packet> p);
+  void WriteText (void);
+  void WriteBlock (uint8_t type, const std::string &data);
+  void WriteContexts (void);
+  void WriteEvents (void);
+
+  std::ofstream m_file;
+  bool m_storePackets;
+  TextBuffer m_textBuffer;
+  std::ostream m_textStream;
+  FlushBuffer m_flushBuffer;
+  std::ostream m_flushStream;
+  // The interned paths of the contexts are identified by their address.
+  std::map<const std::string *, uint32_t> m_contexts;
+  std::string m_newContexts;
+  uint32_t m_nNewContexts;
+  // The columns of the current block.
+  uint32_t m_nEvents;
+  std::string m_kinds;
+  std::string m_times;
+  std::string m_contextIds;
+  std::string m_uids;
+  std::string m_sizes;
+  std::string m_packetSizes;
+  std::string m_packets;
+  std::string m_textSizes;
+  std::string m_texts;
+  int64_t m_lastTime;
+  uint64_t m_lastUid;
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
@@ -24,7 +24,6 @@
 #include "ns3/log.h"
 #include "ns3/header.h"
 #include "ethernet-header.h"
-#include "address-utils.h"
 
 NS_LOG_COMPONENT_DEFINE ("EthernetHeader");
 
@@ -150,9 +149,14 @@ EthernetHeader::Serialize (Buffer::Iterator start) const
     {
       i.WriteU64 (m_preambleSfd);
     }
-  WriteTo (i, m_destination);
-  WriteTo (i, m_source);
-  i.WriteHtonU16 (m_lengthType);
+  uint8_t header[Layout::SIZE];
+  uint8_t address[6];
+  m_destination.CopyTo (address);
+  Layout::Destination::Write (header, address);
+  m_source.CopyTo (address);
+  Layout::Source::Write (header, address);
+  Layout::LengthType::Write (header, m_lengthType);
+  i.Write (header, Layout::SIZE);
 }
 uint32_t
 EthernetHeader::Deserialize (Buffer::Iterator start)
@@ -164,9 +168,11 @@ EthernetHeader::Deserialize (Buffer::Iterator start)
       m_enPreambleSfd = i.ReadU64 ();
     }
 
-  ReadFrom (i, m_destination);
-  ReadFrom (i, m_source);
-  m_lengthType = i.ReadNtohU16 ();
+  uint8_t header[Layout::SIZE];
+  i.Read (header, Layout::SIZE);
+  m_destination.CopyFrom (Layout::Destination::Get (header));
+  m_source.CopyFrom (Layout::Source::Get (header));
+  m_lengthType = Layout::LengthType::Read (header);
 
   return GetSerializedSize ();
 }
@@ -22,6 +22,7 @@
 #define ETHERNET_HEADER_H
 
 #include "ns3/header.h"
+#include "ns3/header-layout.h"
 #include <string>
 #include "ns3/mac48-address.h"
 
@@ -109,6 +110,21 @@ public:
   virtual uint32_t GetSerializedSize (void) const;
   virtual void Serialize (Buffer::Iterator start) const;
   virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  /**
+   * \brief The fields of a serialized header, after the preamble if
+   * it is enabled
+   *
+   * Used by Serialize and Deserialize, and to read the fields of the
+   * header of a packet without deserializing it, see Packet::PeekBytes.
+   */
+  struct Layout
+  {
+    enum { SIZE = 14 };
+    typedef HeaderBytesField<0, 6> Destination;
+    typedef HeaderBytesField<6, 6> Source;
+    typedef HeaderField<12, uint16_t> LengthType;
+  };
 private:
   static const int PREAMBLE_SIZE = 8; /// size of the preamble_sfd header field
   static const int LENGTH_SIZE = 2;   /// size of the length_type header field
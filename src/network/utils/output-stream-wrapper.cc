@@ -44,9 +44,19 @@ OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
   NS_ABORT_MSG_UNLESS (m_ostream->good (), "Output stream is not vaild for writing.");
 }
 
+OutputStreamWrapper::OutputStreamWrapper (Ptr<BinaryTraceFile> file)
+  : m_ostream (file->GetTextStream ()), m_destroyable (false), m_binary (file)
+{
+  // The binary trace file registers itself with FatalImpl.
+  NS_ABORT_MSG_IF (file->Fail (), "Binary trace file is not valid for writing.");
+}
+
 OutputStreamWrapper::~OutputStreamWrapper ()
 {
-  FatalImpl::UnregisterStream (m_ostream);
+  if (m_binary == 0)
+    {
+      FatalImpl::UnregisterStream (m_ostream);
+    }
   if (m_destroyable) delete m_ostream;
   m_ostream = 0;
 }
@@ -57,4 +67,10 @@ OutputStreamWrapper::GetStream (void)
   return m_ostream;
 }
 
+Ptr<BinaryTraceFile>
+OutputStreamWrapper::GetBinaryTraceFile (void) const
+{
+  return m_binary;
+}
+
 } // namespace ns3
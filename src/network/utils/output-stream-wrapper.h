@@ -23,6 +23,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "binary-trace-file.h"
 
 namespace ns3 {
 
@@ -72,6 +73,14 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
 public:
   OutputStreamWrapper (std::string filename, std::ios::openmode filemode);
   OutputStreamWrapper (std::ostream* os);
+  /**
+   * Wrap a binary trace file: the ascii trace sinks store their packet
+   * events in the file, and the stream returned by GetStream stores
+   * the text written by the other sinks.
+   *
+   * \param file an open binary trace file.
+   */
+  OutputStreamWrapper (Ptr<BinaryTraceFile> file);
   ~OutputStreamWrapper ();
 
   /**
@@ -83,9 +92,16 @@ public:
    */
   std::ostream *GetStream (void);
 
+  /**
+   * \returns the binary trace file wrapped by this object, or zero if
+   * it wraps a std::ostream.
+   */
+  Ptr<BinaryTraceFile> GetBinaryTraceFile (void) const;
+
 private:
   std::ostream *m_ostream;
   bool m_destroyable;
+  Ptr<BinaryTraceFile> m_binary;
 };
 
 } // namespace ns3
@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-ring.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("PacketRing");
+
+namespace ns3 {
+
+PacketRing::PacketRing ()
+  : m_mask (0),
+    m_head (0),
+    m_size (0)
+{
+}
+
+PacketRing::~PacketRing ()
+{
+  Clear ();
+}
+
+void
+PacketRing::Reserve (uint32_t capacity)
+{
+  if (capacity > m_slots.size ())
+    {
+      Grow (capacity);
+    }
+}
+
+void
+PacketRing::Clear (void)
+{
+  while (!IsEmpty ())
+    {
+      PopFront ();
+    }
+  m_head = 0;
+}
+
+void
+PacketRing::Grow (uint32_t capacity)
+{
+  uint32_t size = 1;
+  while (size < capacity)
+    {
+      size <<= 1;
+    }
+  NS_LOG_FUNCTION (this << size);
+  // copy the packets in order at the start of the new array.
+  std::vector<Packet *> slots (size);
+  for (uint32_t i = 0; i < m_size; i++)
+    {
+      slots[i] = m_slots[(m_head + i) & m_mask];
+    }
+  m_slots.swap (slots);
+  m_mask = size - 1;
+  m_head = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_RING_H
+#define PACKET_RING_H
+
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup queue
+ *
+ * \brief A FIFO of packets stored in a contiguous circular array
+ *
+ * The storage of the queues: unlike a std::deque or a std::list, it
+ * does not allocate memory while packets are enqueued and dequeued,
+ * once it has grown to the largest number of packets it held.  Queues
+ * reserve their maximum number of packets up front, and the array
+ * doubles when it is full, e.g., for queues limited in bytes.
+ *
+ * The ring holds a reference to each of its packets, which PopFront
+ * hands over to the returned Ptr: a packet goes through the ring with
+ * a single reference count increment.
+ */
+class PacketRing
+{
+public:
+  PacketRing ();
+  ~PacketRing ();
+
+  /**
+   * \param capacity the number of packets which can be stored without
+   *        allocating memory.  It is rounded up to a power of two.
+   */
+  void Reserve (uint32_t capacity);
+  /**
+   * \returns the number of packets which can be stored without
+   *          allocating memory.
+   */
+  uint32_t GetCapacity (void) const;
+  /**
+   * \returns the number of packets stored.
+   */
+  uint32_t GetSize (void) const;
+  /**
+   * \returns true if no packet is stored.
+   */
+  bool IsEmpty (void) const;
+  /**
+   * \param p the packet to store after the last one.
+   */
+  void PushBack (const Ptr<Packet> &p);
+  /**
+   * \returns the first packet, which is removed.  The ring must not
+   *          be empty.
+   */
+  Ptr<Packet> PopFront (void);
+  /**
+   * \returns the first packet.  The ring must not be empty.
+   */
+  Ptr<Packet> Front (void) const;
+  /**
+   * Remove all the packets and keep the capacity.
+   */
+  void Clear (void);
+
+private:
+  PacketRing (const PacketRing &o);
+  PacketRing &operator = (const PacketRing &o);
+  void Grow (uint32_t capacity);
+
+  std::vector<Packet *> m_slots;
+  uint32_t m_mask; // size of m_slots - 1, the size being a power of two
+  uint32_t m_head;
+  uint32_t m_size;
+};
+
+} // namespace ns3
+
+namespace ns3 {
+
+inline uint32_t
+PacketRing::GetCapacity (void) const
+{
+  return m_slots.size ();
+}
+inline uint32_t
+PacketRing::GetSize (void) const
+{
+  return m_size;
+}
+inline bool
+PacketRing::IsEmpty (void) const
+{
+  return m_size == 0;
+}
+inline void
+PacketRing::PushBack (const Ptr<Packet> &p)
+{
+  if (m_size == m_slots.size ())
+    {
+      Grow (m_size * 2);
+    }
+  p->Ref ();
+  m_slots[(m_head + m_size) & m_mask] = PeekPointer (p);
+  m_size++;
+}
+inline Ptr<Packet>
+PacketRing::PopFront (void)
+{
+  NS_ASSERT (m_size > 0);
+  Packet *p = m_slots[m_head];
+  m_head = (m_head + 1) & m_mask;
+  m_size--;
+  // the reference of the ring is handed over.
+  return Ptr<Packet> (p, false);
+}
+inline Ptr<Packet>
+PacketRing::Front (void) const
+{
+  NS_ASSERT (m_size > 0);
+  return m_slots[m_head];
+}
+
+} // namespace ns3
+
+#endif /* PACKET_RING_H */
@@ -39,12 +39,20 @@ PcapFileWrapper::GetTypeId (void)
                    UintegerValue (PcapFile::SNAPLEN_DEFAULT),
                    MakeUintegerAccessor (&PcapFileWrapper::m_snapLen),
                    MakeUintegerChecker<uint32_t> (0, PcapFile::SNAPLEN_DEFAULT))
+    .AddAttribute ("BufferSize",
+                   "Size of the buffer in which packets are accumulated before being "
+                   "written to the file, or zero for the default buffer of the iostream library",
+                   UintegerValue (PcapFile::BUFFER_SIZE_DEFAULT),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_ngInterface (0),
+    m_ngDataLinkType (0)
 {
 }
 
@@ -57,6 +65,10 @@ PcapFileWrapper::~PcapFileWrapper ()
 bool 
 PcapFileWrapper::Fail (void) const
 {
+  if (m_ngFile != 0)
+    {
+      return m_ngFile->Fail ();
+    }
   return m_file.Fail ();
 }
 bool 
@@ -74,11 +86,13 @@ void
 PcapFileWrapper::Close (void)
 {
   m_file.Close ();
+  m_ngFile = 0;
 }
 
 void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
+  m_file.SetBufferSize (m_bufferSize);
   m_file.Open (filename, mode);
 }
 
@@ -100,9 +114,26 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
     } 
 }
 
+void
+PcapFileWrapper::Init (Ptr<PcapNgFile> file, std::string const &name, uint32_t dataLinkType, uint32_t snapLen)
+{
+  if (snapLen == std::numeric_limits<uint32_t>::max ())
+    {
+      snapLen = m_snapLen;
+    }
+  m_ngFile = file;
+  m_ngInterface = file->AddInterface (name, dataLinkType, snapLen);
+  m_ngDataLinkType = dataLinkType;
+}
+
 void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), p);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -113,6 +144,11 @@ PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 void
 PcapFileWrapper::Write (Time t, Header &header, Ptr<const Packet> p)
 {
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), header, p);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -123,6 +159,11 @@ PcapFileWrapper::Write (Time t, Header &header, Ptr<const Packet> p)
 void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), buffer, length);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -163,12 +204,20 @@ PcapFileWrapper::GetSigFigs (void)
 uint32_t
 PcapFileWrapper::GetSnapLen (void)
 {
+  if (m_ngFile != 0)
+    {
+      return m_ngFile->GetSnapLen (m_ngInterface);
+    }
   return m_file.GetSnapLen ();
 }
 
 uint32_t
 PcapFileWrapper::GetDataLinkType (void)
 {
+  if (m_ngFile != 0)
+    {
+      return m_ngDataLinkType;
+    }
   return m_file.GetDataLinkType ();
 }
 
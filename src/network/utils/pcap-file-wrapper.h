@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcapng-file.h"
 
 namespace ns3 {
 
@@ -105,6 +106,22 @@ public:
              uint32_t snapLen = std::numeric_limits<uint32_t>::max (), 
              int32_t tzCorrection = PcapFile::ZONE_DEFAULT);
 
+  /**
+   * Make this wrapper write its packets to an interface of a shared
+   * pcapng file rather than to its own pcap file; Open must not be
+   * called.  The methods which return the fields of the pcap file
+   * header are then meaningless, except GetSnapLen and GetDataLinkType
+   * which return those of the interface.
+   *
+   * \param file the pcapng file, which must be open.
+   * \param name the name of the new interface in the pcapng file.
+   * \param dataLinkType the data link type of the packets.
+   * \param snapLen An optional maximum size for packets written to the
+   * file.  If it is not provided, the "CaptureSize" attribute is used.
+   */
+  void Init (Ptr<PcapNgFile> file, std::string const &name, uint32_t dataLinkType,
+             uint32_t snapLen = std::numeric_limits<uint32_t>::max ());
+
   /**
    * \brief Write the next packet to file
    * 
@@ -197,6 +214,10 @@ public:
 private:
   PcapFile m_file;
   uint32_t m_snapLen;
+  uint32_t m_bufferSize;
+  Ptr<PcapNgFile> m_ngFile;
+  uint32_t m_ngInterface;
+  uint32_t m_ngDataLinkType;
 };
 
 } // namespace ns3
@@ -45,6 +45,7 @@ const int32_t  SIGFIGS_DEFAULT = 0;           /**< Significant figures for times
 
 PcapFile::PcapFile ()
   : m_file (),
+    m_bufferSize (BUFFER_SIZE_DEFAULT),
     m_swapMode (false)
 {
   FatalImpl::RegisterStream (&m_file);
@@ -80,6 +81,12 @@ PcapFile::Close (void)
   m_file.close ();
 }
 
+void
+PcapFile::SetBufferSize (uint32_t size)
+{
+  m_bufferSize = size;
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -292,6 +299,16 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
   //
   mode |= std::ios::binary;
 
+  //
+  // The buffer of a file stream can only be replaced before the file is
+  // opened.
+  //
+  if (m_bufferSize != 0)
+    {
+      m_buffer.resize (m_bufferSize);
+      m_file.rdbuf ()->pubsetbuf (&m_buffer[0], m_buffer.size ());
+    }
+
   m_file.open (filename.c_str (), mode);
   if (mode & std::ios::in)
     {
@@ -351,25 +368,21 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
-  PcapRecordHeader header;
-  header.m_tsSec = tsSec;
-  header.m_tsUsec = tsUsec;
-  header.m_inclLen = inclLen;
-  header.m_origLen = totalLen;
+  //
+  // The record header is made of four 32 bit fields: lay them out in an
+  // array, which has no padding on any machine, and write them at once.
+  //
+  uint32_t fields[4] = { tsSec, tsUsec, inclLen, totalLen };
 
   if (m_swapMode)
     {
-      Swap (&header, &header);
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          fields[i] = Swap (fields[i]);
+        }
     }
 
-  //
-  // Watch out for memory alignment differences between machines, so write
-  // them all individually.
-  //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
+  m_file.write ((const char *)fields, sizeof (fields));
   return inclLen;
 }
 
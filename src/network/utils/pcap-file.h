@@ -23,6 +23,7 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ptr.h"
 
@@ -42,6 +43,7 @@ class PcapFile
 public:
   static const int32_t  ZONE_DEFAULT    = 0;           /**< Time zone offset for current location */
   static const uint32_t SNAPLEN_DEFAULT = 65535;       /**< Default value for maximum octets to save per packet */
+  static const uint32_t BUFFER_SIZE_DEFAULT = 32768;   /**< Default size of the buffer of the underlying file */
 
 public:
   PcapFile ();
@@ -83,6 +85,17 @@ public:
    */
   void Close (void);
 
+  /**
+   * Set the size of the buffer in which packet records are accumulated
+   * before being written to the underlying file.  Larger buffers make
+   * fewer system calls, at the cost of memory for each open file.
+   * Must be called before Open to take effect.
+   *
+   * \param size the size of the buffer in bytes, or zero to use the
+   * default buffer of the iostream library.
+   */
+  void SetBufferSize (uint32_t size);
+
   /**
    * Initialize the pcap file associated with this object.  This file must have
    * been previously opened with write permissions.
@@ -288,6 +301,8 @@ private:
 
   std::string    m_filename;
   std::fstream   m_file;
+  std::vector<char> m_buffer;
+  uint32_t       m_bufferSize;
   PcapFileHeader m_fileHeader;
   bool m_swapMode;
 };
@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "ns3/packet.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "pcapng-file.h"
+
+namespace ns3 {
+
+const uint32_t SECTION_HEADER_BLOCK = 0x0a0d0d0a;   /**< Block type of the Section Header Block */
+const uint32_t INTERFACE_DESCRIPTION_BLOCK = 1;     /**< Block type of the Interface Description Block */
+const uint32_t ENHANCED_PACKET_BLOCK = 6;           /**< Block type of the Enhanced Packet Block */
+const uint32_t BYTE_ORDER_MAGIC = 0x1a2b3c4d;       /**< Identifies the byte order of a section */
+const uint16_t OPTION_END = 0;                      /**< opt_endofopt */
+const uint16_t OPTION_IF_NAME = 2;                  /**< if_name option of an interface */
+const uint16_t OPTION_IF_TSRESOL = 9;               /**< if_tsresol option of an interface */
+const uint8_t TSRESOL_NANOSECONDS = 9;              /**< Timestamps in units of 10^-9 seconds */
+
+static const char g_padding[4] = { 0, 0, 0, 0 };
+
+static uint32_t
+Pad (uint32_t length)
+{
+  return (length + 3) & ~3U;
+}
+
+PcapNgFile::PcapNgFile ()
+{
+  FatalImpl::RegisterStream (&m_file);
+}
+
+PcapNgFile::~PcapNgFile ()
+{
+  FatalImpl::UnregisterStream (&m_file);
+  Close ();
+}
+
+bool
+PcapNgFile::Fail (void) const
+{
+  return m_file.fail ();
+}
+
+void
+PcapNgFile::Open (std::string const &filename, uint32_t bufferSize)
+{
+  NS_ASSERT (!m_file.is_open ());
+  if (bufferSize != 0)
+    {
+      m_buffer.resize (bufferSize);
+      m_file.rdbuf ()->pubsetbuf (&m_buffer[0], m_buffer.size ());
+    }
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary);
+  m_snapLens.clear ();
+
+  //
+  // A single section, of unspecified length, which holds all the
+  // interfaces and packets.
+  //
+  uint32_t length = 28;
+  uint32_t header[3] = { SECTION_HEADER_BLOCK, length, BYTE_ORDER_MAGIC };
+  uint16_t version[2] = { 1, 0 };
+  uint32_t sectionLength[2] = { 0xffffffff, 0xffffffff };
+  m_file.write ((const char *)header, sizeof (header));
+  m_file.write ((const char *)version, sizeof (version));
+  m_file.write ((const char *)sectionLength, sizeof (sectionLength));
+  m_file.write ((const char *)&length, sizeof (length));
+}
+
+void
+PcapNgFile::Close (void)
+{
+  m_file.close ();
+}
+
+uint32_t
+PcapNgFile::AddInterface (std::string const &name, uint32_t dataLinkType, uint32_t snapLen)
+{
+  NS_ASSERT (m_file.good ());
+  uint32_t nameLength = Pad (name.size ());
+  uint32_t options = 4 + nameLength + 4 + 4 + 4;
+  uint32_t length = 16 + options + 4;
+
+  uint32_t header[2] = { INTERFACE_DESCRIPTION_BLOCK, length };
+  uint16_t linkType[2] = { static_cast<uint16_t> (dataLinkType), 0 };
+  m_file.write ((const char *)header, sizeof (header));
+  m_file.write ((const char *)linkType, sizeof (linkType));
+  m_file.write ((const char *)&snapLen, sizeof (snapLen));
+
+  uint16_t option[2];
+  option[0] = OPTION_IF_NAME;
+  option[1] = name.size ();
+  m_file.write ((const char *)option, sizeof (option));
+  m_file.write (name.data (), name.size ());
+  m_file.write (g_padding, nameLength - name.size ());
+
+  option[0] = OPTION_IF_TSRESOL;
+  option[1] = 1;
+  m_file.write ((const char *)option, sizeof (option));
+  char resolution[4] = { TSRESOL_NANOSECONDS, 0, 0, 0 };
+  m_file.write (resolution, sizeof (resolution));
+
+  option[0] = OPTION_END;
+  option[1] = 0;
+  m_file.write ((const char *)option, sizeof (option));
+  m_file.write ((const char *)&length, sizeof (length));
+
+  m_snapLens.push_back (snapLen);
+  return m_snapLens.size () - 1;
+}
+
+uint32_t
+PcapNgFile::GetNInterfaces (void) const
+{
+  return m_snapLens.size ();
+}
+
+uint32_t
+PcapNgFile::GetSnapLen (uint32_t interface) const
+{
+  NS_ASSERT (interface < m_snapLens.size ());
+  return m_snapLens[interface];
+}
+
+uint32_t
+PcapNgFile::WriteBlockHeader (uint32_t interface, uint64_t ns, uint32_t totalLen)
+{
+  NS_ASSERT (m_file.good ());
+  NS_ASSERT (interface < m_snapLens.size ());
+  uint32_t snapLen = m_snapLens[interface];
+  uint32_t inclLen = totalLen > snapLen ? snapLen : totalLen;
+
+  uint32_t header[7];
+  header[0] = ENHANCED_PACKET_BLOCK;
+  header[1] = sizeof (header) + Pad (inclLen) + 4;
+  header[2] = interface;
+  header[3] = ns >> 32;
+  header[4] = ns & 0xffffffff;
+  header[5] = inclLen;
+  header[6] = totalLen;
+  m_file.write ((const char *)header, sizeof (header));
+  return inclLen;
+}
+
+void
+PcapNgFile::WriteBlockTrailer (uint32_t inclLen)
+{
+  uint32_t padded = Pad (inclLen);
+  uint32_t length = 28 + padded + 4;
+  m_file.write (g_padding, padded - inclLen);
+  m_file.write ((const char *)&length, sizeof (length));
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t ns, uint8_t const *data, uint32_t totalLen)
+{
+  uint32_t inclLen = WriteBlockHeader (interface, ns, totalLen);
+  m_file.write ((const char *)data, inclLen);
+  WriteBlockTrailer (inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t ns, Ptr<const Packet> p)
+{
+  uint32_t inclLen = WriteBlockHeader (interface, ns, p->GetSize ());
+  p->CopyData (&m_file, inclLen);
+  WriteBlockTrailer (inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t ns, Header &header, Ptr<const Packet> p)
+{
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t inclLen = WriteBlockHeader (interface, ns, headerSize + p->GetSize ());
+
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (&m_file, toCopy);
+  p->CopyData (&m_file, inclLen - toCopy);
+  WriteBlockTrailer (inclLen);
+}
+
+} // namespace ns3
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_H
+#define PCAPNG_FILE_H
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+
+/**
+ * \brief A pcapng file which multiplexes the packets of many interfaces
+ *
+ * A pcap file holds the packets of a single data link, so tracing
+ * thousands of devices with PcapFile requires thousands of open files.
+ * A pcapng file holds a single section in which each traced device is
+ * described by an Interface Description Block; each packet is written
+ * as an Enhanced Packet Block which refers to its interface.  The file
+ * can be read by wireshark and tshark, which can filter the packets of
+ * an interface with the "frame.interface_id" or "frame.interface_name"
+ * fields.
+ *
+ * All the blocks are written in the byte order of the host, as allowed
+ * by the format, with timestamps in nanoseconds.  Writes are
+ * accumulated in a single large buffer.
+ *
+ * See http://www.winpcap.org/ntar/draft/PCAP-DumpFileFormat.html
+ */
+class PcapNgFile : public SimpleRefCount<PcapNgFile>
+{
+public:
+  static const uint32_t BUFFER_SIZE_DEFAULT = 1 << 20; /**< Default size of the buffer of the file */
+
+  PcapNgFile ();
+  ~PcapNgFile ();
+
+  /**
+   * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Create a new pcapng file and write its section header.
+   *
+   * \param filename the name of the file.
+   * \param bufferSize the size of the buffer in which blocks are
+   * accumulated before being written to the file.
+   */
+  void Open (std::string const &filename, uint32_t bufferSize = BUFFER_SIZE_DEFAULT);
+
+  /**
+   * Write the buffered blocks and close the file.
+   */
+  void Close (void);
+
+  /**
+   * Describe a new interface in the file.
+   *
+   * \param name the name of the interface, stored in its if_name option.
+   * \param dataLinkType the data link type of the packets of the
+   * interface, as defined in the pcap library.
+   * \param snapLen the maximum number of bytes stored for each packet of
+   * the interface; packets are truncated before being copied.
+   * \return the identifier of the interface, to pass to Write.
+   */
+  uint32_t AddInterface (std::string const &name, uint32_t dataLinkType, uint32_t snapLen);
+
+  /**
+   * \return the number of interfaces described in the file.
+   */
+  uint32_t GetNInterfaces (void) const;
+
+  /**
+   * \param interface the identifier of an interface.
+   * \return the snap length of the interface.
+   */
+  uint32_t GetSnapLen (uint32_t interface) const;
+
+  /**
+   * \brief Write a packet of an interface to the file
+   *
+   * \param interface the identifier of the interface, as returned by AddInterface
+   * \param ns          Packet timestamp, in nanoseconds
+   * \param data        Data buffer
+   * \param totalLen    Total packet length
+   */
+  void Write (uint32_t interface, uint64_t ns, uint8_t const *data, uint32_t totalLen);
+  /**
+   * \brief Write a packet of an interface to the file
+   *
+   * \param interface the identifier of the interface, as returned by AddInterface
+   * \param ns          Packet timestamp, in nanoseconds
+   * \param p           Packet to write
+   */
+  void Write (uint32_t interface, uint64_t ns, Ptr<const Packet> p);
+  /**
+   * \brief Write a packet of an interface to the file
+   *
+   * \param interface the identifier of the interface, as returned by AddInterface
+   * \param ns          Packet timestamp, in nanoseconds
+   * \param header      Header to write, in front of packet
+   * \param p           Packet to write
+   */
+  void Write (uint32_t interface, uint64_t ns, Header &header, Ptr<const Packet> p);
+
+private:
+  uint32_t WriteBlockHeader (uint32_t interface, uint64_t ns, uint32_t totalLen);
+  void WriteBlockTrailer (uint32_t inclLen);
+
+  std::fstream m_file;
+  std::vector<char> m_buffer;
+  std::vector<uint32_t> m_snapLens;
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_H */
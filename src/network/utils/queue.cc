@@ -18,6 +18,7 @@
 
 #include "ns3/log.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/simulator.h"
 #include "queue.h"
 
 NS_LOG_COMPONENT_DEFINE ("Queue");
@@ -37,6 +38,10 @@ Queue::GetTypeId (void)
                      MakeTraceSourceAccessor (&Queue::m_traceDequeue))
     .AddTraceSource ("Drop", "Drop a packet stored in the queue.",
                      MakeTraceSourceAccessor (&Queue::m_traceDrop))
+    .AddTraceSource ("PacketsInQueue", "Number of packets currently stored in the queue.",
+                     MakeTraceSourceAccessor (&Queue::m_tracePacketsInQueue))
+    .AddTraceSource ("BytesInQueue", "Number of bytes currently stored in the queue.",
+                     MakeTraceSourceAccessor (&Queue::m_traceBytesInQueue))
   ;
   return tid;
 }
@@ -47,7 +52,8 @@ Queue::Queue() :
   m_nPackets (0),
   m_nTotalReceivedPackets (0),
   m_nTotalDroppedBytes (0),
-  m_nTotalDroppedPackets (0)
+  m_nTotalDroppedPackets (0),
+  m_histogramBinWidth (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -72,12 +78,19 @@ Queue::Enqueue (Ptr<Packet> p)
       NS_LOG_LOGIC ("m_traceEnqueue (p)");
       m_traceEnqueue (p);
 
+      if (m_histogramBinWidth != 0)
+        {
+          RecordOccupancy ();
+        }
       uint32_t size = p->GetSize ();
       m_nBytes += size;
       m_nTotalReceivedBytes += size;
 
       m_nPackets++;
       m_nTotalReceivedPackets++;
+
+      m_tracePacketsInQueue (m_nPackets - 1, m_nPackets);
+      m_traceBytesInQueue (m_nBytes - size, m_nBytes);
     }
   return retval;
 }
@@ -94,15 +107,41 @@ Queue::Dequeue (void)
       NS_ASSERT (m_nBytes >= packet->GetSize ());
       NS_ASSERT (m_nPackets > 0);
 
-      m_nBytes -= packet->GetSize ();
+      if (m_histogramBinWidth != 0)
+        {
+          RecordOccupancy ();
+        }
+      uint32_t size = packet->GetSize ();
+      m_nBytes -= size;
       m_nPackets--;
 
+      m_tracePacketsInQueue (m_nPackets + 1, m_nPackets);
+      m_traceBytesInQueue (m_nBytes + size, m_nBytes);
+
       NS_LOG_LOGIC ("m_traceDequeue (packet)");
       m_traceDequeue (packet);
     }
   return packet;
 }
 
+uint32_t
+Queue::DequeueBatch (uint32_t n, std::vector<Ptr<Packet> > &packets)
+{
+  NS_LOG_FUNCTION (this << n);
+  uint32_t count = 0;
+  while (count < n)
+    {
+      Ptr<Packet> packet = Dequeue ();
+      if (packet == 0)
+        {
+          break;
+        }
+      packets.push_back (packet);
+      count++;
+    }
+  return count;
+}
+
 void
 Queue::DequeueAll (void)
 {
@@ -185,6 +224,52 @@ Queue::ResetStatistics (void)
   m_nTotalReceivedPackets = 0;
   m_nTotalDroppedBytes = 0;
   m_nTotalDroppedPackets = 0;
+  if (m_histogramBinWidth != 0)
+    {
+      m_histogram.clear ();
+      m_lastOccupancyChange = Simulator::Now ();
+    }
+}
+
+void
+Queue::EnableOccupancyHistogram (uint32_t binWidth)
+{
+  NS_LOG_FUNCTION (this << binWidth);
+  NS_ASSERT_MSG (binWidth > 0, "Queue::EnableOccupancyHistogram(): the bins cannot be empty");
+  m_histogramBinWidth = binWidth;
+  m_histogram.clear ();
+  m_lastOccupancyChange = Simulator::Now ();
+}
+
+std::vector<Time>
+Queue::GetOccupancyHistogram (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Time> histogram = m_histogram;
+  if (m_histogramBinWidth != 0)
+    {
+      // add the time spent since the last change
+      uint32_t bin = m_nPackets / m_histogramBinWidth;
+      if (bin >= histogram.size ())
+        {
+          histogram.resize (bin + 1);
+        }
+      histogram[bin] += Simulator::Now () - m_lastOccupancyChange;
+    }
+  return histogram;
+}
+
+void
+Queue::RecordOccupancy (void)
+{
+  uint32_t bin = m_nPackets / m_histogramBinWidth;
+  if (bin >= m_histogram.size ())
+    {
+      m_histogram.resize (bin + 1);
+    }
+  Time now = Simulator::Now ();
+  m_histogram[bin] += now - m_lastOccupancyChange;
+  m_lastOccupancyChange = now;
 }
 
 void
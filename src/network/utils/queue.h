@@ -26,8 +26,10 @@
 
 #include <string>
 #include <list>
+#include <vector>
 #include "ns3/packet.h"
 #include "ns3/object.h"
+#include "ns3/nstime.h"
 #include "ns3/traced-callback.h"
 
 namespace ns3 {
@@ -65,6 +67,14 @@ public:
    * \return 0 if the operation was not successful; the packet otherwise.
    */
   Ptr<Packet> Dequeue (void);
+  /**
+   * Remove up to n packets from the front of the Queue, e.g., to
+   * transmit a burst of packets.
+   * \param n the maximum number of packets to remove
+   * \param packets the vector to which the packets are appended, in order
+   * \return the number of packets removed
+   */
+  uint32_t DequeueBatch (uint32_t n, std::vector<Ptr<Packet> > &packets);
   /**
    * Get a copy of the item at the front of the queue without removing it
    * \return 0 if the operation was not successful; the packet otherwise.
@@ -115,6 +125,20 @@ public:
    */
   void ResetStatistics (void);
 
+  /**
+   * Start recording how long the Queue holds each number of packets.
+   * The histogram is reset by ResetStatistics.
+   * \param binWidth the number of consecutive queue lengths which are
+   * accumulated in the same bin of the histogram
+   */
+  void EnableOccupancyHistogram (uint32_t binWidth = 1);
+  /**
+   * \return the time spent by the Queue with a number of packets in
+   * [i * binWidth, (i + 1) * binWidth) for each bin i, up to the current
+   * simulation time.  The vector is empty if the histogram is not enabled.
+   */
+  std::vector<Time> GetOccupancyHistogram (void) const;
+
 #if 0
   // average calculation requires keeping around
   // a buffer with the date of arrival of past received packets
@@ -150,9 +174,17 @@ protected:
   void Drop (Ptr<Packet> packet);
 
 private:
+  // accumulate the time spent with the current number of packets, if
+  // the histogram is enabled.
+  void RecordOccupancy (void);
+
   TracedCallback<Ptr<const Packet> > m_traceEnqueue;
   TracedCallback<Ptr<const Packet> > m_traceDequeue;
   TracedCallback<Ptr<const Packet> > m_traceDrop;
+  // (old, new) occupancy: the counters below stay plain integers, such
+  // that the occupancy costs nothing when no sink is connected.
+  TracedCallback<uint32_t, uint32_t> m_tracePacketsInQueue;
+  TracedCallback<uint32_t, uint32_t> m_traceBytesInQueue;
 
   uint32_t m_nBytes;
   uint32_t m_nTotalReceivedBytes;
@@ -160,6 +192,10 @@ private:
   uint32_t m_nTotalReceivedPackets;
   uint32_t m_nTotalDroppedBytes;
   uint32_t m_nTotalDroppedPackets;
+
+  uint32_t m_histogramBinWidth; // 0 if the histogram is disabled
+  std::vector<Time> m_histogram;
+  Time m_lastOccupancyChange;
 };
 
 } // namespace ns3
@@ -67,6 +67,7 @@
 #include "ns3/double.h"
 #include "ns3/simulator.h"
 #include "ns3/abort.h"
+#include <algorithm>
 #include "red-queue.h"
 
 NS_LOG_COMPONENT_DEFINE ("RedQueue");
@@ -223,7 +224,7 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
   else if (GetMode () == PACKETS)
     {
       NS_LOG_DEBUG ("Enqueue in packets mode");
-      nQueued = m_packets.size ();
+      nQueued = m_packets.GetSize ();
     }
 
   // simulate number of packets arrival during idle period
@@ -250,7 +251,7 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
   m_qAvg = Estimator (nQueued, m + 1, m_qAvg, m_qW);
 
   NS_LOG_DEBUG ("\t bytesInQueue  " << m_bytesInQueue << "\tQavg " << m_qAvg);
-  NS_LOG_DEBUG ("\t packetsInQueue  " << m_packets.size () << "\tQavg " << m_qAvg);
+  NS_LOG_DEBUG ("\t packetsInQueue  " << m_packets.GetSize () << "\tQavg " << m_qAvg);
 
   m_count++;
   m_countBytes += p->GetSize ();
@@ -317,9 +318,9 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
     }
 
   m_bytesInQueue += p->GetSize ();
-  m_packets.push_back (p);
+  m_packets.PushBack (p);
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetSize ());
   NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
 
   return true;
@@ -342,6 +343,8 @@ RedQueue::InitializeParams (void)
   m_stats.qLimDrop = 0;
 
   m_cautious = 0;
+  // in bytes mode, the ring grows when it is full.
+  m_packets.Reserve (GetMode () == PACKETS ? std::min<uint32_t> (m_queueLimit, 4096) : 16);
   m_ptc = m_linkBandwidth.GetBitRate () / (8.0 * m_meanPktSize);
 
   m_qAvg = 0.0;
@@ -595,7 +598,7 @@ RedQueue::GetQueueSize (void)
     }
   else if (GetMode () == PACKETS)
     {
-      return m_packets.size ();
+      return m_packets.GetSize ();
     }
   else
     {
@@ -608,7 +611,7 @@ RedQueue::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       m_idle = 1;
@@ -619,13 +622,12 @@ RedQueue::DoDequeue (void)
   else
     {
       m_idle = 0;
-      Ptr<Packet> p = m_packets.front ();
-      m_packets.pop_front ();
+      Ptr<Packet> p = m_packets.PopFront ();
       m_bytesInQueue -= p->GetSize ();
 
       NS_LOG_LOGIC ("Popped " << p);
 
-      NS_LOG_LOGIC ("Number packets " << m_packets.size ());
+      NS_LOG_LOGIC ("Number packets " << m_packets.GetSize ());
       NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
 
       return p;
@@ -636,15 +638,15 @@ Ptr<const Packet>
 RedQueue::DoPeek (void) const
 {
   NS_LOG_FUNCTION (this);
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       return 0;
     }
 
-  Ptr<Packet> p = m_packets.front ();
+  Ptr<Packet> p = m_packets.Front ();
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetSize ());
   NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
 
   return p;
@@ -66,7 +66,7 @@
 #ifndef RED_QUEUE_H
 #define RED_QUEUE_H
 
-#include <queue>
+#include "ns3/packet-ring.h"
 #include "ns3/packet.h"
 #include "ns3/queue.h"
 #include "ns3/nstime.h"
@@ -201,7 +201,7 @@ private:
   double ModifyP (double p, uint32_t count, uint32_t countBytes,
                   uint32_t meanPktSize, bool wait, uint32_t size);
 
-  std::list<Ptr<Packet> > m_packets;
+  PacketRing m_packets;
 
   uint32_t m_bytesInQueue;
   bool m_hasRedStarted;
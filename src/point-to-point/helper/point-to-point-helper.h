@@ -88,6 +88,16 @@ public:
    */
   void SetDeviceAttribute (std::string name, const AttributeValue &value);
 
+  /**
+   * \param nQueues the number of queues of each device
+   *
+   * Set the number of queues, of the type set by
+   * PointToPointHelper::SetQueue, created for each
+   * ns3::PointToPointNetDevice by PointToPointHelper::Install.  The
+   * default is a single queue.
+   */
+  void SetNQueues (uint32_t nQueues);
+
   /**
    * Set an attribute value to be propagated to each Channel created by the
    * helper.
@@ -181,6 +191,7 @@ private:
   ObjectFactory m_channelFactory;
   ObjectFactory m_remoteChannelFactory;
   ObjectFactory m_deviceFactory;
+  uint32_t m_nQueues;
 };
 
 } // namespace ns3
@@ -16,6 +16,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include "ns3/log.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
@@ -24,6 +25,7 @@
 #include "ns3/error-model.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
+#include "ns3/enum.h"
 #include "ns3/pointer.h"
 #include "ns3/mpi-interface.h"
 #include "point-to-point-net-device.h"
@@ -75,9 +77,32 @@ PointToPointNetDevice::GetTypeId (void)
     .AddAttribute ("TxQueue", 
                    "A queue to use as the transmit queue in the device.",
                    PointerValue (),
-                   MakePointerAccessor (&PointToPointNetDevice::m_queue),
+                   MakePointerAccessor (&PointToPointNetDevice::SetQueue,
+                                        static_cast<Ptr<Queue> (PointToPointNetDevice::*)(void) const> (&PointToPointNetDevice::GetQueue)),
                    MakePointerChecker<Queue> ())
 
+    //
+    // Link aggregation: the sub-links transmit at once, from the queues
+    // picked by the scheduler.
+    //
+    .AddAttribute ("SubLinks", 
+                   "The number of sub-links the device transmits on at once, each at the data rate of the device.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&PointToPointNetDevice::SetNSubLinks,
+                                         &PointToPointNetDevice::GetNSubLinks),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Scheduler", 
+                   "The scheduler which picks the queue a free sub-link transmits from.",
+                   EnumValue (ROUND_ROBIN),
+                   MakeEnumAccessor (&PointToPointNetDevice::m_scheduler),
+                   MakeEnumChecker (ROUND_ROBIN, "RoundRobin",
+                                    DRR, "Drr"))
+    .AddAttribute ("Quantum", 
+                   "The number of bytes a queue may transmit in a round of the Drr scheduler.",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&PointToPointNetDevice::m_quantum),
+                   MakeUintegerChecker<uint32_t> (1))
+
     //
     // Trace sources at the "top" of the net device, where packets transition
     // to/from higher layers.
@@ -144,12 +169,30 @@ PointToPointNetDevice::GetTypeId (void)
 }
 
 
+PointToPointNetDevice::SubLink::SubLink ()
+  : txMachineState (READY),
+    currentPkt (0),
+    queue (0)
+{
+}
+
+PointToPointNetDevice::TxQueue::TxQueue ()
+  : queue (0),
+    transmitting (false),
+    deficit (0),
+    nTxPackets (0),
+    nTxBytes (0)
+{
+}
+
 PointToPointNetDevice::PointToPointNetDevice () 
   :
-    m_txMachineState (READY),
+    m_subLinks (1),
     m_channel (0),
-    m_linkUp (false),
-    m_currentPkt (0)
+    m_queues (1),
+    m_nextQueue (0),
+    m_quantumGiven (false),
+    m_linkUp (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -185,7 +228,10 @@ PointToPointNetDevice::DoDispose ()
   m_node = 0;
   m_channel = 0;
   m_receiveErrorModel = 0;
-  m_currentPkt = 0;
+  for (std::vector<SubLink>::iterator i = m_subLinks.begin (); i != m_subLinks.end (); ++i)
+    {
+      i->currentPkt = 0;
+    }
   NetDevice::DoDispose ();
 }
 
@@ -203,10 +249,28 @@ PointToPointNetDevice::SetInterframeGap (Time t)
   m_tInterframeGap = t;
 }
 
+void
+PointToPointNetDevice::SetNSubLinks (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ASSERT_MSG (n > 0, "PointToPointNetDevice::SetNSubLinks(): at least one sub-link is needed");
+  for (std::vector<SubLink>::const_iterator i = m_subLinks.begin (); i != m_subLinks.end (); ++i)
+    {
+      NS_ASSERT_MSG (i->txMachineState == READY, "PointToPointNetDevice::SetNSubLinks(): a packet is being transmitted");
+    }
+  m_subLinks.resize (n);
+}
+
+uint32_t
+PointToPointNetDevice::GetNSubLinks (void) const
+{
+  return m_subLinks.size ();
+}
+
 bool
-PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
+PointToPointNetDevice::TransmitStart (Ptr<Packet> p, uint32_t subLink, uint32_t queue)
 {
-  NS_LOG_FUNCTION (this << p);
+  NS_LOG_FUNCTION (this << p << subLink << queue);
   NS_LOG_LOGIC ("UID is " << p->GetUid () << ")");
 
   //
@@ -214,16 +278,21 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   // We need to tell the channel that we've started wiggling the wire and
   // schedule an event that will be executed when the transmission is complete.
   //
-  NS_ASSERT_MSG (m_txMachineState == READY, "Must be READY to transmit");
-  m_txMachineState = BUSY;
-  m_currentPkt = p;
-  m_phyTxBeginTrace (m_currentPkt);
+  SubLink &link = m_subLinks[subLink];
+  NS_ASSERT_MSG (link.txMachineState == READY, "Must be READY to transmit");
+  link.txMachineState = BUSY;
+  link.currentPkt = p;
+  link.queue = queue;
+  m_queues[queue].transmitting = true;
+  m_queues[queue].nTxPackets++;
+  m_queues[queue].nTxBytes += p->GetSize ();
+  m_phyTxBeginTrace (p);
 
   Time txTime = Seconds (m_bps.CalculateTxTime (p->GetSize ()));
   Time txCompleteTime = txTime + m_tInterframeGap;
 
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
-  Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+  Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this, subLink);
 
   bool result = m_channel->TransmitStart (p, this, txTime);
   if (result == false)
@@ -234,39 +303,179 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
 }
 
 void
-PointToPointNetDevice::TransmitComplete (void)
+PointToPointNetDevice::TransmitComplete (uint32_t subLink)
 {
-  NS_LOG_FUNCTION_NOARGS ();
+  NS_LOG_FUNCTION (this << subLink);
 
   //
   // This function is called to when we're all done transmitting a packet.
-  // We try and pull another packet off of the transmit queue.  If the queue
-  // is empty, we are done, otherwise we need to start transmitting the
-  // next packet.
+  // We try and pull another packet off of the transmit queues.  If the
+  // queues are empty, we are done, otherwise we need to start transmitting
+  // the next packet.
   //
-  NS_ASSERT_MSG (m_txMachineState == BUSY, "Must be BUSY if transmitting");
-  m_txMachineState = READY;
+  SubLink &link = m_subLinks[subLink];
+  NS_ASSERT_MSG (link.txMachineState == BUSY, "Must be BUSY if transmitting");
+  link.txMachineState = READY;
+
+  NS_ASSERT_MSG (link.currentPkt != 0, "PointToPointNetDevice::TransmitComplete(): currentPkt zero");
 
-  NS_ASSERT_MSG (m_currentPkt != 0, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
+  m_phyTxEndTrace (link.currentPkt);
+  link.currentPkt = 0;
+  m_queues[link.queue].transmitting = false;
 
-  m_phyTxEndTrace (m_currentPkt);
-  m_currentPkt = 0;
+  TransmitNext (subLink);
+}
 
-  Ptr<Packet> p = m_queue->Dequeue ();
-  if (p == 0)
+bool
+PointToPointNetDevice::TransmitNext (uint32_t subLink)
+{
+  NS_LOG_FUNCTION (this << subLink);
+  uint32_t queue = SelectQueue ();
+  if (queue == m_queues.size ())
     {
       //
-      // No packet was on the queue, so we just exit.
+      // No packet may be transmitted, so we just exit.
       //
-      return;
+      return true;
     }
 
   //
-  // Got another packet off of the queue, so start the transmit process agin.
+  // Got another packet off of a queue, so start the transmit process again.
   //
+  Ptr<Packet> p = m_queues[queue].queue->Dequeue ();
   m_snifferTrace (p);
   m_promiscSnifferTrace (p);
-  TransmitStart (p);
+  return TransmitStart (p, subLink, queue);
+}
+
+uint32_t
+PointToPointNetDevice::SelectQueue (void)
+{
+  uint32_t n = m_queues.size ();
+  bool ready = false;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (!m_queues[i].transmitting && !m_queues[i].queue->IsEmpty ())
+        {
+          ready = true;
+          break;
+        }
+    }
+  if (!ready)
+    {
+      return n;
+    }
+
+  if (m_scheduler == ROUND_ROBIN)
+    {
+      for (uint32_t k = 0; k < n; k++)
+        {
+          uint32_t i = (m_nextQueue + k) % n;
+          if (!m_queues[i].transmitting && !m_queues[i].queue->IsEmpty ())
+            {
+              m_nextQueue = (i + 1) % n;
+              return i;
+            }
+        }
+      NS_ASSERT (false);
+      return n;
+    }
+
+  //
+  // Deficit round robin: the queue the scheduler is on is given its quantum
+  // once per round, and transmits as long as its head packet fits in its
+  // deficit.  Since a ready queue gets a quantum every round, this ends.
+  //
+  while (true)
+    {
+      TxQueue &q = m_queues[m_nextQueue];
+      if (q.queue->IsEmpty ())
+        {
+          q.deficit = 0;
+        }
+      else if (!q.transmitting)
+        {
+          if (!m_quantumGiven)
+            {
+              q.deficit += m_quantum;
+              m_quantumGiven = true;
+            }
+          uint32_t size = q.queue->Peek ()->GetSize ();
+          if (size <= q.deficit)
+            {
+              q.deficit -= size;
+              return m_nextQueue;
+            }
+        }
+      m_nextQueue = (m_nextQueue + 1) % n;
+      m_quantumGiven = false;
+    }
+  return n;
+}
+
+uint32_t
+PointToPointNetDevice::GetReadySubLink (void) const
+{
+  for (uint32_t i = 0; i < m_subLinks.size (); i++)
+    {
+      if (m_subLinks[i].txMachineState == READY)
+        {
+          return i;
+        }
+    }
+  return m_subLinks.size ();
+}
+
+uint32_t
+PointToPointNetDevice::HashFlow (Ptr<const Packet> p, uint16_t protocolNumber)
+{
+  uint8_t scratch[64];
+  uint32_t size = std::min (p->GetSize (), static_cast<uint32_t> (sizeof (scratch)));
+  uint8_t const *buffer = p->PeekBytes (size, scratch);
+  // the protocol and the addresses, then the ports.
+  uint8_t key[40];
+  uint32_t n = 0;
+  uint32_t transport = 0;
+  if (protocolNumber == 0x0800 && size >= 20)
+    {
+      key[n++] = buffer[9];
+      memcpy (key + n, buffer + 12, 8);
+      n += 8;
+      // all the fragments of a datagram belong to the same flow.
+      bool fragment = (buffer[6] & 0x3f) != 0 || buffer[7] != 0;
+      if (!fragment && (buffer[9] == 6 || buffer[9] == 17))
+        {
+          transport = (buffer[0] & 0x0f) * 4;
+        }
+    }
+  else if (protocolNumber == 0x86DD && size >= 40)
+    {
+      key[n++] = buffer[6];
+      memcpy (key + n, buffer + 8, 32);
+      n += 32;
+      if (buffer[6] == 6 || buffer[6] == 17)
+        {
+          transport = 40;
+        }
+    }
+  else
+    {
+      return 0;
+    }
+  if (transport != 0 && size >= transport + 4)
+    {
+      memcpy (key + n, buffer + transport, 4);
+      n += 4;
+    }
+
+  // 32 bit FNV-1a
+  uint32_t hash = 2166136261U;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      hash ^= key[i];
+      hash *= 16777619U;
+    }
+  return hash;
 }
 
 bool
@@ -291,7 +500,48 @@ void
 PointToPointNetDevice::SetQueue (Ptr<Queue> q)
 {
   NS_LOG_FUNCTION (this << q);
-  m_queue = q;
+  m_queues[0].queue = q;
+}
+
+void
+PointToPointNetDevice::AddQueue (Ptr<Queue> q)
+{
+  NS_LOG_FUNCTION (this << q);
+  if (m_queues[0].queue == 0)
+    {
+      m_queues[0].queue = q;
+      return;
+    }
+  TxQueue queue;
+  queue.queue = q;
+  m_queues.push_back (queue);
+}
+
+uint32_t
+PointToPointNetDevice::GetNQueues (void) const
+{
+  return m_queues.size ();
+}
+
+Ptr<Queue>
+PointToPointNetDevice::GetQueue (uint32_t i) const
+{
+  NS_ASSERT (i < m_queues.size ());
+  return m_queues[i].queue;
+}
+
+uint64_t
+PointToPointNetDevice::GetNTxPackets (uint32_t i) const
+{
+  NS_ASSERT (i < m_queues.size ());
+  return m_queues[i].nTxPackets;
+}
+
+uint64_t
+PointToPointNetDevice::GetNTxBytes (uint32_t i) const
+{
+  NS_ASSERT (i < m_queues.size ());
+  return m_queues[i].nTxBytes;
 }
 
 void
@@ -349,7 +599,7 @@ Ptr<Queue>
 PointToPointNetDevice::GetQueue (void) const
 { 
   NS_LOG_FUNCTION_NOARGS ();
-  return m_queue;
+  return m_queues[0].queue;
 }
 
 void
@@ -479,6 +729,15 @@ PointToPointNetDevice::Send (
       return false;
     }
 
+  //
+  // Spread the flows over the queues.
+  //
+  uint32_t queue = 0;
+  if (m_queues.size () > 1)
+    {
+      queue = HashFlow (packet, protocolNumber) % m_queues.size ();
+    }
+
   //
   // Stick a point to point protocol header on the packet in preparation for
   // shoving it out the door.
@@ -488,21 +747,19 @@ PointToPointNetDevice::Send (
   m_macTxTrace (packet);
 
   //
-  // If there's a transmission in progress, we enque the packet for later
-  // transmission; otherwise we send it now.
+  // If there's a transmission in progress on every sub-link, we enque the
+  // packet for later transmission; otherwise we send it now.
   //
-  if (m_txMachineState == READY) 
+  uint32_t subLink = GetReadySubLink ();
+  if (subLink < m_subLinks.size ())
     {
       // 
       // Even if the transmitter is immediately available, we still enqueue and
       // dequeue the packet to hit the tracing hooks.
       //
-      if (m_queue->Enqueue (packet) == true)
+      if (m_queues[queue].queue->Enqueue (packet) == true)
         {
-          packet = m_queue->Dequeue ();
-          m_snifferTrace (packet);
-          m_promiscSnifferTrace (packet);
-          return TransmitStart (packet);
+          return TransmitNext (subLink);
         }
       else
         {
@@ -513,7 +770,7 @@ PointToPointNetDevice::Send (
     }
   else
     {
-      return m_queue->Enqueue (packet);
+      return m_queues[queue].queue->Enqueue (packet);
     }
 }
 
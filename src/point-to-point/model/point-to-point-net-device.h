@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_NET_DEVICE_H
 
 #include <string.h>
+#include <vector>
 #include "ns3/address.h"
 #include "ns3/node.h"
 #include "ns3/net-device.h"
@@ -54,12 +55,32 @@ class ErrorModel;
  * Key parameters or objects that can be specified for this device 
  * include a queue, data rate, and interframe transmission gap (the 
  * propagation delay is set in the PointToPointChannel).
+ *
+ * The device may also model a trunk of bonded links: it then transmits
+ * on several sub-links at once, each at the data rate of the device,
+ * from several queues.  The packets are spread over the queues by a hash
+ * of their flow (the addresses, the protocol and the ports of the IPv4
+ * or IPv6 header), and a sub-link which becomes free picks the next
+ * queue to serve round robin, or with deficit round robin.  A queue is
+ * served by a single sub-link at a time, such that the packets of a
+ * flow are never reordered.  With a single queue and a single sub-link,
+ * the default, the device behaves as a plain serial link.
  */
 class PointToPointNetDevice : public NetDevice
 {
 public:
   static TypeId GetTypeId (void);
 
+  /**
+   * Enumeration of the schedulers which pick the queue a free sub-link
+   * transmits from.
+   */
+  enum SchedulerType
+  {
+    ROUND_ROBIN, /**< One packet from each queue in turn */
+    DRR          /**< Deficit round robin: Quantum bytes from each queue in turn */
+  };
+
   /**
    * Construct a PointToPointNetDevice
    *
@@ -120,6 +141,53 @@ public:
    */
   Ptr<Queue> GetQueue (void) const;
 
+  /**
+   * Attach one more transmit queue to the PointToPointNetDevice.  The
+   * flows are hashed over all the queues attached.  If the device has
+   * no queue yet, the queue becomes its first queue.
+   *
+   * @param queue Ptr to the new queue.
+   */
+  void AddQueue (Ptr<Queue> queue);
+
+  /**
+   * @returns the number of transmit queues of the device.
+   */
+  uint32_t GetNQueues (void) const;
+
+  /**
+   * @param i index of the queue
+   * @returns the i-th transmit queue of the device.
+   */
+  Ptr<Queue> GetQueue (uint32_t i) const;
+
+  /**
+   * @param i index of the queue
+   * @returns the number of packets of the i-th queue which were
+   *          transmitted.
+   */
+  uint64_t GetNTxPackets (uint32_t i) const;
+
+  /**
+   * @param i index of the queue
+   * @returns the number of bytes of the i-th queue which were
+   *          transmitted.
+   */
+  uint64_t GetNTxBytes (uint32_t i) const;
+
+  /**
+   * Set the number of sub-links the device transmits on at once.  It
+   * must not be changed while a packet is being transmitted.
+   *
+   * @param n the number of sub-links, at least one
+   */
+  void SetNSubLinks (uint32_t n);
+
+  /**
+   * @returns the number of sub-links of the device.
+   */
+  uint32_t GetNSubLinks (void) const;
+
   /**
    * Attach a receive ErrorModel to the PointToPointNetDevice.
    *
@@ -234,17 +302,53 @@ private:
    * @see PointToPointChannel::TransmitStart ()
    * @see TransmitCompleteEvent ()
    * @param p a reference to the packet to send
+   * @param subLink the sub-link to transmit on
+   * @param queue the queue the packet was dequeued from
    * @returns true if success, false on failure
    */
-  bool TransmitStart (Ptr<Packet> p);
+  bool TransmitStart (Ptr<Packet> p, uint32_t subLink, uint32_t queue);
 
   /**
    * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
    *
    * The TransmitComplete method is used internally to finish the process
    * of sending a packet out on the channel.
+   *
+   * @param subLink the sub-link the packet was transmitted on
+   */
+  void TransmitComplete (uint32_t subLink);
+
+  /**
+   * Dequeue the next packet to transmit, if any, and start transmitting
+   * it on a free sub-link.
+   *
+   * @param subLink the free sub-link
+   * @returns the result of TransmitStart, or true if there was no packet
+   *          to transmit
+   */
+  bool TransmitNext (uint32_t subLink);
+
+  /**
+   * @returns the index of the queue to transmit the next packet from,
+   *          or the number of queues if no queue may be served: a queue
+   *          may be served if it is not empty and none of its packets is
+   *          being transmitted.
    */
-  void TransmitComplete (void);
+  uint32_t SelectQueue (void);
+
+  /**
+   * @returns the index of a free sub-link, or the number of sub-links if
+   *          they are all busy.
+   */
+  uint32_t GetReadySubLink (void) const;
+
+  /**
+   * @param p packet to send, without the PPP header
+   * @param protocolNumber protocol number of the packet
+   * @returns a hash of the addresses, the protocol and the ports of the
+   *          packet, if it is an IPv4 or IPv6 packet, and zero otherwise.
+   */
+  static uint32_t HashFlow (Ptr<const Packet> p, uint16_t protocolNumber);
 
   void NotifyLinkUp (void);
 
@@ -256,11 +360,39 @@ private:
     READY,   /**< The transmitter is ready to begin transmission of a packet */
     BUSY     /**< The transmitter is busy transmitting a packet */
   };
+
   /**
-   * The state of the Net Device transmit state machine.
-   * @see TxMachineState
+   * The transmit state machine of a sub-link.
    */
-  TxMachineState m_txMachineState;
+  struct SubLink
+  {
+    SubLink ();
+    /**
+     * The state of the transmit state machine.
+     * @see TxMachineState
+     */
+    TxMachineState txMachineState;
+    Ptr<Packet> currentPkt;
+    // the queue currentPkt was dequeued from.
+    uint32_t queue;
+  };
+
+  /**
+   * A transmit queue and its scheduling state.
+   */
+  struct TxQueue
+  {
+    TxQueue ();
+    Ptr<Queue> queue;
+    // true if a packet of the queue is being transmitted.
+    bool transmitting;
+    // the bytes the queue may still transmit in this round of DRR.
+    uint32_t deficit;
+    uint64_t nTxPackets;
+    uint64_t nTxBytes;
+  };
+
+  std::vector<SubLink> m_subLinks;
 
   /**
    * The data rate that the Net Device uses to simulate packet transmission
@@ -284,13 +416,34 @@ private:
   Ptr<PointToPointChannel> m_channel;
 
   /**
-   * The Queue which this PointToPointNetDevice uses as a packet source.
-   * Management of this Queue has been delegated to the PointToPointNetDevice
+   * The Queues which this PointToPointNetDevice uses as a packet source.
+   * Management of these Queues has been delegated to the PointToPointNetDevice
    * and it has the responsibility for deletion.
    * @see class Queue
    * @see class DropTailQueue
    */
-  Ptr<Queue> m_queue;
+  std::vector<TxQueue> m_queues;
+
+  /**
+   * The scheduler between the queues.
+   * @see SchedulerType
+   */
+  SchedulerType m_scheduler;
+
+  /**
+   * The bytes a queue may transmit in a round of DRR.
+   */
+  uint32_t m_quantum;
+
+  /**
+   * The queue the scheduler serves next.
+   */
+  uint32_t m_nextQueue;
+
+  /**
+   * True if the queue the scheduler serves next was given its quantum.
+   */
+  bool m_quantumGiven;
 
   /**
    * Error model for receive packet events
@@ -449,8 +602,6 @@ private:
    */
   uint32_t m_mtu;
 
-  Ptr<Packet> m_currentPkt;
-
   /**
    * \brief PPP to Ethernet protocol number mapping
    * \param protocol A PPP protocol number
@@ -20,6 +20,7 @@
 #define PPP_HEADER_H
 
 #include "ns3/header.h"
+#include "ns3/header-layout.h"
 
 namespace ns3 {
 
@@ -84,6 +85,18 @@ public:
    */
   uint16_t GetProtocol (void);
 
+  /**
+   * \brief The fields of a serialized header
+   *
+   * Used to read the protocol of a frame without deserializing its
+   * header, see Packet::PeekBytes.
+   */
+  struct Layout
+  {
+    enum { SIZE = 2 };
+    typedef HeaderField<0, uint16_t> Protocol;
+  };
+
 private:
 
   /**
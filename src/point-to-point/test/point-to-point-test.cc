@@ -3,6 +3,10 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/ppp-header.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -55,6 +59,228 @@ PointToPointTest::DoRun (void)
 
   Simulator::Destroy ();
 }
+
+class PointToPointTrunkTest : public TestCase
+{
+public:
+  PointToPointTrunkTest ();
+
+  virtual void DoRun (void);
+
+private:
+  void Setup (uint32_t nSubLinks, uint32_t nQueues);
+  // an IPv4 UDP packet of the given size, PPP header included, whose
+  // payload starts with id.
+  Ptr<Packet> CreateUdpPacket (uint32_t size, uint16_t sourcePort, uint8_t id);
+  void SendPacket (Ptr<Packet> p);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+  void CheckFlows (void);
+  void CheckOrder (void);
+  void CheckDrr (PointToPointNetDevice::SchedulerType scheduler, uint32_t nLarge);
+
+  Ptr<PointToPointNetDevice> m_devA;
+  Ptr<PointToPointNetDevice> m_devB;
+  std::vector<Ptr<const Packet> > m_received;
+  std::vector<Time> m_receivedTime;
+};
+
+PointToPointTrunkTest::PointToPointTrunkTest ()
+  : TestCase ("PointToPoint sub-links and queues")
+{
+}
+
+void
+PointToPointTrunkTest::Setup (uint32_t nSubLinks, uint32_t nQueues)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  m_devA = CreateObject<PointToPointNetDevice> ();
+  m_devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  // 1000 bytes in 1ms.
+  m_devA->SetDataRate (DataRate ("8Mbps"));
+  m_devA->SetNSubLinks (nSubLinks);
+  m_devA->Attach (channel);
+  m_devA->SetAddress (Mac48Address::Allocate ());
+  for (uint32_t i = 0; i < nQueues; i++)
+    {
+      m_devA->AddQueue (CreateObject<DropTailQueue> ());
+    }
+  m_devB->Attach (channel);
+  m_devB->SetAddress (Mac48Address::Allocate ());
+  m_devB->SetQueue (CreateObject<DropTailQueue> ());
+
+  a->AddDevice (m_devA);
+  b->AddDevice (m_devB);
+  // replaces the callback set by the node.
+  m_devB->SetReceiveCallback (MakeCallback (&PointToPointTrunkTest::Receive, this));
+  m_received.clear ();
+  m_receivedTime.clear ();
+}
+
+Ptr<Packet>
+PointToPointTrunkTest::CreateUdpPacket (uint32_t size, uint16_t sourcePort, uint8_t id)
+{
+  uint8_t buffer[1000];
+  memset (buffer, 0, sizeof (buffer));
+  buffer[0] = 0x45;
+  buffer[9] = 17;
+  buffer[12] = 10;
+  buffer[15] = 1;
+  buffer[16] = 10;
+  buffer[19] = 2;
+  buffer[20] = sourcePort >> 8;
+  buffer[21] = sourcePort & 0xff;
+  buffer[23] = 9;
+  buffer[28] = id;
+  return Create<Packet> (buffer, size - 2);
+}
+
+void
+PointToPointTrunkTest::SendPacket (Ptr<Packet> p)
+{
+  m_devA->Send (p, m_devA->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointTrunkTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  m_received.push_back (p);
+  m_receivedTime.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+PointToPointTrunkTest::CheckFlows (void)
+{
+  // sixteen flows over two sub-links.
+  Setup (2, 2);
+  for (uint32_t i = 0; i < 16; i++)
+    {
+      Simulator::Schedule (Seconds (1.0), &PointToPointTrunkTest::SendPacket, this,
+                           CreateUdpPacket (1000, 1000 + i, i));
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 16, "All the packets were received");
+  NS_TEST_EXPECT_MSG_EQ (m_devA->GetNTxPackets (0) + m_devA->GetNTxPackets (1), 16, "All the packets were transmitted");
+  NS_TEST_EXPECT_MSG_EQ (m_devA->GetNTxBytes (0) + m_devA->GetNTxBytes (1), 16000, "All the bytes were transmitted");
+  NS_TEST_EXPECT_MSG_NE (m_devA->GetNTxPackets (0), 0, "The flows were spread over the queues");
+  NS_TEST_EXPECT_MSG_NE (m_devA->GetNTxPackets (1), 0, "The flows were spread over the queues");
+  NS_TEST_EXPECT_MSG_LT (m_receivedTime.back ().GetSeconds (), 1.016, "The sub-links transmitted at once");
+  Simulator::Destroy ();
+}
+
+void
+PointToPointTrunkTest::CheckOrder (void)
+{
+  // a single flow is transmitted on a single sub-link at a time.
+  Setup (2, 2);
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      Simulator::Schedule (Seconds (1.0), &PointToPointTrunkTest::SendPacket, this,
+                           CreateUdpPacket (i % 2 ? 100 : 1000, 1000, i));
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 8, "All the packets were received");
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      uint8_t buffer[29];
+      m_received[i]->CopyData (buffer, 29);
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)buffer[28], i, "The packets of the flow were received in order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_devA->GetNTxPackets (0) * m_devA->GetNTxPackets (1), 0, "The flow was hashed to one queue");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_receivedTime.back ().GetSeconds (), 1.0044, 1e-6, "The packets were transmitted one after the other");
+  Simulator::Destroy ();
+}
+
+void
+PointToPointTrunkTest::CheckDrr (PointToPointNetDevice::SchedulerType scheduler, uint32_t nLarge)
+{
+  // small packets in the first queue, large packets in the second one.
+  Setup (1, 2);
+  m_devA->SetAttribute ("Scheduler", EnumValue (scheduler));
+  m_devA->SetAttribute ("Quantum", UintegerValue (1000));
+  PppHeader ppp;
+  ppp.SetProtocol (0x0021);
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (248);
+      p->AddHeader (ppp);
+      m_devA->GetQueue (0)->Enqueue (p);
+    }
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (998);
+      p->AddHeader (ppp);
+      m_devA->GetQueue (1)->Enqueue (p);
+    }
+  // too short to be hashed: it goes to the first queue.
+  Simulator::Schedule (Seconds (1.0), &PointToPointTrunkTest::SendPacket, this, Create<Packet> (10));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 51, "All the packets were received");
+  uint32_t large = 0;
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      if (m_received[i]->GetSize () == 998)
+        {
+          large++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (large, nLarge, "The share of the large packets");
+  NS_TEST_EXPECT_MSG_EQ (m_devA->GetNTxBytes (0), 40 * 250 + 12, "The bytes of the first queue");
+  NS_TEST_EXPECT_MSG_EQ (m_devA->GetNTxBytes (1), 10 * 1000, "The bytes of the second queue");
+  Simulator::Destroy ();
+}
+
+void
+PointToPointTrunkTest::DoRun (void)
+{
+  CheckFlows ();
+  CheckOrder ();
+  // round robin shares packets, deficit round robin shares bytes.
+  CheckDrr (PointToPointNetDevice::ROUND_ROBIN, 10);
+  CheckDrr (PointToPointNetDevice::DRR, 4);
+}
+//-----------------------------------------------------------------------------
+class PppHeaderLayoutTest : public TestCase
+{
+public:
+  PppHeaderLayoutTest ();
+
+  virtual void DoRun (void);
+};
+
+PppHeaderLayoutTest::PppHeaderLayoutTest ()
+  : TestCase ("PPP Header fields read without deserialization")
+{
+}
+
+void
+PppHeaderLayoutTest::DoRun (void)
+{
+  // IPv4 and IPv6
+  uint16_t protocols[2] = { 0x0021, 0x0057 };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      PppHeader header;
+      header.SetProtocol (protocols[i]);
+      Ptr<Packet> p = Create<Packet> (100);
+      p->AddHeader (header);
+
+      uint8_t scratch[PppHeader::Layout::SIZE];
+      uint8_t const *bytes = p->PeekBytes (PppHeader::Layout::SIZE, scratch);
+      uint32_t protocol = PppHeader::Layout::Protocol::Read (bytes);
+      NS_TEST_EXPECT_MSG_EQ (protocol, protocols[i], "protocol");
+
+      PppHeader deserialized;
+      p->PeekHeader (deserialized);
+      NS_TEST_EXPECT_MSG_EQ (protocol, deserialized.GetProtocol (), "deserialized protocol");
+    }
+}
 //-----------------------------------------------------------------------------
 class PointToPointTestSuite : public TestSuite
 {
@@ -66,6 +292,8 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest);
+  AddTestCase (new PointToPointTrunkTest);
+  AddTestCase (new PppHeaderLayoutTest);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite;
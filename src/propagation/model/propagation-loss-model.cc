@@ -26,6 +26,8 @@
 #include "ns3/mobility-model.h"
 #include "ns3/boolean.h"
 #include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
 #include <math.h>
 
 NS_LOG_COMPONENT_DEFINE ("PropagationLossModel");
@@ -73,6 +75,12 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
   return self;
 }
 
+bool
+PropagationLossModel::IsDeterministic (void) const
+{
+  return false;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (RandomPropagationLossModel);
@@ -193,6 +201,12 @@ FriisPropagationLossModel::DbmFromW (double w) const
   return dbm;
 }
 
+bool
+FriisPropagationLossModel::IsDeterministic (void) const
+{
+  return true;
+}
+
 double 
 FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                           Ptr<MobilityModel> a,
@@ -334,6 +348,12 @@ TwoRayGroundPropagationLossModel::DbmFromW (double w) const
   return dbm;
 }
 
+bool
+TwoRayGroundPropagationLossModel::IsDeterministic (void) const
+{
+  return true;
+}
+
 double 
 TwoRayGroundPropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                                  Ptr<MobilityModel> a,
@@ -460,6 +480,12 @@ LogDistancePropagationLossModel::GetPathLossExponent (void) const
   return m_exponent;
 }
 
+bool
+LogDistancePropagationLossModel::IsDeterministic (void) const
+{
+  return true;
+}
+
 double
 LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                                 Ptr<MobilityModel> a,
@@ -545,6 +571,12 @@ ThreeLogDistancePropagationLossModel::ThreeLogDistancePropagationLossModel ()
 {
 }
 
+bool
+ThreeLogDistancePropagationLossModel::IsDeterministic (void) const
+{
+  return true;
+}
+
 double 
 ThreeLogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                                      Ptr<MobilityModel> a,
@@ -836,4 +868,194 @@ RangePropagationLossModel::DoCalcRxPower (double txPowerDbm,
 
 // ------------------------------------------------------------------------- //
 
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("Model",
+                   "The first model of the chain of loss models whose results are cached.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetModel,
+                                        &CachedPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("MaxSize",
+                   "The maximum number of (source, destination) pairs whose loss is cached.",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&CachedPropagationLossModel::SetMaxSize,
+                                         &CachedPropagationLossModel::GetMaxSize),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_maxSize (65536),
+    m_hits (0),
+    m_misses (0)
+{
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  Clear ();
+  m_model = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+void
+CachedPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  Clear ();
+  m_model = model;
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+void
+CachedPropagationLossModel::Clear (void)
+{
+  m_cache.clear ();
+  m_uses.clear ();
+}
+
+void
+CachedPropagationLossModel::SetMaxSize (uint32_t maxSize)
+{
+  NS_ASSERT_MSG (maxSize > 0, "The cache must hold at least one pair");
+  m_maxSize = maxSize;
+  Evict (m_maxSize);
+}
+
+uint32_t
+CachedPropagationLossModel::GetMaxSize (void) const
+{
+  return m_maxSize;
+}
+
+uint32_t
+CachedPropagationLossModel::GetSize (void) const
+{
+  return m_cache.size ();
+}
+
+void
+CachedPropagationLossModel::Evict (uint32_t maxSize) const
+{
+  while (m_cache.size () > maxSize)
+    {
+      NS_LOG_DEBUG ("evict pair " << m_uses.back ().first << "," << m_uses.back ().second);
+      m_cache.erase (m_uses.back ());
+      m_uses.pop_back ();
+    }
+}
+
+uint64_t
+CachedPropagationLossModel::GetHits (void) const
+{
+  return m_hits;
+}
+
+uint64_t
+CachedPropagationLossModel::GetMisses (void) const
+{
+  return m_misses;
+}
+
+double
+CachedPropagationLossModel::GetHitRate (void) const
+{
+  if (m_hits + m_misses == 0)
+    {
+      return 0;
+    }
+  return (double) m_hits / (m_hits + m_misses);
+}
+
+void
+CachedPropagationLossModel::ResetStatistics (void)
+{
+  m_hits = 0;
+  m_misses = 0;
+}
+
+bool
+CachedPropagationLossModel::SamePosition (const Vector &a, const Vector &b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  // find the leading deterministic part of the wrapped chain
+  Ptr<PropagationLossModel> random = m_model;
+  while (random != 0 && random->IsDeterministic ())
+    {
+      random = random->m_next;
+    }
+
+  double rxPowerDbm = txPowerDbm;
+  if (random != m_model)
+    {
+      Vector source = a->GetPosition ();
+      Vector destination = b->GetPosition ();
+      MobilityPair pair = std::make_pair (PeekPointer (a), PeekPointer (b));
+      std::map<MobilityPair, Entry>::iterator i = m_cache.find (pair);
+      if (i != m_cache.end ()
+          && SamePosition (i->second.source, source)
+          && SamePosition (i->second.destination, destination))
+        {
+          m_hits++;
+          rxPowerDbm = txPowerDbm - i->second.lossDb;
+          m_uses.splice (m_uses.begin (), m_uses, i->second.use);
+        }
+      else
+        {
+          m_misses++;
+          for (Ptr<PropagationLossModel> model = m_model; model != random; model = model->m_next)
+            {
+              rxPowerDbm = model->DoCalcRxPower (rxPowerDbm, a, b);
+            }
+          if (i == m_cache.end ())
+            {
+              // make room for the new pair
+              Evict (m_maxSize - 1);
+              m_uses.push_front (pair);
+              i = m_cache.insert (std::make_pair (pair, Entry ())).first;
+            }
+          else
+            {
+              m_uses.splice (m_uses.begin (), m_uses, i->second.use);
+            }
+          i->second.source = source;
+          i->second.destination = destination;
+          i->second.lossDb = txPowerDbm - rxPowerDbm;
+          i->second.use = m_uses.begin ();
+          NS_LOG_DEBUG ("cached loss=" << i->second.lossDb << "dB");
+        }
+    }
+  if (random != 0)
+    {
+      rxPowerDbm = random->CalcRxPower (rxPowerDbm, a, b);
+    }
+  return rxPowerDbm;
+}
+
+// ------------------------------------------------------------------------- //
+
 } // namespace ns3
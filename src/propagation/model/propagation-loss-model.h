@@ -27,7 +27,9 @@
 
 #include "ns3/object.h"
 #include "ns3/random-variable.h"
+#include "ns3/vector.h"
 #include <map>
+#include <list>
 
 namespace ns3 {
 
@@ -74,11 +76,24 @@ public:
                       Ptr<MobilityModel> a,
                       Ptr<MobilityModel> b) const;
 private:
+  friend class CachedPropagationLossModel;
+
   PropagationLossModel (const PropagationLossModel &o);
   PropagationLossModel &operator = (const PropagationLossModel &o);
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const = 0;
+  /**
+   * \returns true if the loss (in dB) computed by DoCalcRxPower depends
+   *          only on the current positions of the source and destination,
+   *          and not on the transmission power nor on any random
+   *          variable.
+   *
+   * The results of such models can be memoised by
+   * ns3::CachedPropagationLossModel.  The default implementation
+   * returns false.
+   */
+  virtual bool IsDeterministic (void) const;
 
   Ptr<PropagationLossModel> m_next;
 };
@@ -195,6 +210,7 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual bool IsDeterministic (void) const;
   double DbmToW (double dbm) const;
   double DbmFromW (double w) const;
 
@@ -285,6 +301,7 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual bool IsDeterministic (void) const;
   double DbmToW (double dbm) const;
   double DbmFromW (double w) const;
 
@@ -339,6 +356,7 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual bool IsDeterministic (void) const;
   static Ptr<PropagationLossModel> CreateDefaultReference (void);
 
   double m_exponent;
@@ -401,6 +419,7 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual bool IsDeterministic (void) const;
 
   double m_distance0;
   double m_distance1;
@@ -563,6 +582,126 @@ private:
   double m_range;
 };
 
+/**
+ * \ingroup propagation
+ *
+ * \brief Memoise the results of a chain of deterministic loss models
+ * for each pair of mobility models.
+ *
+ * In static or mostly static topologies, deterministic loss models such
+ * as ns3::FriisPropagationLossModel or
+ * ns3::LogDistancePropagationLossModel recompute the same distances and
+ * logarithms for every packet exchanged between the same pair of nodes.
+ * This model wraps a chain of loss models (see SetModel) and remembers,
+ * for each (source, destination) pair, the loss computed by the leading
+ * deterministic models of the chain, together with the positions it was
+ * computed for.  The cached loss of a pair is discarded as soon as the
+ * source or the destination has moved, whether through a course change
+ * or through continuous movement.
+ *
+ * The first model of the wrapped chain which is not deterministic (for
+ * example, ns3::NakagamiPropagationLossModel) and all the models which
+ * follow it are evaluated for every call, with the output of the cached
+ * models as input power.
+ *
+ * The cache holds at most MaxSize pairs: when it is full, the pair
+ * which was used least recently is forgotten, so that the pairs of
+ * nodes which stopped communicating, or which were destroyed, do not
+ * accumulate.
+ *
+ * The cache relies on the parameters of the wrapped models remaining
+ * unchanged: Clear must be called if the parameters of a wrapped model
+ * are modified during the simulation.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  /**
+   * \param model the first model of the chain of loss models to cache.
+   *
+   * Clears the cache.
+   */
+  void SetModel (Ptr<PropagationLossModel> model);
+  /**
+   * \returns the first model of the chain of cached loss models.
+   */
+  Ptr<PropagationLossModel> GetModel (void) const;
+  /**
+   * Forget all the cached losses.
+   */
+  void Clear (void);
+  /**
+   * \param maxSize the maximum number of (source, destination) pairs
+   *        whose loss is cached.
+   *
+   * The least recently used pairs are forgotten if the cache holds more
+   * than maxSize pairs.
+   */
+  void SetMaxSize (uint32_t maxSize);
+  /**
+   * \returns the maximum number of (source, destination) pairs whose
+   *          loss is cached.
+   */
+  uint32_t GetMaxSize (void) const;
+  /**
+   * \returns the number of (source, destination) pairs whose loss is
+   *          currently cached.
+   */
+  uint32_t GetSize (void) const;
+
+  /**
+   * \returns the number of calls whose deterministic loss was found in
+   *          the cache.
+   */
+  uint64_t GetHits (void) const;
+  /**
+   * \returns the number of calls whose deterministic loss had to be
+   *          computed.
+   */
+  uint64_t GetMisses (void) const;
+  /**
+   * \returns GetHits () / (GetHits () + GetMisses ()), or 0 if the model
+   *          was never used.
+   */
+  double GetHitRate (void) const;
+  /**
+   * Reset the hit and miss counters.
+   */
+  void ResetStatistics (void);
+
+private:
+  CachedPropagationLossModel (const CachedPropagationLossModel &o);
+  CachedPropagationLossModel & operator = (const CachedPropagationLossModel &o);
+  virtual void DoDispose (void);
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  static bool SamePosition (const Vector &a, const Vector &b);
+  void Evict (uint32_t maxSize) const;
+
+  typedef std::pair<const MobilityModel *, const MobilityModel *> MobilityPair;
+  struct Entry
+  {
+    Vector source;      //!< position of the source when the loss was computed
+    Vector destination; //!< position of the destination when the loss was computed
+    double lossDb;      //!< loss of the deterministic models, in dB
+    std::list<MobilityPair>::iterator use; //!< position of the pair in m_uses
+  };
+
+  Ptr<PropagationLossModel> m_model;
+  uint32_t m_maxSize;
+  mutable std::map<MobilityPair, Entry> m_cache;
+  // the cached pairs, from the most to the least recently used
+  mutable std::list<MobilityPair> m_uses;
+  mutable uint64_t m_hits;
+  mutable uint64_t m_misses;
+};
+
 } // namespace ns3
 
 #endif /* PROPAGATION_LOSS_MODEL_H */
@@ -21,6 +21,7 @@
 #include "ns3/test.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
@@ -434,6 +435,101 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Test CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (100,0,0));
+
+  Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  friis->SetNext (logDistance);
+  Ptr<CachedPropagationLossModel> cache = CreateObject<CachedPropagationLossModel> ();
+  cache->SetModel (friis);
+
+  double tolerance = 1e-9;
+  double resultdBm;
+  double expected = friis->CalcRxPower (10.0, a, b);
+  resultdBm = cache->CalcRxPower (10.0, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, expected, tolerance, "Got unexpected rcv power");
+  resultdBm = cache->CalcRxPower (10.0, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, expected, tolerance, "Got unexpected cached rcv power");
+  // the cached loss does not depend on the transmission power
+  resultdBm = cache->CalcRxPower (0.0, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, expected - 10.0, tolerance, "Got unexpected cached rcv power");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetMisses (), 1, "Loss not cached");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetHits (), 2, "Loss not cached");
+  // the loss is cached per ordered pair
+  resultdBm = cache->CalcRxPower (10.0, b, a);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, expected, tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetMisses (), 2, "Loss cached for the wrong pair");
+
+  // moving a node invalidates its cached losses
+  b->SetPosition (Vector (200,0,0));
+  expected = friis->CalcRxPower (10.0, a, b);
+  resultdBm = cache->CalcRxPower (10.0, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, expected, tolerance, "Got stale cached rcv power");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetMisses (), 3, "Cached loss not invalidated");
+  NS_TEST_EXPECT_MSG_EQ_TOL (cache->GetHitRate (), 0.4, tolerance, "Got unexpected hit rate");
+
+  // models which follow a non-deterministic model are evaluated every time
+  Ptr<RangePropagationLossModel> range = CreateObject<RangePropagationLossModel> ();
+  range->SetAttribute ("MaxRange", DoubleValue (250.0));
+  logDistance->SetNext (range);
+  cache->ResetStatistics ();
+  resultdBm = cache->CalcRxPower (10.0, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, expected, tolerance, "Got unexpected rcv power");
+  range->SetAttribute ("MaxRange", DoubleValue (150.0));
+  resultdBm = cache->CalcRxPower (10.0, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (resultdBm, -1000.0, tolerance, "Non-deterministic model not evaluated");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetHits (), 2, "Deterministic part not cached");
+
+  // the least recently used pairs are forgotten when the cache is full
+  Ptr<MobilityModel> c = CreateObject<ConstantPositionMobilityModel> ();
+  c->SetPosition (Vector (0,100,0));
+  logDistance->SetNext (0);
+  cache->SetAttribute ("MaxSize", UintegerValue (2));
+  NS_TEST_EXPECT_MSG_EQ (cache->GetSize (), 2, "Unexpected cache size");
+  cache->ResetStatistics ();
+  cache->CalcRxPower (10.0, a, b);
+  cache->CalcRxPower (10.0, a, c);
+  NS_TEST_EXPECT_MSG_EQ (cache->GetSize (), 2, "Cache size not bounded");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetMisses (), 1, "Unexpected cache misses");
+  cache->CalcRxPower (10.0, a, b);
+  NS_TEST_EXPECT_MSG_EQ (cache->GetHits (), 2, "Recently used pair evicted");
+  cache->CalcRxPower (10.0, b, a);
+  NS_TEST_EXPECT_MSG_EQ (cache->GetMisses (), 2, "Least recently used pair not evicted");
+  cache->CalcRxPower (10.0, a, c);
+  NS_TEST_EXPECT_MSG_EQ (cache->GetMisses (), 3, "Least recently used pair not evicted");
+  cache->CalcRxPower (10.0, b, a);
+  NS_TEST_EXPECT_MSG_EQ (cache->GetHits (), 3, "Recently used pair evicted");
+  cache->Clear ();
+  NS_TEST_EXPECT_MSG_EQ (cache->GetSize (), 0, "Cache not cleared");
+
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -448,6 +544,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase);
   AddTestCase (new MatrixPropagationLossModelTestCase);
   AddTestCase (new RangePropagationLossModelTestCase);
+  AddTestCase (new CachedPropagationLossModelTestCase);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -354,6 +354,131 @@ WaypointMobilityModelViaHelper::DoRun (void)
   Simulator::Destroy ();
 }
 
+// A mobility model which counts the computations of its position
+class CountingMobilityModel : public MobilityModel
+{
+public:
+  CountingMobilityModel (bool cache);
+  mutable uint32_t m_computed;
+  Vector m_position;
+
+private:
+  virtual Vector DoGetPosition (void) const;
+  virtual void DoSetPosition (const Vector &position);
+  virtual Vector DoGetVelocity (void) const;
+};
+
+CountingMobilityModel::CountingMobilityModel (bool cache)
+  : m_computed (0)
+{
+  if (cache)
+    {
+      EnablePositionCache ();
+    }
+}
+
+Vector
+CountingMobilityModel::DoGetPosition (void) const
+{
+  m_computed++;
+  return m_position;
+}
+
+void
+CountingMobilityModel::DoSetPosition (const Vector &position)
+{
+  m_position = position;
+}
+
+Vector
+CountingMobilityModel::DoGetVelocity (void) const
+{
+  return Vector (0.0, 0.0, 0.0);
+}
+
+// Test the per-timestamp position cache of the models which enable it
+class PositionCache : public TestCase
+{
+public:
+  PositionCache ();
+  virtual ~PositionCache ();
+
+private:
+  void TestPositions (void);
+  void TestWaypoint (void);
+  virtual void DoRun (void);
+  Ptr<CountingMobilityModel> m_cached;
+  Ptr<CountingMobilityModel> m_uncached;
+  Ptr<WaypointMobilityModel> m_waypoint;
+};
+
+PositionCache::PositionCache ()
+  : TestCase ("Test the position cache")
+{
+}
+
+PositionCache::~PositionCache ()
+{
+}
+
+void
+PositionCache::TestPositions (void)
+{
+  uint32_t cached = m_cached->m_computed;
+  uint32_t uncached = m_uncached->m_computed;
+  m_cached->GetPosition ();
+  m_cached->GetPosition ();
+  m_uncached->GetPosition ();
+  m_uncached->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ (m_cached->m_computed, cached + 1, "Position computed more than once");
+  NS_TEST_EXPECT_MSG_EQ (m_uncached->m_computed, uncached + 2, "Position cached without being enabled");
+
+  // a position set at the current time must not be hidden by the cache
+  m_cached->SetPosition (Vector (1.0, 2.0, 3.0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_cached->GetPosition ().y, 2.0, 0.001, "Stale cached position");
+  m_cached->SetPosition (Vector (0.0, 0.0, 0.0));
+}
+
+void
+PositionCache::TestWaypoint (void)
+{
+  // a waypoint reached at the current time must not be hidden by the cache
+  Time now = Simulator::Now ();
+  Vector old = m_waypoint->GetPosition ();
+  m_waypoint->AddWaypoint (Waypoint (now, Vector (old.x + 10.0, old.y, old.z)));
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_waypoint->GetPosition ().x, old.x + 10.0, 0.001, "Stale cached position");
+}
+
+void
+PositionCache::DoRun (void)
+{
+  m_cached = CreateObject<CountingMobilityModel> (true);
+  m_uncached = CreateObject<CountingMobilityModel> (false);
+  m_waypoint = CreateObject<WaypointMobilityModel> ();
+  m_waypoint->SetAttribute ("LazyNotify", BooleanValue (true));
+
+  Simulator::Schedule (Seconds (1.0), &PositionCache::TestPositions, this);
+  Simulator::Schedule (Seconds (1.5), &PositionCache::TestPositions, this);
+  Simulator::Schedule (Seconds (1.5), &PositionCache::TestPositions, this);
+  Simulator::Schedule (Seconds (1.0), &PositionCache::TestWaypoint, this);
+  Simulator::Schedule (Seconds (2.0), &PositionCache::TestWaypoint, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // a position cached at some time of a run is not reused at the same
+  // time of the next run
+  m_cached->GetPosition ();
+  Simulator::Destroy ();
+  uint32_t cached = m_cached->m_computed;
+  m_cached->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ (m_cached->m_computed, cached + 1, "Position cached across simulation runs");
+  Simulator::Destroy ();
+
+  m_cached = 0;
+  m_uncached = 0;
+  m_waypoint = 0;
+}
+
 class MobilityTestSuite : public TestSuite
 {
 public:
@@ -367,6 +492,7 @@ MobilityTestSuite::MobilityTestSuite ()
   AddTestCase (new WaypointLazyNotifyTrue);
   AddTestCase (new WaypointInitialPositionIsWaypoint);
   AddTestCase (new WaypointMobilityModelViaHelper);
+  AddTestCase (new PositionCache);
 }
 
 static MobilityTestSuite mobilityTestSuite;
@@ -38,7 +38,7 @@
 NS_LOG_COMPONENT_DEFINE ("EdcaTxopN");
 
 #undef NS_LOG_APPEND_CONTEXT
-#define NS_LOG_APPEND_CONTEXT if (m_low != 0) { std::clog << "[mac=" << m_low->GetAddress () << "] "; }
+#define NS_LOG_APPEND_CONTEXT if (m_low != 0) { ns3LogStream << "[mac=" << m_low->GetAddress () << "] "; }
 
 namespace ns3 {
 
@@ -23,6 +23,7 @@
 #define WIFI_MAC_HEADER_H
 
 #include "ns3/header.h"
+#include "ns3/header-layout.h"
 #include "ns3/mac48-address.h"
 #include "ns3/nstime.h"
 #include <stdint.h>
@@ -102,6 +103,26 @@ public:
   virtual void Serialize (Buffer::Iterator start) const;
   virtual uint32_t Deserialize (Buffer::Iterator start);
 
+  /**
+   * \brief The fields of a serialized header which are at a fixed
+   * offset
+   *
+   * The format of the header depends on its type: SIZE bytes are
+   * common to all the frames, the fields after them are those of the
+   * data and management frames.  Used to read these fields without
+   * deserializing the header, see Packet::PeekBytes.
+   */
+  struct Layout
+  {
+    enum { SIZE = 10 };
+    typedef HeaderLsbField<0, uint16_t> FrameControl;
+    typedef HeaderLsbField<2, uint16_t> Duration;
+    typedef HeaderBytesField<4, 6> Addr1;
+    typedef HeaderBytesField<10, 6> Addr2;
+    typedef HeaderBytesField<16, 6> Addr3;
+    typedef HeaderLsbField<22, uint16_t> SequenceControl;
+  };
+
 
   void SetAssocReq (void);
   void SetAssocResp (void);
@@ -37,6 +37,8 @@
 #include "ns3/dca-txop.h"
 #include "ns3/mac-rx-middle.h"
 #include "ns3/pointer.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/packet.h"
 
 namespace ns3 {
 
@@ -284,6 +286,90 @@ InterferenceHelperSequenceTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+//-----------------------------------------------------------------------------
+class WifiMacHeaderLayoutTest : public TestCase
+{
+public:
+  WifiMacHeaderLayoutTest ();
+
+  virtual void DoRun (void);
+private:
+  void CheckLayout (const WifiMacHeader &header);
+};
+
+WifiMacHeaderLayoutTest::WifiMacHeaderLayoutTest ()
+  : TestCase ("WifiMacHeader fields read without deserialization")
+{
+}
+
+void
+WifiMacHeaderLayoutTest::CheckLayout (const WifiMacHeader &header)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddHeader (header);
+
+  // the fields of the data and management frames.
+  uint8_t scratch[WifiMacHeader::Layout::SequenceControl::END];
+  uint8_t const *bytes = p->PeekBytes (WifiMacHeader::Layout::SequenceControl::END, scratch);
+  uint32_t frameControl = WifiMacHeader::Layout::FrameControl::Read (bytes);
+  uint32_t duration = WifiMacHeader::Layout::Duration::Read (bytes);
+  Mac48Address addr1;
+  addr1.CopyFrom (WifiMacHeader::Layout::Addr1::Get (bytes));
+  Mac48Address addr2;
+  addr2.CopyFrom (WifiMacHeader::Layout::Addr2::Get (bytes));
+  Mac48Address addr3;
+  addr3.CopyFrom (WifiMacHeader::Layout::Addr3::Get (bytes));
+  uint32_t sequenceControl = WifiMacHeader::Layout::SequenceControl::Read (bytes);
+
+  WifiMacHeader deserialized;
+  p->PeekHeader (deserialized);
+  NS_TEST_EXPECT_MSG_EQ (deserialized.GetType (), header.GetType (), "type");
+  NS_TEST_EXPECT_MSG_EQ (((frameControl >> 2) & 0x3), (deserialized.IsData () ? 2u : 0u), "frame type");
+  NS_TEST_EXPECT_MSG_EQ ((((frameControl >> 8) & 0x1) != 0), deserialized.IsToDs (), "to ds");
+  NS_TEST_EXPECT_MSG_EQ ((((frameControl >> 9) & 0x1) != 0), deserialized.IsFromDs (), "from ds");
+  NS_TEST_EXPECT_MSG_EQ ((((frameControl >> 10) & 0x1) != 0), deserialized.IsMoreFragments (), "more fragments");
+  NS_TEST_EXPECT_MSG_EQ ((((frameControl >> 11) & 0x1) != 0), deserialized.IsRetry (), "retry");
+  NS_TEST_EXPECT_MSG_EQ (duration, deserialized.GetRawDuration (), "duration");
+  NS_TEST_EXPECT_MSG_EQ (addr1, deserialized.GetAddr1 (), "addr1");
+  NS_TEST_EXPECT_MSG_EQ (addr2, deserialized.GetAddr2 (), "addr2");
+  NS_TEST_EXPECT_MSG_EQ (addr3, deserialized.GetAddr3 (), "addr3");
+  NS_TEST_EXPECT_MSG_EQ (sequenceControl, deserialized.GetSequenceControl (), "sequence control");
+  NS_TEST_EXPECT_MSG_EQ (sequenceControl, ((uint32_t (header.GetSequenceNumber ()) << 4) | header.GetFragmentNumber ()),
+                         "sequence and fragment numbers");
+}
+
+void
+WifiMacHeaderLayoutTest::DoRun (void)
+{
+  WifiMacHeader data;
+  data.SetTypeData ();
+  data.SetDsTo ();
+  data.SetDsNotFrom ();
+  data.SetRetry ();
+  data.SetMoreFragments ();
+  data.SetRawDuration (314);
+  data.SetAddr1 (Mac48Address ("00:11:22:33:44:55"));
+  data.SetAddr2 (Mac48Address ("66:77:88:99:aa:bb"));
+  data.SetAddr3 (Mac48Address ("cc:dd:ee:ff:00:01"));
+  data.SetSequenceNumber (1234);
+  data.SetFragmentNumber (3);
+  CheckLayout (data);
+
+  WifiMacHeader beacon;
+  beacon.SetBeacon ();
+  beacon.SetDsNotTo ();
+  beacon.SetDsNotFrom ();
+  beacon.SetNoRetry ();
+  beacon.SetNoMoreFragments ();
+  beacon.SetRawDuration (0);
+  beacon.SetAddr1 (Mac48Address::GetBroadcast ());
+  beacon.SetAddr2 (Mac48Address ("66:77:88:99:aa:bb"));
+  beacon.SetAddr3 (Mac48Address ("66:77:88:99:aa:bb"));
+  beacon.SetSequenceNumber (4095);
+  beacon.SetFragmentNumber (0);
+  CheckLayout (beacon);
+}
+
 //-----------------------------------------------------------------------------
 
 class WifiTestSuite : public TestSuite
@@ -298,6 +384,7 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new WifiTest);
   AddTestCase (new QosUtilsIsOldPacketTest);
   AddTestCase (new InterferenceHelperSequenceTest); // Bug 991
+  AddTestCase (new WifiMacHeaderLayoutTest);
 }
 
 static WifiTestSuite g_wifiTestSuite;
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/object.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <sstream>
+
+using namespace ns3;
+
+/*
+ * Measure the cost of Object::GetObject on an aggregate of
+ * --aggregates objects of distinct types, each type deriving from a
+ * common base.
+ */
+
+class BenchBase : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("BenchBase")
+      .SetParent<Object> ()
+    ;
+    return tid;
+  }
+};
+
+template <int N>
+class BenchObject : public BenchBase
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId (GetName ().c_str ())
+      .SetParent<BenchBase> ()
+    ;
+    return tid;
+  }
+  virtual TypeId GetInstanceTypeId (void) const
+  {
+    return GetTypeId ();
+  }
+private:
+  static std::string GetName (void)
+  {
+    std::ostringstream oss;
+    oss << "BenchObject<" << N << ">";
+    return oss.str ();
+  }
+};
+
+// never aggregated, to measure failed lookups
+class BenchMissing : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("BenchMissing")
+      .SetParent<Object> ()
+    ;
+    return tid;
+  }
+};
+
+static void
+Aggregate (Ptr<Object> object, uint32_t n)
+{
+  // 16 distinct types: enough to go past the size of the lookup cache
+  Ptr<Object> objects[] = {
+    CreateObject<BenchObject<1> > (), CreateObject<BenchObject<2> > (),
+    CreateObject<BenchObject<3> > (), CreateObject<BenchObject<4> > (),
+    CreateObject<BenchObject<5> > (), CreateObject<BenchObject<6> > (),
+    CreateObject<BenchObject<7> > (), CreateObject<BenchObject<8> > (),
+    CreateObject<BenchObject<9> > (), CreateObject<BenchObject<10> > (),
+    CreateObject<BenchObject<11> > (), CreateObject<BenchObject<12> > (),
+    CreateObject<BenchObject<13> > (), CreateObject<BenchObject<14> > (),
+    CreateObject<BenchObject<15> > (), CreateObject<BenchObject<16> > ()
+  };
+  for (uint32_t i = 0; i < n && i < 16; i++)
+    {
+      object->AggregateObject (objects[i]);
+    }
+}
+
+template <typename T>
+static void
+RunBench (Ptr<Object> object, uint32_t n, char const *name)
+{
+  SystemWallClockMs time;
+  uint32_t found = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (object->GetObject<T> () != 0)
+        {
+          found++;
+        }
+    }
+  uint64_t deltaMs = time.End ();
+  double ns = deltaMs;
+  ns *= 1000000;
+  ns /= n;
+  std::cout << name << "=" << ns << " ns/lookup (found " << found << ")" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+  uint32_t aggregates = 12;
+
+  CommandLine cmd;
+  cmd.AddValue ("n", "Number of lookups of each kind", n);
+  cmd.AddValue ("aggregates", "Number of objects aggregated to the first one (at most 16)", aggregates);
+  cmd.Parse (argc, argv);
+
+  Ptr<Object> object = CreateObject<Object> ();
+  Aggregate (object, aggregates);
+  std::cout << "Running bench-object with n=" << n
+            << " and " << aggregates << " aggregates" << std::endl;
+
+  RunBench<BenchObject<1> > (object, n, "first");
+  RunBench<BenchObject<12> > (object, n, "twelfth");
+  RunBench<BenchBase> (object, n, "base");
+  RunBench<BenchMissing> (object, n, "missing");
+
+  object->Dispose ();
+  return 0;
+}
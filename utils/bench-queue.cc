@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/callback.h"
+#include "ns3/packet.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/data-rate.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include <iostream>
+
+using namespace ns3;
+
+/*
+ * Measure the cost of the queues of the devices: --n rounds which fill
+ * a DropTailQueue of --size packets and drain it, then a point-to-point
+ * link of --rate fed at twice its rate for --duration seconds, such
+ * that its queue stays full.  With --trace, a sink is connected to the
+ * occupancy trace source of the queues.
+ */
+
+static uint64_t g_received = 0;
+
+static void
+Occupancy (uint32_t oldValue, uint32_t newValue)
+{
+}
+
+static void
+Receive (Ptr<const Packet> p)
+{
+  g_received++;
+}
+
+static void
+Generate (Ptr<NetDevice> device, uint32_t packetSize, Time interval)
+{
+  device->Send (Create<Packet> (packetSize), device->GetBroadcast (), 0x0800);
+  Simulator::Schedule (interval, &Generate, device, packetSize, interval);
+}
+
+static void
+BenchQueue (uint32_t n, uint32_t size, bool trace)
+{
+  Ptr<Queue> queue = CreateObject<DropTailQueue> ();
+  queue->SetAttribute ("MaxPackets", UintegerValue (size));
+  if (trace)
+    {
+      queue->TraceConnectWithoutContext ("PacketsInQueue", MakeCallback (&Occupancy));
+    }
+  Ptr<Packet> p = Create<Packet> (100);
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t round = 0; round < n; round++)
+    {
+      for (uint32_t i = 0; i < size; i++)
+        {
+          queue->Enqueue (p);
+        }
+      for (uint32_t i = 0; i < size; i++)
+        {
+          queue->Dequeue ();
+        }
+    }
+  uint64_t ms = time.End ();
+  std::cout << "queue: " << ms * 1000000.0 / (uint64_t (n) * size)
+            << " ns/packet (" << ms << " ms)" << std::endl;
+}
+
+static void
+BenchLink (std::string rate, uint32_t packetSize, double duration, bool trace)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue (rate));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  p2p.SetQueue ("ns3::DropTailQueue", "MaxPackets", UintegerValue (1000));
+  NetDeviceContainer devices = p2p.Install (nodes);
+  devices.Get (1)->TraceConnectWithoutContext ("MacRx", MakeCallback (&Receive));
+  if (trace)
+    {
+      devices.Get (0)->GetObject<PointToPointNetDevice> ()->GetQueue ()
+        ->TraceConnectWithoutContext ("PacketsInQueue", MakeCallback (&Occupancy));
+    }
+
+  // twice the rate of the link.
+  Time interval = Seconds (packetSize * 8.0 / (2.0 * DataRate (rate).GetBitRate ()));
+  Simulator::Schedule (Seconds (0), &Generate, devices.Get (0), packetSize, interval);
+  Simulator::Stop (Seconds (duration));
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  uint64_t ms = time.End ();
+  Simulator::Destroy ();
+  std::cout << "link: " << g_received << " packets received, "
+            << ms * 1000000.0 / g_received << " ns/packet (" << ms << " ms)" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000;
+  uint32_t size = 1000;
+  std::string rate = "100Mbps";
+  uint32_t packetSize = 1000;
+  double duration = 10;
+  bool trace = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("n", "Number of rounds which fill and drain the queue", n);
+  cmd.AddValue ("size", "Number of packets of the queue", size);
+  cmd.AddValue ("rate", "Rate of the point-to-point link", rate);
+  cmd.AddValue ("packetSize", "Size of the packets sent over the link", packetSize);
+  cmd.AddValue ("duration", "Simulated time of the link, in seconds", duration);
+  cmd.AddValue ("trace", "Connect a sink to the occupancy of the queues", trace);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-queue with n=" << n << " size=" << size
+            << " rate=" << rate << " duration=" << duration
+            << " trace=" << trace << std::endl;
+
+  BenchQueue (n, size, trace);
+  BenchLink (rate, packetSize, duration, trace);
+  return 0;
+}
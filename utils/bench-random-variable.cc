@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/random-variable.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/*
+ * Measure the cost of drawing --n values from the common random
+ * variables, one at a time with GetValue and in blocks of --block
+ * values with GetValues.
+ */
+
+static void
+RunBench (RandomVariable variable, uint32_t n, uint32_t block, char const *name)
+{
+  SystemWallClockMs time;
+  double sum = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += variable.GetValue ();
+    }
+  uint64_t singleMs = time.End ();
+
+  std::vector<double> values (block);
+  double bulkSum = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i += block)
+    {
+      variable.GetValues (block, &values[0]);
+      for (uint32_t j = 0; j < block; j++)
+        {
+          bulkSum += values[j];
+        }
+    }
+  uint64_t bulkMs = time.End ();
+
+  double singleNs = singleMs * 1000000.0 / n;
+  double bulkNs = bulkMs * 1000000.0 / n;
+  std::cout << name << ": GetValue=" << singleNs << " ns/value"
+            << " GetValues=" << bulkNs << " ns/value"
+            << " (mean " << sum / n << ", " << bulkSum / n << ")" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+  uint32_t block = 1024;
+
+  CommandLine cmd;
+  cmd.AddValue ("n", "Number of values drawn from each variable", n);
+  cmd.AddValue ("block", "Number of values drawn by each call to GetValues", block);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-random-variable with n=" << n
+            << " and block=" << block << std::endl;
+
+  RunBench (UniformVariable (0, 1), n, block, "uniform");
+  RunBench (ExponentialVariable (1), n, block, "exponential");
+  RunBench (NormalVariable (0, 1), n, block, "normal");
+  return 0;
+}
@@ -0,0 +1,47 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/animation-interface.h"
+#include <iostream>
+#include <fstream>
+
+using namespace ns3;
+
+/*
+ * Print an animation written after AnimationInterface::EnableBinaryOutput
+ * as the xml trace read by the network animator.
+ */
+
+int main (int argc, char *argv[])
+{
+  if (argc != 2)
+    {
+      std::cerr << "usage: " << argv[0] << " <binary animation file>" << std::endl;
+      return 1;
+    }
+  std::ifstream is (argv[1], std::ios::binary);
+  if (!is)
+    {
+      std::cerr << "could not open " << argv[1] << std::endl;
+      return 1;
+    }
+  if (!AnimationInterface::ConvertToXml (is, std::cout))
+    {
+      std::cerr << argv[1] << ": not a binary animation or truncated" << std::endl;
+      return 1;
+    }
+  return 0;
+}